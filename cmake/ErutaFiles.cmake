@@ -15,6 +15,7 @@ set(BF_SRC_FILES
 set(ERUTA_SRC_FILES
   src/alps.c
   src/area.c
+  src/atlas.c
   src/bad.c
   src/bevec.c
   src/brex.c
@@ -23,6 +24,7 @@ set(ERUTA_SRC_FILES
   src/bxml.c
   src/bxmlparser.c
   src/camera.c
+  src/cook.c
   src/callrb.c
   src/draw.c
   src/dynar.c
@@ -30,6 +32,7 @@ set(ERUTA_SRC_FILES
   src/event.c
   src/every.c
   src/flags.c
+  src/framecache.c
   src/fifi.c
   src/glh.c
   src/hatab.c
@@ -38,10 +41,13 @@ set(ERUTA_SRC_FILES
   src/intgrid.c
   src/laytext.c
   src/mem.c
+  src/miniz.c
   src/mobile.c
   src/mode.c
   src/monolog.c
   src/obj.c
+  src/pack.c
+  src/pickgrid.c
   src/pique.c
   src/pointergrid.c
   src/react.c
@@ -49,14 +55,22 @@ set(ERUTA_SRC_FILES
   src/rebox.c
   src/resor.c
   src/rh.c    
+  src/rhalloc.c
+  src/rhprof.c
+  src/rhtask.c
   src/scegra.c
+  src/scriptcache.c
   src/ses.c
   src/silut.c
   src/sound.c
   src/sprite.c
   src/spritelist.c
   src/spritestate.c
+  src/spriteload.c
+  src/storeload.c
+  src/arena.c
   src/spritelayout.c
+  src/spriteanim.c
   src/state.c
   src/store.c
   src/str.c
@@ -66,14 +80,17 @@ set(ERUTA_SRC_FILES
   src/tilemap.c
   src/tilepane.c
   src/tarray.c
+  src/textcache.c
   src/tmatrix.c
   src/toruby.c
   src/tr_audio.c
   src/tr_path.c
   src/tr_store.c
   src/tr_graph.c
+  src/tr_bind.c
   src/tr_sprite.c
   src/tr_thing.c
+  src/tween.c
   src/ui.c
   src/utf8.c
   src/widget.c
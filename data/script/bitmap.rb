@@ -17,6 +17,14 @@ class Bitmap < Store
     end 
   end
 
+  # Loads a bitmap in the background. The block, if any, is called with the 
+  # bitmap, or nil if loading failed, when it's done.
+  def self.load_async(name, vpath, &block)
+    load_something_async(forward_name(name), vpath, self, block) do | nid |
+      Eruta::Store.load_bitmap_async(nid, vpath)
+    end
+  end
+
   # Converts the mask color of this bitmapp expressed by r, g, b to transparent.
   def mask_to_alpha(r, g, b)
     return Eruta::Store.mask_to_alpha(@id, r, g, b)
@@ -17,6 +17,14 @@ class Font < Store
     end 
   end
 
+  # Loads a truetype or opentype font in the background. The block, if any,
+  # is called with the font, or nil if loading failed, when it's done.
+  def self.load_ttf_async(name, vpath, height, flags = 0, &block)
+    load_something_async(forward_name(name), vpath, self, block) do | nid |
+      Eruta::Store.load_ttf_font_async(nid, vpath, height, flags)
+    end 
+  end
+
   # Loads a bitmap font
   def self.load_bitmap(name, vpath)
     load_something(forward_name(name), vpath, self) do | nid |
@@ -101,6 +101,31 @@ class Graph < Eruta::Graph
       Eruta::Graph.line_stop_(@id, store_id)
     end
 
+    # Tweens the property prop (one of the Eruta::Graph::PROP_ constants)
+    # of this node towards values in duration seconds. Options are :delay,
+    # :ease, :loop, :loops and :notify. If :notify is true, on_tween 
+    # will be called on this node when the tween is done or loops.
+    def tween(prop, values, duration, opts = {})
+      v1, v2, v3, v4 = *values
+      Eruta::Graph.tween(@id, prop, duration.to_f, (opts[:delay] || 0).to_f,
+                         opts[:ease] || 0, opts[:loop] || 0, opts[:loops] || 0,
+                         !!opts[:notify], (v1 || 0).to_f, (v2 || 0).to_f,
+                         (v3 || 0).to_f, (v4 || 0).to_f)
+    end
+
+    def tween_stop(prop = nil)
+      return Eruta::Graph.tween_stop_all(@id) unless prop
+      Eruta::Graph.tween_stop(@id, prop)
+    end
+
+    def tween?(prop)
+      Eruta::Graph.tween_p(@id, prop)
+    end
+
+    # Called when a tween with :notify set is done or loops.
+    def on_tween(prop, kind)
+    end
+
     # Forwards methods to Eruta::Graph(@id, * args)
     def self.forward_graph(name)
       clean_name = name.to_s
@@ -164,6 +189,27 @@ class Graph < Eruta::Graph
     thing = nil
   end
   
+  # Makes amount copies of the node template, each one moved by dx, dy
+  # from the previous one, in one call. Returns an array of the new nodes.
+  def self.make_copies(template, amount, dx = 0, dy = 0)
+    ids = Eruta::Graph.make_from_template(template.id, self.get_unused_id, 
+                                          amount, dx.to_f, dy.to_f)
+    ids.map { |id| Node.new(id) }
+  end
+
+  # Returns the topmost visible node at x, y or nil if none.
+  def self.pick_node(x, y)
+    id = Eruta::Graph.pick(x.to_f, y.to_f)
+    return nil unless id
+    self.registry[id]
+  end
+
+  # Called from eruta_on_tween.
+  def self.on_tween(id, prop, kind)
+    node = self.registry[id]
+    node.on_tween(prop, kind) if node
+  end
+
   def self.get_unused_id
     29000.times do | i | 
       return i unless self.registry[i]
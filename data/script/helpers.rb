@@ -14,3 +14,24 @@ def script_once(filenname)
 end
 
 
+
+# Starts or stops the script profiler, for use from the console. When it is
+# stopped, the methods the scripts spent the most time in are shown, and the
+# sampled call stacks are written to filename, which flamegraph.pl can read.
+def profile(filename = "profile.folded", top = 10)
+  unless Eruta.profile
+    Eruta.profile_reset
+    Eruta.profile = true
+    puts "Profiling the scripts." if Eruta.profile
+    puts "No profiler, build with ERUTA_PROFILER." unless Eruta.profile
+    return Eruta.profile
+  end
+  Eruta.profile = false
+  puts "self ms total ms method"
+  Eruta.profile_report(top).each do | label, self_time, total_time |
+    puts "#{(self_time * 1000).round(1)} #{(total_time * 1000).round(1)} #{label}"
+  end
+  stacks = Eruta.profile_dump(filename)
+  puts "Wrote #{stacks} call stacks to #{filename}." if stacks
+  return false
+end
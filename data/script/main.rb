@@ -40,6 +40,7 @@ script 'state.rb'
 script 'keycode.rb'
 # Load OO wrappers
 script 'timer.rb'
+script 'task.rb'
 script 'thing.rb'
 script 'sprite.rb'
 script 'graph.rb'
@@ -111,6 +112,8 @@ module Main
     player_1.pose      = Sprite::STAND
     player_1.hide_layer(Sprite::Layer::STAFF)
     player_1.group     = Thing::Kind::PLAYER
+    # Let the engine pick the walking animation from the velocity.
+    player_1.set_hull_flag(Thing::Flag::ANIMATE)
     
     # hf = Thing[100].hull_flags= Thing::Flag::DISABLED
     # p "set hull flag", hf, Thing[100].hull_flags
@@ -548,13 +551,52 @@ def eruta_on_sprite(spriteid, thingid, pose, direction, kind = nil)
   puts "Sprite event: #{spriteid} #{thingid}  #{pose} #{direction} #{kind}."
 end
 
+# Called once per update with all sprite events of that update, as an array
+# of [spriteid, pose, direction, kind] arrays.
+def eruta_on_sprites(events)
+  events.each do | event |
+    eruta_on_sprite(*event)
+  end
+end
+
+# Called when a sprite layer that was loading in the background is done.
+# ok is false if the layer could not be loaded.
+def eruta_on_sprite_loaded(job, sprite_id, layer, ok)
+  Sprite.on_loaded(job, sprite_id, layer, ok != 0)
+end
+
+# Called when a resource that was loading in the background into the store 
+# is done. ok is false if the resource could not be loaded.
+def eruta_on_resource_loaded(job, id, kind, ok)
+  Store.on_loaded(job, id, kind, ok != 0)
+end
+
+# Called when a scene graph tween that has notify set is done or loops.
+def eruta_on_tween(id, prop, kind)
+  Graph.on_tween(id, prop, kind)
+end
+
 # Called on an update tick, just before drawing to the screen.
 def eruta_on_update(dt)
   # Update the timers
   Timer.update
 end
 
+# Called to resume the script task with the given id, after eruta_on_update.
+# Must return true if the task has more work to do.
+def eruta_on_task(id)
+  Task.resume(id)
+end
+
 # Called when an input event occurs.
+# Called once per frame with all input events of that frame, each an array
+# with the same contents as the arguments of eruta_on_poll.
+def eruta_on_events(events)
+  events.each do | event |
+    eruta_on_poll(*event)
+  end
+end
+
 def eruta_on_poll(*args)
   # Send to Zori ui first. If it returns non-nil the event is handled,
   # otherwise, pass on to key handler.
@@ -11,6 +11,14 @@ class Sound < Store
     end 
   end
   
+  # Loads a sample in the background. The block, if any, is called with the 
+  # sample, or nil if loading failed, when it's done.
+  def self.load_async(name, vpath, &block)
+    load_something_async(forward_name(name), vpath, self, block) do | nid |
+      Eruta::Store.load_sample_async(nid, vpath)
+    end 
+  end
+  
   # Plays this sample immediately 
   def play!
     Eruta::Audio.play_sample @id
@@ -31,6 +31,35 @@ class Sprite < Eruta::Sprite
     Sprite.load_builtin(@id, layer, vpath, layout)
   end
 
+  # Starts loading a sprite sheet with built in layout as a layer in the 
+  # background. The block, if any, is called with the sprite and the layer 
+  # and whether loading worked when the layer is done. Returns the load job id.
+  def self.load_builtin_async(sprite_id, layer, name, layout = :ulpcss, &block)
+    ilayout = BUILTIN_LAYOUTS[layout]
+    full_name = "image/ulpcss/#{name}"
+    job = Eruta::Sprite.load_builtin_async sprite_id, layer, full_name, ilayout
+    @load_blocks ||= {}
+    @load_blocks[job] = block if block && job > 0
+    return job
+  end
+  
+  # Called when a layer that was loading in the background is done.
+  def self.on_loaded(job, sprite_id, layer, ok)
+    @load_blocks ||= {}
+    block = @load_blocks.delete(job)
+    block.call(self[sprite_id], layer, ok) if block
+  end
+  
+  # Loads a sprite sheet with built in layout as a layer in the background.
+  def load_builtin_async(layer, vpath, layout = :ulpcss, &block)
+    Sprite.load_builtin_async(@id, layer, vpath, layout, &block)
+  end
+  
+  # Returns true if some layers of this sprite are still loading.
+  def loading?
+    Eruta::Sprite.loading(@id).to_i > 0
+  end
+
   # Loads a ULPCSS sprite sheet with built in layout as a layer.
   def load_ulpcss(layer, vpath)
     Sprite.load_builtin(@id, layer, vpath, :ulpcss)
@@ -41,6 +41,47 @@ class Store
   end
   
   
+  # Load helper for loading in the background. The block must start the 
+  # load into the given id and return the job id. The stored object is 
+  # returned immediately, and can be used once it's loaded. done, if given,
+  # is called with the object, or nil if loading failed, when it's done.
+  def self.load_something_async(name, vpath, klass = nil, done = nil, &block)
+    Store[name].drop! if Store[name]
+    id    = Eruta::Store.get_unused_id(1000)
+    return nil if id < 0
+    job = block.call(id)
+    return nil unless job && job > 0
+    klass ||= self
+    loaded = klass.new(id, name, vpath)
+    Store.register(loaded, id, name)
+    Store.load_jobs[job] = [loaded, done]
+    return loaded
+  end
+  
+  # Stored objects that are loading in the background by job id.
+  def self.load_jobs
+    @load_jobs ||= {}
+  end
+  
+  # Called when a resource that was loading in the background is done.
+  def self.on_loaded(job, id, kind, ok)
+    loaded, done = Store.load_jobs.delete(job)
+    return nil unless loaded
+    # Don't drop what was stored at the same id after a cancelled load.
+    loaded.drop! if !ok && Store[id].equal?(loaded)
+    done.call(ok ? loaded : nil) if done
+  end
+  
+  # How far along the loading in the background is, between 0.0 and 1.0.
+  def self.load_progress
+    Eruta::Store.load_progress
+  end
+  
+  # Returns true if resources are still loading in the background.
+  def self.loading?
+    Eruta::Store.load_pending > 0
+  end
+  
   # Loads a tile map
   def self.load_tilemap(name, vpath)
     load_something(name, vpath) do | nid |
@@ -64,6 +105,27 @@ class Store
     return Eruta::Store.kind(@id)
   end
   
+  # Pins this object so it's never evicted when over the memory budget.
+  def pin!
+    Eruta::Store.pin(@id)
+  end
+  
+  # Allows this object to be evicted again when over the memory budget.
+  def unpin!
+    Eruta::Store.unpin(@id)
+  end
+  
+  # Returns true if this object is pinned.
+  def pinned?
+    Eruta::Store.pinned(@id)
+  end
+  
+  # Sets the memory budget in bytes for the given kind of stored objects,
+  # for example Store::BITMAP. 0 means no budget.
+  def self.set_budget(kind, bytes)
+    Eruta::Store.set_budget(kind, bytes)
+  end
+  
   # Drops this object from storage
   def drop!
     res = Eruta::Store.drop(@id)
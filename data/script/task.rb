@@ -0,0 +1,56 @@
+# The Task module runs long jobs of the scripts, such as sorting an inventory
+# or planning the moves of foes, a bit at a time over several frames. A task
+# is a Fiber that calls Task.pause or Fiber.yield between parts of its work.
+# The engine resumes the tasks in turn after eruta_on_update, until their
+# time budget of the frame, Eruta::Task.budget, is used up.
+module Task
+  # Returned by the fiber of a task when its block is done.
+  DONE = Object.new
+
+  # Starts a task that runs the block, which is passed the task id. Returns
+  # the task id, or nil if the task could not be added.
+  def self.start(name = 'task', &block)
+    @tasks ||= {}
+    id = Eruta::Task.add(name.to_s)
+    return nil if id < 0
+    @tasks[id] = Fiber.new { block.call(id); DONE }
+    return id
+  end
+
+  # Resumes the task with the given id. Returns true if it has more work to
+  # do, false if it is done, stopped or failed.
+  def self.resume(id)
+    @tasks ||= {}
+    fiber = @tasks[id]
+    return false unless fiber
+    begin
+      return !DONE.equal?(fiber.resume)
+    ensure
+      @tasks.delete(id) unless fiber.alive?
+    end
+  end
+
+  # Yields the task that calls this if its time of this frame is used up.
+  # Call it often from long loops.
+  def self.pause
+    Fiber.yield if Eruta::Task.time_left <= 0
+  end
+
+  # Time left for the tasks in this frame, in seconds.
+  def self.time_left
+    return Eruta::Task.time_left
+  end
+
+  # Stops the task with the given id.
+  def self.stop(id)
+    @tasks ||= {}
+    @tasks.delete(id)
+    return Eruta::Task.remove(id) >= 0
+  end
+
+  # Returns true if the task with the given id is still running.
+  def self.running?(id)
+    @tasks ||= {}
+    return @tasks.has_key?(id)
+  end
+end
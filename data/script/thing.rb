@@ -4,6 +4,10 @@
 class Thing
   extend Registry 
   
+  # Kinds and flags of things.
+  Kind = Eruta::Thing::Kind
+  Flag = Eruta::Thing::Flag
+  
   attr_reader   :id
   attr_reader   :sprite_id
   attr_reader   :sprite
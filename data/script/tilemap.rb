@@ -15,6 +15,8 @@ class Tilemap < Store
   def self.activate!(tilemap)
     active_map_ tilemap.id
     @active = tilemap
+    # A new map is a good moment to clean up what the previous one left.
+    Eruta.gc_full_later
   end
 
   # returns the current active tilemap
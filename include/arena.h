@@ -0,0 +1,45 @@
+#ifndef arena_H_INCLUDED
+#define arena_H_INCLUDED
+
+#include "eruta.h"
+
+/* An Arena hands out memory from large blocks by bumping a pointer. The
+ * memory can't be freed piece by piece, it's all freed at once by
+ * arena_done or arena_free. This is handy for data that lives and dies
+ * together, like the actions, frames and cells of a sprite. */
+
+/* Default size of the blocks of an arena. */
+#define ARENA_BLOCK_DEFAULT 16384
+
+typedef struct Arena_      Arena;
+typedef struct ArenaStats_ ArenaStats;
+
+/* Statistics of an arena. */
+struct ArenaStats_ {
+  long blocks;
+  long bytes;
+  long used;
+  long allocations;
+};
+
+Arena * arena_alloc(void);
+Arena * arena_init(Arena * self, size_t block_size);
+Arena * arena_new(size_t block_size);
+Arena * arena_done(Arena * self);
+Arena * arena_free(Arena * self);
+
+void * arena_allocate(Arena * self, size_t size);
+void * arena_reallocate(Arena * self, void * ptr, size_t oldsize,
+                        size_t newsize);
+bool arena_stats(Arena * self, ArenaStats * stats);
+
+/* Allocates a zeroed struct from the arena. */
+#define ARENA_ALLOC(ARENA, STRUCT)                                             \
+        ((STRUCT *) arena_allocate((ARENA), sizeof(STRUCT)))
+
+/* Allocates a zeroed array of AMOUNT structs from the arena. */
+#define ARENA_NALLOC(ARENA, STRUCT, AMOUNT)                                    \
+        ((STRUCT *) arena_allocate((ARENA), sizeof(STRUCT) * (AMOUNT)))
+
+
+#endif
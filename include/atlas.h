@@ -0,0 +1,82 @@
+#ifndef atlas_H_INCLUDED
+#define atlas_H_INCLUDED
+
+#include "eruta.h"
+#include "image.h"
+
+/* An Atlas packs many small images into a few large shared pages, so 
+ * drawing them one after the other can be batched by Allegro while 
+ * al_hold_bitmap_drawing is in effect, since they use the same texture. 
+ * The images in the atlas are sub bitmaps of the pages. 
+ *
+ * Pages are reference counted: a page is destroyed once all images that were
+ * packed into it have been released. Space in a page is not reused before
+ * that. */
+
+/* Default size of an atlas page. 1024 is supported by all hardware. */
+#define ATLAS_PAGE_WIDE  1024
+#define ATLAS_PAGE_HIGH  1024
+
+/* Transparent pixels kept between the images in a page to prevent 
+ * neighbouring images from bleeding in when drawing with filtering.  */
+#define ATLAS_PADDING    1
+
+typedef struct Skyline_       Skyline;
+typedef struct SkylineNode_   SkylineNode;
+typedef struct Atlas_         Atlas;
+typedef struct AtlasStats_    AtlasStats;
+
+/* A segment of the skyline: the top of the used space from x to x + w is y. */
+struct SkylineNode_ {
+  int x, y, w;
+};
+
+/* A Skyline is a bottom-left skyline rectangle packer. It keeps track of
+ * the top edge of the used area of a page, and places every new rectangle 
+ * as low as possible on it. */
+struct Skyline_ {
+  SkylineNode * nodes;
+  int           used;
+  int           wide;
+  int           high;
+  long          area;
+};
+
+/* Statistics of an atlas. */
+struct AtlasStats_ {
+  /* Pages currently in use. */
+  int  pages;
+  /* Images currently in the atlas. */
+  int  images;
+  /* Pixels of all pages. */
+  long page_area;
+  /* Pixels of all pages that are covered by images. */
+  long used_area;
+  /* Pixels that were saved by trimming transparent borders of the images.*/
+  long trimmed_area;
+};
+
+
+Skyline * skyline_init(Skyline * self, int wide, int high);
+Skyline * skyline_done(Skyline * self);
+bool skyline_insert(Skyline * self, int wide, int high, int * x, int * y);
+
+bool atlas_alpha_bounds(const unsigned char * data, int pitch, int pixsize, 
+                        int wide, int high, int * bx, int * by, 
+                        int * bw, int * bh);
+
+Atlas * atlas_alloc(void);
+Atlas * atlas_init(Atlas * self, int page_wide, int page_high);
+Atlas * atlas_new(int page_wide, int page_high);
+Atlas * atlas_done(Atlas * self);
+Atlas * atlas_free(Atlas * self);
+
+Image * atlas_add_region(Atlas * self, Image * source, int x, int y, 
+                         int wide, int high, int * page);
+Image * atlas_add_trimmed(Atlas * self, Image * source, int x, int y, 
+                          int wide, int high, int * page, Point * trim);
+int atlas_release(Atlas * self, Image * image, int page);
+bool atlas_stats(Atlas * self, AtlasStats * stats);
+
+
+#endif
@@ -2,6 +2,24 @@
 #define collide_H_INCLUDED
 
 #include "state.h"
+#include "spriteanim.h"
+#include "rh.h"
+
+/* Indexes of the callbacks into the scripts. */
+enum CallrbCallbacks_ {
+  CALLRB_ON_START           = 0,
+  CALLRB_ON_RELOAD          = 1,
+  CALLRB_ON_UPDATE          = 2,
+  CALLRB_ON_POLL            = 3,
+  CALLRB_ON_SPRITE          = 4,
+  CALLRB_ON_SPRITES         = 5,
+  CALLRB_ON_SPRITE_LOADED   = 6,
+  CALLRB_ON_RESOURCE_LOADED = 7,
+  CALLRB_ON_TWEEN           = 8,
+  CALLRB_ON_EVENTS          = 9,
+  CALLRB_ON_TASK            = 10,
+  CALLRB_CALLBACKS          = 11
+};
 
 enum CollisionKinds_ {
   COLLIDE_BEGIN     = 1,
@@ -9,14 +27,38 @@ enum CollisionKinds_ {
   COLLIDE_END       = 3
 };
 
+int callrb_resolve(void);
+
+const char * callrb_name(int index);
+
+bool callrb_defined(int index);
+
+bool callrb_stats(int index, RhCallbackStats * stats);
+
+void callrb_stats_reset(void);
+
 int callrb_sprite_event(SpriteState * spritestate, int kind, void * data);
 
+int callrb_sprite_events(SpriteAnimEvent * events, int count);
+
+int callrb_sprite_loaded(int job, int spriteid, int layer, int ok);
+
+int callrb_resource_loaded(int job, int index, int kind, int ok);
+
 int callrb_on_start();
 
 int callrb_on_reload();
 
 int callrb_on_update(State * self);
 
+int callrb_on_poll(int argc, mrb_value * argv);
+
+int callrb_on_events(mrb_value events);
+
+int callrb_tween_event(int node, int prop, int kind);
+
+int callrb_task_resume(int id, void * data);
+
 
 #endif
 
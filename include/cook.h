@@ -0,0 +1,52 @@
+#ifndef cook_H_INCLUDED
+#define cook_H_INCLUDED
+
+#include "eruta.h"
+
+/* Cooked textures are images that were already decoded into raw pixels, so
+ * loading them is little more than copying the pixels into a bitmap, in
+ * stead of running the PNG or JPEG decoder every time. The cooked file of
+ * an image is stored next to it, with COOK_EXTENSION appended to the name,
+ * and it's only used as long as it's newer than the image.
+ *
+ * The format, all numbers are 32 bits little endian:
+ *
+ * header: "ERTX", version, width, height, pixel format, method, levels,
+ *         size of the pixel data in the file
+ * pixels: rows of width * 4 bytes, top to bottom, each pixel R, G, B, A,
+ *         with the alpha premultiplied, as Allegro loads images by default.
+ *
+ * The method is COOK_STORE or COOK_DEFLATE, which is raw deflate without
+ * zlib header. levels is the amount of mipmap levels in the file, which is
+ * always 1 for now, Allegro makes the mipmaps itself if asked to. */
+
+#define COOK_MAGIC        "ERTX"
+#define COOK_VERSION      1
+#define COOK_HEADER_SIZE  32
+#define COOK_EXTENSION    ".ctex"
+
+enum CookFormat_ {
+  COOK_RGBA_PREMULTIPLIED = 0
+};
+
+enum CookMethod_ {
+  COOK_STORE    = 0,
+  COOK_DEFLATE  = 1
+};
+
+ALLEGRO_BITMAP * cook_load_bitmap_f(ALLEGRO_FILE * file);
+ALLEGRO_BITMAP * cook_load_bitmap(const char * filename);
+bool cook_save_bitmap_f(ALLEGRO_FILE * file, ALLEGRO_BITMAP * bitmap,
+                        int method);
+bool cook_save_bitmap(const char * filename, ALLEGRO_BITMAP * bitmap,
+                      int method);
+
+bool cook_flags_ok(int flags);
+bool cook_source_ok(const char * filename);
+char * cook_vpath(char * buffer, size_t size, const char * vpath);
+bool cook_fresh(const char * source, const char * cooked);
+bool cook_file(const char * source, int method);
+int cook_tree(const char * dirname, int method, bool force);
+
+
+#endif
@@ -1,6 +1,14 @@
 #ifndef fifi_H_INCLUDED
 #define fifi_H_INCLUDED
 
+#include "pack.h"
+
+/* Name of the pack file in the data directory. */
+#define FIFI_PACK_NAME "data.pack"
+
+/* Maximum length of a vpath. */
+#define FIFI_VPATH_MAX 1024
+
 /** FifiSimpleLoader is a generic loading function. Handy to redirect 
 loading of files over fifi. */
 typedef void * (FifiSimpleLoader)(const char * filename);
@@ -33,9 +41,16 @@ ALLEGRO_PATH *fifi_data_vpath(const char *vpath);
 const char *fifi_data_path_cstr(void);
 ALLEGRO_PATH *fifi_data_path(void);
 ALLEGRO_PATH *fifi_init(void);
+Pack *fifi_pack(void);
+void fifi_pack_close(void);
+const char *fifi_vpath_extension(const char *vpath);
+ALLEGRO_FILE *fifi_pack_fopen(const char *vpath);
+ALLEGRO_PATH *fifi_cooked_path(const char *vpath);
 ALLEGRO_PATH *fifi_make_data_path(void);
 extern ALLEGRO_PATH *fifi_data_path_;
 int fifi_path_exists(Path *path);
+bool fifi_file_mtime(const char *filename, time_t *mtime);
+bool fifi_file_stat(const char *filename, time_t *mtime, off_t *size);
 const char *fifi_path_cstr(Path *path);
 
 
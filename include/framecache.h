@@ -0,0 +1,66 @@
+#ifndef framecache_H_INCLUDED
+#define framecache_H_INCLUDED
+
+#include "eruta.h"
+#include "image.h"
+
+/* The frame cache keeps bitmaps with the visible, tinted layers of a frame of 
+ * a sprite composited together, so a sprite that doesn't change the set of 
+ * layers it shows can be drawn with a single blit. It's shared by all sprite 
+ * states, so states with identical layer settings share the bitmaps too. */
+
+/* Amount of layers that can be described in a key. Must be at most 64. */
+#define FRAMECACHE_LAYERS           64
+
+/* Maximum amount of bitmaps in the cache. */
+#define FRAMECACHE_ENTRIES          512
+
+/* Default upper bound of the memory used by the cached bitmaps in bytes.*/
+#define FRAMECACHE_BUDGET_DEFAULT   (16 * 1024 * 1024)
+
+typedef struct FrameCacheKey_   FrameCacheKey;
+typedef struct FrameCacheStats_ FrameCacheStats;
+
+/* Describes what a cached bitmap is composited from. Keys are compared 
+ * byte by byte, so they must be cleared with memset before use. */
+struct FrameCacheKey_ {
+  void     * sprite;
+  int        action;
+  int        frame;
+  /* Bit i is set if layer i is hidden, resp. tinted. */
+  uint64_t   hidden;
+  uint64_t   tinted;
+  /* Tints of the tinted layers, packed as 0xRRGGBBAA. 0 if not tinted. */
+  uint32_t   tints[FRAMECACHE_LAYERS];
+};
+
+/* Statistics about the use of the frame cache. */
+struct FrameCacheStats_ {
+  long hits;
+  long misses;
+  long evictions;
+  /* Memory currently used by the cached bitmaps in bytes. */
+  long bytes;
+  /* Upper bound of bytes. */
+  long budget;
+  /* Amount of cached bitmaps. */
+  int  entries;
+};
+
+uint32_t framecache_config_hash(FrameCacheKey * key);
+uint32_t framecache_hash(FrameCacheKey * key, uint32_t config_hash);
+
+Image * framecache_get(FrameCacheKey * key, uint32_t hash, Point * origin);
+Image * framecache_put(FrameCacheKey * key, uint32_t hash, 
+                       Image * image, Point origin);
+int framecache_drop_sprite(void * sprite);
+void framecache_clear(void);
+void framecache_done(void);
+
+bool framecache_fits(int w, int h);
+long framecache_budget(void);
+long framecache_budget_(long budget);
+bool framecache_stats(FrameCacheStats * stats);
+
+
+#endif
@@ -22,6 +22,19 @@ void * mem_resize(void ** ptr, size_t newsize);
 /* Wrapper for memmove, for consistency */
 void * mem_move(void * dest, void * src, size_t size);
 
+/* Reads and writes 32 bits little endian numbers, as used in the file
+formats of the pack, the cooked textures and the script cache. */
+uint32_t mem_get32(const unsigned char * at);
+void mem_put32(unsigned char * at, uint32_t value);
+
+/* Starting values for the FNV-1a hashes below. */
+#define MEM_FNV32_BASIS 2166136261u
+#define MEM_FNV64_BASIS 14695981039346656037ULL
+
+/* FNV-1a hashes of size bytes at data, continuing from hash. */
+uint32_t mem_fnv32(uint32_t hash, const void * data, size_t size);
+uint64_t mem_fnv64(uint64_t hash, const void * data, size_t size);
+
 /* A function pointer that can act as a destructor. 
 Should return NULL on sucessful freeing, and non-null 
 if freeing failed. */
@@ -0,0 +1,64 @@
+#ifndef pack_H_INCLUDED
+#define pack_H_INCLUDED
+
+#include "eruta.h"
+
+/* A Pack is a single file that holds many data files, so they can be loaded
+ * without opening and stat-ing each file on its own. The pack is mapped into
+ * memory when possible, or read in whole otherwise. Stored entries are used
+ * in place, deflated entries are inflated when first used, and freed again
+ * when every pack_data call for them is matched by pack_forget.
+ *
+ * The format, all numbers are 32 bits little endian:
+ *
+ * header:    "ERPK", version, entry count, directory offset, names offset,
+ *            names size, alignment, reserved
+ * directory: per entry, sorted by name: name offset, name length, method,
+ *            flags, data offset, packed size, size, reserved
+ * names:     the vpaths of the entries, each followed by a 0 byte
+ * data:      the entries, each starting at a multiple of the alignment
+ *
+ * The method is PACK_STORE or PACK_DEFLATE. Deflated entries are raw deflate
+ * streams without zlib header. */
+
+#define PACK_MAGIC        "ERPK"
+#define PACK_VERSION      1
+/* Alignment of the data of the entries in the pack. */
+#define PACK_ALIGN        16
+#define PACK_HEADER_SIZE  32
+#define PACK_ENTRY_SIZE   32
+
+enum PackMethod_ {
+  PACK_STORE    = 0,
+  PACK_DEFLATE  = 1
+};
+
+typedef struct Pack_        Pack;
+typedef struct PackSource_  PackSource;
+
+/* Describes an entry to write to a pack with pack_write. For PACK_DEFLATE
+ * entries, data must already be deflated, and size is the size after
+ * inflating. */
+struct PackSource_ {
+  const char * name;
+  const void * data;
+  size_t       packed_size;
+  size_t       size;
+  int          method;
+};
+
+Pack * pack_open(const char * filename);
+Pack * pack_close(Pack * self);
+
+int pack_count(Pack * self);
+const char * pack_name(Pack * self, int index);
+int pack_find(Pack * self, const char * vpath);
+bool pack_has(Pack * self, const char * vpath);
+const void * pack_data(Pack * self, const char * vpath, size_t * size);
+bool pack_forget(Pack * self, const char * vpath);
+ALLEGRO_FILE * pack_fopen(Pack * self, const char * vpath);
+
+bool pack_write(const char * filename, int count, PackSource * sources);
+
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef pickgrid_H_INCLUDED
+#define pickgrid_H_INCLUDED
+
+#include "mem.h"
+
+/* A PickGrid is a uniform grid of cells that keeps track of which
+ * rectangles, identified by an integer id, overlap which cells. It's used
+ * to quickly find the candidates for a hit test at a point, without having
+ * to check every rectangle. Rectangles outside of the grid are clamped to
+ * the cells at the edges of the grid. */
+
+typedef struct PickGrid_ PickGrid;
+
+PickGrid * pickgrid_alloc(void);
+PickGrid * pickgrid_init(PickGrid * self, float w, float h,
+                         float cell_w, float cell_h, int ids_max);
+PickGrid * pickgrid_new(float w, float h, float cell_w, float cell_h,
+                        int ids_max);
+PickGrid * pickgrid_done(PickGrid * self);
+PickGrid * pickgrid_free(PickGrid * self);
+
+int pickgrid_put(PickGrid * self, int id, float x, float y, float w, float h);
+int pickgrid_remove(PickGrid * self, int id);
+int pickgrid_clear(PickGrid * self);
+int pickgrid_query(PickGrid * self, float x, float y, int * ids, int max);
+
+
+#endif
@@ -2,6 +2,7 @@
 #define RESOR_H_INCLUDED 
 
 #include "rebox.h"
+#include "textcache.h"
 
 enum ResorKind_ {
   RESOR_NONE          = 0,
@@ -80,6 +81,32 @@ Resor *resor_init(Resor *self,ResorKind kind,ResorData data,ResorDestructor *fre
 int resor_kind(Resor *self);
 int resor_free(Resor *self);
 int resor_done(Resor *self);
+Resor * resor_acquire(Resor * self);
+int resor_release(Resor * self);
+int resor_refs(Resor * self);
+const char * resor_key(Resor * self);
+const char * resor_key_(Resor * self, const char * key);
+long resor_bytes(Resor * self);
+long resor_used(Resor * self);
+long resor_used_(Resor * self, long stamp);
+int resor_pins(Resor * self);
+int resor_pins_(Resor * self, int delta);
+bool resor_evict(Resor * self);
+bool resor_evicted(Resor * self);
+bool resor_restore(Resor * self, Resor * loaded);
+Resor * resor_newer(Resor * self);
+Resor * resor_older(Resor * self);
+Resor * resor_newer_(Resor * self, Resor * newer);
+Resor * resor_older_(Resor * self, Resor * older);
+Resor * resor_source_bitmap_(Resor * self, const char * vpath, int flags, 
+                             int bitmap_flags);
+Resor * resor_source_sample_(Resor * self, const char * vpath);
+Resor * resor_source_ttf_font_(Resor * self, const char * vpath, int w, int h,
+                               int flags);
+Resor * resor_forget_source(Resor * self);
+bool resor_reloadable(Resor * self);
+bool resor_reload(Resor * self);
+const char * resor_vpath(Resor * self);
 
 bool resor_get_bitmap_format(Resor *self,int *value);
 bool resor_get_bitmap_flags(Resor *self,int *value);
@@ -92,6 +119,8 @@ bool resor_get_text_width(Resor *self,char *text,int *value);
 bool resor_get_font_line_height(Resor *self,int *value);
 bool resor_get_font_descent(Resor *self,int *value);
 bool resor_get_font_ascent(Resor *self,int *value);
+bool resor_prewarm_font(Resor *self);
+bool resor_get_text_cache_stats(Resor *self, TextCacheStats *stats);
 
 ResorSaver * resor_set_saver(Resor * resor, ResorSaver * saver);
 ResorSaver * resor_saver(Resor * resor);
@@ -12,6 +12,84 @@ typedef mrb_state Ruby;
 
 typedef struct Script_ Script;
 
+/* Amount of arguments that fit in the argument array of a callback. */
+#define RH_CALLBACK_ARGS_MAX 16
+
+/* Amount of events that can be queued per frame before they're sent. */
+#define RH_EVENTS_MAX 256
+
+/* Part of the GC threshold the live objects must reach before GC work is
+ * started in idle time, in stead of waiting for mruby to start it. */
+#define RH_GC_IDLE_START    0.75
+/* Default frame time that idle time is calculated from, and the most time
+ * per frame that is spent on GC in idle time, in seconds. */
+#define RH_GC_FRAME_TIME    (1.0 / 60.0)
+#define RH_GC_IDLE_MAX      0.004
+
+/* Allocators the ruby can be created with by rh_new. */
+enum RhAllocators_ {
+  RH_ALLOC_SYSTEM = 0,
+  RH_ALLOC_POOL   = 1
+};
+
+typedef struct RhCallback_      RhCallback;
+typedef struct RhCallbackStats_ RhCallbackStats;
+typedef struct RhEventStats_    RhEventStats;
+typedef struct RhGcStats_       RhGcStats;
+
+/* Memory and garbage collection statistics of a ruby. The times are in
+ * seconds and only cover the GC work that is done explicitly by rh_gc_idle
+ * and rh_gc_full, not the GC work that mruby does while allocating. */
+struct RhGcStats_ {
+  size_t heap;
+  size_t heap_max;
+  size_t live;
+  size_t threshold;
+  double frame_time;
+  double time;
+  double time_max;
+  long   steps;
+  long   full;
+  int    arena_max;
+};
+
+/* Statistics of the batched sending of events to the scripts. */
+struct RhEventStats_ {
+  long queued;
+  long coalesced;
+  long sent;
+  long batches;
+};
+
+/* Decides where a queued event goes when the events are sent, by 
+ * rh_flush_events. Must handle the event and return true if it doesn't go to
+ * the scripts. */
+typedef int RhEventRoute(ALLEGRO_EVENT * event, void * data);
+
+/* Call counts and time spent in a callback, in seconds. */
+struct RhCallbackStats_ {
+  long   calls;
+  double time;
+  double time_max;
+};
+
+/* A toplevel ruby function that is called often from C. The symbol is
+ * interned once, by rh_callback_resolve, in stead of on every call. A 
+ * function that didn't exist yet is looked for again on each call, so one
+ * that a script defines later, after it was resolved, is still called. args
+ * can be used to pass arguments without having to allocate an array for 
+ * every call. What a callback allocates is assumed to be garbage by the next
+ * frame, unless lasting is set. */
+struct RhCallback_ {
+  const char      * name;
+  mrb_sym           sym;
+  int               resolved;
+  int               defined;
+  int               lasting;
+  mrb_value         args[RH_CALLBACK_ARGS_MAX];
+  RhCallbackStats   stats;
+};
+
 
 #include "widget.h"
 
@@ -25,6 +103,10 @@ extern struct mrb_data_type toruby_Path;
 
 mrb_value tr_Path (Ruby * ruby, mrb_value self,  struct RClass * klass); 
 
+int rh_allocator(void);
+
+int rh_allocator_(int allocator);
+
 Ruby * rh_new(void);
 
 Ruby * rh_free(Ruby * self );
@@ -33,6 +115,8 @@ mrb_value rh_inspect(mrb_state *mrb , mrb_value obj );
 
 char * rh_inspect_cstr(mrb_state *mrb , mrb_value value);
 
+int rh_make_report(Ruby * self, mrb_value v);
+
 int rh_run_file (Ruby * self , const char * filename, FILE * file );
 
 int rh_run_filename (Ruby * self , const char * filename );
@@ -59,7 +143,11 @@ mrb_value rh_run_toplevel_va(Ruby * ruby, char * name, char * format, va_list ar
 mrb_value rh_run_function(Ruby * ruby, mrb_value rubyself, char * name, char * format, ...);
 
 mrb_value rh_run_toplevel(Ruby * ruby, char * name, char * format, ...);
-int rh_tobool(mrb_value v);                              
+int rh_tobool(mrb_value v);
+
+int rh_callback_resolve(Ruby * ruby, RhCallback * callback);
+mrb_value rh_callback_call(Ruby * ruby, RhCallback * callback, 
+                           int argc, mrb_value * argv);                              
                               
 #define rh_bool_value(B) ( (B) ? mrb_true_value() : mrb_false_value())
 
@@ -67,7 +155,29 @@ int rh_poll_event(mrb_state * mrb, ALLEGRO_EVENT * event);
 
 int rh_poll_events(mrb_state * mrb, ALLEGRO_EVENT_QUEUE * queue);
 
+int rh_queue_event(mrb_state * mrb, ALLEGRO_EVENT * event);
+
+int rh_flush_events(mrb_state * mrb);
+
+void rh_events_route_(RhEventRoute * route, void * data);
+
+int rh_events_coalesce(void);
+
+int rh_events_coalesce_(int coalesce);
+
+bool rh_event_stats(RhEventStats * stats);
+
+void rh_gc_configure(Ruby * ruby, int interval_ratio, int step_ratio);
+void rh_gc_idle_budget_(double frame_time, double idle_max);
+double rh_gc_idle(Ruby * ruby, double used);
+double rh_gc_flip(Ruby * ruby, double frame_start, void (*flip)(void));
+double rh_gc_full(Ruby * ruby);
+void rh_gc_full_later(void);
+bool rh_gc_stats(Ruby * ruby, RhGcStats * stats);
+void rh_gc_stats_reset(void);
+
 int rh_load_main();
+int rh_reload_main();
 int rh_on_start();
 int rh_on_reload(); 
 
@@ -0,0 +1,61 @@
+#ifndef rhalloc_H_INCLUDED
+#define rhalloc_H_INCLUDED
+
+#include "eruta.h"
+
+/* Rhalloc is the allocator of the mruby VM. Small blocks come from free
+ * lists per size class, which are refilled from large chunks and never
+ * given back to the system until rhalloc_done. While a frame is marked with
+ * rhalloc_frame_begin and rhalloc_frame_end, small blocks that the free
+ * lists can't supply are bumped from a frame region in stead. A region is
+ * reused as soon as all blocks in it are freed, which is fast for the many
+ * short lived strings and arrays the scripts make every frame. A region
+ * that fills up while some of its blocks are still live becomes part of the
+ * pool, and those blocks go to the free lists when they're freed. Only
+ * mark frames in which most allocations are garbage by the next frame.
+ * Large blocks go to malloc. Every block has a small header with its size
+ * and origin.
+ *
+ * Rhalloc is not thread safe, just like mruby itself. */
+
+/* Size classes of small blocks, and the largest small block. */
+#define RHALLOC_CLASSES         8
+#define RHALLOC_SMALL_MAX       256
+/* Size of the chunks the size classes are refilled from. */
+#define RHALLOC_CHUNK_SIZE      (64 * 1024)
+/* Size of a frame region. */
+#define RHALLOC_REGION_SIZE     (256 * 1024)
+
+/* Indexes for rhalloc_stats after the size classes. */
+#define RHALLOC_CLASS_FRAME     RHALLOC_CLASSES
+#define RHALLOC_CLASS_SYSTEM    (RHALLOC_CLASSES + 1)
+#define RHALLOC_STATS           (RHALLOC_CLASSES + 2)
+
+typedef struct RhallocStats_ RhallocStats;
+
+/* Allocation counts of a size class, of the frame regions or of malloc. */
+struct RhallocStats_ {
+  long   allocs;
+  long   frees;
+  long   live;
+  size_t bytes;
+};
+
+struct mrb_state;
+
+void * rhalloc_allocf(struct mrb_state * mrb, void * ptr, size_t size,
+                      void * ud);
+
+void rhalloc_frame_begin(void);
+void rhalloc_frame_end(void);
+
+int rhalloc_class_size(int index);
+bool rhalloc_stats(int index, RhallocStats * stats);
+void rhalloc_stats_reset(void);
+size_t rhalloc_heap(void);
+size_t rhalloc_heap_max(void);
+
+void rhalloc_done(void);
+
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef rhprof_H_INCLUDED
+#define rhprof_H_INCLUDED
+
+#include "eruta.h"
+#include "rh.h"
+
+/* Rhprof is a sampling profiler for the scripts. While it runs, the code
+ * fetch hook of mruby checks the time every RHPROF_FETCHES instructions, and
+ * takes a sample of the call stack of the scripts once per interval that
+ * passed. Only the time spent in the script callbacks is sampled, so the
+ * time between frames isn't blamed on the scripts. Time spent in methods
+ * written in C is blamed on the script method that called them.
+ *
+ * The samples are added up per method, by name and by the file and line
+ * where the method starts, and per call stack, which can be written in the
+ * folded format that flamegraph.pl and speedscope read.
+ *
+ * The code fetch hook is only there when mruby was built with
+ * MRB_ENABLE_DEBUG_HOOK, and eruta must be built with the same, using the
+ * ERUTA_PROFILER cmake option. Otherwise rhprof_start fails. When the
+ * profiler isn't running, the hook isn't set, so it costs nothing. */
+
+/* Default time between samples in seconds. */
+#define RHPROF_INTERVAL     0.001
+/* Amount of instructions between checks of the time. */
+#define RHPROF_FETCHES      64
+/* Deepest call stack sampled, deeper frames near the root are left out. */
+#define RHPROF_DEPTH_MAX    64
+/* Longest label of a stack frame. */
+#define RHPROF_LABEL_MAX    128
+
+typedef struct RhprofEntry_ RhprofEntry;
+
+/* Samples of a method. Self counts the samples where the method was
+ * running, total also those where it was waiting for a method it called. */
+struct RhprofEntry_ {
+  const char * label;
+  long         self;
+  long         total;
+};
+
+bool rhprof_available(void);
+bool rhprof_start(Ruby * ruby, double interval);
+bool rhprof_stop(Ruby * ruby);
+bool rhprof_active(void);
+double rhprof_interval(void);
+double rhprof_interval_(double interval);
+
+void rhprof_enter(void);
+void rhprof_leave(void);
+
+int rhprof_record(const char ** labels, int depth, long weight);
+long rhprof_samples(void);
+int rhprof_top(RhprofEntry * entries, int max);
+int rhprof_write_folded(FILE * out);
+int rhprof_dump(const char * filename);
+void rhprof_reset(void);
+
+
+#endif
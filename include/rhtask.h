@@ -0,0 +1,62 @@
+#ifndef rhtask_H_INCLUDED
+#define rhtask_H_INCLUDED
+
+#include "eruta.h"
+
+/* Rhtask schedules cooperative tasks of the scripts, such as sorting an
+ * inventory or planning the moves of foes, which would take too long to do in
+ * one frame. A task is a Fiber on the scripting side, which yields after doing
+ * a part of the work. Here a task is only an id and a name with statistics.
+ *
+ * Every frame, rhtask_run resumes the tasks in turn, each at most once, until
+ * the time budget of the frame is used up. The tasks that didn't get a turn
+ * go first in the next frame. At least one task is resumed every frame, so
+ * the tasks always get on. A task that takes longer than the time that is left
+ * can't be interrupted, but is counted as an overrun in it's statistics. */
+
+/* Default time budget of the tasks per frame, in seconds. */
+#define RHTASK_BUDGET    0.004
+/* Longest name of a task. */
+#define RHTASK_NAME_MAX  64
+
+typedef struct RhTaskStats_      RhTaskStats;
+typedef struct RhTaskFrameStats_ RhTaskFrameStats;
+
+/* Statistics of a task. The times are in seconds. */
+struct RhTaskStats_ {
+  int    id;
+  char   name[RHTASK_NAME_MAX];
+  long   resumes;
+  long   overruns;
+  double time;
+  double time_max;
+  double frame_time;
+};
+
+/* Statistics of the last frame of all tasks. */
+struct RhTaskFrameStats_ {
+  int    tasks;
+  int    resumed;
+  int    finished;
+  int    waiting;
+  double time;
+  double budget;
+};
+
+/* Resumes the task with the given id. Must return true if the task has more
+ * work to do, or false if it is done. */
+typedef int RhTaskResume(int id, void * data);
+
+int    rhtask_add(const char * name);
+int    rhtask_remove(int id);
+int    rhtask_count(void);
+double rhtask_budget(void);
+double rhtask_budget_(double budget);
+double rhtask_time_left(void);
+int    rhtask_run(RhTaskResume * resume, void * data);
+bool   rhtask_stats(int nth, RhTaskStats * stats);
+bool   rhtask_frame_stats(RhTaskFrameStats * stats);
+void   rhtask_done(void);
+
+
+#endif
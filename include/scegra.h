@@ -18,6 +18,47 @@ typedef void ScegraDone  (ScegraNode * node);
 
 #define SCEGRA_VERTEX_MAX 32
 
+/* Maximum amount of float values a node property can have (colors have 4). */
+#define SCEGRA_PROP_VALUES_MAX 4
+
+/* Node properties that can be read or written generically, by number. 
+ * Used by the tween engine and for bulk updates from scripts. Colors 
+ * are 4 floats in the range 0 to 255. */
+enum ScegraProperty_ {
+  SCEGRA_PROP_NONE              = 0,
+  SCEGRA_PROP_POSITION          = 1,
+  SCEGRA_PROP_SIZE              = 2,
+  SCEGRA_PROP_SPEED             = 3,
+  SCEGRA_PROP_COLOR             = 4,
+  SCEGRA_PROP_BACKGROUND_COLOR  = 5,
+  SCEGRA_PROP_BORDER_COLOR      = 6,
+  SCEGRA_PROP_BORDER_THICKNESS  = 7,
+  SCEGRA_PROP_MARGIN            = 8,
+  SCEGRA_PROP_ANGLE             = 9,
+  /* The following properties are integers, passed as a float. */
+  SCEGRA_PROP_Z                 = 10,
+  SCEGRA_PROP_VISIBLE           = 11,
+  SCEGRA_PROP_FONT_ID           = 12,
+  SCEGRA_PROP_IMAGE_ID          = 13,
+  SCEGRA_PROP_BACKGROUND_IMAGE_ID = 14,
+  SCEGRA_PROP_TEXT_FLAGS        = 15,
+  SCEGRA_PROP_IMAGE_FLAGS       = 16,
+  SCEGRA_PROP_MAX               = 17
+};
+
+/* A change of a single property of a single node, for bulk updates. 
+ * The packed form used by scegra_apply_packed is the same: a 32 bits id, 
+ * a 32 bits property and 4 32 bits floats, all in native byte order. */
+struct ScegraChange_ {
+  int32_t               id;
+  int32_t               prop;
+  float                 values[SCEGRA_PROP_VALUES_MAX];
+};
+
+typedef struct ScegraChange_ ScegraChange;
+
+#define SCEGRA_CHANGE_PACKED_SIZE 24
+
 
 /* A very simple scene graph, mainly for drawing the UI that will be managed from 
  * the scripting side of things. Only one "global" scene graph is supported.
@@ -142,6 +183,17 @@ int scegra_at_end(int index);
 
 int scegra_show_system_mouse_cursor(int show);
 
+int scegra_property_size(int prop);
+int scegra_property(int index, int prop, float * values);
+int scegra_property_(int index, int prop, const float * values);
+
+int scegra_apply_changes(const ScegraChange * changes, int amount);
+int scegra_apply_packed(const char * buffer, int size);
+int scegra_copy_node(int index, int template_index);
+int scegra_pick(float x, float y);
+int scegra_make_from_template(int template_index, int minimum, int amount, 
+                              float dx, float dy, int * ids);
+
 
 
 #endif
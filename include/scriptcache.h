@@ -0,0 +1,72 @@
+#ifndef scriptcache_H_INCLUDED
+#define scriptcache_H_INCLUDED
+
+#include "eruta.h"
+#include "rh.h"
+
+/* The script cache keeps the scripts compiled to mruby bytecode, so they
+ * don't have to be parsed and compiled again every time they are loaded.
+ * The bytecode of data/<vpath> is stored in data/cache/<vpath>.mrbc, and it
+ * is only used when its key matches the key of the current source, which is
+ * a hash of the source and of the version of mruby.
+ *
+ * The format, all numbers are 32 bits little endian:
+ *
+ * header: "ERBC", version, key low 32 bits, key high 32 bits, size of the
+ *         bytecode, reserved
+ * code:   the irep as dumped by mruby, with debug info, so backtraces still
+ *         have file names and line numbers.
+ *
+ * The loaded scripts are also remembered, with the script that loaded them,
+ * so scriptcache_reload can run only the ones that changed again. */
+
+#define SCRIPTCACHE_MAGIC        "ERBC"
+#define SCRIPTCACHE_VERSION      1
+#define SCRIPTCACHE_HEADER_SIZE  24
+#define SCRIPTCACHE_DIR          "cache"
+#define SCRIPTCACHE_EXTENSION    ".mrbc"
+/* Amount of scripts that are remembered for reloading. */
+#define SCRIPTCACHE_LOADED_MAX   256
+/* Seconds between checks for changed scripts where inotify isn't there. */
+#define SCRIPTCACHE_WATCH_INTERVAL 0.5
+/* Seconds without inotify events before the changed scripts are checked. */
+#define SCRIPTCACHE_WATCH_QUIET    0.1
+
+typedef struct ScriptCacheStats_ ScriptCacheStats;
+
+/* How often loading a script could use the cache, and how long it took. */
+struct ScriptCacheStats_ {
+  long   hits;
+  long   misses;
+  long   failed;
+  double time;
+};
+
+uint64_t scriptcache_key(const char * source, size_t size);
+ALLEGRO_PATH * scriptcache_path(const char * vpath);
+
+unsigned char * scriptcache_read(const char * filename, uint64_t key,
+                                 size_t * size);
+bool scriptcache_write(const char * filename, uint64_t key,
+                       const unsigned char * code, size_t size);
+
+int scriptcache_run(Ruby * mrb, const char * vpath);
+int scriptcache_compile(Ruby * mrb, const char * vpath, bool force);
+int scriptcache_tree(Ruby * mrb, const char * vpath, bool force);
+
+int scriptcache_changed(void);
+int scriptcache_reload(Ruby * mrb);
+void scriptcache_forget(void);
+void scriptcache_done(void);
+const char * scriptcache_loaded_vpath(int index, const char ** parent);
+
+bool scriptcache_watch_(bool watch);
+bool scriptcache_watch(void);
+bool scriptcache_poll(void);
+
+bool scriptcache_enabled(void);
+bool scriptcache_enabled_(bool enabled);
+bool scriptcache_stats(ScriptCacheStats * stats);
+
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "eruta.h"
 #include "image.h"
+#include "atlas.h"
 
 typedef struct SpriteCell_      SpriteCell;
 typedef struct SpriteFrame_     SpriteFrame;
@@ -93,6 +94,9 @@ enum SpriteLoadType_ {
 /* Amount of potential actions that a sprite has by default at creation. */
 #define SPRITE_NACTIONS_DEFAULT 32
 
+/* Size of the blocks of the arena of a sprite. */
+#define SPRITE_ARENA_BLOCK 16384
+
 /* Amount of potential frame that a spriteaction has by default at creation. */
 #define SPRITEACTION_NFRAMES_DEFAULT 32
 
@@ -123,6 +127,8 @@ Sprite * sprite_now_(Sprite * self, int actionnow, int framenow);
 void sprite_update(Sprite * self, double dt);
 
 SpriteAction * sprite_action_for(Sprite * me, int pose, int direction);
+SpriteAction * 
+sprite_set_new_action(Sprite * self, int actionindex, int type, int direction);
 int sprite_action_index_for(Sprite * me, int pose, int direction);
 
 
@@ -137,6 +143,11 @@ SpriteCell * sprite_load_cell_from
   (Sprite * self, int pose, int direction, int layeri, 
     Image * source, Point size, Point where, Point offset, double duration);
 
+SpriteCell * sprite_load_trimmed_cell_from
+  (Sprite * self, int pose, int direction, int layeri, Image * source, 
+   Point size, Point where, Point trim, Point trimsize, Point offset, 
+   double duration);
+
 SpriteFrame * sprite_newframe
   (Sprite * self, int actionindex, int frameindex, double duration);
 
@@ -148,6 +159,15 @@ Sprite * sprite_loadlayer_ulpcss_vpath
 
 int sprite_framesused(Sprite * self, int actionindex);
 
+Image * spritecell_image(SpriteCell * self);
+
+int sprite_flat_frames(Sprite * self, int action);
+SpriteFrame * 
+sprite_flat_frame(Sprite * self, int action, int frame, double * duration);
+
+void sprite_atlas_done();
+bool sprite_atlas_stats(AtlasStats * stats);
+
 double spriteframe_duration(SpriteFrame * me);
 
 int spriteaction_is_pose(SpriteAction * self, int pose, int direction);
@@ -159,6 +179,10 @@ void spritecell_draw(SpriteCell * self, Point * at);
  
 
 int sprite_id(Sprite * sprite);
+int sprite_loading(Sprite * sprite);
+int sprite_loading_(Sprite * sprite, int delta);
+int sprite_loading_box(Sprite * sprite, Point * offset, Point * size);
+void sprite_loading_box_(Sprite * sprite, Point offset, Point size);
 
 Point spritecell_real_position(SpriteCell * self, Point * at);
 
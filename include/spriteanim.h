@@ -0,0 +1,32 @@
+#ifndef spriteanim_H_INCLUDED
+#define spriteanim_H_INCLUDED
+
+#include "sprite.h"
+#include "spritestate.h"
+
+/* The sprite animation system advances the animations of all active sprite 
+ * states in one pass over packed arrays of their timing data. Only the sprite
+ * states of which the current frame is over are looked at in more detail. 
+ * The sprite events this causes are sent to the scripting side in a single 
+ * batch after the pass. */
+
+typedef struct SpriteAnimEvent_ SpriteAnimEvent;
+
+/* A sprite event that waits to be sent to the scripting side. */
+struct SpriteAnimEvent_ {
+  int sprite;
+  int pose;
+  int direction;
+  int kind;
+};
+
+int spriteanim_add(SpriteState * state);
+int spriteanim_remove(SpriteState * state);
+void spriteanim_sync(SpriteState * state);
+int spriteanim_update(double dt);
+int spriteanim_notify(SpriteState * state, int kind);
+int spriteanim_count(void);
+void spriteanim_done(void);
+
+
+#endif
@@ -35,6 +35,12 @@ struct SpriteLayout_ NAME = { ROWS  , PER_ROW, ROW_POSE, ROW_DIR,              \
 
 int spritelayout_rows(SpriteLayout * layout);
 
+int spritelayout_cells(SpriteLayout * layout);
+
+int spritelayout_cell(SpriteLayout * layout, int rowi, int coli, 
+  int * pose, int * direction, Point * where, Point * size, Point * offset, 
+  double * duration);
+
 Sprite * spritelayout_loadactionlayer(SpriteLayout * layout, Sprite * sprite, 
   Image * source, int actionindex, int layerindex);
  
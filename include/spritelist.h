@@ -2,10 +2,12 @@
 #define spritelist_H_INCLUDED
 
 
+#include "every.h"
+
 /* Sprite list functions. */
 
 typedef struct SpriteList_      SpriteList;
-/* Amount of potential sprites that a SpriteList can contain at creation. */
+/* Maximum amount of sprites that a SpriteList can contain by default. */
 #define SPRITELIST_NSPRITES_DEFAULT 10000
 
 
@@ -36,6 +38,10 @@ int spritelist_tint_sprite_layer
 
 int spritelist_delete_sprite(SpriteList * self, int index);
 
+int spritelist_count(SpriteList * self);
+Sprite * spritelist_live(SpriteList * self, int nth);
+void * spritelist_walk(SpriteList * self, Walker * walker, void * extra);
+
 #endif
 
 
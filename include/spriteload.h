@@ -0,0 +1,38 @@
+#ifndef spriteload_H_INCLUDED
+#define spriteload_H_INCLUDED
+
+#include "sprite.h"
+
+/* Background loading of sprite layers. Decoding the sprite sheet into a
+ * memory bitmap and slicing and trimming it into cells is done by a pool of
+ * worker threads. Only copying the cells into the sprite atlas is done on the
+ * display thread, a few cells at a time, in spriteload_update. */
+
+/* Amount of worker threads. */
+#define SPRITELOAD_WORKERS 2
+
+/* Default time in seconds spent on copying cells per update. */
+#define SPRITELOAD_BUDGET_DEFAULT 0.004
+
+typedef struct SpriteLoadStats_ SpriteLoadStats;
+
+/* Statistics of the background loading of sprite layers. */
+struct SpriteLoadStats_ {
+  long started;
+  long loaded;
+  long failed;
+  long cells;
+  int  pending;
+};
+
+int spriteload_start(Sprite * sprite, int layer, char * vpath, int load_type);
+int spriteload_update(double budget);
+int spriteload_cancel_sprite(Sprite * sprite);
+int spriteload_pending(void);
+double spriteload_budget(void);
+double spriteload_budget_(double budget);
+bool spriteload_stats(SpriteLoadStats * stats);
+void spriteload_done(void);
+
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef spritestate_H_INCLUDED
 #define spritestate_H_INCLUDED
 
+#include "framecache.h"
+
 #define SPRITESTATE_LAYER_MAX  64
 #define SPRITESTATE_ACTION_MAX 32
 
@@ -56,6 +58,14 @@ struct SpriteState_ {
   /* It's not worth while to use dynamical memory for these, IMO. */
   SpriteStateLayer   layers[SPRITESTATE_LAYER_MAX];
   SpriteStateAction  actions[SPRITESTATE_ACTION_MAX];
+  /* If set, frames are drawn from composited bitmaps in the frame cache. */
+  int                cache_frames;
+  /* Set if the layer settings changed since cache_key was last built. */
+  int                cache_dirty;
+  uint32_t           cache_config_hash;
+  FrameCacheKey      cache_key;
+  /* Slot in the sprite animation system, or negative if not in it. */
+  int                anim_slot;
 };
 
 
@@ -76,6 +86,7 @@ void          spritestate_draw(SpriteState * self, Point * at);
 
 SpriteState * spritestate_now_(SpriteState * self, int actionnow, int framenow);
 void          spritestate_update(SpriteState * self, double dt);
+void          spritestate_advance(SpriteState * self);
 int           spriteaction_ispose(SpriteAction * self, int pose, int direction);
 int           spritestate_pose_(SpriteState * self, int pose);
 int           spritestate_pose(SpriteState * self);
@@ -95,6 +106,9 @@ int spritestate_remove_tint_layer(SpriteState * self, int layer);
 int spritestate_is_layer_tinted(SpriteState * self, int layer);
 Color * spritestate_get_layer_tint(SpriteState * self, int layer);
 
+int spritestate_cache_frames_(SpriteState * self, int enable);
+int spritestate_cache_frames(SpriteState * self);
+
 int spritestate_set_action_loop(SpriteState * self, int action, int loopmode);
 int spritestate_get_action_loop(SpriteState * self, int action);
 int spritestate_is_action_done(SpriteState * self, int action);
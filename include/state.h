@@ -54,6 +54,9 @@ int state_new_sprite_id(State * state);
 int state_sprite_load_builtin
 (State * state, int sprite_index, int layer_index, char * vpath, int layout);
 
+int state_sprite_load_builtin_async
+(State * state, int sprite_index, int layer_index, char * vpath, int layout);
+
 int state_sprite_tintlayer
 (State * state, int sprite_index, int layer_index, int, int g, int b, int a);
 
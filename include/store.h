@@ -4,6 +4,22 @@
 #include "resor.h"
 #include "xresor.h"
 
+/* Maximum length of the cache key of a resource. */
+#define STORE_KEY_MAX 1024
+
+typedef struct StoreCacheStats_ StoreCacheStats;
+
+/* Statistics of the sharing of loaded resources between store indexes, 
+ * and of the eviction of resources that are over budget. */
+struct StoreCacheStats_ {
+  long hits;
+  long misses;
+  long bytes_saved;
+  int  entries;
+  long evictions;
+  long reloads;
+};
+
 int store_kind(int index);
 Resor *store_load_bitmap(int index,const char *vpath);
 Resor *store_load_bitmap_flags(int index,const char *vpath,int flags);
@@ -39,6 +55,8 @@ bool store_get_text_width(int index,char *text,int *value);
 bool store_get_font_line_height(int index,int *value);
 bool store_get_font_descent(int index,int *value);
 bool store_get_font_ascent(int index,int *value);
+bool store_prewarm_font(int index);
+bool store_get_text_cache_stats(int index, TextCacheStats *stats);
 
 
 
@@ -54,6 +72,23 @@ void * store_get_other(int index, unsigned kind);
 
 int store_get_unused_id(int minimum);
 
+char * store_key_bitmap(char * buffer, const char * vpath, int flags);
+char * store_key_sample(char * buffer, const char * vpath);
+char * store_key_ttf_font(char * buffer, const char * vpath, int w, int h, 
+                          int flags);
+Resor * store_cached(const char * key);
+Resor * store_share(int index, const char * key);
+Resor * store_put_keyed(int index, const char * key, Resor * value);
+Resor * store_unshare(int index);
+long store_budget(int kind);
+long store_budget_(int kind, long bytes);
+long store_used(int kind);
+bool store_pin(int index);
+bool store_unpin(int index);
+bool store_pinned(int index);
+bool store_cache_stats(StoreCacheStats * stats);
+void store_frame(void);
+
 
 
 
@@ -0,0 +1,45 @@
+#ifndef storeload_H_INCLUDED
+#define storeload_H_INCLUDED
+
+#include "store.h"
+
+/* Background loading of resources into the store. Reading and decoding the
+ * files is done by a pool of worker threads. Only the work that needs the
+ * display, such as turning a decoded image into a video bitmap, is done on
+ * the display thread, a few resources at a time, in storeload_update. */
+
+/* Amount of worker threads. */
+#define STORELOAD_WORKERS 2
+
+/* Default time in seconds spent on finishing loaded resources per update. */
+#define STORELOAD_BUDGET_DEFAULT 0.004
+
+typedef struct StoreLoadStats_ StoreLoadStats;
+
+/* Statistics of the background loading of resources. */
+struct StoreLoadStats_ {
+  long started;
+  long loaded;
+  long failed;
+  long shared;
+  int  pending;
+};
+
+int storeload_bitmap(int index, const char * vpath);
+int storeload_bitmap_flags(int index, const char * vpath, int flags);
+int storeload_sample(int index, const char * vpath);
+int storeload_ttf_font(int index, const char * vpath, int h, int flags);
+int storeload_ttf_font_stretch(int index, const char * vpath, int w, int h,
+                               int flags);
+int storeload_update(double budget);
+int storeload_cancel(int index);
+bool storeload_index_pending(int index);
+int storeload_pending(void);
+double storeload_progress(void);
+double storeload_budget(void);
+double storeload_budget_(double budget);
+bool storeload_stats(StoreLoadStats * stats);
+void storeload_done(void);
+
+
+#endif
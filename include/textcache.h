@@ -0,0 +1,45 @@
+#ifndef textcache_H_INCLUDED
+#define textcache_H_INCLUDED
+
+#include "eruta.h"
+
+/* Default amount of measurements a text cache keeps. */
+#define TEXTCACHE_SIZE_DEFAULT 256
+
+/* Texts longer than this in bytes are not cached. */
+#define TEXTCACHE_TEXT_MAX 96
+
+typedef struct TextCache_       TextCache;
+typedef struct TextCacheStats_  TextCacheStats;
+
+/* Statistics about the use of a text cache. */
+struct TextCacheStats_ {
+  /* Measurements answered from the cache. */
+  long hits;
+  /* Measurements that had to be done by Allegro. */
+  long misses;
+  /* Measurements of texts too long to cache. */
+  long skipped;
+  /* Entries dropped to make place for new ones. */
+  long evictions;
+  /* Widths calculated from the prewarmed glyph widths. */
+  long computed;
+};
+
+TextCache * textcache_alloc();
+TextCache * textcache_init(TextCache * self, int size);
+TextCache * textcache_new(int size);
+TextCache * textcache_done(TextCache * self);
+TextCache * textcache_free(TextCache * self);
+void textcache_clear(TextCache * self);
+
+bool textcache_get_width(TextCache * self, ALLEGRO_FONT * font,
+                         const char * text, int size, int * value);
+bool textcache_get_dimensions(TextCache * self, ALLEGRO_FONT * font,
+                              const char * text, int size,
+                              int * bbx, int * bby, int * bbw, int * bbh);
+bool textcache_prewarm(TextCache * self, ALLEGRO_FONT * font);
+bool textcache_stats(TextCache * self, TextCacheStats * stats);
+
+
+#endif
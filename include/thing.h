@@ -0,0 +1,95 @@
+#ifndef thing_H_INCLUDED
+#define thing_H_INCLUDED
+
+#include "sprite.h"
+#include "spritestate.h"
+
+/* Things are the game objects of the scripts. Their components, the
+ * transform, velocity, collision bounds, flags and sprite state, are kept in
+ * packed arrays, and a thing is addressed by an integer id that stays the same
+ * while it lives. The game logic stays in the scripts, but the per frame work
+ * on all things, moving them, choosing their walking animations and passing
+ * those to their sprite states, is done in C by thing_update. */
+
+/* Flags of a thing. */
+enum ThingFlags_ {
+  /* Not moved, animated or found. */
+  THING_FLAG_DISABLED = 1 << 0,
+  /* Found by rectangle searches, but doesn't block. */
+  THING_FLAG_SENSOR   = 1 << 1,
+  /* Never moved by its velocity. */
+  THING_FLAG_STATIC   = 1 << 2,
+  /* The walking or standing pose and the direction follow the velocity. */
+  THING_FLAG_ANIMATE  = 1 << 3,
+  /* Not drawn. */
+  THING_FLAG_HIDDEN   = 1 << 4,
+};
+
+/* Kinds of things. */
+enum ThingKinds_ {
+  THING_KIND_NONE     = 0,
+  THING_KIND_PLAYER   = 1,
+  THING_KIND_NPC      = 2,
+  THING_KIND_FOE      = 3,
+  THING_KIND_ITEM     = 4,
+  THING_KIND_ATTACK   = 5,
+  THING_KIND_WALL     = 6,
+};
+
+int   thing_new(int kind, float x, float y, float z, float w, float h);
+int   thing_delete(int id);
+int   thing_exists(int id);
+int   thing_count(void);
+int   thing_nth(int nth);
+
+float thing_x(int id);
+float thing_y(int id);
+float thing_z(int id);
+float thing_w(int id);
+float thing_h(int id);
+float thing_cx(int id);
+float thing_cy(int id);
+float thing_vx(int id);
+float thing_vy(int id);
+int   thing_position_(int id, float x, float y);
+int   thing_z_(int id, float z);
+int   thing_size_(int id, float w, float h);
+int   thing_v_(int id, float vx, float vy);
+
+int   thing_kind(int id);
+int   thing_flags(int id);
+int   thing_flags_(int id, int flags);
+int   thing_set_flag(int id, int flag);
+int   thing_unset_flag(int id, int flag);
+int   thing_group(int id);
+int   thing_group_(int id, int group);
+
+int   thing_pose(int id);
+int   thing_pose_(int id, int pose);
+int   thing_direction(int id);
+int   thing_direction_(int id, int direction);
+int   thing_sprite_(int id, Sprite * sprite);
+SpriteState * thing_spritestate(int id);
+int   thing_forget_sprite(Sprite * sprite);
+
+int   thing_tint_layer(int id, int layer, int r, int g, int b, int a);
+int   thing_hide_layer(int id, int layer, int hidden);
+int   thing_layer_hidden(int id, int layer);
+int   thing_set_action_loop(int id, int action, int loopmode);
+int   thing_get_action_loop(int id, int action);
+int   thing_set_pose_direction_loop(int id, int pose, int direction, int loopmode);
+int   thing_get_pose_direction_loop(int id, int pose, int direction);
+int   thing_action_done(int id, int action);
+
+int   thing_find_in_rectangle(float x, float y, float w, float h,
+                              int * ids, int max);
+
+int   thing_integrate(double dt);
+int   thing_animate(void);
+int   thing_sync_sprites(void);
+int   thing_update(double dt);
+void  thing_draw(int show_bounds);
+void  thing_done(void);
+
+
+#endif
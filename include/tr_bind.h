@@ -0,0 +1,50 @@
+#ifndef tr_bind_H_INCLUDED
+#define tr_bind_H_INCLUDED
+
+#include <mruby.h>
+#include <mruby/array.h>
+
+/* Support for the bindings that bin/trgen generates from the src/tr_*.bind
+ * files. In stead of letting mrb_get_args interpret a format string on every
+ * call, the generated wrappers check the amount of arguments once, and take
+ * the arguments straight from the stack of mruby. The TR_BIND_ macros
+ * convert them, and only call a function when an argument isn't already of
+ * the expected type, which is never for integers and rarely for floats.
+ *
+ * Integers and floats convert into each other, but unlike mrb_get_args,
+ * nothing else converts to a number, so no Ruby code can run while the
+ * arguments are read. Booleans follow Ruby's truth, and strings must be
+ * strings. */
+
+#define TR_BIND_INT(MRB, VALUE)                                                \
+  (mrb_fixnum_p(VALUE) ? mrb_fixnum(VALUE) : tr_bind_int((MRB), (VALUE)))
+
+#define TR_BIND_FLOAT(MRB, VALUE)                                              \
+  (mrb_float_p(VALUE) ? mrb_float(VALUE) : tr_bind_float((MRB), (VALUE)))
+
+#define TR_BIND_BOOL(MRB, VALUE)   mrb_test(VALUE)
+
+#define TR_BIND_STRING(MRB, VALUE) tr_bind_string((MRB), (VALUE))
+
+/* Returns the arguments of the C function mruby is calling now, and stores
+ * their amount in argc. */
+static inline mrb_value * tr_bind_args(mrb_state * mrb, mrb_int * argc) {
+  mrb_callinfo * ci = mrb->c->ci;
+  /* A call with a splat has its arguments packed in an array. */
+  if (ci->argc < 0) {
+    mrb_value args = mrb->c->stack[1];
+    (*argc) = RARRAY_LEN(args);
+    return RARRAY_PTR(args);
+  }
+  (*argc) = ci->argc;
+  return mrb->c->stack + 1;
+}
+
+mrb_int tr_bind_int(mrb_state * mrb, mrb_value value);
+mrb_float tr_bind_float(mrb_state * mrb, mrb_value value);
+const char * tr_bind_string(mrb_state * mrb, mrb_value value);
+mrb_value tr_bind_arity_error(mrb_state * mrb, mrb_int argc, int expected);
+mrb_int tr_bind_batch_size(mrb_state * mrb, mrb_value list, int stride);
+
+
+#endif
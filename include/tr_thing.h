@@ -0,0 +1,6 @@
+#ifndef tr_thing_H_INCLUDED
+#define tr_thing_H_INCLUDED
+
+int tr_thing_init(mrb_state * mrb, struct RClass * eru);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef tween_H_INCLUDED
+#define tween_H_INCLUDED
+
+#include "scegra.h"
+
+/* Maximum amount of tween tracks that can be active at the same time. */
+#define TWEEN_TRACKS_MAX 2000
+
+/* Easing curves for tweens. */
+enum TweenEase_ {
+  TWEEN_EASE_LINEAR       = 0,
+  TWEEN_EASE_QUAD_IN      = 1,
+  TWEEN_EASE_QUAD_OUT     = 2,
+  TWEEN_EASE_QUAD_INOUT   = 3,
+  TWEEN_EASE_CUBIC_IN     = 4,
+  TWEEN_EASE_CUBIC_OUT    = 5,
+  TWEEN_EASE_CUBIC_INOUT  = 6,
+  TWEEN_EASE_SINE_IN      = 7,
+  TWEEN_EASE_SINE_OUT     = 8,
+  TWEEN_EASE_SINE_INOUT   = 9,
+  TWEEN_EASE_BACK_OUT     = 10,
+  TWEEN_EASE_ELASTIC_OUT  = 11,
+  TWEEN_EASE_BOUNCE_OUT   = 12,
+  TWEEN_EASE_MAX          = 13
+};
+
+/* What to do when a tween reaches the end. */
+enum TweenLoop_ {
+  /* Stop the tween. */
+  TWEEN_LOOP_NONE         = 0,
+  /* Restart the tween from the start value. */
+  TWEEN_LOOP_REPEAT       = 1,
+  /* Play the tween backwards, then forwards again, etc. */
+  TWEEN_LOOP_PINGPONG     = 2
+};
+
+/* Kinds of tween events sent to the scripting side. */
+enum TweenEvent_ {
+  TWEEN_EVENT_DONE        = 1,
+  TWEEN_EVENT_LOOP        = 2
+};
+
+
+double tween_ease(int ease, double t);
+
+void tween_init();
+void tween_done();
+void tween_update(double dt);
+
+int tween_start(int node, int prop, const float * to, double duration,
+                double delay, int ease, int loop, int loops, int notify);
+int tween_stop(int node, int prop);
+int tween_stop_node(int node);
+int tween_active_p(int node, int prop);
+int tween_count();
+
+
+#endif
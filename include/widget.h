@@ -262,6 +262,8 @@ int bbconsole_printf(BBConsole * self, const char * format, ...);
 
 int bbconsole_draw(BBWidget * widget, void * data);
 
+int bbconsole_rows(BBConsole * self);
+
 void bbconsole_active_ (BBConsole * self , int active );
 
 int bbconsole_active (BBConsole * self );
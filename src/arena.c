@@ -0,0 +1,149 @@
+#include "arena.h"
+#include "mem.h"
+#include <string.h>
+
+/*
+ * The blocks of an arena are kept in a singly linked list with the newest
+ * block first. Only the newest block is allocated from, what's left over at
+ * the end of the older blocks is wasted. Allocations larger than a block get
+ * a block of their own, which is put after the newest block so the space
+ * left in the newest block can still be used.
+ *
+ * Memory is aligned for the largest of the basic C types.
+ */
+
+#define ARENA_ALIGN (sizeof(double) > sizeof(void *) ? sizeof(double)          \
+                                                      : sizeof(void *))
+
+typedef struct ArenaBlock_ ArenaBlock;
+
+struct ArenaBlock_ {
+  ArenaBlock * next;
+  size_t       size;
+  size_t       used;
+  /* Keeps data aligned. */
+  double       data[1];
+};
+
+struct Arena_ {
+  ArenaBlock * blocks;
+  size_t       block_size;
+  ArenaStats   stats;
+};
+
+
+/* Rounds size up to the alignment of the arena. */
+static size_t arena_round(size_t size) {
+  return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+/** Allocates an arena. */
+Arena * arena_alloc(void) {
+  return STRUCT_ALLOC(Arena);
+}
+
+/** Initializes an arena that allocates blocks of block_size bytes,
+ * or ARENA_BLOCK_DEFAULT if block_size is 0. No memory is allocated
+ * until it's needed. */
+Arena * arena_init(Arena * self, size_t block_size) {
+  if (!self) return NULL;
+  if (block_size < 1) block_size = ARENA_BLOCK_DEFAULT;
+  self->blocks     = NULL;
+  self->block_size = arena_round(block_size);
+  memset(&self->stats, 0, sizeof(self->stats));
+  return self;
+}
+
+/** Allocates and initializes an arena. */
+Arena * arena_new(size_t block_size) {
+  return arena_init(arena_alloc(), block_size);
+}
+
+/** Frees all memory that was allocated from the arena at once. The arena can
+ * be used again afterwards. */
+Arena * arena_done(Arena * self) {
+  ArenaBlock * block, * next;
+  if (!self) return NULL;
+  for (block = self->blocks; block; block = next) {
+    next = block->next;
+    mem_free(block);
+  }
+  self->blocks = NULL;
+  memset(&self->stats, 0, sizeof(self->stats));
+  return self;
+}
+
+/** Frees all memory of the arena and the arena itself. Returns NULL. */
+Arena * arena_free(Arena * self) {
+  arena_done(self);
+  return mem_free(self);
+}
+
+/* Allocates a new block with room for size bytes, and links it in. */
+static ArenaBlock * arena_add_block(Arena * self, size_t size) {
+  ArenaBlock * block;
+  size_t room = (size > self->block_size) ? size : self->block_size;
+  block       = mem_alloc(sizeof(ArenaBlock) + room);
+  if (!block) return NULL;
+  block->size = room;
+  block->used = 0;
+  if (self->blocks && (room > self->block_size)) {
+    /* A large allocation, keep using the space of the newest block. */
+    block->next         = self->blocks->next;
+    self->blocks->next  = block;
+  } else {
+    block->next         = self->blocks;
+    self->blocks        = block;
+  }
+  self->stats.blocks++;
+  self->stats.bytes += room;
+  return block;
+}
+
+/** Allocates size bytes of zeroed memory from the arena. The memory must not
+ * be freed, it's freed with the arena. Returns NULL if out of memory. */
+void * arena_allocate(Arena * self, size_t size) {
+  ArenaBlock * block;
+  char * result;
+  if (!self) return NULL;
+  size  = arena_round(size < 1 ? 1 : size);
+  block = self->blocks;
+  if (!block || ((block->size - block->used) < size)) {
+    block = arena_add_block(self, size);
+    if (!block) return NULL;
+  }
+  result       = ((char *) block->data) + block->used;
+  block->used += size;
+  self->stats.used += size;
+  self->stats.allocations++;
+  memset(result, 0, size);
+  return result;
+}
+
+/** Grows or shrinks memory allocated from the arena from oldsize to newsize
+ * bytes. The new memory is zeroed. If self is NULL, the memory is allocated
+ * with mem_realloc in stead, so code can work with or without an arena.
+ * Returns the memory, which may have moved, or NULL if out of memory. */
+void * arena_reallocate(Arena * self, void * ptr, size_t oldsize,
+                        size_t newsize) {
+  void * result;
+  if (!self) {
+    result = mem_realloc(ptr, newsize);
+    if (result && (newsize > oldsize)) {
+      memset(((char *) result) + oldsize, 0, newsize - oldsize);
+    }
+    return result;
+  }
+  if (newsize <= oldsize) return ptr;
+  /* The old memory is wasted until the arena is freed. */
+  result = arena_allocate(self, newsize);
+  if (result && ptr) memcpy(result, ptr, oldsize);
+  return result;
+}
+
+/** Copies the statistics of the arena into stats. */
+bool arena_stats(Arena * self, ArenaStats * stats) {
+  if (!self || !stats) return false;
+  (*stats) = self->stats;
+  return true;
+}
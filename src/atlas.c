@@ -0,0 +1,363 @@
+#include "atlas.h"
+#include "mem.h"
+#include <string.h>
+
+
+/* A page of the atlas. */
+struct AtlasPage_ {
+  Image   * image;
+  Skyline   skyline;
+  /* Amount of images in this page that are still in use. */
+  int       refs;
+};
+
+struct Atlas_ {
+  struct AtlasPage_ * pages;
+  int                 pages_size;
+  int                 page_wide;
+  int                 page_high;
+  AtlasStats          stats;
+};
+
+
+/* Skyline packer. */
+
+/** Initializes a skyline packer for an area of wide by high. */
+Skyline * skyline_init(Skyline * self, int wide, int high) {
+  if (!self) return NULL;
+  if ((wide < 1) || (high < 1)) return NULL;
+  /* Every node is at least one pixel wide, so there can't be more nodes
+   * than that, plus one for while inserting. */
+  self->nodes = STRUCT_NALLOC(SkylineNode, wide + 1);
+  if (!self->nodes) return NULL;
+  self->wide  = wide;
+  self->high  = high;
+  self->used  = 1;
+  self->area  = 0;
+  self->nodes[0].x = 0;
+  self->nodes[0].y = 0;
+  self->nodes[0].w = wide;
+  return self;
+}
+
+/** Cleans up a skyline packer. */
+Skyline * skyline_done(Skyline * self) {
+  if (!self) return NULL;
+  self->nodes = mem_free(self->nodes);
+  self->used  = 0;
+  return self;
+}
+
+/* Returns the y at which a rectangle of wide by high fits if it's left side
+ * is placed at the start of the node at index, or negative if it doesn't
+ * fit there. */
+static int skyline_fit(Skyline * self, int index, int wide, int high) {
+  int y    = 0;
+  int left = wide;
+  if ((self->nodes[index].x + wide) > self->wide) return -1;
+  while (left > 0) {
+    if (self->nodes[index].y > y) y = self->nodes[index].y;
+    if ((y + high) > self->high) return -1;
+    left -= self->nodes[index].w;
+    index++;
+  }
+  return y;
+}
+
+/* Removes the node at index. */
+static void skyline_remove(Skyline * self, int index) {
+  memmove(self->nodes + index, self->nodes + index + 1,
+          sizeof(SkylineNode) * (self->used - index - 1));
+  self->used--;
+}
+
+/** Finds a place for a rectangle of wide by high, as low as possible and
+ * then as far to the left as possible, and marks it as used. Stores the
+ * position in x and y. Returns false if the rectangle doesn't fit. */
+bool skyline_insert(Skyline * self, int wide, int high, int * x, int * y) {
+  int index, best = -1, best_y = 0, best_top = 0, best_w = 0;
+  SkylineNode * node;
+  if (!self || !self->nodes || (wide < 1) || (high < 1)) return false;
+  for (index = 0; index < self->used; index++) {
+    int fy = skyline_fit(self, index, wide, high);
+    if (fy < 0) continue;
+    if ((best < 0) || ((fy + high) < best_top) ||
+        (((fy + high) == best_top) && (self->nodes[index].w < best_w))) {
+      best      = index;
+      best_y    = fy;
+      best_top  = fy + high;
+      best_w    = self->nodes[index].w;
+    }
+  }
+  if (best < 0) return false;
+
+  /* Put a new node for the top of the rectangle at best. */
+  memmove(self->nodes + best + 1, self->nodes + best,
+          sizeof(SkylineNode) * (self->used - best));
+  self->used++;
+  node    = self->nodes + best;
+  node->y = best_y + high;
+  node->w = wide;
+  /* node->x stays the same. */
+
+  /* Shrink or remove the nodes that are now covered by the new one. */
+  index = best + 1;
+  while (index < self->used) {
+    SkylineNode * prev = self->nodes + index - 1;
+    SkylineNode * now  = self->nodes + index;
+    int shrink         = (prev->x + prev->w) - now->x;
+    if (shrink <= 0) break;
+    now->x += shrink;
+    now->w -= shrink;
+    if (now->w > 0) break;
+    skyline_remove(self, index);
+  }
+
+  /* Merge neighbours at the same height. */
+  index = 0;
+  while (index < (self->used - 1)) {
+    if (self->nodes[index].y == self->nodes[index + 1].y) {
+      self->nodes[index].w += self->nodes[index + 1].w;
+      skyline_remove(self, index + 1);
+    } else {
+      index++;
+    }
+  }
+
+  self->area += wide * high;
+  if (x) (*x) = node->x;
+  if (y) (*y) = best_y;
+  return true;
+}
+
+
+/** Finds the bounding box of the pixels that are not fully transparent in
+ * an image of wide by high pixels. data must point to the alpha byte of the
+ * first pixel, pitch is the distance in bytes between rows, and pixsize the
+ * distance in bytes between pixels. Returns false if all pixels are fully
+ * transparent. */
+bool atlas_alpha_bounds(const unsigned char * data, int pitch, int pixsize,
+                        int wide, int high, int * bx, int * by,
+                        int * bw, int * bh) {
+  int x, y, x1 = wide, y1 = high, x2 = -1, y2 = -1;
+  if (!data) return false;
+  for (y = 0; y < high; y++) {
+    const unsigned char * row = data + (y * pitch);
+    for (x = 0; x < wide; x++) {
+      if (!row[x * pixsize]) continue;
+      if (x < x1) x1 = x;
+      if (x > x2) x2 = x;
+      if (y < y1) y1 = y;
+      y2 = y;
+    }
+  }
+  if (x2 < 0) return false;
+  (*bx) = x1;
+  (*by) = y1;
+  (*bw) = x2 - x1 + 1;
+  (*bh) = y2 - y1 + 1;
+  return true;
+}
+
+
+/* Atlas */
+
+/** Allocates an atlas. */
+Atlas * atlas_alloc(void) {
+  return STRUCT_ALLOC(Atlas);
+}
+
+/** Initializes an atlas with pages of page_wide by page_high. */
+Atlas * atlas_init(Atlas * self, int page_wide, int page_high) {
+  if (!self) return NULL;
+  if ((page_wide < 1) || (page_high < 1)) return NULL;
+  self->pages      = NULL;
+  self->pages_size = 0;
+  self->page_wide  = page_wide;
+  self->page_high  = page_high;
+  memset(&self->stats, 0, sizeof(self->stats));
+  return self;
+}
+
+/** Allocates and initializes an atlas. */
+Atlas * atlas_new(int page_wide, int page_high) {
+  Atlas * self = atlas_alloc();
+  if (!atlas_init(self, page_wide, page_high)) {
+    return mem_free(self);
+  }
+  return self;
+}
+
+/* Destroys the page at index. */
+static void atlas_drop_page(Atlas * self, int index) {
+  struct AtlasPage_ * page = self->pages + index;
+  if (!page->image) return;
+  al_destroy_bitmap(page->image);
+  page->image = NULL;
+  skyline_done(&page->skyline);
+  page->refs  = 0;
+  self->stats.pages--;
+  self->stats.page_area -= self->page_wide * self->page_high;
+}
+
+/** Cleans up the atlas, destroying all pages. The images in it must have been
+ * released before, since they are sub bitmaps of the pages. */
+Atlas * atlas_done(Atlas * self) {
+  int index;
+  if (!self) return NULL;
+  for (index = 0; index < self->pages_size; index++) {
+    atlas_drop_page(self, index);
+  }
+  self->pages      = mem_free(self->pages);
+  self->pages_size = 0;
+  return self;
+}
+
+/** Cleans up and frees the atlas. Returns NULL. */
+Atlas * atlas_free(Atlas * self) {
+  atlas_done(self);
+  return mem_free(self);
+}
+
+/* Makes a new, empty page and returns it's index, or negative on error. */
+static int atlas_new_page(Atlas * self) {
+  int index;
+  struct AtlasPage_ * page;
+  Image * target;
+  for (index = 0; index < self->pages_size; index++) {
+    if (!self->pages[index].image) break;
+  }
+  if (index >= self->pages_size) {
+    int newsize = (self->pages_size < 1) ? 4 : self->pages_size * 2;
+    self->pages = mem_realloc(self->pages, newsize * sizeof(struct AtlasPage_));
+    memset(self->pages + self->pages_size, 0,
+           (newsize - self->pages_size) * sizeof(struct AtlasPage_));
+    self->pages_size = newsize;
+  }
+  page = self->pages + index;
+  if (!skyline_init(&page->skyline, self->page_wide, self->page_high)) {
+    return -1;
+  }
+  page->image = al_create_bitmap(self->page_wide, self->page_high);
+  if (!page->image) {
+    skyline_done(&page->skyline);
+    return -1;
+  }
+  target = al_get_target_bitmap();
+  al_set_target_bitmap(page->image);
+  al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+  al_set_target_bitmap(target);
+  page->refs = 0;
+  self->stats.pages++;
+  self->stats.page_area += self->page_wide * self->page_high;
+  return index;
+}
+
+/** Copies the region of wide by high at x, y of source into a page of the
+ * atlas. Returns a sub bitmap of the page with the copy, and stores the
+ * index of the page in page. Returns NULL if the region is too large to fit
+ * into a page or on error. The image must be released with atlas_release
+ * and not be destroyed directly. */
+Image * atlas_add_region(Atlas * self, Image * source, int x, int y,
+                         int wide, int high, int * page) {
+  int index, px = 0, py = 0, op, src, dst;
+  Image * target, * result;
+  if (!self || !source || !page) return NULL;
+  if ((wide < 1) || (high < 1)) return NULL;
+  if (((wide + ATLAS_PADDING) > self->page_wide) ||
+      ((high + ATLAS_PADDING) > self->page_high)) return NULL;
+
+  for (index = 0; index < self->pages_size; index++) {
+    if (!self->pages[index].image) continue;
+    if (skyline_insert(&self->pages[index].skyline,
+                       wide + ATLAS_PADDING, high + ATLAS_PADDING, &px, &py)) {
+      break;
+    }
+  }
+  if (index >= self->pages_size) {
+    index = atlas_new_page(self);
+    if (index < 0) return NULL;
+    if (!skyline_insert(&self->pages[index].skyline,
+                        wide + ATLAS_PADDING, high + ATLAS_PADDING, &px, &py)) {
+      atlas_drop_page(self, index);
+      return NULL;
+    }
+  }
+
+  /* Copy the pixels as they are, without blending. */
+  target = al_get_target_bitmap();
+  al_get_blender(&op, &src, &dst);
+  al_set_target_bitmap(self->pages[index].image);
+  al_set_blender(ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ZERO);
+  al_draw_bitmap_region(source, x, y, wide, high, px, py, 0);
+  al_set_blender(op, src, dst);
+  al_set_target_bitmap(target);
+
+  result = al_create_sub_bitmap(self->pages[index].image, px, py, wide, high);
+  if (!result) {
+    /* A page that was made for this image has nothing else in it. */
+    if (self->pages[index].refs < 1) atlas_drop_page(self, index);
+    return NULL;
+  }
+  self->pages[index].refs++;
+  self->stats.images++;
+  self->stats.used_area += wide * high;
+  (*page) = index;
+  return result;
+}
+
+/** Like atlas_add_region, but trims away the fully transparent border of the
+ * region first. The top left corner of the trimmed image relative to the
+ * region is stored in trim, so it can be drawn at the right spot. A fully
+ * transparent region is trimmed down to a single pixel. */
+Image * atlas_add_trimmed(Atlas * self, Image * source, int x, int y,
+                          int wide, int high, int * page, Point * trim) {
+  ALLEGRO_LOCKED_REGION * lock;
+  Image * result;
+  int bx = 0, by = 0, bw = wide, bh = high;
+  if (!self || !source || !trim) return NULL;
+  lock = al_lock_bitmap_region(source, x, y, wide, high,
+                               ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE,
+                               ALLEGRO_LOCK_READONLY);
+  if (lock) {
+    /* In ABGR_8888_LE the alpha is the last of the 4 bytes of a pixel. */
+    if (!atlas_alpha_bounds(((const unsigned char *) lock->data) + 3,
+                            lock->pitch, lock->pixel_size, wide, high,
+                            &bx, &by, &bw, &bh)) {
+      bx = 0; by = 0; bw = 1; bh = 1;
+    }
+    al_unlock_bitmap(source);
+  }
+  /* If locking failed the region is packed untrimmed. */
+  result = atlas_add_region(self, source, x + bx, y + by, bw, bh, page);
+  if (!result) return NULL;
+  self->stats.trimmed_area += (wide * high) - (bw * bh);
+  (*trim) = bevec(bx, by);
+  return result;
+}
+
+/** Releases an image that was added to the page with index page of the
+ * atlas. The page is destroyed if no images are left in it.
+ * Returns the amount of images still in the page, or negative on error. */
+int atlas_release(Atlas * self, Image * image, int page) {
+  struct AtlasPage_ * now;
+  if (!self || !image)                        return -1;
+  if ((page < 0) || (page >= self->pages_size)) return -2;
+  now = self->pages + page;
+  if (!now->image)                            return -3;
+  self->stats.images--;
+  self->stats.used_area -= al_get_bitmap_width(image) *
+                           al_get_bitmap_height(image);
+  al_destroy_bitmap(image);
+  now->refs--;
+  if (now->refs > 0) return now->refs;
+  atlas_drop_page(self, page);
+  return 0;
+}
+
+/** Copies the statistics of the atlas into stats. */
+bool atlas_stats(Atlas * self, AtlasStats * stats) {
+  if (!self || !stats) return false;
+  (*stats) = self->stats;
+  return true;
+}
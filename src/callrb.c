@@ -7,52 +7,214 @@
 #include "rh.h"
 #include "spritestate.h"
 #include "callrb.h"
+#include <mruby/array.h>
+#include <string.h>
+
+/* The callbacks, indexed by CallrbCallbacks_. Their symbols are resolved
+ * again by callrb_resolve whenever main.rb is (re)loaded. Callbacks that a
+ * script defines later are found when they're next called. The lasting ones
+ * set up or keep objects, so they don't allocate from a frame region. */
+static RhCallback callrb_callbacks[CALLRB_CALLBACKS] = {
+  [CALLRB_ON_START]            = { .name = "eruta_on_start", .lasting = 1 },
+  [CALLRB_ON_RELOAD]           = { .name = "eruta_on_reload", .lasting = 1 },
+  [CALLRB_ON_UPDATE]           = { .name = "eruta_on_update" },
+  [CALLRB_ON_POLL]             = { .name = "eruta_on_poll" },
+  [CALLRB_ON_SPRITE]           = { .name = "eruta_on_sprite" },
+  [CALLRB_ON_SPRITES]          = { .name = "eruta_on_sprites" },
+  [CALLRB_ON_SPRITE_LOADED]    = { .name = "eruta_on_sprite_loaded",
+                                   .lasting = 1 },
+  [CALLRB_ON_RESOURCE_LOADED]  = { .name = "eruta_on_resource_loaded",
+                                   .lasting = 1 },
+  [CALLRB_ON_TWEEN]            = { .name = "eruta_on_tween" },
+  [CALLRB_ON_EVENTS]           = { .name = "eruta_on_events" },
+  [CALLRB_ON_TASK]             = { .name = "eruta_on_task" }
+};
+
+/* Calls the callback with argc arguments from its args array, under the
+ * toplevel of the ruby of the state. */
+static mrb_value callrb_call(int index, int argc) {
+  RhCallback * callback = callrb_callbacks + index;
+  State * state         = state_get();
+  Ruby * ruby;
+  if (!state) return mrb_nil_value();
+  ruby = state_ruby(state);
+  return rh_callback_call(ruby, callback, argc, callback->args);
+}
+
+/** Looks up all callbacks again. Must be called after the scripts were
+ * (re)loaded. Returns the amount of callbacks that the scripts define. */
+int callrb_resolve(void) {
+  int index, defined = 0;
+  State * state = state_get();
+  Ruby * ruby   = (state ? state_ruby(state) : NULL);
+  if (!ruby) return 0;
+  for (index = 0; index < CALLRB_CALLBACKS; index++) {
+    if (rh_callback_resolve(ruby, callrb_callbacks + index)) defined++;
+  }
+  return defined;
+}
+
+/** Returns the name of the ruby function of the callback with the given
+ * index, or NULL if out of range. */
+const char * callrb_name(int index) {
+  if ((index < 0) || (index >= CALLRB_CALLBACKS)) return NULL;
+  return callrb_callbacks[index].name;
+}
+
+/** Returns true if the scripts define the callback with the given index. */
+bool callrb_defined(int index) {
+  RhCallback * callback;
+  State * state = state_get();
+  if ((index < 0) || (index >= CALLRB_CALLBACKS) || !state) return false;
+  callback = callrb_callbacks + index;
+  /* Look again if it wasn't defined, a script may have defined it since. */
+  if (!callback->defined) rh_callback_resolve(state_ruby(state), callback);
+  return callback->defined;
+}
+
+/** Copies the call count and timing statistics of the callback with the
+ * given index to stats. */
+bool callrb_stats(int index, RhCallbackStats * stats) {
+  if ((index < 0) || (index >= CALLRB_CALLBACKS) || !stats) return false;
+  (*stats) = callrb_callbacks[index].stats;
+  return true;
+}
+
+/** Clears the statistics of all callbacks. */
+void callrb_stats_reset(void) {
+  int index;
+  for (index = 0; index < CALLRB_CALLBACKS; index++) {
+    memset(&callrb_callbacks[index].stats, 0, sizeof(RhCallbackStats));
+  }
+}
 
 /* Sprite event handler. Calls an mruby callback. */
 int callrb_sprite_event(SpriteState * spritestate, int kind, void * data) { 
   mrb_value res;
   Sprite * sprite;
-  State * state;
   int spriteid, thingid, pose, direction;
-  Ruby * ruby;
   void * thing;
+  mrb_value * args = callrb_callbacks[CALLRB_ON_SPRITE].args;
   sprite    = spritestate_sprite(spritestate);
   spriteid  = sprite_id(sprite);
   thing     = spritestate_data(spritestate);  
   pose      = spritestate_pose(spritestate);
   direction = spritestate_direction(spritestate);
-  state     = state_get();
-  ruby      = state_ruby(state);
-  res       = rh_run_toplevel(ruby, "eruta_on_sprite", "iiii", 
-                spriteid, pose, direction, kind);
+  args[0]   = mrb_fixnum_value(spriteid);
+  args[1]   = mrb_fixnum_value(pose);
+  args[2]   = mrb_fixnum_value(direction);
+  args[3]   = mrb_fixnum_value(kind);
+  res       = callrb_call(CALLRB_ON_SPRITE, 4);
   (void) data;
   return rh_tobool(res);
 }
 
-/* Calls the eruta_on_start function  */ 
-int callrb_on_start() { 
-  mrb_value res;
+/* Sends a batch of sprite events to the eruta_on_sprites function in one
+ * call, as an array of [spriteid, pose, direction, kind] arrays. */
+int callrb_sprite_events(SpriteAnimEvent * events, int count) { 
+  mrb_value res, list, vals[4];
+  mrb_state * mrb;
+  int index, arena;
   State * state = state_get();
   Ruby * ruby   = state_ruby(state);
-  res           = rh_run_toplevel(ruby, "eruta_on_start", "");
+  if (!ruby || (count < 1)) return FALSE;
+  mrb   = ruby;
+  arena = mrb_gc_arena_save(mrb);
+  list  = mrb_ary_new_capa(mrb, count);
+  for (index = 0; index < count; index++) {
+    vals[0] = mrb_fixnum_value(events[index].sprite);
+    vals[1] = mrb_fixnum_value(events[index].pose);
+    vals[2] = mrb_fixnum_value(events[index].direction);
+    vals[3] = mrb_fixnum_value(events[index].kind);
+    mrb_ary_push(mrb, list, mrb_ary_new_from_values(mrb, 4, vals));
+  }
+  callrb_callbacks[CALLRB_ON_SPRITES].args[0] = list;
+  res = callrb_call(CALLRB_ON_SPRITES, 1);
+  mrb_gc_arena_restore(mrb, arena);
   return rh_tobool(res);
 }
 
-/* Calls the eruta_on_reload function  */
+/* Tells the scripting side that the background loading of a sprite layer 
+ * with the given job id is done, by calling eruta_on_sprite_loaded. ok is 
+ * false if the layer could not be loaded. */
+int callrb_sprite_loaded(int job, int spriteid, int layer, int ok) { 
+  mrb_value * args = callrb_callbacks[CALLRB_ON_SPRITE_LOADED].args;
+  args[0]   = mrb_fixnum_value(job);
+  args[1]   = mrb_fixnum_value(spriteid);
+  args[2]   = mrb_fixnum_value(layer);
+  args[3]   = mrb_fixnum_value(ok);
+  return rh_tobool(callrb_call(CALLRB_ON_SPRITE_LOADED, 4));
+}
+
+/* Tells the scripting side that the background loading of a resource into 
+ * the store at index with the given job id is done, by calling 
+ * eruta_on_resource_loaded. ok is false if the resource could not be 
+ * loaded. */
+int callrb_resource_loaded(int job, int index, int kind, int ok) { 
+  mrb_value * args = callrb_callbacks[CALLRB_ON_RESOURCE_LOADED].args;
+  args[0]   = mrb_fixnum_value(job);
+  args[1]   = mrb_fixnum_value(index);
+  args[2]   = mrb_fixnum_value(kind);
+  args[3]   = mrb_fixnum_value(ok);
+  return rh_tobool(callrb_call(CALLRB_ON_RESOURCE_LOADED, 4));
+}
+
+/* Calls the eruta_on_start function, after resolving the callbacks defined 
+ * by main.rb. */ 
+int callrb_on_start() { 
+  callrb_resolve();
+  return rh_tobool(callrb_call(CALLRB_ON_START, 0));
+}
+
+/* Calls the eruta_on_reload function, after resolving the callbacks again,
+ * since main.rb was reloaded. */
 int callrb_on_reload() { 
-  mrb_value res;
-  State * state = state_get();
-  Ruby * ruby   = state_ruby(state);
-  res           = rh_run_toplevel(ruby, "eruta_on_reload", "");
-  return rh_tobool(res);
+  callrb_resolve();
+  return rh_tobool(callrb_call(CALLRB_ON_RELOAD, 0));
 }
 
 
 /* Calls the eruta_on_update function. */
 int callrb_on_update(State * self) {
+  RhCallback * callback = callrb_callbacks + CALLRB_ON_UPDATE;
   mrb_value res;  
-  mrb_value mval = mrb_float_value(state_ruby(self), state_frametime(self));
-  res = rh_run_toplevel_args(state_ruby(self), "eruta_on_update", 1, &mval);
+  callback->args[0] = mrb_float_value(state_ruby(self), state_frametime(self));
+  res = rh_callback_call(state_ruby(self), callback, 1, callback->args);
   return rh_tobool(res);
 }
 
+/* Calls the eruta_on_poll function with the arguments of an input event. */
+int callrb_on_poll(int argc, mrb_value * argv) {
+  State * state = state_get();
+  if (!state) return FALSE;
+  return rh_tobool(rh_callback_call(state_ruby(state), 
+                   callrb_callbacks + CALLRB_ON_POLL, argc, argv));
+}
+
+/* Calls the eruta_on_events function with all input events of a frame, as an 
+ * array of arrays with the arguments that eruta_on_poll would get. */
+int callrb_on_events(mrb_value events) {
+  callrb_callbacks[CALLRB_ON_EVENTS].args[0] = events;
+  return rh_tobool(callrb_call(CALLRB_ON_EVENTS, 1));
+}
+
+
+/* Calls the eruta_on_tween function when a scene graph tween is done 
+ * or loops. */
+int callrb_tween_event(int node, int prop, int kind) {
+  mrb_value * args = callrb_callbacks[CALLRB_ON_TWEEN].args;
+  args[0]   = mrb_fixnum_value(node);
+  args[1]   = mrb_fixnum_value(prop);
+  args[2]   = mrb_fixnum_value(kind);
+  return rh_tobool(callrb_call(CALLRB_ON_TWEEN, 3));
+}
+
+/* Calls the eruta_on_task function to resume the task with the given id.
+ * Returns true if the task has more work to do. Used by rhtask_run. */
+int callrb_task_resume(int id, void * data) {
+  mrb_value * args = callrb_callbacks[CALLRB_ON_TASK].args;
+  (void) data;
+  args[0]   = mrb_fixnum_value(id);
+  return rh_tobool(callrb_call(CALLRB_ON_TASK, 1));
+}
+
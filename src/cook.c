@@ -0,0 +1,286 @@
+#include "eruta.h"
+#include "mem.h"
+#include "monolog.h"
+#include "cook.h"
+#include "fifi.h"
+#include <ctype.h>
+#include <string.h>
+#include <time.h>
+
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
+
+/*
+ * The pixels are read and written with the bitmap locked in
+ * ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, which is R, G, B, A in memory on all
+ * platforms. When the pitch of the locked region is just the width of a row,
+ * the pixels are read straight into the bitmap in one go.
+ */
+
+/* Extensions of the images that are worth cooking. */
+static const char * cook_extensions[] = {
+  ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".pcx", NULL
+};
+
+
+/* Copies the pixels in rows of row bytes to the locked region. */
+static void cook_copy_in(ALLEGRO_LOCKED_REGION * lock, const unsigned char *
+                         pixels, size_t row, int h) {
+  int y;
+  for (y = 0; y < h; y++) {
+    memcpy(((char *) lock->data) + y * lock->pitch, pixels + y * row, row);
+  }
+}
+
+/* Reads the pixels of the file into the locked region. */
+static bool cook_read_pixels(ALLEGRO_FILE * file, ALLEGRO_LOCKED_REGION * lock,
+                             int method, size_t packed, int w, int h) {
+  size_t row  = ((size_t) w) * 4;
+  size_t size = row * h;
+  unsigned char * buffer, * pixels;
+  bool ok;
+  int y;
+  if ((method == COOK_STORE) && (packed == size)) {
+    if (lock->pitch == (int) row) {
+      return al_fread(file, lock->data, size) == size;
+    }
+    for (y = 0; y < h; y++) {
+      char * to = ((char *) lock->data) + y * lock->pitch;
+      if (al_fread(file, to, row) != row) return false;
+    }
+    return true;
+  }
+  if (method != COOK_DEFLATE) return false;
+  buffer = mem_alloc(packed > 0 ? packed : 1);
+  if (!buffer) return false;
+  ok = (al_fread(file, buffer, packed) == packed);
+  if (ok && (lock->pitch == (int) row)) {
+    ok = (tinfl_decompress_mem_to_mem(lock->data, size, buffer, packed, 0)
+          == size);
+  } else if (ok) {
+    pixels = mem_alloc(size);
+    ok     = pixels && (tinfl_decompress_mem_to_mem(pixels, size, buffer,
+                                                    packed, 0) == size);
+    if (ok) cook_copy_in(lock, pixels, row, h);
+    mem_free(pixels);
+  }
+  mem_free(buffer);
+  return ok;
+}
+
+/** Loads a cooked texture from the file, which is left open. The bitmap is
+ * made with the current new bitmap flags and format. Returns NULL if the
+ * file isn't a cooked texture or can't be read. */
+ALLEGRO_BITMAP * cook_load_bitmap_f(ALLEGRO_FILE * file) {
+  unsigned char header[COOK_HEADER_SIZE];
+  ALLEGRO_BITMAP        * bitmap;
+  ALLEGRO_LOCKED_REGION * lock;
+  uint32_t w, h, method, packed;
+  bool ok;
+  if (!file) return NULL;
+  if (al_fread(file, header, sizeof(header)) != sizeof(header)) return NULL;
+  if (memcmp(header, COOK_MAGIC, 4) != 0)                       return NULL;
+  w      = mem_get32(header + 8);
+  h      = mem_get32(header + 12);
+  method = mem_get32(header + 20);
+  packed = mem_get32(header + 28);
+  if ((mem_get32(header + 4)  != COOK_VERSION) ||
+      (mem_get32(header + 16) != COOK_RGBA_PREMULTIPLIED) ||
+      (w < 1) || (h < 1) || (w > 0x4000) || (h > 0x4000)) return NULL;
+  bitmap = al_create_bitmap(w, h);
+  if (!bitmap) return NULL;
+  lock   = al_lock_bitmap(bitmap, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE,
+                          ALLEGRO_LOCK_WRITEONLY);
+  if (!lock) {
+    al_destroy_bitmap(bitmap);
+    return NULL;
+  }
+  ok = cook_read_pixels(file, lock, method, packed, w, h);
+  al_unlock_bitmap(bitmap);
+  if (!ok) {
+    al_destroy_bitmap(bitmap);
+    return NULL;
+  }
+  return bitmap;
+}
+
+/** Loads a cooked texture from the file with the given name. */
+ALLEGRO_BITMAP * cook_load_bitmap(const char * filename) {
+  ALLEGRO_BITMAP * bitmap;
+  ALLEGRO_FILE   * file = al_fopen(filename, "rb");
+  if (!file) return NULL;
+  bitmap = cook_load_bitmap_f(file);
+  al_fclose(file);
+  return bitmap;
+}
+
+/** Writes the bitmap to the file as a cooked texture, with the pixels
+ * stored as they are or deflated according to method. The pixels are
+ * written as they are in the bitmap, so it should have been loaded with
+ * premultiplied alpha. Returns true on success. */
+bool cook_save_bitmap_f(ALLEGRO_FILE * file, ALLEGRO_BITMAP * bitmap,
+                        int method) {
+  unsigned char header[COOK_HEADER_SIZE];
+  ALLEGRO_LOCKED_REGION * lock;
+  unsigned char * pixels;
+  void   * packed = NULL;
+  size_t   row, size, packed_size;
+  int w, h, y;
+  bool ok;
+  if (!file || !bitmap) return false;
+  if ((method != COOK_STORE) && (method != COOK_DEFLATE)) return false;
+  w    = al_get_bitmap_width(bitmap);
+  h    = al_get_bitmap_height(bitmap);
+  row  = ((size_t) w) * 4;
+  size = row * h;
+  pixels = mem_alloc(size > 0 ? size : 1);
+  if (!pixels) return false;
+  lock = al_lock_bitmap(bitmap, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE,
+                        ALLEGRO_LOCK_READONLY);
+  if (!lock) {
+    mem_free(pixels);
+    return false;
+  }
+  for (y = 0; y < h; y++) {
+    memcpy(pixels + y * row, ((char *) lock->data) + y * lock->pitch, row);
+  }
+  al_unlock_bitmap(bitmap);
+  packed_size = size;
+  if (method == COOK_DEFLATE) {
+    packed = tdefl_compress_mem_to_heap(pixels, size, &packed_size,
+                                        TDEFL_DEFAULT_MAX_PROBES);
+    if (!packed) {
+      mem_free(pixels);
+      return false;
+    }
+  }
+  memset(header, 0, sizeof(header));
+  memcpy(header, COOK_MAGIC, 4);
+  mem_put32(header + 4 , COOK_VERSION);
+  mem_put32(header + 8 , w);
+  mem_put32(header + 12, h);
+  mem_put32(header + 16, COOK_RGBA_PREMULTIPLIED);
+  mem_put32(header + 20, method);
+  mem_put32(header + 24, 1);
+  mem_put32(header + 28, packed_size);
+  ok = (al_fwrite(file, header, sizeof(header)) == sizeof(header));
+  ok = ok && (al_fwrite(file, packed ? packed : pixels, packed_size)
+              == packed_size);
+  if (packed) mz_free(packed);
+  mem_free(pixels);
+  return ok;
+}
+
+/** Writes the bitmap to the file with the given name as a cooked texture. */
+bool cook_save_bitmap(const char * filename, ALLEGRO_BITMAP * bitmap,
+                      int method) {
+  bool ok;
+  ALLEGRO_FILE * file = al_fopen(filename, "wb");
+  if (!file) return false;
+  ok = cook_save_bitmap_f(file, bitmap, method);
+  al_fclose(file);
+  if (!ok) remove(filename);
+  return ok;
+}
+
+/** Returns true if a cooked texture can be used in stead of loading the
+ * image with the given al_load_bitmap_flags flags. Cooked textures always
+ * have premultiplied alpha. */
+bool cook_flags_ok(int flags) {
+  return !(flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA);
+}
+
+/** Returns true if the file is an image that can be cooked, going by its
+ * extension. */
+bool cook_source_ok(const char * filename) {
+  const char * dot;
+  int index;
+  if (!filename) return false;
+  dot = strrchr(filename, '.');
+  if (!dot) return false;
+  for (index = 0; cook_extensions[index]; index++) {
+    const char * ext = cook_extensions[index];
+    size_t length    = strlen(ext);
+    size_t at;
+    if (strlen(dot) != length) continue;
+    for (at = 0; at < length; at++) {
+      if (tolower((unsigned char) dot[at]) != ext[at]) break;
+    }
+    if (at == length) return true;
+  }
+  return false;
+}
+
+/** Stores the name of the cooked file of the image vpath or file name in
+ * buffer. Returns buffer, or NULL if it doesn't fit. */
+char * cook_vpath(char * buffer, size_t size, const char * vpath) {
+  if (!buffer || !vpath) return NULL;
+  if (strlen(vpath) + strlen(COOK_EXTENSION) + 1 > size) return NULL;
+  strcpy(buffer, vpath);
+  strcat(buffer, COOK_EXTENSION);
+  return buffer;
+}
+
+/** Returns true if the cooked file exists and is at least as new as the
+ * source image, or if only the cooked file exists. */
+bool cook_fresh(const char * source, const char * cooked) {
+  time_t source_time, cooked_time;
+  if (!fifi_file_mtime(cooked, &cooked_time)) return false;
+  if (!fifi_file_mtime(source, &source_time)) return true;
+  return cooked_time >= source_time;
+}
+
+/** Cooks the image in the file source into source with COOK_EXTENSION
+ * appended. Returns true on success. */
+bool cook_file(const char * source, int method) {
+  char cooked[1024];
+  ALLEGRO_BITMAP * bitmap;
+  int old_flags;
+  bool ok;
+  if (!cook_vpath(cooked, sizeof(cooked), source)) return false;
+  old_flags = al_get_new_bitmap_flags();
+  al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+  bitmap = al_load_bitmap(source);
+  al_set_new_bitmap_flags(old_flags);
+  if (!bitmap) {
+    LOG_WARNING("Could not load %s to cook it.\n", source);
+    return false;
+  }
+  ok = cook_save_bitmap(cooked, bitmap, method);
+  al_destroy_bitmap(bitmap);
+  if (!ok) LOG_WARNING("Could not write cooked texture %s.\n", cooked);
+  return ok;
+}
+
+/** Cooks all images in the directory dirname and its subdirectories that
+ * don't have a fresh cooked file yet, or all of them if force is true.
+ * Returns the amount of images cooked, or negative if the directory can't
+ * be read. */
+int cook_tree(const char * dirname, int method, bool force) {
+  ALLEGRO_FS_ENTRY * dir, * entry;
+  int cooked = 0;
+  dir = al_create_fs_entry(dirname);
+  if (!dir) return -1;
+  if (!al_open_directory(dir)) {
+    al_destroy_fs_entry(dir);
+    return -2;
+  }
+  while ((entry = al_read_directory(dir))) {
+    const char * name = al_get_fs_entry_name(entry);
+    char cooked_name[1024];
+    if (al_get_fs_entry_mode(entry) & ALLEGRO_FILEMODE_ISDIR) {
+      int sub = cook_tree(name, method, force);
+      if (sub > 0) cooked += sub;
+    } else if (cook_source_ok(name) &&
+               cook_vpath(cooked_name, sizeof(cooked_name), name)) {
+      if ((force || !cook_fresh(name, cooked_name)) &&
+          cook_file(name, method)) {
+        cooked++;
+      }
+    }
+    al_destroy_fs_entry(entry);
+  }
+  al_close_directory(dir);
+  al_destroy_fs_entry(dir);
+  return cooked;
+}
@@ -4,6 +4,9 @@
 #include "eruta.h"
 #include "fifi.h"
 #include "monolog.h"
+#include "pack.h"
+#include "cook.h"
+#include <string.h>
 
 /* Fifi contain functionality that helps finding back the file resouces,
 such as images, music, etc that EKQ needs.
@@ -68,6 +71,25 @@ int fifi_path_exists(Path * path) {
   return al_filename_exists(fifi_path_cstr(path));
 }
 
+/** Gets the modification time of the file into mtime. Returns false if the
+ * file doesn't exist. */
+bool fifi_file_mtime(const char * filename, time_t * mtime) {
+  return fifi_file_stat(filename, mtime, NULL);
+}
+
+/** Gets the modification time and the size of the file into mtime and size,
+ * either of which may be NULL. Returns false if the file doesn't exist. */
+bool fifi_file_stat(const char * filename, time_t * mtime, off_t * size) {
+  bool exists;
+  ALLEGRO_FS_ENTRY * entry = al_create_fs_entry(filename);
+  if (!entry) return false;
+  exists = al_fs_entry_exists(entry);
+  if (exists && mtime) (*mtime) = al_get_fs_entry_mtime(entry);
+  if (exists && size)  (*size)  = al_get_fs_entry_size(entry);
+  al_destroy_fs_entry(entry);
+  return exists;
+}
+
 /*
 static ALLEGRO_PATH * fifi_try_path(ALLEGRO_PATH base, char * name) {
   al_
@@ -107,17 +129,66 @@ ALLEGRO_PATH * fifi_make_data_path(void) {
   return path;
 }
 
+/* The pack of the data directory, if any. Files in the pack are loaded from
+ * the pack in stead of from the data directory. */
+static Pack * fifi_pack_ = NULL;
+
+/* Opens data.pack in the data directory if it's there. */
+static Pack * fifi_pack_open(void) {
+  ALLEGRO_PATH * path = al_clone_path(fifi_data_path_);
+  if (!path) return NULL;
+  al_set_path_filename(path, FIFI_PACK_NAME);
+  if (al_filename_exists(PATH_CSTR(path))) {
+    fifi_pack_ = pack_open(PATH_CSTR(path));
+    if (fifi_pack_) {
+      LOG("Data pack: %s, %d files\n", PATH_CSTR(path), 
+          pack_count(fifi_pack_));
+    }
+  }
+  al_destroy_path(path);
+  return fifi_pack_;
+}
+
 /** Initializes the file finding dir  */
 ALLEGRO_PATH * fifi_init(void) {
   fifi_data_path_ = fifi_find_data_path();
   if (fifi_data_path_) { 
     LOG("Data path: %s\n", PATH_CSTR(fifi_data_path_));
+    fifi_pack_open();
   } else {  
     LOG_WARNING("NULL data path!\n");
   }
   return fifi_data_path_ ;
 }
 
+/** Returns the pack of the data directory, or NULL if there is none. */
+Pack * fifi_pack(void) {
+  return fifi_pack_;
+}
+
+/** Closes the pack of the data directory. Resources loaded from the pack
+ * that keep reading from it, such as fonts and audio streams, must have been
+ * destroyed already. */
+void fifi_pack_close(void) {
+  fifi_pack_ = pack_close(fifi_pack_);
+}
+
+/** Returns the extension of the vpath, including the dot, for use as the
+ * file type of the al_load_*_f functions. Returns "" if there is none. */
+const char * fifi_vpath_extension(const char * vpath) {
+  const char * dot   = strrchr(vpath, '.');
+  const char * slash = strrchr(vpath, '/');
+  if (!dot || (slash && (slash > dot))) return "";
+  return dot;
+}
+
+/** Opens the file with the given vpath from the data pack as a memory file.
+ * Returns NULL if there is no pack, or if the file isn't in it. */
+ALLEGRO_FILE * fifi_pack_fopen(const char * vpath) {
+  if (!fifi_pack_ || !vpath) return NULL;
+  return pack_fopen(fifi_pack_, vpath);
+}
+
 /** Returns a pointer to the data path. Must be cloned before use.*/
 ALLEGRO_PATH * fifi_data_path(void) {  
   return fifi_data_path_;
@@ -463,6 +534,17 @@ ALLEGRO_PATH * fifi_tileset_filename(const char * name) {
 ALLEGRO_FONT * fifi_load_ttf_font_stretch(const char * vpath, int w, int h,  int flags) {
   ALLEGRO_FONT * font = NULL;
   ALLEGRO_PATH * path;  
+  ALLEGRO_FILE * file = fifi_pack_fopen(vpath);
+  /* The font keeps reading from the file, and closes it when destroyed. */
+  if (file) {
+    font = al_load_ttf_font_stretch_f(file, fifi_vpath_extension(vpath), 
+                                      w, h, flags);
+    if (!font) {
+      al_fclose(file);
+      pack_forget(fifi_pack_, vpath);
+    }
+    return font;
+  }
   path         = fifi_data_vpath(vpath);
   if (!path) return NULL;
   font = al_load_ttf_font_stretch(PATH_CSTR(path), w, h, flags);
@@ -476,13 +558,7 @@ ALLEGRO_FONT * fifi_load_ttf_font_stretch(const char * vpath, int w, int h,  int
 * and flags. 
 */
 ALLEGRO_FONT * fifi_load_ttf_font(const char * vpath, int h,  int flags) {
-  ALLEGRO_FONT * font = NULL;
-  ALLEGRO_PATH * path;  
-  path         = fifi_data_vpath(vpath);
-  if (!path) return NULL;
-  font = al_load_ttf_font(PATH_CSTR(path), h, flags);
-  al_destroy_path(path);
-  return font;
+  return fifi_load_ttf_font_stretch(vpath, 0, h, flags);
 }
 
 
@@ -522,6 +598,17 @@ ALLEGRO_FONT * fifi_load_bitmap_font(const char * vpath) {
 ALLEGRO_AUDIO_STREAM * fifi_load_audio_stream(const char * vpath, size_t buffer_count, int samples) {
   ALLEGRO_AUDIO_STREAM * data = NULL;
   ALLEGRO_PATH        * path;  
+  ALLEGRO_FILE        * file = fifi_pack_fopen(vpath);
+  /* The stream keeps reading from the file, and closes it when destroyed. */
+  if (file) {
+    data = al_load_audio_stream_f(file, fifi_vpath_extension(vpath), 
+                                  buffer_count, samples);
+    if (!data) {
+      al_fclose(file);
+      pack_forget(fifi_pack_, vpath);
+    }
+    return data;
+  }
   path         = fifi_data_vpath(vpath);
   if (!path) return NULL;
   data = al_load_audio_stream(PATH_CSTR(path), buffer_count, samples);
@@ -537,6 +624,13 @@ ALLEGRO_AUDIO_STREAM * fifi_load_audio_stream(const char * vpath, size_t buffer_
 ALLEGRO_SAMPLE * fifi_load_sample(const char * vpath) {
   ALLEGRO_SAMPLE      * data = NULL;
   ALLEGRO_PATH        * path;  
+  ALLEGRO_FILE        * file = fifi_pack_fopen(vpath);
+  if (file) {
+    data = al_load_sample_f(file, fifi_vpath_extension(vpath));
+    al_fclose(file);
+    pack_forget(fifi_pack_, vpath);
+    return data;
+  }
   path         = fifi_data_vpath(vpath);
   if (!path) return NULL;
   data = al_load_sample(PATH_CSTR(path));
@@ -545,13 +639,69 @@ ALLEGRO_SAMPLE * fifi_load_sample(const char * vpath) {
 }
 
 
+/**
+* Returns the path of the cooked texture of the image with the given virtual
+* path, if it's in the data directory and newer than the image, or NULL if
+* not. Must be destroyed after use. 
+*/
+ALLEGRO_PATH * fifi_cooked_path(const char * vpath) {
+  char cooked[FIFI_VPATH_MAX];
+  ALLEGRO_PATH * path, * cooked_path;
+  if (!cook_vpath(cooked, sizeof(cooked), vpath)) return NULL;
+  path        = fifi_data_vpath(vpath);
+  cooked_path = fifi_data_vpath(cooked);
+  if (path && cooked_path && 
+      cook_fresh(PATH_CSTR(path), PATH_CSTR(cooked_path))) {
+    al_destroy_path(path);
+    return cooked_path;
+  }
+  if (path)        al_destroy_path(path);
+  if (cooked_path) al_destroy_path(cooked_path);
+  return NULL;
+}
+
+/* Loads the cooked texture of the image with the given virtual path from 
+ * the data pack or the data directory. Returns NULL if there is none. */
+static ALLEGRO_BITMAP * fifi_load_cooked(const char * vpath) {
+  char cooked[FIFI_VPATH_MAX];
+  ALLEGRO_BITMAP * data = NULL;
+  ALLEGRO_PATH   * path;
+  ALLEGRO_FILE   * file;
+  if (!cook_vpath(cooked, sizeof(cooked), vpath)) return NULL;
+  file = fifi_pack_fopen(cooked);
+  if (file) {
+    data = cook_load_bitmap_f(file);
+    al_fclose(file);
+    pack_forget(fifi_pack_, cooked);
+    return data;
+  }
+  path = fifi_cooked_path(vpath);
+  if (!path) return NULL;
+  data = cook_load_bitmap(PATH_CSTR(path));
+  al_destroy_path(path);
+  return data;
+}
+
 /**
 * Loads a bitmap from the data directory, with the given virtual path, 
-* and parameters as per al_load_bitmap_flags. 
+* and parameters as per al_load_bitmap_flags. A cooked texture of the image
+* is used in stead if there is a fresh one.
 */
 ALLEGRO_BITMAP * fifi_load_bitmap_flags(const char * vpath, int flags) {
   ALLEGRO_BITMAP      * data = NULL;
   ALLEGRO_PATH        * path;  
+  ALLEGRO_FILE        * file;
+  if (cook_flags_ok(flags)) {
+    data = fifi_load_cooked(vpath);
+    if (data) return data;
+  }
+  file = fifi_pack_fopen(vpath);
+  if (file) {
+    data = al_load_bitmap_flags_f(file, fifi_vpath_extension(vpath), flags);
+    al_fclose(file);
+    pack_forget(fifi_pack_, vpath);
+    return data;
+  }
   path         = fifi_data_vpath(vpath);
   if (!path) return NULL;
   data = al_load_bitmap_flags(PATH_CSTR(path), flags);
@@ -0,0 +1,255 @@
+#include "framecache.h"
+#include "mem.h"
+#include <string.h>
+
+/*
+ * The frame cache is a fixed size hash table with chaining, of which the
+ * entries are also kept in a least recently used list. When adding a bitmap
+ * would make the cache go over it's memory budget, or when all entries are in
+ * use, the least recently used bitmaps are destroyed.
+ *
+ * The sprite states build the keys and composite the bitmaps, the cache only
+ * stores them. A sprite state that changes the tint or visibility of a layer
+ * simply gets a different key, and the bitmaps for the old key are evicted
+ * once they are no longer used.
+ */
+
+#define FRAMECACHE_BUCKETS (FRAMECACHE_ENTRIES * 2)
+
+struct FrameCacheEntry_ {
+  FrameCacheKey key;
+  uint32_t      hash;
+  Image       * image;
+  Point         origin;
+  long          bytes;
+  /* Next entry in the same hash bucket or in the free list, or -1. */
+  int           next;
+  /* Neighbours in the least recently used list, or -1. */
+  int           older;
+  int           newer;
+};
+
+static struct FrameCacheEntry_ framecache_entries[FRAMECACHE_ENTRIES];
+static int             framecache_buckets[FRAMECACHE_BUCKETS];
+static int             framecache_free_entry = -1;
+static int             framecache_newest     = -1;
+static int             framecache_oldest     = -1;
+static int             framecache_ready      = FALSE;
+static FrameCacheStats framecache_stats_now  = { 0, 0, 0, 0,
+                                                 FRAMECACHE_BUDGET_DEFAULT, 0 };
+
+
+/* Sets up the buckets and the free list. */
+static void framecache_setup(void) {
+  int index;
+  for (index = 0; index < FRAMECACHE_BUCKETS; index++) {
+    framecache_buckets[index] = -1;
+  }
+  for (index = 0; index < FRAMECACHE_ENTRIES; index++) {
+    framecache_entries[index].image = NULL;
+    framecache_entries[index].next  = index + 1;
+  }
+  framecache_entries[FRAMECACHE_ENTRIES - 1].next = -1;
+  framecache_free_entry = 0;
+  framecache_newest     = -1;
+  framecache_oldest     = -1;
+  framecache_ready      = TRUE;
+}
+
+/** Hashes the parts of the key that describe the layer settings. These only
+ * change when a layer is tinted or hidden, so sprite states can keep the
+ * result around and pass it to framecache_hash. */
+uint32_t framecache_config_hash(FrameCacheKey * key) {
+  uint32_t hash = MEM_FNV32_BASIS;
+  hash = mem_fnv32(hash, &key->hidden, sizeof(key->hidden));
+  hash = mem_fnv32(hash, &key->tinted, sizeof(key->tinted));
+  return mem_fnv32(hash, key->tints, sizeof(key->tints));
+}
+
+/** Hashes the key, given the result of framecache_config_hash for it. */
+uint32_t framecache_hash(FrameCacheKey * key, uint32_t config_hash) {
+  uint32_t hash = config_hash;
+  hash = mem_fnv32(hash, &key->sprite, sizeof(key->sprite));
+  hash = mem_fnv32(hash, &key->action, sizeof(key->action));
+  return mem_fnv32(hash, &key->frame, sizeof(key->frame));
+}
+
+/* Removes the entry at index from the least recently used list. */
+static void framecache_unlink(int index) {
+  struct FrameCacheEntry_ * entry = framecache_entries + index;
+  if (entry->older >= 0) {
+    framecache_entries[entry->older].newer = entry->newer;
+  } else {
+    framecache_oldest = entry->newer;
+  }
+  if (entry->newer >= 0) {
+    framecache_entries[entry->newer].older = entry->older;
+  } else {
+    framecache_newest = entry->older;
+  }
+  entry->older = entry->newer = -1;
+}
+
+/* Puts the entry at index at the newest end of the least recently used list. */
+static void framecache_link_newest(int index) {
+  struct FrameCacheEntry_ * entry = framecache_entries + index;
+  entry->older = framecache_newest;
+  entry->newer = -1;
+  if (framecache_newest >= 0) {
+    framecache_entries[framecache_newest].newer = index;
+  }
+  framecache_newest = index;
+  if (framecache_oldest < 0) framecache_oldest = index;
+}
+
+/* Destroys the bitmap of the entry at index and puts it on the free list. */
+static void framecache_remove(int index) {
+  struct FrameCacheEntry_ * entry = framecache_entries + index;
+  int * link = framecache_buckets + (entry->hash % FRAMECACHE_BUCKETS);
+  while ((*link) >= 0) {
+    if ((*link) == index) {
+      (*link) = entry->next;
+      break;
+    }
+    link = &framecache_entries[*link].next;
+  }
+  framecache_unlink(index);
+  al_destroy_bitmap(entry->image);
+  entry->image = NULL;
+  framecache_stats_now.bytes -= entry->bytes;
+  framecache_stats_now.entries--;
+  entry->next  = framecache_free_entry;
+  framecache_free_entry = index;
+}
+
+/* Evicts the least recently used entries until there is room for an entry
+ * of bytes. */
+static void framecache_make_room(long bytes) {
+  while ((framecache_oldest >= 0) &&
+         ((framecache_free_entry < 0) ||
+          ((framecache_stats_now.bytes + bytes) > framecache_stats_now.budget))) {
+    framecache_remove(framecache_oldest);
+    framecache_stats_now.evictions++;
+  }
+}
+
+/** Looks up the cached bitmap for the key, which must have the given hash.
+ * Returns it and stores the position to draw it at relative to the sprite's
+ * position in origin, or returns NULL if the bitmap is not in the cache.
+ * The bitmap is owned by the cache, and should be drawn right away. */
+Image * framecache_get(FrameCacheKey * key, uint32_t hash, Point * origin) {
+  int index;
+  if (!framecache_ready || !key) return NULL;
+  index = framecache_buckets[hash % FRAMECACHE_BUCKETS];
+  while (index >= 0) {
+    struct FrameCacheEntry_ * entry = framecache_entries + index;
+    if ((entry->hash == hash) &&
+        (memcmp(&entry->key, key, sizeof(FrameCacheKey)) == 0)) {
+      if (framecache_newest != index) {
+        framecache_unlink(index);
+        framecache_link_newest(index);
+      }
+      framecache_stats_now.hits++;
+      if (origin) (*origin) = entry->origin;
+      return entry->image;
+    }
+    index = entry->next;
+  }
+  framecache_stats_now.misses++;
+  return NULL;
+}
+
+/** Puts the bitmap for the key, which must have the given hash, in the cache.
+ * The cache takes ownership of the bitmap. If the bitmap is larger than the
+ * budget of the cache, it's destroyed and NULL is returned, otherwise the
+ * bitmap is returned. */
+Image * framecache_put(FrameCacheKey * key, uint32_t hash,
+                       Image * image, Point origin) {
+  struct FrameCacheEntry_ * entry;
+  int index, bucket;
+  long bytes;
+  if (!key || !image) return NULL;
+  if (!framecache_ready) framecache_setup();
+  bytes = 4L * al_get_bitmap_width(image) * al_get_bitmap_height(image);
+  if (!framecache_fits(al_get_bitmap_width(image), 
+                       al_get_bitmap_height(image))) {
+    al_destroy_bitmap(image);
+    return NULL;
+  }
+  framecache_make_room(bytes);
+  index                 = framecache_free_entry;
+  entry                 = framecache_entries + index;
+  framecache_free_entry = entry->next;
+  entry->key            = (*key);
+  entry->hash           = hash;
+  entry->image          = image;
+  entry->origin         = origin;
+  entry->bytes          = bytes;
+  bucket                = hash % FRAMECACHE_BUCKETS;
+  entry->next           = framecache_buckets[bucket];
+  framecache_buckets[bucket] = index;
+  framecache_link_newest(index);
+  framecache_stats_now.bytes += bytes;
+  framecache_stats_now.entries++;
+  return image;
+}
+
+/** Removes all bitmaps made from the given sprite from the cache. Must be
+ * called when a sprite is changed or freed. Returns the amount removed. */
+int framecache_drop_sprite(void * sprite) {
+  int index, next, dropped = 0;
+  if (!framecache_ready) return 0;
+  for (index = framecache_oldest; index >= 0; index = next) {
+    next = framecache_entries[index].newer;
+    if (framecache_entries[index].key.sprite == sprite) {
+      framecache_remove(index);
+      dropped++;
+    }
+  }
+  return dropped;
+}
+
+/** Removes all bitmaps from the cache. */
+void framecache_clear(void) {
+  if (!framecache_ready) return;
+  while (framecache_oldest >= 0) {
+    framecache_remove(framecache_oldest);
+  }
+}
+
+/** Cleans up the frame cache. Must be called before the display is
+ * destroyed. */
+void framecache_done(void) {
+  framecache_clear();
+}
+
+/** Returns true if a bitmap of w by h pixels can be put in the cache, that is,
+ * if the cache is enabled and the bitmap isn't larger than the budget. Check
+ * this before compositing a bitmap that framecache_put would only destroy. */
+bool framecache_fits(int w, int h) {
+  long bytes = 4L * w * h;
+  return (framecache_stats_now.budget > 0) && 
+         (bytes <= framecache_stats_now.budget);
+}
+
+/** Returns the upper bound of the memory used by the frame cache in bytes. */
+long framecache_budget(void) {
+  return framecache_stats_now.budget;
+}
+
+/** Sets the upper bound of the memory used by the frame cache in bytes,
+ * evicting bitmaps if needed. A budget of 0 disables the cache.
+ * Returns the new budget. */
+long framecache_budget_(long budget) {
+  if (budget < 0) budget = 0;
+  framecache_stats_now.budget = budget;
+  if (framecache_ready) framecache_make_room(0);
+  return budget;
+}
+
+/** Copies the statistics of the frame cache into stats. */
+bool framecache_stats(FrameCacheStats * stats) {
+  if (!stats) return false;
+  (*stats) = framecache_stats_now;
+  return true;
+}
@@ -15,6 +15,9 @@
 #include "store.h"
 #include "scegra.h"
 #include "callrb.h"
+#include "cook.h"
+#include "scriptcache.h"
+#include <string.h>
 
 
 
@@ -64,9 +67,8 @@ React * main_react_key_down(React * self, ALLEGRO_KEYBOARD_EVENT * event) {
       bbconsole_active_(state_console(state), FALSE);
     break;  
     case ALLEGRO_KEY_F5:
-      /* Reload main script (and hence all other scripts that it loads)  on F5 */
-      rh_load_main();
-      callrb_on_reload();
+      /* Reload the scripts that changed on F5 */
+      rh_reload_main();
     break;    
     /* Emergency exit keys. */
     case ALLEGRO_KEY_F12:
@@ -141,6 +143,8 @@ int real_main(void) {
   /* Main game loop, controlled by the State object. */  
   while(state_busy(state)) { 
       react_poll(&react, state);
+      /* Reload changed scripts automatically if they are being watched. */
+      if (scriptcache_poll()) rh_reload_main();
       state_update(state);
       state_draw(state);
       state_flip_display(state);
@@ -151,10 +155,95 @@ int real_main(void) {
 }
 
 
+/* Cooks the images in the given data directories, or in the image, sprite 
+ * and texture directories if none are given, and exits. Run as
+ * eruta --cook [--deflate] [--force] [vpath...] */
+int cook_main(int argc, char * argv[]) {
+  static char * dirs[] = { "image", "sprite", "texture", NULL };
+  char ** vpaths = dirs;
+  int method     = COOK_STORE;
+  bool force     = false;
+  int index, total = 0;
+  while ((argc > 0) && (strncmp(argv[0], "--", 2) == 0)) {
+    if (strcmp(argv[0], "--deflate") == 0) method = COOK_DEFLATE;
+    if (strcmp(argv[0], "--force") == 0)   force  = true;
+    argc--; argv++;
+  }
+  if (argc > 0) vpaths = argv;
+  if (!al_init() || !al_init_image_addon() || !fifi_init()) {
+    fprintf(stderr, "Could not initialize to cook textures.\n");
+    return 1;
+  }
+  for (index = 0; ((argc > 0) ? (index < argc) : (vpaths[index] != NULL)); 
+       index++) {
+    ALLEGRO_PATH * path = fifi_data_vpath(vpaths[index]);
+    int cooked;
+    if (!path) continue;
+    cooked = cook_tree(PATH_CSTR(path), method, force);
+    if (cooked < 0) {
+      fprintf(stderr, "Could not read %s\n", PATH_CSTR(path));
+    } else {
+      printf("Cooked %d images in %s\n", cooked, PATH_CSTR(path));
+      total += cooked;
+    }
+    al_destroy_path(path);
+  }
+  printf("Cooked %d images.\n", total);
+  return 0;
+}
+
+/* Compiles the scripts in the given data directories, or in the script
+ * directory if none are given, to bytecode in the script cache, and exits.
+ * Run as eruta --compile [--force] [vpath...] */
+int compile_main(int argc, char * argv[]) {
+  static char * dirs[] = { "script", NULL };
+  char ** vpaths = dirs;
+  bool force     = false;
+  Ruby * ruby;
+  int index, total = 0;
+  while ((argc > 0) && (strncmp(argv[0], "--", 2) == 0)) {
+    if (strcmp(argv[0], "--force") == 0) force = true;
+    argc--; argv++;
+  }
+  if (argc > 0) vpaths = argv;
+  if (!al_init() || !fifi_init()) {
+    fprintf(stderr, "Could not initialize to compile scripts.\n");
+    return 1;
+  }
+  ruby = rh_new();
+  if (!ruby) {
+    fprintf(stderr, "Could not start mruby to compile scripts.\n");
+    return 1;
+  }
+  for (index = 0; ((argc > 0) ? (index < argc) : (vpaths[index] != NULL)); 
+       index++) {
+    int compiled = scriptcache_tree(ruby, vpaths[index], force);
+    if (compiled < 0) {
+      fprintf(stderr, "Could not read %s\n", vpaths[index]);
+    } else {
+      printf("Compiled %d scripts in %s\n", compiled, vpaths[index]);
+      total += compiled;
+    }
+  }
+  rh_free(ruby);
+  printf("Compiled %d scripts.\n", total);
+  return 0;
+}
+
+
 int main(int argc, char* argv[]) {
   int res; // init xml parser
   // LIBXML_TEST_VERSION
-  (void) argc, (void) argv;
+  if ((argc > 1) && (strcmp(argv[1], "--cook") == 0)) {
+    return cook_main(argc - 2, argv + 2);
+  }
+  if ((argc > 1) && (strcmp(argv[1], "--compile") == 0)) {
+    return compile_main(argc - 2, argv + 2);
+  }
+  /* To compare the pooled script allocator with plain malloc. */
+  if ((argc > 1) && (strcmp(argv[1], "--system-malloc") == 0)) {
+    rh_allocator_(RH_ALLOC_SYSTEM);
+  }
   res = real_main();
   // cleanup xml parser
   // xmlCleanupParser();
@@ -36,7 +36,6 @@ struct MazeItem_ {
 };
 
 struct MazeWall_ {
-  ALLEGRO_BITMAP * texture_bmp;
   int         used;
   int         direction;
   int         texture;
@@ -252,8 +251,9 @@ MazeWall * maze_get_wall(Maze * me, int z, int x, int y, int dir) {
 
 MazeWall * mazewall_set_texture(MazeWall * wall, int texture) {
   if (!wall) return NULL;
+  /* The bitmap is fetched from the store when the wall is drawn, since the 
+   * store may evict it in the mean time. */
   wall->texture      = texture;
-  wall->texture_bmp  = store_get_bitmap(wall->texture);
   return wall;
 } 
 
@@ -360,7 +360,7 @@ void mazewall_draw(MazeWall * wall, int z, int x, int y, int dir) {
   al_compose_transform(&model, &camera);
   al_use_transform(&model);
   /* swap of y and z is intentional! */
-  draw_wall(0.0, 0.0, 0.0, 2.0, 2.0, colors, wall->texture_bmp);
+  draw_wall(0.0, 0.0, 0.0, 2.0, 2.0, colors, store_get_bitmap(wall->texture));
 
   /* Restore the camera transform. */
   al_use_transform(&camera);
@@ -60,6 +60,42 @@ void * mem_move(void * dest, void * src, size_t size) {
   return memmove(dest , src, size);
 }
 
+/** Reads a 32 bits little endian number. */
+uint32_t mem_get32(const unsigned char * at) {
+  return ((uint32_t) at[0])         | (((uint32_t) at[1]) << 8) |
+         (((uint32_t) at[2]) << 16) | (((uint32_t) at[3]) << 24);
+}
+
+/** Writes a 32 bits little endian number. */
+void mem_put32(unsigned char * at, uint32_t value) {
+  at[0] = value & 0xff;
+  at[1] = (value >> 8)  & 0xff;
+  at[2] = (value >> 16) & 0xff;
+  at[3] = (value >> 24) & 0xff;
+}
+
+/** 32 bits FNV-1a hash of size bytes at data, continuing from hash. */
+uint32_t mem_fnv32(uint32_t hash, const void * data, size_t size) {
+  const unsigned char * bytes = data;
+  size_t index;
+  for (index = 0; index < size; index++) {
+    hash ^= bytes[index];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/** 64 bits FNV-1a hash of size bytes at data, continuing from hash. */
+uint64_t mem_fnv64(uint64_t hash, const void * data, size_t size) {
+  const unsigned char * bytes = data;
+  size_t index;
+  for (index = 0; index < size; index++) {
+    hash ^= bytes[index];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
 /* Thoughts on hierarchical data structures.
 * Often, in C data is allocatedin a hierarchical way. 
 * It's useful to have functions that take this into consideration...
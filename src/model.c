@@ -43,7 +43,8 @@ struct Model_ {
   int               nverts;
   int               nfaces;  
   
-  ALLEGRO_BITMAP  * texture;
+  /* Index of the texture in the store, or negative for none. */
+  int               texture;
   Vec3d             position;
   Vec3d             speed;
   Vec3d             size;
@@ -147,7 +148,7 @@ Model * model_init(Model * me) {
   me->size      = vec3d(1.0, 1.0, 1.0);
   me->sverts    = MODEL_VERTEX_SPACE;
   me->sfaces    = MODEL_FACE_SPACE;
-  me->texture   = NULL;
+  me->texture   = -1;
   me->vertices  = calloc(MODEL_VERTEX_SPACE, sizeof(*me->vertices));
   me->faces     = calloc(MODEL_FACE_SPACE  , sizeof(*me->faces));  
   me->objfile   = NULL;
@@ -239,7 +240,9 @@ Model * model_convert_from_objfile(Model * me , ObjFile * objfile);
  * This entails a full scale recalculation of the model from it's object file.
  */
 int model_set_texture(Model * me, int texture) {
-    me->texture = store_get_bitmap(texture);
+    /* The bitmap is fetched from the store when the model is drawn, since
+     * the store may evict it in the mean time. */
+    me->texture = texture;
     // model_convert_from_objfile(me , me->objfile);
     return texture;
 }
@@ -310,7 +313,7 @@ void model_draw(Model * me) {
   /* Disable the depth test */
   // al_set_render_state(ALLEGRO_DEPTH_TEST, 0);
   
-  al_draw_indexed_prim(me->vertices, me->vdecl, me->texture, me->faces, me->nfaces, ALLEGRO_PRIM_TRIANGLE_LIST);
+  al_draw_indexed_prim(me->vertices, me->vdecl, store_get_bitmap(me->texture), me->faces, me->nfaces, ALLEGRO_PRIM_TRIANGLE_LIST);
   
   
   /* Re-enable the depth test */
@@ -0,0 +1,345 @@
+#if defined(__unix__) || defined(__APPLE__)
+/* Needed for mmap with -std=c99. */
+#define _POSIX_C_SOURCE 200112L
+#define PACK_USE_MMAP 1
+#endif
+
+#include "eruta.h"
+#include "mem.h"
+#include "monolog.h"
+#include "pack.h"
+#include <string.h>
+
+#ifdef PACK_USE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
+
+/*
+ * The whole pack is in memory at base, either mapped or read in. The
+ * directory is parsed into entries once when the pack is opened. Since the
+ * directory is sorted by name, entries are found with a binary search.
+ */
+
+typedef struct PackEntry_ PackEntry;
+
+struct PackEntry_ {
+  const char    * name;
+  int             method;
+  size_t          offset;
+  size_t          packed_size;
+  size_t          size;
+  /* Inflated data of a deflated entry, made when first used. */
+  unsigned char * inflated;
+  /* Amount of pack_data calls for the inflated data that pack_forget 
+   * hasn't released yet. */
+  int             uses;
+};
+
+struct Pack_ {
+  unsigned char * base;
+  size_t          size;
+  int             mapped;
+  int             count;
+  PackEntry     * entries;
+};
+
+
+/* Gets the contents of the file into the pack, mapped if possible. */
+static bool pack_load(Pack * self, const char * filename) {
+  FILE * file;
+  long   size;
+#ifdef PACK_USE_MMAP
+  struct stat info;
+  int fd = open(filename, O_RDONLY);
+  if (fd >= 0) {
+    if ((fstat(fd, &info) == 0) && (info.st_size > 0)) {
+      void * map = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+        self->base   = map;
+        self->size   = info.st_size;
+        self->mapped = TRUE;
+        close(fd);
+        return true;
+      }
+    }
+    close(fd);
+  }
+#endif
+  file = fopen(filename, "rb");
+  if (!file) return false;
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (size > 0) self->base = mem_alloc(size);
+  if (self->base && (fread(self->base, 1, size, file) == (size_t) size)) {
+    self->size   = size;
+    self->mapped = FALSE;
+    fclose(file);
+    return true;
+  }
+  self->base = mem_free(self->base);
+  fclose(file);
+  return false;
+}
+
+/* Parses and checks the header and directory of the pack. */
+static bool pack_parse(Pack * self) {
+  uint32_t version, dir_offset, names_offset, names_size;
+  int index;
+  if (self->size < PACK_HEADER_SIZE) return false;
+  if (memcmp(self->base, PACK_MAGIC, 4) != 0) return false;
+  version      = mem_get32(self->base + 4);
+  self->count  = mem_get32(self->base + 8);
+  dir_offset   = mem_get32(self->base + 12);
+  names_offset = mem_get32(self->base + 16);
+  names_size   = mem_get32(self->base + 20);
+  if (version != PACK_VERSION) return false;
+  if ((self->count < 0) ||
+      (dir_offset + ((size_t) self->count) * PACK_ENTRY_SIZE > self->size) ||
+      (((size_t) names_offset) + names_size > self->size)) return false;
+  self->entries = STRUCT_NALLOC(PackEntry, self->count > 0 ? self->count : 1);
+  if (!self->entries) return false;
+  for (index = 0; index < self->count; index++) {
+    const unsigned char * at = self->base + dir_offset +
+                               index * PACK_ENTRY_SIZE;
+    PackEntry * entry  = self->entries + index;
+    uint32_t name_at   = mem_get32(at);
+    uint32_t name_size = mem_get32(at + 4);
+    /* The name must fit and be 0 terminated. */
+    if ((((size_t) name_at) + name_size >= names_size) ||
+        (self->base[names_offset + name_at + name_size] != '\0')) {
+      return false;
+    }
+    entry->name        = (const char *) self->base + names_offset + name_at;
+    entry->method      = mem_get32(at + 8);
+    entry->offset      = mem_get32(at + 16);
+    entry->packed_size = mem_get32(at + 20);
+    entry->size        = mem_get32(at + 24);
+    entry->inflated    = NULL;
+    entry->uses        = 0;
+    if ((entry->method != PACK_STORE) && (entry->method != PACK_DEFLATE)) {
+      return false;
+    }
+    /* Stored entries are used in place, so their size must be what's in the
+     * pack. The sizes are checked one by one so the sum can't overflow. */
+    if ((entry->method == PACK_STORE) && 
+        (entry->size != entry->packed_size)) return false;
+    if ((entry->offset > self->size) ||
+        (entry->packed_size > self->size - entry->offset)) return false;
+  }
+  return true;
+}
+
+/** Opens the pack file with the given file name. Returns NULL if it doesn't
+ * exist or isn't a valid pack. */
+Pack * pack_open(const char * filename) {
+  Pack * self;
+  if (!filename) return NULL;
+  self = STRUCT_NALLOC(Pack, 1);
+  if (!self) return NULL;
+  if (!pack_load(self, filename)) return mem_free(self);
+  if (!pack_parse(self)) {
+    LOG_WARNING("%s is not a valid pack file.\n", filename);
+    return pack_close(self);
+  }
+  return self;
+}
+
+/** Closes the pack. Data gotten from the pack can't be used anymore
+ * afterwards. Returns NULL. */
+Pack * pack_close(Pack * self) {
+  int index;
+  if (!self) return NULL;
+  if (self->entries) {
+    for (index = 0; index < self->count; index++) {
+      mem_free(self->entries[index].inflated);
+    }
+    mem_free(self->entries);
+  }
+#ifdef PACK_USE_MMAP
+  if (self->mapped) {
+    munmap(self->base, self->size);
+    self->base = NULL;
+  }
+#endif
+  mem_free(self->base);
+  return mem_free(self);
+}
+
+/** Returns the amount of entries in the pack. */
+int pack_count(Pack * self) {
+  if (!self) return 0;
+  return self->count;
+}
+
+/** Returns the name of the entry at index, or NULL if out of range. */
+const char * pack_name(Pack * self, int index) {
+  if (!self || (index < 0) || (index >= self->count)) return NULL;
+  return self->entries[index].name;
+}
+
+/** Returns the index of the entry with the given vpath, or negative if the
+ * pack doesn't have it. */
+int pack_find(Pack * self, const char * vpath) {
+  int low = 0, high;
+  if (!self || !vpath) return -1;
+  high = self->count - 1;
+  while (low <= high) {
+    int middle = low + (high - low) / 2;
+    int cmp    = strcmp(vpath, self->entries[middle].name);
+    if (cmp == 0) return middle;
+    if (cmp < 0) high = middle - 1; else low = middle + 1;
+  }
+  return -2;
+}
+
+/** Returns true if the pack has an entry with the given vpath. */
+bool pack_has(Pack * self, const char * vpath) {
+  return pack_find(self, vpath) >= 0;
+}
+
+/** Returns the data of the entry with the given vpath and stores its size
+ * in size, or returns NULL if there is no such entry or it can't be inflated.
+ * Stored entries are used in place. The data stays valid until the pack is
+ * closed, or, for a deflated entry, until each pack_data call for it is
+ * matched by a pack_forget call. */
+const void * pack_data(Pack * self, const char * vpath, size_t * size) {
+  PackEntry * entry;
+  int index = pack_find(self, vpath);
+  if (index < 0) return NULL;
+  entry = self->entries + index;
+  if (entry->method == PACK_DEFLATE) {
+    if (!entry->inflated) {
+      size_t done;
+      entry->inflated = mem_alloc(entry->size > 0 ? entry->size : 1);
+      if (!entry->inflated) return NULL;
+      done = tinfl_decompress_mem_to_mem(entry->inflated, entry->size,
+                                         self->base + entry->offset,
+                                         entry->packed_size, 0);
+      if (done != entry->size) {
+        LOG_WARNING("Could not inflate %s from pack.\n", vpath);
+        entry->inflated = mem_free(entry->inflated);
+        return NULL;
+      }
+    }
+    entry->uses++;
+    if (size) (*size) = entry->size;
+    return entry->inflated;
+  }
+  if (size) (*size) = entry->size;
+  return self->base + entry->offset;
+}
+
+/** Releases data gotten with pack_data once it isn't needed anymore, after
+ * it was loaded. The inflated data of a deflated entry is freed when all uses
+ * of it are released, so data that is still used elsewhere stays valid.
+ * Returns true if inflated data was freed. */
+bool pack_forget(Pack * self, const char * vpath) {
+  PackEntry * entry;
+  int index = pack_find(self, vpath);
+  if (index < 0) return false;
+  entry = self->entries + index;
+  if (!entry->inflated) return false;
+  if (entry->uses > 0) entry->uses--;
+  if (entry->uses > 0) return false;
+  entry->inflated = mem_free(entry->inflated);
+  return true;
+}
+
+/** Opens the entry with the given vpath as an Allegro memory file, for use
+ * with the al_load_*_f functions. Returns NULL if there is no such entry. */
+ALLEGRO_FILE * pack_fopen(Pack * self, const char * vpath) {
+  size_t size;
+  const void * data = pack_data(self, vpath, &size);
+  if (!data) return NULL;
+  return al_open_memfile((void *) data, size, "r");
+}
+
+/* Compares the names of two pack sources for qsort. */
+static int pack_source_compare(const void * one, const void * two) {
+  const PackSource * s1 = *((const PackSource **) one);
+  const PackSource * s2 = *((const PackSource **) two);
+  return strcmp(s1->name, s2->name);
+}
+
+/* Writes size bytes of padding 0's to the file. */
+static bool pack_write_padding(FILE * file, size_t size) {
+  static const unsigned char zeroes[PACK_ALIGN] = { 0 };
+  return fwrite(zeroes, 1, size, file) == size;
+}
+
+/** Writes a pack with the given count entries to the file filename.
+ * Returns true on success. */
+bool pack_write(const char * filename, int count, PackSource * sources) {
+  PackSource   ** sorted;
+  unsigned char   header[PACK_HEADER_SIZE];
+  unsigned char   entry[PACK_ENTRY_SIZE];
+  size_t names_size = 0, name_at = 0, at;
+  size_t data_start, data_at;
+  FILE * file;
+  bool ok = true;
+  int index;
+  if (!filename || (count < 0) || (!sources && (count > 0))) return false;
+  sorted = STRUCT_NALLOC(PackSource *, count > 0 ? count : 1);
+  if (!sorted) return false;
+  for (index = 0; index < count; index++) {
+    sorted[index] = sources + index;
+    names_size   += strlen(sources[index].name) + 1;
+  }
+  qsort(sorted, count, sizeof(PackSource *), pack_source_compare);
+  file = fopen(filename, "wb");
+  if (!file) {
+    mem_free(sorted);
+    return false;
+  }
+  at         = PACK_HEADER_SIZE + ((size_t) count) * PACK_ENTRY_SIZE;
+  data_start = (at + names_size + PACK_ALIGN - 1) & ~((size_t) PACK_ALIGN - 1);
+  memset(header, 0, sizeof(header));
+  memcpy(header, PACK_MAGIC, 4);
+  mem_put32(header + 4 , PACK_VERSION);
+  mem_put32(header + 8 , count);
+  mem_put32(header + 12, PACK_HEADER_SIZE);
+  mem_put32(header + 16, at);
+  mem_put32(header + 20, names_size);
+  mem_put32(header + 24, PACK_ALIGN);
+  ok = ok && (fwrite(header, 1, sizeof(header), file) == sizeof(header));
+  data_at = data_start;
+  for (index = 0; index < count; index++) {
+    PackSource * source = sorted[index];
+    size_t packed = (source->method == PACK_DEFLATE) ? source->packed_size
+                                                     : source->size;
+    memset(entry, 0, sizeof(entry));
+    mem_put32(entry     , name_at);
+    mem_put32(entry + 4 , strlen(source->name));
+    mem_put32(entry + 8 , source->method);
+    mem_put32(entry + 16, data_at);
+    mem_put32(entry + 20, packed);
+    mem_put32(entry + 24, source->size);
+    ok = ok && (fwrite(entry, 1, sizeof(entry), file) == sizeof(entry));
+    name_at += strlen(source->name) + 1;
+    data_at  = (data_at + packed + PACK_ALIGN - 1) &
+               ~((size_t) PACK_ALIGN - 1);
+  }
+  for (index = 0; index < count; index++) {
+    const char * name = sorted[index]->name;
+    ok = ok && (fwrite(name, 1, strlen(name) + 1, file) == strlen(name) + 1);
+  }
+  ok = ok && pack_write_padding(file, data_start - at - names_size);
+  for (index = 0; index < count; index++) {
+    PackSource * source = sorted[index];
+    size_t packed = (source->method == PACK_DEFLATE) ? source->packed_size
+                                                     : source->size;
+    size_t padded = (packed + PACK_ALIGN - 1) & ~((size_t) PACK_ALIGN - 1);
+    ok = ok && (fwrite(source->data, 1, packed, file) == packed);
+    ok = ok && pack_write_padding(file, padded - packed);
+  }
+  if (fclose(file) != 0) ok = false;
+  mem_free(sorted);
+  return ok;
+}
@@ -0,0 +1,212 @@
+#include "pickgrid.h"
+#include <string.h>
+
+
+/* A cell of the pick grid, with the id's of the rectangles that overlap it. */
+struct PickGridCell_ {
+  int * ids;
+  int   used;
+  int   size;
+};
+
+/* What the pick grid knows of a rectangle. */
+struct PickGridEntry_ {
+  float x, y, w, h;
+  /* Range of cells the rectangle overlaps, inclusive. */
+  int   cx1, cy1, cx2, cy2;
+  int   active;
+};
+
+struct PickGrid_ {
+  struct PickGridCell_  * cells;
+  struct PickGridEntry_ * entries;
+  int                     ids_max;
+  int                     cols;
+  int                     rows;
+  float                   cell_w;
+  float                   cell_h;
+};
+
+
+/** Allocates a new, uninitialized PickGrid. */
+PickGrid * pickgrid_alloc(void) {
+  return STRUCT_ALLOC(PickGrid);
+}
+
+/** Initializes a pick grid that covers an area of w by h with cells of
+ * cell_w by cell_h, and that can store rectangles with ids from 0 up to
+ * ids_max. Returns NULL on error. */
+PickGrid * pickgrid_init(PickGrid * self, float w, float h,
+                         float cell_w, float cell_h, int ids_max) {
+  if (!self) return NULL;
+  if ((cell_w <= 0.0) || (cell_h <= 0.0) || (ids_max < 1)) return NULL;
+  self->cell_w  = cell_w;
+  self->cell_h  = cell_h;
+  self->cols    = (int) ceil(w / cell_w);
+  self->rows    = (int) ceil(h / cell_h);
+  if (self->cols < 1) self->cols = 1;
+  if (self->rows < 1) self->rows = 1;
+  self->ids_max = ids_max;
+  self->cells   = STRUCT_NALLOC(struct PickGridCell_, self->cols * self->rows);
+  self->entries = STRUCT_NALLOC(struct PickGridEntry_, ids_max);
+  return self;
+}
+
+/** Allocates and initializes a new pick grid. */
+PickGrid * pickgrid_new(float w, float h, float cell_w, float cell_h,
+                        int ids_max) {
+  PickGrid * self = pickgrid_alloc();
+  if (!pickgrid_init(self, w, h, cell_w, cell_h, ids_max)) {
+    return mem_free(self);
+  }
+  return self;
+}
+
+/** Cleans up the pick grid. */
+PickGrid * pickgrid_done(PickGrid * self) {
+  int index;
+  if (!self) return NULL;
+  if (self->cells) {
+    for (index = 0; index < (self->cols * self->rows); index++) {
+      mem_free(self->cells[index].ids);
+    }
+  }
+  self->cells   = mem_free(self->cells);
+  self->entries = mem_free(self->entries);
+  self->ids_max = 0;
+  return self;
+}
+
+/** Cleans up and frees the pick grid. Returns NULL. */
+PickGrid * pickgrid_free(PickGrid * self) {
+  pickgrid_done(self);
+  return mem_free(self);
+}
+
+/* Returns the cell at the given column and row. No checks. */
+static struct PickGridCell_ * pickgrid_cell(PickGrid * self, int cx, int cy) {
+  return self->cells + (cy * self->cols) + cx;
+}
+
+/* Returns the column for x, clamped to the grid. */
+static int pickgrid_col(PickGrid * self, float x) {
+  int cx = (int) floor(x / self->cell_w);
+  if (cx < 0)           return 0;
+  if (cx >= self->cols) return self->cols - 1;
+  return cx;
+}
+
+/* Returns the row for y, clamped to the grid. */
+static int pickgrid_row(PickGrid * self, float y) {
+  int cy = (int) floor(y / self->cell_h);
+  if (cy < 0)           return 0;
+  if (cy >= self->rows) return self->rows - 1;
+  return cy;
+}
+
+/* Adds id to the cell, growing it if needed. */
+static void pickgridcell_add(struct PickGridCell_ * cell, int id) {
+  if (cell->used >= cell->size) {
+    int newsize = (cell->size < 1) ? 8 : cell->size * 2;
+    cell->ids   = mem_realloc(cell->ids, newsize * sizeof(int));
+    cell->size  = newsize;
+  }
+  cell->ids[cell->used] = id;
+  cell->used++;
+}
+
+/* Removes id from the cell. The order of the ids is not kept. */
+static void pickgridcell_remove(struct PickGridCell_ * cell, int id) {
+  int index;
+  for (index = 0; index < cell->used; index++) {
+    if (cell->ids[index] == id) {
+      cell->used--;
+      cell->ids[index] = cell->ids[cell->used];
+      return;
+    }
+  }
+}
+
+/* Removes the entry for id from the cells it is in. */
+static void pickgrid_unlink(PickGrid * self, int id) {
+  struct PickGridEntry_ * entry = self->entries + id;
+  int cx, cy;
+  for (cy = entry->cy1; cy <= entry->cy2; cy++) {
+    for (cx = entry->cx1; cx <= entry->cx2; cx++) {
+      pickgridcell_remove(pickgrid_cell(self, cx, cy), id);
+    }
+  }
+  entry->active = FALSE;
+}
+
+/** Puts or moves the rectangle with the given id in the grid.
+ * Cheap if the rectangle stays in the same cells.
+ * Returns id on success or negative on error. */
+int pickgrid_put(PickGrid * self, int id, float x, float y, float w, float h) {
+  struct PickGridEntry_ * entry;
+  int cx1, cy1, cx2, cy2, cx, cy;
+  if (!self || !self->entries)          return -1;
+  if ((id < 0) || (id >= self->ids_max)) return -2;
+  entry = self->entries + id;
+  cx1   = pickgrid_col(self, x);
+  cy1   = pickgrid_row(self, y);
+  cx2   = pickgrid_col(self, x + w);
+  cy2   = pickgrid_row(self, y + h);
+  if (entry->active) {
+    if ((entry->cx1 == cx1) && (entry->cy1 == cy1) &&
+        (entry->cx2 == cx2) && (entry->cy2 == cy2)) {
+      entry->x = x; entry->y = y; entry->w = w; entry->h = h;
+      return id;
+    }
+    pickgrid_unlink(self, id);
+  }
+  entry->x   = x  ; entry->y   = y  ; entry->w   = w  ; entry->h   = h;
+  entry->cx1 = cx1; entry->cy1 = cy1; entry->cx2 = cx2; entry->cy2 = cy2;
+  for (cy = cy1; cy <= cy2; cy++) {
+    for (cx = cx1; cx <= cx2; cx++) {
+      pickgridcell_add(pickgrid_cell(self, cx, cy), id);
+    }
+  }
+  entry->active = TRUE;
+  return id;
+}
+
+/** Removes the rectangle with the given id from the grid.
+ * Returns id if it was removed or negative if it wasn't in the grid. */
+int pickgrid_remove(PickGrid * self, int id) {
+  if (!self || !self->entries)          return -1;
+  if ((id < 0) || (id >= self->ids_max)) return -2;
+  if (!self->entries[id].active)        return -1;
+  pickgrid_unlink(self, id);
+  return id;
+}
+
+/** Removes all rectangles from the grid, but keeps the memory of the cells. */
+int pickgrid_clear(PickGrid * self) {
+  int index;
+  if (!self || !self->cells) return -1;
+  for (index = 0; index < (self->cols * self->rows); index++) {
+    self->cells[index].used = 0;
+  }
+  memset(self->entries, 0, sizeof(struct PickGridEntry_) * self->ids_max);
+  return 0;
+}
+
+/** Stores up to max ids of the rectangles that contain the point x, y
+ * in ids, in no particular order. Returns the amount of ids found,
+ * which may be more than max. */
+int pickgrid_query(PickGrid * self, float x, float y, int * ids, int max) {
+  struct PickGridCell_ * cell;
+  int index, found = 0;
+  if (!self || !self->cells) return 0;
+  cell = pickgrid_cell(self, pickgrid_col(self, x), pickgrid_row(self, y));
+  for (index = 0; index < cell->used; index++) {
+    int id = cell->ids[index];
+    struct PickGridEntry_ * entry = self->entries + id;
+    if ((x < entry->x) || (y < entry->y))                          continue;
+    if ((x >= (entry->x + entry->w)) || (y >= (entry->y + entry->h))) continue;
+    if (ids && (found < max)) ids[found] = id;
+    found++;
+  }
+  return found;
+}
@@ -94,27 +94,37 @@ React * react_react(React * self, ALLEGRO_EVENT * event) {
 }
 
 
+/* Routes a queued event when the events of the frame are sent. React reacts
+ * first, then if that fails, the event goes to the console, but only if it is
+ * active. Returns false if the event should go to ruby. This is decided for
+ * each event in turn, so the events after one that opens or closes the 
+ * console go to the right place. */
+static int react_route(ALLEGRO_EVENT * event, void * data) {
+  React * self        = data;
+  BBConsole * console = state_console(state_get());
+  if (react_react(self, event)) return TRUE;
+  if (bbconsole_active(console)) { 
+    bbconsole_handle((BBWidget *)console, event);
+    return TRUE;
+  }
+  return FALSE;
+}
+
 /** Polls for allegro events and reacts to them. */
 React * react_poll(React * self, void * state) {
-  int res;
   ALLEGRO_EVENT * event;
-  BBConsole * console = state_console(state);
+  Ruby * ruby = state_ruby(state_get());
 
   if(!self) return NULL;
+  rh_events_route_(react_route, self);
   // yes an assignment is fine here :)
   while( (event = state_pollnew((State *)state)) ) { 
-    /* Let react react first, then if that fails, send to the console,
-    but only if it is active. If not active, send the event to ruby */
-    if(!react_react(self, event))  { 
-      if (bbconsole_active(console)) { 
-        bbconsole_handle((BBWidget *)console, event);
-      } else {
-        rh_poll_event(state_ruby(state_get()), event);
-      }
-    }
+    rh_queue_event(ruby, event);
     event_free(event);
     // here we must free the event...
   }
+  /* Send all events of this frame at once, in order. */
+  rh_flush_events(ruby);
   return self;
 }  
 
@@ -11,18 +11,43 @@
 #include "mem.h"
 #include "fifi.h"
 #include "bad.h"
+#include "textcache.h"
 #include <rebox.h>
 #include <assert.h>
+#include <string.h>
 
 
 /** typedef int ResorDestructor(Resor * self);  */
 
+/* Loads the data of a resource again, from the vpath and the arguments it
+ * was first loaded with. */
+typedef Resor * ResorReload(const char * vpath, const int * args);
+
 struct Resor_ { 
   ResorKind             kind; 
   ResorData             data;
   ResorStatus           status;
   ResorDestructor     * free;
   ResorSaver          * saver;
+  /* Cache of text measurements, only for fonts. Made when first needed. */
+  TextCache           * textcache;
+  /* Amount of references to this resource, it's freed when the last one is 
+   * released. */
+  int                   refs;
+  /* Key describing where and how the resource was loaded, or NULL. */
+  char                * key;
+  /* When the resource was last used, as counted by the store. */
+  long                  used;
+  /* Amount of pins that keep the resource from being evicted. */
+  int                   pins;
+  /* Where and how the data was loaded, so it can be loaded again after it
+   * was evicted. reload is NULL if that's not possible. */
+  ResorReload         * reload;
+  char                * vpath;
+  int                   args[3];
+  /* Neighbours in the store's list of resources by last use. */
+  Resor               * newer;
+  Resor               * older;
 };
 
 
@@ -74,6 +99,7 @@ static int resor_free_audio_stream(Resor * self) {
 int resor_done(Resor * self) {
   int res;
   if(!self) return RESOR_NULL;
+  self->textcache = textcache_free(self->textcache);
   if(self->free) {
     res = self->free(self);
     self->kind = RESOR_NONE;
@@ -85,10 +111,264 @@ int resor_done(Resor * self) {
 /* Cleans up the contents of the resource and deallocates the memory self points to. */
 int resor_free(Resor * self) {
   int res = resor_done(self);
+  if (self) { 
+    mem_free(self->key);
+    mem_free(self->vpath);
+  }
   mem_free(self);
   return res;
 }
 
+/* Adds a reference to the resource. Returns self. */
+Resor * resor_acquire(Resor * self) {
+  if (!self) return NULL;
+  self->refs++;
+  return self;
+}
+
+/* Releases a reference to the resource, and frees it if that was the last 
+ * one. Returns the amount of references left. */
+int resor_release(Resor * self) {
+  if (!self) return 0;
+  self->refs--;
+  if (self->refs > 0) return self->refs;
+  resor_free(self);
+  return 0;
+}
+
+/* Returns the amount of references to the resource. */
+int resor_refs(Resor * self) {
+  if (!self) return 0;
+  return self->refs;
+}
+
+/* Returns the key that describes how the resource was loaded, or NULL if 
+ * not set. */
+const char * resor_key(Resor * self) {
+  if (!self) return NULL;
+  return self->key;
+}
+
+/* Sets the key that describes how the resource was loaded to a copy of key, 
+ * or clears it if key is NULL. Returns the new key. */
+const char * resor_key_(Resor * self, const char * key) {
+  if (!self) return NULL;
+  self->key = mem_free(self->key);
+  if (key) {
+    self->key = mem_alloc(strlen(key) + 1);
+    if (self->key) strcpy(self->key, key);
+  }
+  return self->key;
+}
+
+/* Returns an estimate of the memory used by the data of the resource in 
+ * bytes, or 0 if it's not known. */
+long resor_bytes(Resor * self) {
+  ALLEGRO_BITMAP * bmp;
+  ALLEGRO_SAMPLE * sample;
+  ALLEGRO_AUDIO_STREAM * stream;
+  if ((bmp = resor_bitmap(self))) {
+    return ((long) al_get_bitmap_width(bmp)) * al_get_bitmap_height(bmp) *
+           al_get_pixel_size(al_get_bitmap_format(bmp));
+  }
+  if ((sample = resor_sample(self))) {
+    return ((long) al_get_sample_length(sample)) * 
+           al_get_channel_count(al_get_sample_channels(sample)) *
+           al_get_audio_depth_size(al_get_sample_depth(sample));
+  }
+  if ((stream = resor_audio_stream(self))) {
+    /* Only the buffers are in memory. */
+    return ((long) al_get_audio_stream_fragments(stream)) * 
+           al_get_audio_stream_length(stream) *
+           al_get_channel_count(al_get_audio_stream_channels(stream)) *
+           al_get_audio_depth_size(al_get_audio_stream_depth(stream));
+  }
+  return 0;
+}
+
+/* Returns when the resource was last used. */
+long resor_used(Resor * self) {
+  if (!self) return 0;
+  return self->used;
+}
+
+/* Sets when the resource was last used. Returns stamp. */
+long resor_used_(Resor * self, long stamp) {
+  if (!self) return 0;
+  return self->used = stamp;
+}
+
+/* Returns the amount of pins that keep the resource from being evicted. */
+int resor_pins(Resor * self) {
+  if (!self) return 0;
+  return self->pins;
+}
+
+/* Adds delta to the amount of pins of the resource. Returns the new amount. */
+int resor_pins_(Resor * self, int delta) {
+  if (!self) return 0;
+  self->pins += delta;
+  if (self->pins < 0) self->pins = 0;
+  return self->pins;
+}
+
+/* Returns the resource that was used right after this one, as linked by 
+ * the store. */
+Resor * resor_newer(Resor * self) {
+  if (!self) return NULL;
+  return self->newer;
+}
+
+/* Returns the resource that was used right before this one, as linked by 
+ * the store. */
+Resor * resor_older(Resor * self) {
+  if (!self) return NULL;
+  return self->older;
+}
+
+/* Sets the resource that was used right after this one. Returns newer. */
+Resor * resor_newer_(Resor * self, Resor * newer) {
+  if (!self) return NULL;
+  return self->newer = newer;
+}
+
+/* Sets the resource that was used right before this one. Returns older. */
+Resor * resor_older_(Resor * self, Resor * older) {
+  if (!self) return NULL;
+  return self->older = older;
+}
+
+/* Remembers that the data of the resource was loaded from vpath with the 
+ * given reload function and arguments. Returns self. */
+static Resor * resor_source_(Resor * self, ResorReload * reload, 
+                             const char * vpath, int a, int b, int c) {
+  if (!self) return NULL;
+  resor_forget_source(self);
+  if (!vpath) return self;
+  self->vpath   = mem_alloc(strlen(vpath) + 1);
+  strcpy(self->vpath, vpath);
+  self->reload  = reload;
+  self->args[0] = a;
+  self->args[1] = b;
+  self->args[2] = c;
+  return self;
+}
+
+/* Loads a bitmap again with the loader flags and the new bitmap flags it 
+ * was loaded with first. */
+static Resor * resor_reload_bitmap(const char * vpath, const int * args) {
+  ALLEGRO_BITMAP * bitmap;
+  int old_flags = al_get_new_bitmap_flags();
+  al_set_new_bitmap_flags(args[1]);
+  bitmap = fifi_load_bitmap_flags(vpath, args[0]);
+  al_set_new_bitmap_flags(old_flags);
+  return resor_new_bitmap(bitmap);
+}
+
+/* Loads a sample again. */
+static Resor * resor_reload_sample(const char * vpath, const int * args) {
+  (void) args;
+  return resor_new_sample(fifi_load_sample(vpath));
+}
+
+/* Loads a TTF font again with the size and flags it was loaded with. */
+static Resor * resor_reload_ttf_font(const char * vpath, const int * args) {
+  return resor_new_font(fifi_load_ttf_font_stretch(vpath, args[0], args[1], 
+                                                   args[2]));
+}
+
+/* Loads a bitmap font again with the flags it was loaded with. */
+static Resor * resor_reload_bitmap_font(const char * vpath, const int * args) {
+  return resor_new_font(fifi_load_bitmap_font_flags(vpath, args[0]));
+}
+
+/* Remembers that the bitmap resource was loaded from vpath with the given 
+ * loader flags while the new bitmap flags were bitmap_flags. Returns self. */
+Resor * resor_source_bitmap_(Resor * self, const char * vpath, int flags, 
+                             int bitmap_flags) {
+  return resor_source_(self, resor_reload_bitmap, vpath, flags, bitmap_flags,
+                       0);
+}
+
+/* Remembers that the sample resource was loaded from vpath. Returns self. */
+Resor * resor_source_sample_(Resor * self, const char * vpath) {
+  return resor_source_(self, resor_reload_sample, vpath, 0, 0, 0);
+}
+
+/* Remembers that the font resource was loaded from the TTF font at vpath 
+ * with the given size and flags. w is 0 for fonts that aren't stretched. 
+ * Returns self. */
+Resor * resor_source_ttf_font_(Resor * self, const char * vpath, int w, int h,
+                               int flags) {
+  return resor_source_(self, resor_reload_ttf_font, vpath, w, h, flags);
+}
+
+/* Forgets where the data of the resource was loaded from, for when it is 
+ * going to be changed, so it's never evicted and loaded again. 
+ * Returns self. */
+Resor * resor_forget_source(Resor * self) {
+  if (!self) return NULL;
+  self->vpath  = mem_free(self->vpath);
+  self->reload = NULL;
+  return self;
+}
+
+/* Returns true if the data of the resource can be loaded again after it was
+ * evicted. */
+bool resor_reloadable(Resor * self) {
+  if (!self) return false;
+  return self->reload != NULL;
+}
+
+/* Loads the data of an evicted resource again from where it was first 
+ * loaded from. Returns true on success. */
+bool resor_reload(Resor * self) {
+  if (!resor_reloadable(self) || !resor_evicted(self)) return false;
+  return resor_restore(self, self->reload(self->vpath, self->args));
+}
+
+/* Returns the vpath the data of the resource was loaded from, or NULL if 
+ * not known. */
+const char * resor_vpath(Resor * self) {
+  if (!self) return NULL;
+  return self->vpath;
+}
+
+/* Frees the data of a bitmap, sample or font resource to save memory, 
+ * but keeps the resource itself, so the data can be put back with 
+ * resor_restore. Returns true if the data was evicted. */
+bool resor_evict(Resor * self) {
+  if (!self || !self->free) return false;
+  if ((self->kind != RESOR_BITMAP) && (self->kind != RESOR_SAMPLE) &&
+      (self->kind != RESOR_FONT)) return false;
+  if (self->status == RESOR_EMPTY) return false;
+  /* The text measurements of a font stay valid after reloading it. */
+  self->free(self);
+  self->status = RESOR_EMPTY;
+  return true;
+}
+
+/* Returns true if the data of the resource was evicted. */
+bool resor_evicted(Resor * self) {
+  if (!self) return false;
+  return self->status == RESOR_EMPTY;
+}
+
+/* Puts back the data of an evicted resource from loaded, which must be a 
+ * freshly loaded resource of the same kind. loaded is freed. Returns true 
+ * on success. */
+bool resor_restore(Resor * self, Resor * loaded) {
+  if (!self || !loaded || (loaded->kind != self->kind)) { 
+    resor_free(loaded);
+    return false;
+  }
+  self->data     = loaded->data;
+  self->status   = RESOR_OK;
+  loaded->free   = NULL;
+  resor_free(loaded);
+  return true;
+}
+
 /* Returns the resource kind.  */
 int resor_kind(Resor * self) {
   if (!self) return RESOR_EMPTY;
@@ -104,6 +384,15 @@ Resor *  resor_init(Resor * self, ResorKind kind, ResorData data, ResorDestructo
   self->free    = free;
   self->status  = RESOR_OK;
   self->saver   = NULL;
+  self->textcache = NULL;
+  self->refs    = 1;
+  self->key     = NULL;
+  self->used    = 0;
+  self->pins    = 0;
+  self->reload  = NULL;
+  self->vpath   = NULL;
+  self->newer   = NULL;
+  self->older   = NULL;
   return self;
 }
 
@@ -165,7 +454,8 @@ Resor * resor_new_other(ResorKind kind, void * data, ResorDestructor * free) {
 * Loads a TTF font from the data directory as a resource.
 */
 Resor * resor_load_ttf_font_stretch(const char * vpath, int w, int h,  int flags) {  
-  return resor_new_font(fifi_load_ttf_font_stretch(vpath, w, h, flags));
+  Resor * self = resor_new_font(fifi_load_ttf_font_stretch(vpath, w, h, flags));
+  return resor_source_ttf_font_(self, vpath, w, h, flags);
 }
 
 
@@ -173,7 +463,8 @@ Resor * resor_load_ttf_font_stretch(const char * vpath, int w, int h,  int flags
 * Loads a TTF font from the data directory as a resource.
 */
 Resor * resor_load_ttf_font(const char * vpath, int h, int flags) {  
-  return resor_new_font(fifi_load_ttf_font(vpath, h, flags));
+  Resor * self = resor_new_font(fifi_load_ttf_font(vpath, h, flags));
+  return resor_source_ttf_font_(self, vpath, 0, h, flags);
 }
 
 
@@ -181,14 +472,16 @@ Resor * resor_load_ttf_font(const char * vpath, int h, int flags) {
 * Loads a bitmap font from the data directory as a resource 
 */
 Resor * resor_load_bitmap_font_flags(const char * vpath, int flags) {  
-  return resor_new_font(fifi_load_bitmap_font_flags(vpath, flags));
+  Resor * self = resor_new_font(fifi_load_bitmap_font_flags(vpath, flags));
+  return resor_source_(self, resor_reload_bitmap_font, vpath, flags, 0, 0);
 }
 
 /*
 * Loads a bitmap font from the data directory as a resource. 
 */
 Resor * resor_load_bitmap_font(const char * vpath) {  
-  return resor_new_font(fifi_load_bitmap_font(vpath));
+  return resor_source_(resor_new_font(fifi_load_bitmap_font(vpath)),
+                       resor_reload_bitmap_font, vpath, 0, 0, 0);
 }
 
 /*
@@ -203,21 +496,24 @@ resor_load_audio_stream(const char * vpath, size_t buffer_count, int samples) {
 * Loads a sample from the data directory as a resource. 
 */
 Resor * resor_load_sample(const char * vpath) {  
-  return resor_new_sample(fifi_load_sample(vpath));
+  Resor * self = resor_new_sample(fifi_load_sample(vpath));
+  return resor_source_sample_(self, vpath);
 }
 
 /*
 * Loads a bitmap from the data directory as a resource. 
 */
 Resor * resor_load_bitmap_flags(const char * vpath, int flags) {  
-  return resor_new_bitmap(fifi_load_bitmap_flags(vpath, flags));
+  Resor * self = resor_new_bitmap(fifi_load_bitmap_flags(vpath, flags));
+  return resor_source_bitmap_(self, vpath, flags, al_get_new_bitmap_flags());
 }
 
 /*
 * Loads a bitmap from the data directory as a resource. 
 */
 Resor * resor_load_bitmap(const char * vpath) {  
-  return resor_new_bitmap(fifi_load_bitmap(vpath));
+  Resor * self = resor_new_bitmap(fifi_load_bitmap(vpath));
+  return resor_source_bitmap_(self, vpath, 0, al_get_new_bitmap_flags());
 }
 
 /* Loads an other resource using the loader callback */
@@ -326,6 +622,16 @@ bool resor_get_font_line_height(Resor * self, int * value) {
   return true;
 }
 
+/* Returns the text measurement cache of the resource if it is a font, 
+ * making it if needed, or NULL if it's not a font. */
+static TextCache * resor_textcache(Resor * self) {
+  if (!resor_font(self)) return NULL;
+  if (!self->textcache) { 
+    self->textcache = textcache_new(TEXTCACHE_SIZE_DEFAULT);
+  }
+  return self->textcache;
+}
+
 /* If the resource is a font, stores the width of the given text in the font into 
  * value and returns true . Otherwise, returns false
  */
@@ -333,11 +639,19 @@ bool resor_get_text_width(Resor * self, char * text, int * value) {
   ALLEGRO_FONT * font = resor_font(self);
   if (!font)  return false;
   if (!value) return false;
-  (*value) = al_get_text_width(font, text);
-  return true;
+  if (!text)  text = "";
+  return textcache_get_width(resor_textcache(self), font, text, strlen(text), value);
 }
 
 
+/* Helper to store dimensions in a Rebox. */
+static void resor_dimensions_to_rebox(int bbx, int bby, int bbw, int bbh, Rebox * value) {
+  value->at.x   = bbx;
+  value->at.y   = bby;
+  value->size.x = bbw;
+  value->size.y = bbh;
+}
+
 /* If the resource is a font, stores the dimensions of the given text in the 
  * font into value and returns true. Otherwise, returns false
  */
@@ -346,11 +660,10 @@ bool resor_get_text_dimensions(Resor * self, char * text, Rebox * value) {
   ALLEGRO_FONT * font = resor_font(self);
   if (!font)  return false;
   if (!value) return false;
-  al_get_text_dimensions(font, text, &bbx, &bby, &bbw, &bbh);
-  value->at.x   = bbx;
-  value->at.y   = bby;
-  value->size.x = bbw;
-  value->size.y = bbh;
+  if (!text)  text = "";
+  textcache_get_dimensions(resor_textcache(self), font, text, strlen(text),
+                           &bbx, &bby, &bbw, &bbh);
+  resor_dimensions_to_rebox(bbx, bby, bbw, bbh, value);
   return true;
 }
 
@@ -362,8 +675,9 @@ bool resor_get_ustr_width(Resor * self, ALLEGRO_USTR * text, int * value) {
   ALLEGRO_FONT * font = resor_font(self);
   if (!font)  return false;
   if (!value) return false;
-  (*value) = al_get_ustr_width(font, text);
-  return true;
+  if (!text)  return false;
+  return textcache_get_width(resor_textcache(self), font, 
+                             al_cstr(text), al_ustr_size(text), value);
 }
 
 
@@ -375,14 +689,31 @@ bool resor_get_ustr_dimensions(Resor * self, ALLEGRO_USTR * text, Rebox * value)
   ALLEGRO_FONT * font = resor_font(self);
   if (!font)  return false;
   if (!value) return false;
-  al_get_ustr_dimensions(font, text, &bbx, &bby, &bbw, &bbh);
-  value->at.x   = bbx;
-  value->at.y   = bby;
-  value->size.x = bbw;
-  value->size.y = bbh;
+  if (!text)  return false;
+  textcache_get_dimensions(resor_textcache(self), font, 
+                           al_cstr(text), al_ustr_size(text),
+                           &bbx, &bby, &bbw, &bbh);
+  resor_dimensions_to_rebox(bbx, bby, bbw, bbh, value);
   return true;
 }
 
+/* If the resource is a font, measures the widths of its Latin-1 glyphs, so 
+ * widths of texts in that range can be calculated without Allegro. This 
+ * ignores kerning. Returns false if not a font. */
+bool resor_prewarm_font(Resor * self) {
+  ALLEGRO_FONT * font = resor_font(self);
+  if (!font)  return false;
+  return textcache_prewarm(resor_textcache(self), font);
+}
+
+/* If the resource is a font, stores the statistics of its text measurement
+ * cache in stats and returns true. Otherwise, returns false. */
+bool resor_get_text_cache_stats(Resor * self, TextCacheStats * stats) {
+  if (!stats) return false;
+  if (!resor_font(self)) return false;
+  return textcache_stats(resor_textcache(self), stats);
+}
+
 
 /* If the resource is a bitmap, stores the width of the bitmap into 
  * value and returns true . Otherwise, returns false
@@ -8,12 +8,17 @@
 #include "mem.h"
 #include "state.h"
 #include "monolog.h"
+#include "callrb.h"
+#include "scriptcache.h"
+#include "rhalloc.h"
+#include "rhprof.h"
 
 #include <string.h>
 
 #include <stdarg.h>
 #include <mruby.h>
 #include <mruby/error.h>
+#include <mruby/array.h>
 
 /* Debugging level for console output. */ 
 #define LOG_CONSOLE(FORMAT, ...) LOG_LEVEL("CONSOLE", FORMAT, __VA_ARGS__)
@@ -23,6 +28,42 @@
 /* Amount of parameters a mruby function can be called with using _va functions */
 #define RH_ARGS_MAX 64
 
+/* mruby 1.3 moved the state of the GC into mrb->gc. */
+#if defined(MRUBY_RELEASE_NO) && (MRUBY_RELEASE_NO >= 10300)
+#define RH_GC_LIVE(MRB)       ((MRB)->gc.live)
+#define RH_GC_ARENA(MRB)      ((MRB)->gc.arena_idx)
+#define RH_GC_STATE(MRB)      ((MRB)->gc.state)
+#define RH_GC_THRESHOLD(MRB)  ((MRB)->gc.threshold)
+#define RH_GC_INTERVAL(MRB)   ((MRB)->gc.interval_ratio)
+#define RH_GC_STEP(MRB)       ((MRB)->gc.step_ratio)
+#else
+#define RH_GC_LIVE(MRB)       ((MRB)->live)
+#define RH_GC_ARENA(MRB)      ((MRB)->arena_idx)
+#define RH_GC_STATE(MRB)      ((MRB)->gc_state)
+#define RH_GC_THRESHOLD(MRB)  ((MRB)->gc_threshold)
+#define RH_GC_INTERVAL(MRB)   ((MRB)->gc_interval_ratio)
+#define RH_GC_STEP(MRB)       ((MRB)->gc_step_ratio)
+#endif
+
+/* The GC is between cycles in this state, which is the first of the
+ * states in all mruby versions. */
+#define RH_GC_STATE_IDLE 0
+
+/* Size of a block that mruby allocated is kept in front of the block, in
+ * a header that keeps the block aligned as malloc would. */
+typedef union RhAllocHeader_ {
+  size_t      size;
+  double      align_double;
+  void      * align_pointer;
+  long long   align_long;
+} RhAllocHeader;
+
+static int       rh_allocator_now   = RH_ALLOC_POOL;
+static RhGcStats rh_gc_now;
+static double    rh_gc_frame_time   = RH_GC_FRAME_TIME;
+static double    rh_gc_idle_max     = RH_GC_IDLE_MAX;
+static int       rh_gc_full_pending = FALSE;
+
 /*
 * RH contains helper functions for the mruby ruby interpreter.
 */
@@ -158,8 +199,48 @@ char * rh_exceptionstring(Ruby * self) {
 
 
 /** Allocates and initialzes a new ruby state. */
+/** Returns the allocator that rh_new creates rubies with. */
+int rh_allocator(void) {
+  return rh_allocator_now;
+}
+
+/** Sets the allocator that rh_new creates rubies with, RH_ALLOC_POOL for
+ * rhalloc or RH_ALLOC_SYSTEM for malloc. Must be called before rh_new. */
+int rh_allocator_(int allocator) {
+  return rh_allocator_now = allocator;
+}
+
+/* System allocator for mruby that keeps track of the size of the heap. */
+static void * rh_allocf(mrb_state * mrb, void * ptr, size_t size, void * ud) {
+  RhAllocHeader * header = NULL;
+  RhAllocHeader * moved;
+  size_t old_size        = 0;
+  (void) mrb; (void) ud;
+  if (ptr) {
+    header   = ((RhAllocHeader *) ptr) - 1;
+    old_size = header->size;
+  }
+  if (size == 0) {
+    rh_gc_now.heap -= old_size;
+    free(header);
+    return NULL;
+  }
+  moved = realloc(header, sizeof(RhAllocHeader) + size);
+  /* On failure the old block is still there, as with realloc. */
+  if (!moved) return NULL;
+  moved->size     = size;
+  rh_gc_now.heap += size - old_size;
+  if (rh_gc_now.heap > rh_gc_now.heap_max) rh_gc_now.heap_max = rh_gc_now.heap;
+  return moved + 1;
+}
+
 Ruby * rh_new() {
-   Ruby * self = mrb_open();
+   Ruby * self;
+   if (rh_allocator_now == RH_ALLOC_POOL) {
+     self = mrb_open_allocf(rhalloc_allocf, NULL);
+   } else {
+     self = mrb_open_allocf(rh_allocf, NULL);
+   }
    /*mrb_define_method(self, self->kernel_module, 
                      "path", tr_Path, ARGS_REQ(1));*/
    return self;
@@ -167,7 +248,13 @@ Ruby * rh_new() {
 
 /** Frees a ruby state. */
 Ruby * rh_free(Ruby * self) {
+  rhprof_stop(self);
+  rhprof_reset();
   mrb_close(self);
+  /* Nothing points into the loaded bytecode anymore. */
+  scriptcache_done();
+  /* All blocks of the ruby are freed now, so the pools can go too. */
+  if (rh_allocator_now == RH_ALLOC_POOL) rhalloc_done();
   return NULL;
 }
 
@@ -243,6 +330,7 @@ int rh_run_filename(Ruby * self, const char * filename) {
 
 /**
 * Executes a ruby file in Eruta's data/script directory with reporting.
+* The file is run from its cached bytecode when the script cache is enabled.
 * Returns -2 if the file was not found.
 * Returns -3 if the path wasn't found.
 */
@@ -253,6 +341,11 @@ int rh_run_script(Ruby * self, const char * filename) {
   if(!buf) return -3;
   strcpy(buf, "script/");
   strncat(buf, filename, strlen(filename));      
+  if (scriptcache_enabled()) {
+    runres = scriptcache_run(self, buf);
+    free(buf);
+    return runres;
+  }
   ALLEGRO_PATH * path = fifi_data_vpath(buf);
   if(!path) { 
     free(buf);
@@ -372,13 +465,68 @@ mrb_value rh_run_toplevel(Ruby * ruby, char * name, char * format, ...) {
 }
 
 
+/** Looks up the symbol of the callback and whether the toplevel function
+ * it names exists. Must be done again when the scripts are reloaded. 
+ * Returns true if the function exists. */
+int rh_callback_resolve(Ruby * ruby, RhCallback * callback) {
+  if (!ruby || !callback) return FALSE;
+  callback->sym      = mrb_intern_cstr(ruby, callback->name);
+  callback->defined  = mrb_respond_to(ruby, mrb_top_self(ruby), callback->sym);
+  callback->resolved = TRUE;
+  return callback->defined;
+}
+
+/* Returns true if the toplevel function of the resolved callback exists.
+ * If it didn't before, it's looked up again, since a script may have defined
+ * it since. That is only a method lookup, the symbol is already interned. */
+static int rh_callback_defined(Ruby * ruby, RhCallback * callback) {
+  if (!callback->defined) {
+    callback->defined = mrb_respond_to(ruby, mrb_top_self(ruby), 
+                                       callback->sym);
+  }
+  return callback->defined;
+}
+
+/** Calls the toplevel function of the callback with the given arguments,
+ * which may be callback->args. The callback is resolved on first use. Unlike 
+ * rh_run_function_args, only exceptions are reported, and the time spent
+ * in the call is added to the stats of the callback. Returns nil if the
+ * function doesn't exist. */
+mrb_value rh_callback_call(Ruby * ruby, RhCallback * callback, 
+                           int argc, mrb_value * argv) {
+  mrb_value v;
+  double start, spent;
+  int ai;
+  if (!ruby || !callback) return mrb_nil_value();
+  if (!callback->resolved) rh_callback_resolve(ruby, callback);
+  if (!rh_callback_defined(ruby, callback)) return mrb_nil_value();
+  ai    = mrb_gc_arena_save(ruby);
+  start = al_get_time();
+  /* Most of what a callback allocates is garbage by the next frame, but
+   * not what the lasting ones, such as eruta_on_start, set up. */
+  if (!callback->lasting) rhalloc_frame_begin();
+  rhprof_enter();
+  v     = mrb_funcall_argv(ruby, mrb_top_self(ruby), callback->sym, argc, argv);
+  rhprof_leave();
+  if (!callback->lasting) rhalloc_frame_end();
+  if (ruby->exc) rh_make_report(ruby, v);
+  spent = al_get_time() - start;
+  if (RH_GC_ARENA(ruby) > rh_gc_now.arena_max) {
+    rh_gc_now.arena_max = RH_GC_ARENA(ruby);
+  }
+  mrb_gc_arena_restore(ruby, ai);
+  callback->stats.calls++;
+  callback->stats.time += spent;
+  if (spent > callback->stats.time_max) callback->stats.time_max = spent;
+  return v;
+}
+
 /* Calls a function, doesn't log anything. */
 mrb_value rh_simple_funcall(Ruby * ruby, char * name) {
   int ai;  
   Ruby * mrb = (Ruby *) ruby;  
   mrb_value args[16];
   ai = mrb_gc_arena_save(mrb);
-  LOG("GC Area: %d\n", ai);
   // if(ai> 99) exit(0);
   mrb_value v = mrb_funcall_argv(mrb, mrb_top_self(mrb), mrb_intern_cstr(mrb, name), 
                     0, args);
@@ -442,52 +590,105 @@ static int joystick_nr(ALLEGRO_JOYSTICK * stick) {
   return -1;
 }
 
-/* Send the even to the ruby  main "on_poll"   */
-int rh_poll_event(mrb_state * mrb, ALLEGRO_EVENT * event) {
-  State * state = state_get();
-  mrb_value event_args[RH_EVARGS_MAX];
-  int nargs = 0;
-  
-  if (!event) return FALSE;
+/* Names of the kinds of events that are sent to the scripts. */
+enum RhEventKinds_ {
+  RH_EVENT_UNKNOWN                = 0,
+  RH_EVENT_JOYSTICK_AXIS          = 1,
+  RH_EVENT_JOYSTICK_BUTTON_DOWN   = 2,
+  RH_EVENT_JOYSTICK_BUTTON_UP     = 3,
+  RH_EVENT_JOYSTICK_CONFIGURATION = 4,
+  RH_EVENT_KEY_DOWN               = 5,
+  RH_EVENT_KEY_UP                 = 6,
+  RH_EVENT_KEY_CHAR               = 7,
+  RH_EVENT_MOUSE_AXES             = 8,
+  RH_EVENT_MOUSE_WARPED           = 9,
+  RH_EVENT_MOUSE_BUTTON_DOWN      = 10,
+  RH_EVENT_MOUSE_BUTTON_UP        = 11,
+  RH_EVENT_MOUSE_ENTER_DISPLAY    = 12,
+  RH_EVENT_MOUSE_LEAVE_DISPLAY    = 13,
+  RH_EVENT_KINDS                  = 14
+};
+
+static const char * rh_event_names[RH_EVENT_KINDS] = {
+  "unknown", "joystick_axis", "joystick_button_down", "joystick_button_up",
+  "joystick_configuration", "key_down", "key_up", "key_char", "mouse_axes",
+  "mouse_warped", "mouse_button_down", "mouse_button_up", 
+  "mouse_enter_display", "mouse_leave_display"
+};
+
+/* The symbols of the event names, interned once per ruby. */
+static mrb_sym   rh_event_syms[RH_EVENT_KINDS];
+static Ruby    * rh_event_syms_ruby = NULL;
+
+/* Events of this frame that are waiting to be sent to eruta_on_events. */
+static ALLEGRO_EVENT rh_event_queue[RH_EVENTS_MAX];
+static int           rh_event_queued   = 0;
+static int           rh_event_coalesce = TRUE;
+static int           rh_event_flushing = FALSE;
+static RhEventStats  rh_event_stats_now;
+/* Decides which events don't go to the scripts, when they're sent. */
+static RhEventRoute * rh_event_route      = NULL;
+static void         * rh_event_route_data = NULL;
+
+/* Returns the symbol of the name of the event kind. */
+static mrb_value rh_event_symbol(Ruby * mrb, int kind) {
+  int index;
+  if (rh_event_syms_ruby != mrb) {
+    for (index = 0; index < RH_EVENT_KINDS; index++) {
+      rh_event_syms[index] = mrb_intern_cstr(mrb, rh_event_names[index]);
+    }
+    rh_event_syms_ruby = mrb;
+  }
+  return mrb_symbol_value(rh_event_syms[kind]);
+}
+
+/* Converts the event into the arguments for eruta_on_poll: the symbol of the
+ * kind of event, the time stamp, and the details of the event. Returns the
+ * amount of arguments. */
+static int rh_event_args(mrb_state * mrb, ALLEGRO_EVENT * event, 
+                         mrb_value * args) {
+  int kind, nargs;
+  mrb_value * rest = args + 1;
   switch (event->type) {
     case ALLEGRO_EVENT_JOYSTICK_AXIS:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiif", "joystick_axis",
+      kind  = RH_EVENT_JOYSTICK_AXIS;
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fiiif",
               event->any.timestamp,
-              joystick_nr(event->joystick.id), event->joystick.stick, event->joystick.axis, event->joystick.pos);
+              joystick_nr(event->joystick.id), event->joystick.stick, 
+              event->joystick.axis, (double) event->joystick.pos);
     break;
     case ALLEGRO_EVENT_JOYSTICK_BUTTON_DOWN:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiif", "joystick_button_down", 
+      kind  = RH_EVENT_JOYSTICK_BUTTON_DOWN;
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fii",
               event->any.timestamp,
               joystick_nr(event->joystick.id), event->joystick.button);
     break;
     case ALLEGRO_EVENT_JOYSTICK_BUTTON_UP:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiif", "joystick_button_up", 
+      kind  = RH_EVENT_JOYSTICK_BUTTON_UP;
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fii",
               event->any.timestamp,
               joystick_nr(event->joystick.id), event->joystick.button);
     break;
     case ALLEGRO_EVENT_JOYSTICK_CONFIGURATION:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiif", "joystick_configuration", 
+      kind  = RH_EVENT_JOYSTICK_CONFIGURATION;
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "f", 
               event->any.timestamp);
     break;
     case ALLEGRO_EVENT_KEY_DOWN:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfi", "key_down",
+      kind  = RH_EVENT_KEY_DOWN;
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fi",
               event->any.timestamp,
               event->keyboard.keycode   );
     break;
     case ALLEGRO_EVENT_KEY_UP:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfi", "key_up",
+      kind  = RH_EVENT_KEY_UP;
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fi",
               event->any.timestamp,
               event->keyboard.keycode   );
     break;
     case ALLEGRO_EVENT_KEY_CHAR:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiib", "key_char",
+      kind  = RH_EVENT_KEY_CHAR;
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fiiib",
               event->any.timestamp,
               event->keyboard.keycode, event->keyboard.unichar,
               event->keyboard.modifiers, event->keyboard.repeat
@@ -495,17 +696,10 @@ int rh_poll_event(mrb_state * mrb, ALLEGRO_EVENT * event) {
     break;
     
     case ALLEGRO_EVENT_MOUSE_AXES:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiiiiiii", "mouse_axes",
-              event->any.timestamp,
-              event->mouse.x, event->mouse.y, event->mouse.z, event->mouse.w,
-              event->mouse.dx, event->mouse.dy, event->mouse.dz, event->mouse.dw
-             );
-    break;
-
     case ALLEGRO_EVENT_MOUSE_WARPED:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiiiiiii", "mouse_warped",
+      kind  = (event->type == ALLEGRO_EVENT_MOUSE_AXES ? 
+               RH_EVENT_MOUSE_AXES : RH_EVENT_MOUSE_WARPED);
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fiiiiiiii",
               event->any.timestamp,
               event->mouse.x, event->mouse.y, event->mouse.z, event->mouse.w,
               event->mouse.dx, event->mouse.dy, event->mouse.dz, event->mouse.dw
@@ -513,17 +707,10 @@ int rh_poll_event(mrb_state * mrb, ALLEGRO_EVENT * event) {
     break;
     
     case ALLEGRO_EVENT_MOUSE_BUTTON_DOWN:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiiii", "mouse_button_down",
-              event->any.timestamp,
-              event->mouse.x, event->mouse.y, event->mouse.z, event->mouse.w,
-              event->mouse.button
-             );
-    break;
-    
     case ALLEGRO_EVENT_MOUSE_BUTTON_UP:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiiii", "mouse_button_up",
+      kind  = (event->type == ALLEGRO_EVENT_MOUSE_BUTTON_DOWN ? 
+               RH_EVENT_MOUSE_BUTTON_DOWN : RH_EVENT_MOUSE_BUTTON_UP);
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fiiiii",
               event->any.timestamp,
               event->mouse.x, event->mouse.y, event->mouse.z, event->mouse.w,
               event->mouse.button
@@ -531,29 +718,33 @@ int rh_poll_event(mrb_state * mrb, ALLEGRO_EVENT * event) {
     break;
     
     case ALLEGRO_EVENT_MOUSE_ENTER_DISPLAY:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiii", "mouse_enter_display",
-              event->any.timestamp,
-              event->mouse.x, event->mouse.y, event->mouse.z, event->mouse.w
-             );
-    break;
-    
     case ALLEGRO_EVENT_MOUSE_LEAVE_DISPLAY:
-      nargs = 
-      rh_args(mrb, event_args, RH_EVARGS_MAX, "Yfiiii", "mouse_leave_display",
+      kind  = (event->type == ALLEGRO_EVENT_MOUSE_ENTER_DISPLAY ? 
+               RH_EVENT_MOUSE_ENTER_DISPLAY : RH_EVENT_MOUSE_LEAVE_DISPLAY);
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "fiiii",
               event->any.timestamp,
               event->mouse.x, event->mouse.y, event->mouse.z, event->mouse.w
              );
     break;
-       
     
     default:
-      nargs = rh_args(mrb, event_args, RH_EVARGS_MAX, "Yf", "unknown",
-        event->any.timestamp
-      );
+      kind  = RH_EVENT_UNKNOWN;
+      nargs = rh_args(mrb, rest, RH_EVARGS_MAX - 1, "f",
+              event->any.timestamp);
     break;
   }
-  rh_run_toplevel_args(state_ruby(state), "eruta_on_poll", nargs, event_args);
+  args[0] = rh_event_symbol(mrb, kind);
+  return (nargs < 0 ? 1 : nargs + 1);
+}
+
+/* Send the even to the ruby  main "on_poll"   */
+int rh_poll_event(mrb_state * mrb, ALLEGRO_EVENT * event) {
+  mrb_value event_args[RH_EVARGS_MAX];
+  int nargs = 0;
+  
+  if (!event) return FALSE;
+  nargs = rh_event_args(mrb, event, event_args);
+  callrb_on_poll(nargs, event_args);
   return TRUE;
 }
 
@@ -562,11 +753,245 @@ int rh_poll_event(mrb_state * mrb, ALLEGRO_EVENT * event) {
 int rh_poll_events(mrb_state * mrb, ALLEGRO_EVENT_QUEUE * queue) {
   ALLEGRO_EVENT event;
   while(al_get_next_event(queue, &event)) { 
-    rh_poll_event(mrb, &event);
+    rh_queue_event(mrb, &event);
+  }
+  rh_flush_events(mrb);
+  return TRUE;
+}
+
+/* Merges event into the last queued event if both are moves of the same 
+ * mouse or joystick axis. The positions of the later event are kept, and
+ * the mouse movements are added up. Returns true if merged. */
+static int rh_coalesce_event(ALLEGRO_EVENT * event) {
+  ALLEGRO_EVENT * last;
+  if (!rh_event_coalesce || (rh_event_queued < 1)) return FALSE;
+  last = rh_event_queue + rh_event_queued - 1;
+  if (last->type != event->type) return FALSE;
+  if (event->type == ALLEGRO_EVENT_MOUSE_AXES) {
+    ALLEGRO_MOUSE_EVENT merged = event->mouse;
+    if (last->mouse.display != event->mouse.display) return FALSE;
+    merged.dx += last->mouse.dx;
+    merged.dy += last->mouse.dy;
+    merged.dz += last->mouse.dz;
+    merged.dw += last->mouse.dw;
+    last->mouse = merged;
+    return TRUE;
+  }
+  if (event->type == ALLEGRO_EVENT_JOYSTICK_AXIS) {
+    if ((last->joystick.id    != event->joystick.id)    ||
+        (last->joystick.stick != event->joystick.stick) ||
+        (last->joystick.axis  != event->joystick.axis)) return FALSE;
+    (*last) = (*event);
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/** Queues the event to be sent with the other events of this frame by 
+ * rh_flush_events. Consecutive moves of the mouse or of a joystick axis are
+ * merged into one event unless that was turned off. Returns false if the
+ * event was dropped because the queue is full while it's being flushed. */
+int rh_queue_event(mrb_state * mrb, ALLEGRO_EVENT * event) {
+  if (!event) return FALSE;
+  if (rh_coalesce_event(event)) {
+    rh_event_stats_now.coalesced++;
+    return TRUE;
   }
+  if (rh_event_queued >= RH_EVENTS_MAX) {
+    if (rh_event_flushing) return FALSE;
+    rh_flush_events(mrb);
+  }
+  rh_event_queue[rh_event_queued++] = (*event);
+  rh_event_stats_now.queued++;
   return TRUE;
 }
 
+/* Sends the events in list, if any, to eruta_on_events, and restores the 
+ * arena to ai. */
+static void rh_send_events(mrb_state * mrb, mrb_value * list, int ai) {
+  if (mrb_nil_p(*list)) return;
+  callrb_on_events(*list);
+  mrb_gc_arena_restore(mrb, ai);
+  (*list) = mrb_nil_value();
+  rh_event_stats_now.batches++;
+}
+
+/** Sends the queued events in order. Where an event goes is decided here,
+ * and not when it's queued, so it goes where the events before it, such as
+ * a key that opens the console, say it should. Events that the route set 
+ * with rh_events_route_ handles don't go to the scripts. The others are sent
+ * to eruta_on_events as an array of arrays, with the same contents as the
+ * arguments of eruta_on_poll, in one call unless routed events are between
+ * them. If the scripts don't define eruta_on_events, each event is sent to
+ * eruta_on_poll. Returns the amount of events sent to the scripts. */
+int rh_flush_events(mrb_state * mrb) {
+  mrb_value list = mrb_nil_value(), event_args[RH_EVARGS_MAX];
+  int index, nargs, ai = 0, sent = 0, batch;
+  if (rh_event_queued < 1 || rh_event_flushing) return 0;
+  rh_event_flushing = TRUE;
+  batch = callrb_defined(CALLRB_ON_EVENTS);
+  /* Events queued while flushing are sent too. */
+  for (index = 0; index < rh_event_queued; index++) {
+    ALLEGRO_EVENT * event = rh_event_queue + index;
+    if (rh_event_route && rh_event_route(event, rh_event_route_data)) {
+      /* Send the events before this one first, to keep them in order. */
+      rh_send_events(mrb, &list, ai);
+      continue;
+    }
+    sent++;
+    if (!batch) {
+      rh_poll_event(mrb, event);
+      continue;
+    }
+    if (mrb_nil_p(list)) {
+      ai   = mrb_gc_arena_save(mrb);
+      list = mrb_ary_new_capa(mrb, rh_event_queued - index);
+    }
+    nargs = rh_event_args(mrb, event, event_args);
+    mrb_ary_push(mrb, list, mrb_ary_new_from_values(mrb, nargs, event_args));
+  }
+  rh_send_events(mrb, &list, ai);
+  rh_event_queued   = 0;
+  rh_event_flushing = FALSE;
+  rh_event_stats_now.sent += sent;
+  return sent;
+}
+
+/** Sets the route that decides which events don't go to the scripts when 
+ * they're sent, and the data passed to it. NULL sends all to the scripts. */
+void rh_events_route_(RhEventRoute * route, void * data) {
+  rh_event_route      = route;
+  rh_event_route_data = data;
+}
+
+/** Returns true if consecutive mouse and joystick axis moves are merged. */
+int rh_events_coalesce(void) {
+  return rh_event_coalesce;
+}
+
+/** Sets whether consecutive mouse and joystick axis moves are merged. */
+int rh_events_coalesce_(int coalesce) {
+  return rh_event_coalesce = coalesce;
+}
+
+/** Copies the statistics of the batched event delivery to stats. */
+bool rh_event_stats(RhEventStats * stats) {
+  if (!stats) return false;
+  (*stats) = rh_event_stats_now;
+  return true;
+}
+
+
+/** Sets how mruby's incremental GC paces itself, as the GC.interval_ratio
+ * and GC.step_ratio of the scripts do. Negative values are left as is. */
+void rh_gc_configure(Ruby * ruby, int interval_ratio, int step_ratio) {
+  if (!ruby) return;
+  if (interval_ratio >= 0) RH_GC_INTERVAL(ruby) = interval_ratio;
+  if (step_ratio >= 0)     RH_GC_STEP(ruby)     = step_ratio;
+}
+
+/** Sets the frame time that idle time is calculated from, and the most time
+ * per frame rh_gc_idle may spend. Values that aren't positive are left as
+ * they are. */
+void rh_gc_idle_budget_(double frame_time, double idle_max) {
+  if (frame_time > 0.0) rh_gc_frame_time = frame_time;
+  if (idle_max   > 0.0) rh_gc_idle_max   = idle_max;
+}
+
+/* Adds time spent on explicit GC work during this frame to the stats. */
+static void rh_gc_spent(double spent) {
+  rh_gc_now.frame_time = spent;
+  rh_gc_now.time      += spent;
+  if (spent > rh_gc_now.time_max) rh_gc_now.time_max = spent;
+}
+
+/** Runs a full garbage collection now, and returns how long it took. */
+double rh_gc_full(Ruby * ruby) {
+  double start;
+  if (!ruby) return 0.0;
+  start = al_get_time();
+  mrb_full_gc(ruby);
+  rh_gc_now.full++;
+  rh_gc_full_pending = FALSE;
+  return al_get_time() - start;
+}
+
+/** Requests a full garbage collection at the end of this frame, when it
+ * won't interrupt a script. Use this on scene transitions. */
+void rh_gc_full_later(void) {
+  rh_gc_full_pending = TRUE;
+}
+
+/**
+* Does GC work in the time left of this frame, when the work of the frame
+* took used seconds. Must be called before the display is flipped, since
+* with vsync the flip waits out the rest of the frame. Runs a requested
+* full collection first. Otherwise runs incremental GC steps, while a GC
+* cycle is going on or the amount of live objects nears the point where
+* mruby would start one during the next frame, until the cycle is done or
+* the idle time is used. Returns the time spent.
+*/
+double rh_gc_idle(Ruby * ruby, double used) {
+  double start, deadline, spent;
+  if (!ruby) return 0.0;
+  start     = al_get_time();
+  if (rh_gc_full_pending) {
+    spent = rh_gc_full(ruby);
+    rh_gc_spent(spent);
+    return spent;
+  }
+  deadline  = rh_gc_frame_time - used;
+  if (deadline > rh_gc_idle_max) deadline = rh_gc_idle_max;
+  if ((deadline <= 0.0) ||
+      ((RH_GC_STATE(ruby) == RH_GC_STATE_IDLE) &&
+       (RH_GC_LIVE(ruby) < RH_GC_THRESHOLD(ruby) * RH_GC_IDLE_START))) {
+    rh_gc_now.frame_time = 0.0;
+    return 0.0;
+  }
+  deadline += start;
+  do {
+    mrb_incremental_gc(ruby);
+    rh_gc_now.steps++;
+  } while ((RH_GC_STATE(ruby) != RH_GC_STATE_IDLE) && 
+           (al_get_time() < deadline));
+  spent = al_get_time() - start;
+  rh_gc_spent(spent);
+  return spent;
+}
+
+/** Ends the frame that started at frame_start. Does GC work in the time
+ * that is left of it with rh_gc_idle, and then calls flip, which may wait
+ * for vsync. Returns the time after the flip, when the next frame starts. */
+double rh_gc_flip(Ruby * ruby, double frame_start, void (*flip)(void)) {
+  rh_gc_idle(ruby, al_get_time() - frame_start);
+  if (flip) flip();
+  return al_get_time();
+}
+
+/** Copies the memory and GC statistics of the ruby to stats. */
+bool rh_gc_stats(Ruby * ruby, RhGcStats * stats) {
+  if (!ruby || !stats) return false;
+  (*stats)           = rh_gc_now;
+  if (rh_allocator_now == RH_ALLOC_POOL) {
+    stats->heap      = rhalloc_heap();
+    stats->heap_max  = rhalloc_heap_max();
+  }
+  stats->live        = RH_GC_LIVE(ruby);
+  stats->threshold   = RH_GC_THRESHOLD(ruby);
+  return true;
+}
+
+/** Clears the GC times, counts and high water marks. */
+void rh_gc_stats_reset(void) {
+  rhalloc_stats_reset();
+  rh_gc_now.heap_max   = rh_gc_now.heap;
+  rh_gc_now.time       = 0.0;
+  rh_gc_now.time_max   = 0.0;
+  rh_gc_now.steps      = 0;
+  rh_gc_now.full       = 0;
+  rh_gc_now.arena_max  = 0;
+}
+
 
 /* Tries to (re-)load the main ruby file, output to console. */
 int rh_load_main() { 
@@ -574,6 +999,23 @@ int rh_load_main() {
   // Try to load the main ruby file.
   return rh_run_script(state_ruby(state), "main.rb");
 }
+
+/* Reloads the scripts that changed, or all of them by loading the main ruby 
+ * file again if that isn't possible, and calls eruta_on_reload. */
+int rh_reload_main() {
+  State * state = state_get();
+  int reloaded  = -1;
+  if (scriptcache_enabled()) reloaded = scriptcache_reload(state_ruby(state));
+  if (reloaded < 0) {
+    reloaded = rh_load_main();
+  } else {
+    LOG_NOTE("Reloaded %d changed scripts.\n", reloaded);
+  }
+  callrb_on_reload();
+  /* Whatever the old scripts left behind can go at the end of the frame. */
+  rh_gc_full_later();
+  return reloaded;
+}
   
 
 /** For execution of ruby strings by the console */
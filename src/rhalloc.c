@@ -0,0 +1,357 @@
+#include "eruta.h"
+#include "rhalloc.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum RhallocKinds_ {
+  RHALLOC_KIND_POOL   = 1,
+  RHALLOC_KIND_FRAME  = 2,
+  RHALLOC_KIND_SYSTEM = 3
+};
+
+typedef struct RhallocRegion_ RhallocRegion;
+typedef struct RhallocChunk_  RhallocChunk;
+typedef struct RhallocFree_   RhallocFree;
+
+/* The header in front of every block. It is 16 bytes on 32 and 64 bits
+ * systems, so the blocks stay aligned for doubles and pointers. */
+typedef union RhallocHeader_ {
+  struct {
+    RhallocRegion * region;
+    uint32_t        size;
+    uint16_t        kind;
+    uint16_t        index;
+  } info;
+  double            align[2];
+} RhallocHeader;
+
+/* A frame region. Blocks are bumped from data, and the region is emptied
+ * once live drops back to 0. A region that filled up while some of its
+ * blocks were still live is retired: from then on it is part of the pool,
+ * and its blocks go to the free lists of their size class when freed. */
+struct RhallocRegion_ {
+  RhallocRegion * next;
+  size_t          used;
+  long            live;
+  int             retired;
+  double          align;
+  unsigned char   data[RHALLOC_REGION_SIZE];
+};
+
+/* A chunk the size classes are refilled from. */
+struct RhallocChunk_ {
+  RhallocChunk  * next;
+  double          align;
+  unsigned char   data[RHALLOC_CHUNK_SIZE];
+};
+
+/* A free small block, linked in its size class. */
+struct RhallocFree_ {
+  RhallocFree   * next;
+};
+
+/* Block sizes of the size classes, header included, multiples of 16. */
+static const int rhalloc_sizes[RHALLOC_CLASSES] = {
+  32, 48, 64, 96, 128, 192, 256, RHALLOC_SMALL_MAX + sizeof(RhallocHeader)
+};
+
+static RhallocFree   * rhalloc_free_lists[RHALLOC_CLASSES];
+static RhallocChunk  * rhalloc_chunks      = NULL;
+static size_t          rhalloc_chunk_used  = RHALLOC_CHUNK_SIZE;
+static RhallocRegion * rhalloc_region      = NULL;
+static RhallocRegion * rhalloc_retired     = NULL;
+static int             rhalloc_frames      = 0;
+static RhallocStats    rhalloc_stats_now[RHALLOC_STATS];
+static size_t          rhalloc_heap_now    = 0;
+static size_t          rhalloc_heap_top    = 0;
+
+
+/* Returns the size class of a block with size bytes of user data. */
+static int rhalloc_class(size_t size) {
+  size_t total = size + sizeof(RhallocHeader);
+  int index;
+  for (index = 0; index < RHALLOC_CLASSES; index++) {
+    if (total <= (size_t) rhalloc_sizes[index]) return index;
+  }
+  return -1;
+}
+
+/* Counts an allocation or free of size bytes of the given kind of stats. */
+static void rhalloc_count(int index, size_t size, bool alloc) {
+  RhallocStats * stats = rhalloc_stats_now + index;
+  if (alloc) {
+    stats->allocs++;
+    stats->live++;
+    stats->bytes     += size;
+    rhalloc_heap_now += size;
+    if (rhalloc_heap_now > rhalloc_heap_top) rhalloc_heap_top = rhalloc_heap_now;
+  } else {
+    stats->frees++;
+    stats->live--;
+    stats->bytes     -= size;
+    rhalloc_heap_now -= size;
+  }
+}
+
+/* Gets a block of the size class, from its free list or a chunk. */
+static RhallocHeader * rhalloc_pool_get(int index) {
+  RhallocHeader * header;
+  size_t          block = rhalloc_sizes[index];
+  if (rhalloc_free_lists[index]) {
+    header = (RhallocHeader *) rhalloc_free_lists[index];
+    rhalloc_free_lists[index] = rhalloc_free_lists[index]->next;
+    return header;
+  }
+  if ((rhalloc_chunk_used + block) > RHALLOC_CHUNK_SIZE) {
+    /* The rest of the old chunk is too small, it's left unused. */
+    RhallocChunk * chunk = malloc(sizeof(RhallocChunk));
+    if (!chunk) return NULL;
+    chunk->next        = rhalloc_chunks;
+    rhalloc_chunks     = chunk;
+    rhalloc_chunk_used = 0;
+  }
+  header = (RhallocHeader *) (rhalloc_chunks->data + rhalloc_chunk_used);
+  rhalloc_chunk_used += block;
+  return header;
+}
+
+/* Gets a block of the size class from the current frame region. The block
+ * has the size of the class, so it can go to the free list of the class if
+ * its region is retired. */
+static RhallocHeader * rhalloc_frame_get(int index) {
+  RhallocHeader * header;
+  size_t          block = rhalloc_sizes[index];
+  if (rhalloc_region && (rhalloc_region->live == 0)) rhalloc_region->used = 0;
+  if ((!rhalloc_region) || ((rhalloc_region->used + block) >
+                            RHALLOC_REGION_SIZE)) {
+    /* The rest of the full region is left unused. It is found again
+     * through the headers of its live blocks. */
+    RhallocRegion * region = malloc(sizeof(RhallocRegion));
+    if (!region) return NULL;
+    if (rhalloc_region) {
+      rhalloc_region->retired = true;
+      rhalloc_region->next    = rhalloc_retired;
+      rhalloc_retired         = rhalloc_region;
+    }
+    region->next    = NULL;
+    region->used    = 0;
+    region->live    = 0;
+    region->retired = false;
+    rhalloc_region  = region;
+  }
+  header = (RhallocHeader *) (rhalloc_region->data + rhalloc_region->used);
+  rhalloc_region->used += block;
+  rhalloc_region->live++;
+  header->info.region = rhalloc_region;
+  return header;
+}
+
+/* Lets go of a frame block. A block of the current region is reclaimed when
+ * the region is emptied, one of a retired region goes to the free list of
+ * its size class, so a few survivors don't keep a whole region unused. */
+static void rhalloc_frame_put(RhallocHeader * header) {
+  RhallocRegion * region = header->info.region;
+  RhallocFree   * block;
+  int             index  = header->info.index;
+  region->live--;
+  if (!region->retired) return;
+  block = (RhallocFree *) header;
+  block->next = rhalloc_free_lists[index];
+  rhalloc_free_lists[index] = block;
+}
+
+/* Allocates a new block of size bytes. */
+static void * rhalloc_get(size_t size) {
+  RhallocHeader * header = NULL;
+  int index              = rhalloc_class(size);
+  int kind               = RHALLOC_KIND_SYSTEM;
+  if (index >= 0) {
+    if ((rhalloc_frames > 0) && (!rhalloc_free_lists[index])) {
+      header = rhalloc_frame_get(index);
+      kind   = RHALLOC_KIND_FRAME;
+    }
+    if (!header) {
+      header = rhalloc_pool_get(index);
+      kind   = RHALLOC_KIND_POOL;
+    }
+  }
+  if (!header) {
+    header = malloc(sizeof(RhallocHeader) + size);
+    kind   = RHALLOC_KIND_SYSTEM;
+    index  = -1;
+  }
+  if (!header) return NULL;
+  header->info.size  = (uint32_t) size;
+  header->info.kind  = kind;
+  header->info.index = (uint16_t) index;
+  if (kind == RHALLOC_KIND_POOL) {
+    rhalloc_count(index, size, true);
+  } else if (kind == RHALLOC_KIND_FRAME) {
+    rhalloc_count(RHALLOC_CLASS_FRAME, size, true);
+  } else {
+    rhalloc_count(RHALLOC_CLASS_SYSTEM, size, true);
+  }
+  return header + 1;
+}
+
+/* Frees the block with the given header. */
+static void rhalloc_put(RhallocHeader * header) {
+  RhallocFree * block;
+  int index = header->info.index;
+  switch (header->info.kind) {
+    case RHALLOC_KIND_POOL:
+      rhalloc_count(index, header->info.size, false);
+      block = (RhallocFree *) header;
+      block->next = rhalloc_free_lists[index];
+      rhalloc_free_lists[index] = block;
+    break;
+    case RHALLOC_KIND_FRAME:
+      rhalloc_count(RHALLOC_CLASS_FRAME, header->info.size, false);
+      rhalloc_frame_put(header);
+    break;
+    default:
+      rhalloc_count(RHALLOC_CLASS_SYSTEM, header->info.size, false);
+      free(header);
+    break;
+  }
+}
+
+/* Changes the size of the block with the given header. Blocks that still
+ * fit their size class or region stay where they are. */
+static void * rhalloc_resize(RhallocHeader * header, size_t size) {
+  void * moved;
+  size_t old_size = header->info.size;
+  int    index    = header->info.index;
+  int    frames;
+  switch (header->info.kind) {
+    case RHALLOC_KIND_POOL:
+      if (rhalloc_class(size) == index) {
+        rhalloc_stats_now[index].bytes += size - old_size;
+        rhalloc_heap_now               += size - old_size;
+        header->info.size               = (uint32_t) size;
+        return header + 1;
+      }
+    break;
+    case RHALLOC_KIND_FRAME:
+      if (rhalloc_class(size) == index) {
+        rhalloc_stats_now[RHALLOC_CLASS_FRAME].bytes += size - old_size;
+        rhalloc_heap_now                             += size - old_size;
+        header->info.size                             = (uint32_t) size;
+        return header + 1;
+      }
+    break;
+    default:
+      if (rhalloc_class(size) < 0) {
+        /* Stays a system block, let realloc do the work. */
+        RhallocHeader * resized = realloc(header, sizeof(RhallocHeader) + size);
+        if (!resized) return NULL;
+        rhalloc_stats_now[RHALLOC_CLASS_SYSTEM].bytes += size - old_size;
+        rhalloc_heap_now                              += size - old_size;
+        if (rhalloc_heap_now > rhalloc_heap_top) rhalloc_heap_top = rhalloc_heap_now;
+        resized->info.size = (uint32_t) size;
+        return resized + 1;
+      }
+    break;
+  }
+  /* Growing blocks likely live longer, they don't go to a frame region. */
+  frames         = rhalloc_frames;
+  rhalloc_frames = 0;
+  moved          = rhalloc_get(size);
+  rhalloc_frames = frames;
+  if (!moved) return NULL;
+  memcpy(moved, header + 1, (old_size < size) ? old_size : size);
+  rhalloc_put(header);
+  return moved;
+}
+
+/**
+* The allocation function for mrb_open_allocf. Allocates, resizes or frees
+* blocks the way mruby expects: with size 0 ptr is freed, otherwise ptr is
+* resized or a new block is allocated if ptr is NULL. On failure NULL is
+* returned and ptr is left as it is.
+*/
+void * rhalloc_allocf(struct mrb_state * mrb, void * ptr, size_t size,
+                      void * ud) {
+  RhallocHeader * header = ptr ? (((RhallocHeader *) ptr) - 1) : NULL;
+  (void) mrb; (void) ud;
+  if (size == 0) {
+    if (header) rhalloc_put(header);
+    return NULL;
+  }
+  if (header) return rhalloc_resize(header, size);
+  return rhalloc_get(size);
+}
+
+/** Starts a frame. Until the matching rhalloc_frame_end, small blocks the
+ * free lists can't supply are taken from a frame region. Frames may nest. */
+void rhalloc_frame_begin(void) {
+  rhalloc_frames++;
+}
+
+/** Ends a frame started with rhalloc_frame_begin. */
+void rhalloc_frame_end(void) {
+  if (rhalloc_frames > 0) rhalloc_frames--;
+}
+
+/** Returns the largest user size of the size class with the given index,
+ * or negative if there is no such class. */
+int rhalloc_class_size(int index) {
+  if ((index < 0) || (index >= RHALLOC_CLASSES)) return -1;
+  return rhalloc_sizes[index] - (int) sizeof(RhallocHeader);
+}
+
+/** Copies the statistics of the size class with the given index, or of the
+ * frame regions for RHALLOC_CLASS_FRAME or of the large blocks for
+ * RHALLOC_CLASS_SYSTEM, to stats. */
+bool rhalloc_stats(int index, RhallocStats * stats) {
+  if ((index < 0) || (index >= RHALLOC_STATS) || !stats) return false;
+  (*stats) = rhalloc_stats_now[index];
+  return true;
+}
+
+/** Clears the allocation and free counts. The live counts and sizes are
+ * kept, since the blocks are still there. */
+void rhalloc_stats_reset(void) {
+  int index;
+  for (index = 0; index < RHALLOC_STATS; index++) {
+    rhalloc_stats_now[index].allocs = 0;
+    rhalloc_stats_now[index].frees  = 0;
+  }
+  rhalloc_heap_top = rhalloc_heap_now;
+}
+
+/** Returns the amount of bytes in use by the blocks. */
+size_t rhalloc_heap(void) {
+  return rhalloc_heap_now;
+}
+
+/** Returns the most bytes that were in use at the same time. */
+size_t rhalloc_heap_max(void) {
+  return rhalloc_heap_top;
+}
+
+/** Gives all chunks and regions back to the system. Must only be called
+ * when all blocks were freed, after the VM was closed. */
+void rhalloc_done(void) {
+  int index;
+  while (rhalloc_chunks) {
+    RhallocChunk * next = rhalloc_chunks->next;
+    free(rhalloc_chunks);
+    rhalloc_chunks = next;
+  }
+  while (rhalloc_retired) {
+    RhallocRegion * next = rhalloc_retired->next;
+    free(rhalloc_retired);
+    rhalloc_retired = next;
+  }
+  free(rhalloc_region);
+  rhalloc_region      = NULL;
+  rhalloc_chunk_used  = RHALLOC_CHUNK_SIZE;
+  for (index = 0; index < RHALLOC_CLASSES; index++) {
+    rhalloc_free_lists[index] = NULL;
+  }
+  memset(rhalloc_stats_now, 0, sizeof(rhalloc_stats_now));
+  rhalloc_heap_now = 0;
+  rhalloc_heap_top = 0;
+}
+
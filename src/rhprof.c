@@ -0,0 +1,346 @@
+#include "eruta.h"
+#include "mem.h"
+#include "rhprof.h"
+#include <string.h>
+
+#include <mruby.h>
+
+/* mruby 1.3 renamed ENABLE_DEBUG to MRB_ENABLE_DEBUG_HOOK. */
+#if defined(MRB_ENABLE_DEBUG_HOOK) || defined(ENABLE_DEBUG)
+#define RHPROF_HOOK 1
+#include <mruby/proc.h>
+#include <mruby/irep.h>
+#include <mruby/debug.h>
+#endif
+
+/* Starting size of the tables, must be a power of 2. */
+#define RHPROF_TABLE_SIZE 256
+
+typedef struct RhprofSlot_  RhprofSlot;
+typedef struct RhprofTable_ RhprofTable;
+
+/* A method or call stack with its samples. */
+struct RhprofSlot_ {
+  char     * key;
+  uint64_t   hash;
+  long       self;
+  long       total;
+};
+
+/* Open addressing hash table of slots. */
+struct RhprofTable_ {
+  RhprofSlot * slots;
+  int          size;
+  int          used;
+};
+
+static RhprofTable rhprof_methods;
+static RhprofTable rhprof_stacks;
+static long        rhprof_samples_now  = 0;
+static bool        rhprof_on           = false;
+static int         rhprof_inside       = 0;
+static int         rhprof_fetches      = 0;
+static double      rhprof_last         = 0.0;
+static double      rhprof_interval_now = RHPROF_INTERVAL;
+/* A call stack joined with ;, as the key of rhprof_stacks. */
+static char        rhprof_stack[RHPROF_DEPTH_MAX * (RHPROF_LABEL_MAX + 1)];
+
+/* Finds the free or matching slot of a key in slots. */
+static RhprofSlot * rhprof_table_find(RhprofSlot * slots, int size,
+                                      const char * key, uint64_t hash) {
+  int index = (int) (hash & (uint64_t) (size - 1));
+  for (;;) {
+    RhprofSlot * slot = slots + index;
+    if (!slot->key) return slot;
+    if ((slot->hash == hash) && (strcmp(slot->key, key) == 0)) return slot;
+    index = (index + 1) & (size - 1);
+  }
+}
+
+/* Doubles the size of the table. Returns false if out of memory. */
+static bool rhprof_table_grow(RhprofTable * table) {
+  RhprofSlot * slots;
+  int size  = (table->size > 0) ? (table->size * 2) : RHPROF_TABLE_SIZE;
+  int index;
+  slots = calloc(size, sizeof(RhprofSlot));
+  if (!slots) return false;
+  for (index = 0; index < table->size; index++) {
+    RhprofSlot * old = table->slots + index;
+    if (old->key) {
+      *rhprof_table_find(slots, size, old->key, old->hash) = *old;
+    }
+  }
+  free(table->slots);
+  table->slots = slots;
+  table->size  = size;
+  return true;
+}
+
+/* Returns the slot of key, which is added if it wasn't in the table yet.
+ * Returns NULL if out of memory. */
+static RhprofSlot * rhprof_table_get(RhprofTable * table, const char * key) {
+  RhprofSlot * slot;
+  uint64_t     hash = mem_fnv64(MEM_FNV64_BASIS, key, strlen(key));
+  /* Keep the table at most 3/4 full. */
+  if (((table->used + 1) * 4) > (table->size * 3)) {
+    if (!rhprof_table_grow(table)) return NULL;
+  }
+  slot = rhprof_table_find(table->slots, table->size, key, hash);
+  if (slot->key) return slot;
+  slot->key = malloc(strlen(key) + 1);
+  if (!slot->key) return NULL;
+  strcpy(slot->key, key);
+  slot->hash  = hash;
+  slot->self  = 0;
+  slot->total = 0;
+  table->used++;
+  return slot;
+}
+
+static void rhprof_table_done(RhprofTable * table) {
+  int index;
+  for (index = 0; index < table->size; index++) {
+    free(table->slots[index].key);
+  }
+  free(table->slots);
+  table->slots = NULL;
+  table->size  = 0;
+  table->used  = 0;
+}
+
+/** Adds weight samples of a call stack. labels are the labels of the depth
+ * frames of the stack, from the root to the method that was running. Returns
+ * 0 on success, negative if out of memory or if depth is out of range. */
+int rhprof_record(const char ** labels, int depth, long weight) {
+  RhprofSlot * seen[RHPROF_DEPTH_MAX];
+  RhprofSlot * slot;
+  size_t       length = 0;
+  int          index, other;
+  if ((depth < 1) || (depth > RHPROF_DEPTH_MAX) || (weight < 1)) return -1;
+  for (index = 0; index < depth; index++) {
+    size_t size = strlen(labels[index]);
+    if (size >= RHPROF_LABEL_MAX) size = RHPROF_LABEL_MAX - 1;
+    if (index > 0) rhprof_stack[length++] = ';';
+    memcpy(rhprof_stack + length, labels[index], size);
+    length += size;
+    seen[index] = rhprof_table_get(&rhprof_methods, labels[index]);
+    if (!seen[index]) return -2;
+    /* A recursive method only counts once in the total. */
+    for (other = 0; other < index; other++) {
+      if (seen[other] == seen[index]) break;
+    }
+    if (other == index) seen[index]->total += weight;
+  }
+  rhprof_stack[length] = '\0';
+  seen[depth - 1]->self += weight;
+  slot = rhprof_table_get(&rhprof_stacks, rhprof_stack);
+  if (!slot) return -3;
+  slot->self         += weight;
+  rhprof_samples_now += weight;
+  return 0;
+}
+
+/** Returns the amount of samples taken since the last reset. */
+long rhprof_samples(void) {
+  return rhprof_samples_now;
+}
+
+/* Sorts slots by self samples first and total samples next, most first. */
+static int rhprof_compare(const void * one, const void * two) {
+  const RhprofSlot * slot1 = *((const RhprofSlot **) one);
+  const RhprofSlot * slot2 = *((const RhprofSlot **) two);
+  if (slot1->self  != slot2->self)  return (slot1->self  < slot2->self)  ? 1 : -1;
+  if (slot1->total != slot2->total) return (slot1->total < slot2->total) ? 1 : -1;
+  return strcmp(slot1->key, slot2->key);
+}
+
+/** Stores at most max methods with the most self samples in entries, most
+ * first. The labels stay valid until the next reset. Returns the amount
+ * stored, or negative if out of memory. */
+int rhprof_top(RhprofEntry * entries, int max) {
+  RhprofSlot ** sorted;
+  int           index, amount = 0;
+  if (rhprof_methods.used < 1) return 0;
+  sorted = malloc(rhprof_methods.used * sizeof(RhprofSlot *));
+  if (!sorted) return -1;
+  for (index = 0; index < rhprof_methods.size; index++) {
+    if (rhprof_methods.slots[index].key) {
+      sorted[amount++] = rhprof_methods.slots + index;
+    }
+  }
+  qsort(sorted, amount, sizeof(RhprofSlot *), rhprof_compare);
+  if (amount > max) amount = max;
+  for (index = 0; index < amount; index++) {
+    entries[index].label = sorted[index]->key;
+    entries[index].self  = sorted[index]->self;
+    entries[index].total = sorted[index]->total;
+  }
+  free(sorted);
+  return amount;
+}
+
+/** Writes the sampled call stacks to out in the folded format, one stack
+ * per line, with the frames separated by ; and followed by the amount of
+ * samples. Returns the amount of lines written, negative on failure. */
+int rhprof_write_folded(FILE * out) {
+  int index, lines = 0;
+  if (!out) return -1;
+  for (index = 0; index < rhprof_stacks.size; index++) {
+    RhprofSlot * slot = rhprof_stacks.slots + index;
+    if (!slot->key) continue;
+    if (fprintf(out, "%s %ld\n", slot->key, slot->self) < 0) return -2;
+    lines++;
+  }
+  return lines;
+}
+
+/** Writes the sampled call stacks in the folded format to the file with
+ * the given name. Returns the amount of lines written, negative on
+ * failure. */
+int rhprof_dump(const char * filename) {
+  FILE * out;
+  int    lines;
+  out = fopen(filename, "w");
+  if (!out) return -1;
+  lines = rhprof_write_folded(out);
+  if (fclose(out) != 0) return -2;
+  return lines;
+}
+
+/** Forgets all samples. */
+void rhprof_reset(void) {
+  rhprof_table_done(&rhprof_methods);
+  rhprof_table_done(&rhprof_stacks);
+  rhprof_samples_now = 0;
+}
+
+#ifdef RHPROF_HOOK
+
+/* Writes the label of the frame of ci: the name of the method, and the
+ * file and line where it starts, or <cfunc> for methods written in C. */
+static void rhprof_label(mrb_state * mrb, mrb_callinfo * ci, char * label) {
+  const char * name = "<main>";
+  const char * file = NULL;
+  mrb_int      size = 6;
+  int          line = 0;
+  /* Unlike mrb_sym2name, this never allocates, so the GC can't run. */
+  if (ci->mid) name = mrb_sym2name_len(mrb, ci->mid, &size);
+  if (ci->proc && !MRB_PROC_CFUNC_P(ci->proc)) {
+    file = mrb_debug_get_filename(ci->proc->body.irep, 0);
+    line = mrb_debug_get_line(ci->proc->body.irep, 0);
+  }
+  if (file) {
+    snprintf(label, RHPROF_LABEL_MAX, "%.*s %s:%d", (int) size, name, file, line);
+  } else {
+    snprintf(label, RHPROF_LABEL_MAX, "%.*s <cfunc>", (int) size, name);
+  }
+}
+
+/* Records weight samples of the current call stack. */
+static void rhprof_sample(mrb_state * mrb, long weight) {
+  static char    frames[RHPROF_DEPTH_MAX][RHPROF_LABEL_MAX];
+  const char   * labels[RHPROF_DEPTH_MAX];
+  mrb_callinfo * ci;
+  int            depth = 0, index;
+  for (ci = mrb->c->ci; (ci >= mrb->c->cibase) && (depth < RHPROF_DEPTH_MAX);
+       ci--) {
+    rhprof_label(mrb, ci, frames[depth]);
+    depth++;
+  }
+  /* The frames are found from the top of the stack down. */
+  for (index = 0; index < depth; index++) {
+    labels[index] = frames[depth - 1 - index];
+  }
+  rhprof_record(labels, depth, weight);
+}
+
+/* Code fetch hook, called by mruby for every instruction. */
+static void rhprof_hook(mrb_state * mrb, struct mrb_irep * irep,
+                        mrb_code * pc, mrb_value * regs) {
+  double now;
+  long   ticks;
+  (void) irep; (void) pc; (void) regs;
+  if (rhprof_inside < 1) return;
+  if ((++rhprof_fetches) < RHPROF_FETCHES) return;
+  rhprof_fetches = 0;
+  now   = al_get_time();
+  ticks = (long) ((now - rhprof_last) / rhprof_interval_now);
+  if (ticks < 1) return;
+  rhprof_last += ticks * rhprof_interval_now;
+  rhprof_sample(mrb, ticks);
+}
+
+#endif
+
+/** Returns whether eruta was built with the profiler. */
+bool rhprof_available(void) {
+#ifdef RHPROF_HOOK
+  return true;
+#else
+  return false;
+#endif
+}
+
+/** Starts profiling the scripts run by ruby, taking a sample every interval
+ * seconds, or every RHPROF_INTERVAL if interval isn't positive. Samples are
+ * added to those taken before. Returns false if the profiler isn't
+ * available. */
+bool rhprof_start(Ruby * ruby, double interval) {
+#ifdef RHPROF_HOOK
+  if (!ruby) return false;
+  rhprof_interval_now   = (interval > 0.0) ? interval : RHPROF_INTERVAL;
+  rhprof_inside         = 0;
+  rhprof_on             = true;
+  ruby->code_fetch_hook = rhprof_hook;
+  return true;
+#else
+  (void) ruby; (void) interval;
+  return false;
+#endif
+}
+
+/** Stops profiling. The samples are kept until rhprof_reset. Returns
+ * whether the profiler was running. */
+bool rhprof_stop(Ruby * ruby) {
+  bool was = rhprof_on;
+#ifdef RHPROF_HOOK
+  if (ruby) ruby->code_fetch_hook = NULL;
+#else
+  (void) ruby;
+#endif
+  rhprof_on     = false;
+  rhprof_inside = 0;
+  return was;
+}
+
+/** Returns whether the profiler is running. */
+bool rhprof_active(void) {
+  return rhprof_on;
+}
+
+/** Returns the time between samples in seconds. */
+double rhprof_interval(void) {
+  return rhprof_interval_now;
+}
+
+/** Sets the time between samples in seconds, if it is positive. Returns the
+ * time between samples. */
+double rhprof_interval_(double interval) {
+  if (interval > 0.0) rhprof_interval_now = interval;
+  return rhprof_interval_now;
+}
+
+/** Marks the start of a script callback. Samples are only taken between
+ * rhprof_enter and rhprof_leave. */
+void rhprof_enter(void) {
+  if (!rhprof_on) return;
+  if ((rhprof_inside++) == 0) {
+    rhprof_last    = al_get_time();
+    rhprof_fetches = 0;
+  }
+}
+
+/** Marks the end of a script callback. */
+void rhprof_leave(void) {
+  if (rhprof_inside > 0) rhprof_inside--;
+}
@@ -0,0 +1,163 @@
+#include "eruta.h"
+#include "mem.h"
+#include "rhtask.h"
+#include <string.h>
+
+/*
+ * The tasks are kept in the order they were added in, so they take turns
+ * fairly. rhtask_turn is the slot of the task that goes first in the next
+ * frame. Ids aren't reused, so a script that holds on to the id of a finished
+ * task can't touch another task with it.
+ */
+
+static RhTaskStats    * rhtask_tasks      = NULL;
+static int              rhtask_used       = 0;
+static int              rhtask_size       = 0;
+static int              rhtask_next_id    = 1;
+static int              rhtask_turn       = 0;
+static double           rhtask_budget_now = RHTASK_BUDGET;
+static double           rhtask_start      = 0.0;
+static bool             rhtask_running    = false;
+static RhTaskFrameStats rhtask_frame;
+
+/* Returns the slot of the task with the given id, or negative if there is no
+ * such task. */
+static int rhtask_slot(int id) {
+  int slot;
+  for (slot = 0; slot < rhtask_used; slot++) {
+    if (rhtask_tasks[slot].id == id) return slot;
+  }
+  return -1;
+}
+
+/** Adds a task with the given name. Returns it's id, or negative if out of
+ * memory. */
+int rhtask_add(const char * name) {
+  RhTaskStats * task;
+  if (rhtask_used >= rhtask_size) {
+    int newsize = (rhtask_size < 1) ? 16 : rhtask_size * 2;
+    RhTaskStats * tasks = mem_realloc(rhtask_tasks, newsize * sizeof(RhTaskStats));
+    if (!tasks) return -1;
+    rhtask_tasks = tasks;
+    rhtask_size  = newsize;
+  }
+  task = rhtask_tasks + rhtask_used;
+  memset(task, 0, sizeof(RhTaskStats));
+  task->id = rhtask_next_id++;
+  strncpy(task->name, name ? name : "task", RHTASK_NAME_MAX - 1);
+  rhtask_used++;
+  return task->id;
+}
+
+/** Removes the task with the given id. Returns 0 on success or negative if
+ * there is no such task. */
+int rhtask_remove(int id) {
+  int slot = rhtask_slot(id);
+  if (slot < 0) return -1;
+  memmove(rhtask_tasks + slot, rhtask_tasks + slot + 1,
+          (rhtask_used - slot - 1) * sizeof(RhTaskStats));
+  rhtask_used--;
+  if (rhtask_turn > slot) rhtask_turn--;
+  if (rhtask_turn >= rhtask_used) rhtask_turn = 0;
+  return 0;
+}
+
+/** Returns the amount of tasks. */
+int rhtask_count(void) {
+  return rhtask_used;
+}
+
+/** Returns the time budget of the tasks per frame, in seconds. */
+double rhtask_budget(void) {
+  return rhtask_budget_now;
+}
+
+/** Sets the time budget of the tasks per frame, in seconds. Negative budgets
+ * are ignored. Returns the budget in use. */
+double rhtask_budget_(double budget) {
+  if (budget >= 0.0) rhtask_budget_now = budget;
+  return rhtask_budget_now;
+}
+
+/** Returns the time that is left of the budget of this frame, which is
+ * negative if it was overrun. Outside of rhtask_run, the whole budget is
+ * left. Tasks can use this to do as much work as fits before yielding. */
+double rhtask_time_left(void) {
+  if (!rhtask_running) return rhtask_budget_now;
+  return rhtask_budget_now - (al_get_time() - rhtask_start);
+}
+
+/** Resumes the tasks in turn with resume, until each had a turn or the budget
+ * of the frame is used up. Tasks for which resume returns false are removed.
+ * Returns the amount of tasks resumed. */
+int rhtask_run(RhTaskResume * resume, void * data) {
+  int turns, turn, id, slot, alive;
+  double now, before, spent;
+  /* A task may not run the tasks again. */
+  if (rhtask_running) return 0;
+  memset(&rhtask_frame, 0, sizeof(rhtask_frame));
+  rhtask_frame.budget = rhtask_budget_now;
+  rhtask_frame.tasks  = rhtask_used;
+  if ((!resume) || (rhtask_used < 1)) return 0;
+  rhtask_running = true;
+  rhtask_start   = now = al_get_time();
+  turns          = rhtask_used;
+  for (turn = 0; (turn < turns) && (rhtask_used > 0); turn++) {
+    if ((turn > 0) && ((now - rhtask_start) >= rhtask_budget_now)) break;
+    if (rhtask_turn >= rhtask_used) rhtask_turn = 0;
+    id     = rhtask_tasks[rhtask_turn].id;
+    before = now;
+    alive  = resume(id, data);
+    now    = al_get_time();
+    spent  = now - before;
+    rhtask_frame.resumed++;
+    /* The task may have removed itself or added others. */
+    slot   = rhtask_slot(id);
+    if (slot < 0) {
+      rhtask_frame.finished++;
+      continue;
+    }
+    rhtask_tasks[slot].resumes++;
+    rhtask_tasks[slot].time      += spent;
+    rhtask_tasks[slot].frame_time = spent;
+    if (spent > rhtask_tasks[slot].time_max) rhtask_tasks[slot].time_max = spent;
+    if ((now - rhtask_start) > rhtask_budget_now) rhtask_tasks[slot].overruns++;
+    if (alive) {
+      rhtask_turn = slot + 1;
+    } else {
+      /* The next task moves into the slot, so it has the next turn. */
+      rhtask_turn = slot;
+      rhtask_remove(id);
+      rhtask_frame.finished++;
+    }
+  }
+  rhtask_frame.waiting = turns - turn;
+  rhtask_frame.time    = now - rhtask_start;
+  rhtask_frame.tasks   = rhtask_used;
+  rhtask_running       = false;
+  return rhtask_frame.resumed;
+}
+
+/** Copies the statistics of the nth task into stats. Returns false if there
+ * is no such task. */
+bool rhtask_stats(int nth, RhTaskStats * stats) {
+  if ((!stats) || (nth < 0) || (nth >= rhtask_used)) return false;
+  (*stats) = rhtask_tasks[nth];
+  return true;
+}
+
+/** Copies the statistics of the last frame into stats. */
+bool rhtask_frame_stats(RhTaskFrameStats * stats) {
+  if (!stats) return false;
+  (*stats) = rhtask_frame;
+  return true;
+}
+
+/** Removes all tasks. */
+void rhtask_done(void) {
+  rhtask_tasks = mem_free(rhtask_tasks);
+  rhtask_used  = 0;
+  rhtask_size  = 0;
+  rhtask_turn  = 0;
+  memset(&rhtask_frame, 0, sizeof(rhtask_frame));
+}
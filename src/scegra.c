@@ -12,6 +12,8 @@
 #include "store.h"
 #include "state.h"
 #include "laytext.h"
+#include "tween.h"
+#include "pickgrid.h"
 #include <string.h>
 
 
@@ -165,11 +167,28 @@ static ScegraNode * scegra_nodes_todraw[SCEGRA_NODES_MAX];
 /* How many nodes to draw this time. */
 static int scegra_to_draw = 0;
 
+/* Size of the cells of the grid used for picking. */
+#define SCEGRA_PICK_CELL_SIZE 32
+
+/* Maximum amount of overlapping nodes considered for a pick. */
+#define SCEGRA_PICK_MAX 256
+
+/* Grid of the bounds of the nodes, for picking nodes with the mouse. */
+static PickGrid * scegra_pickgrid = NULL;
+
+/* Updates the node's bounds in the pick grid. Must be called when the 
+ * position or size of the node changes. */
+static void scegranode_moved(ScegraNode * self) {
+  pickgrid_put(scegra_pickgrid, self->id, self->pos.x, self->pos.y,
+               self->size.x, self->size.y);
+}
+
 
 void 
 scegranode_done(ScegraNode * self) {
   if (!self) return;
   if (self->done) self->done(self);
+  if (self->id >= 0) pickgrid_remove(scegra_pickgrid, self->id);
   self->id = -1;
   self->z  = -1;
 }
@@ -197,6 +216,7 @@ scegranode_initall(ScegraNode * node, int kind, int id, BeVec pos, BeVec siz,
   node->done    = NULL;
   node->kind    = kind;
   node->delay   = 0.05;
+  scegranode_moved(node);
   return node;
 }
 
@@ -266,7 +286,9 @@ scegranode_longtext_done(ScegraNode * self) {
 }
 
 void scegra_update_generic(ScegraNode * self, double dt) {
+  if ((self->speed.x == 0.0) && (self->speed.y == 0.0)) return;
   self->pos = bevec_add(self->pos, bevec_mul(self->speed, dt));
+  scegranode_moved(self);
 }
 
 
@@ -679,6 +701,9 @@ void scegra_init() {
     node->id = -1; /* Negative id means unused; */
   }
   scegra_to_draw = 0;
+  scegra_pickgrid = pickgrid_new(SCREEN_W, SCREEN_H, 
+                    SCEGRA_PICK_CELL_SIZE, SCEGRA_PICK_CELL_SIZE, SCEGRA_NODES_MAX);
+  tween_init();
 }
 
 /* End the use of the simple 2D scene graph */
@@ -689,6 +714,8 @@ void scegra_done() {
     scegranode_done(node);
   }
   scegra_to_draw = 0;
+  scegra_pickgrid = pickgrid_free(scegra_pickgrid);
+  tween_done();
 }
 
 
@@ -717,6 +744,8 @@ static inline int scegranode_compare_for_drawing(const void * p1, const void * p
 void scegra_update(double dt) {
   register int index;
   scegra_to_draw = 0;
+  /* Advance the tweens first, so the nodes are drawn with the new values. */
+  tween_update(dt);
   
   for (index = 0; index < SCEGRA_NODES_MAX; index++) {
     register ScegraNode * node = scegra_nodes + index;
@@ -748,10 +777,32 @@ void scegra_draw() {
   }
 }
 
+/** Returns the id of the topmost visible node that contains the point x, y,
+ * or negative if there is no such node. Topmost means the node that is 
+ * drawn last, so the one with the highest z, and with the highest id for 
+ * equal z. */
+int scegra_pick(float x, float y) {
+  int ids[SCEGRA_PICK_MAX];
+  int found, index;
+  ScegraNode * best = NULL;
+  found = pickgrid_query(scegra_pickgrid, x, y, ids, SCEGRA_PICK_MAX);
+  if (found > SCEGRA_PICK_MAX) found = SCEGRA_PICK_MAX;
+  for (index = 0; index < found; index++) {
+    ScegraNode * node = scegra_nodes + ids[index];
+    if (node->id < 0)                           continue;
+    if (!node->draw)                            continue;
+    if (flags_get(node->flags, SCEGRA_NODE_HIDE)) continue;
+    if ((!best) || (scegranode_compare_for_drawing(&node, &best) > 0)) {
+      best = node;
+    }
+  }
+  return best ? best->id : -1;
+}
+
 /* Returns true if out of bounds for the scene graph, or false if ok. */
 int scegra_out_of_bounds(int index) {
   if (index < 0)                  return TRUE;
-  if (index > scegra_nodes_max()) return TRUE;
+  if (index >= scegra_nodes_max()) return TRUE;
   return FALSE;
 }
 
@@ -773,6 +824,7 @@ int scegra_get_id(int index) {
 int scegra_disable_node(int index) {
   ScegraNode * node = scegra_get_node(index);
   if (!node) return -2;
+  tween_stop_node(index);
   scegranode_done(node);
   return node->id = -1; 
 }
@@ -923,6 +975,7 @@ int scegra_position_(int index, float x, float y) {
   if (!node) return -2;
   if (node->id < 0) return -1;
   node->pos = bevec(x, y);  
+  scegranode_moved(node);
   return node->z;
 }
 
@@ -932,6 +985,7 @@ int scegra_size_(int index, float w, float h) {
   if (!node) return -2;
   if (node->id < 0) return -1;
   node->size = bevec(w, h);  
+  scegranode_moved(node);
   return node->z;
 }
 
@@ -1241,6 +1295,270 @@ int scegra_previous_page(int index) {
 }
 
 
+/* Returns the amount of float values the given node property has, 
+ * or negative if the property is unknown. */
+int scegra_property_size(int prop) {
+  switch (prop) {
+    case SCEGRA_PROP_POSITION         : return 2;
+    case SCEGRA_PROP_SIZE             : return 2;
+    case SCEGRA_PROP_SPEED            : return 2;
+    case SCEGRA_PROP_COLOR            : return 4;
+    case SCEGRA_PROP_BACKGROUND_COLOR : return 4;
+    case SCEGRA_PROP_BORDER_COLOR     : return 4;
+    case SCEGRA_PROP_BORDER_THICKNESS : return 1;
+    case SCEGRA_PROP_MARGIN           : return 1;
+    case SCEGRA_PROP_ANGLE            : return 1;
+    case SCEGRA_PROP_Z                : return 1;
+    case SCEGRA_PROP_VISIBLE          : return 1;
+    case SCEGRA_PROP_FONT_ID          : return 1;
+    case SCEGRA_PROP_IMAGE_ID         : return 1;
+    case SCEGRA_PROP_BACKGROUND_IMAGE_ID : return 1;
+    case SCEGRA_PROP_TEXT_FLAGS       : return 1;
+    case SCEGRA_PROP_IMAGE_FLAGS      : return 1;
+    default                           : return -3;
+  }
+}
+
+/* Stores an allegro color as 4 floats in the range 0 to 255. */
+static void scegra_color_to_values(ALLEGRO_COLOR color, float * values) {
+  al_unmap_rgba_f(color, values, values + 1, values + 2, values + 3);
+  values[0] *= 255.0; values[1] *= 255.0; 
+  values[2] *= 255.0; values[3] *= 255.0;
+}
+
+/* Converts 4 floats in the range 0 to 255 to an allegro color, clamping 
+ * them to that range so overshooting tweens don't cause weird colors. */
+static ALLEGRO_COLOR scegra_values_to_color(const float * values) {
+  float c[4];
+  int i;
+  for (i = 0; i < 4; i++) {
+    c[i] = values[i] / 255.0;
+    if (c[i] < 0.0) c[i] = 0.0;
+    if (c[i] > 1.0) c[i] = 1.0;
+  }
+  return al_map_rgba_f(c[0], c[1], c[2], c[3]);
+}
+
+/** Gets the value(s) of the property prop of the node into values, which 
+ * must have space for at least SCEGRA_PROP_VALUES_MAX floats. Returns the 
+ * amount of values stored, or negative on error. */
+int scegra_property(int index, int prop, float * values) {
+  ScegraNode * node = scegra_get_node(index);
+  if (!node)            return -2;
+  if (node->id < 0)     return -1;
+  if (!values)          return -3;
+  switch (prop) {
+    case SCEGRA_PROP_POSITION:
+      values[0] = node->pos.x; values[1] = node->pos.y;
+      break;
+    case SCEGRA_PROP_SIZE:
+      values[0] = node->size.x; values[1] = node->size.y;
+      break;
+    case SCEGRA_PROP_SPEED:
+      values[0] = node->speed.x; values[1] = node->speed.y;
+      break;
+    case SCEGRA_PROP_COLOR:
+      scegra_color_to_values(node->style.color, values);
+      break;
+    case SCEGRA_PROP_BACKGROUND_COLOR:
+      scegra_color_to_values(node->style.background_color, values);
+      break;
+    case SCEGRA_PROP_BORDER_COLOR:
+      scegra_color_to_values(node->style.border_color, values);
+      break;
+    case SCEGRA_PROP_BORDER_THICKNESS:
+      values[0] = node->style.border_thickness;
+      break;
+    case SCEGRA_PROP_MARGIN:
+      values[0] = node->style.margin;
+      break;
+    case SCEGRA_PROP_ANGLE:
+      if (node->kind != SCEGRA_NODE_BITMAP) return -3;
+      values[0] = node->data.bitmap.angle;
+      break;
+    case SCEGRA_PROP_Z:
+      values[0] = node->z;
+      break;
+    case SCEGRA_PROP_VISIBLE:
+      values[0] = flags_get(node->flags, SCEGRA_NODE_HIDE) ? 0.0 : 1.0;
+      break;
+    case SCEGRA_PROP_FONT_ID:
+      values[0] = node->style.font_id;
+      break;
+    case SCEGRA_PROP_IMAGE_ID:
+      if (node->kind != SCEGRA_NODE_BITMAP) return -3;
+      values[0] = node->data.bitmap.image_id;
+      break;
+    case SCEGRA_PROP_BACKGROUND_IMAGE_ID:
+      values[0] = node->style.background_image_id;
+      break;
+    case SCEGRA_PROP_TEXT_FLAGS:
+      values[0] = node->style.text_flags;
+      break;
+    case SCEGRA_PROP_IMAGE_FLAGS:
+      values[0] = node->style.image_flags;
+      break;
+    default:
+      return -3;
+  }
+  return scegra_property_size(prop);
+}
+
+/** Sets the property prop of the node from values, which must contain 
+ * scegra_property_size(prop) floats. Returns the node's z value on success 
+ * or negative on error. */
+int scegra_property_(int index, int prop, const float * values) {
+  ScegraNode * node = scegra_get_node(index);
+  if (!node)            return -2;
+  if (node->id < 0)     return -1;
+  if (!values)          return -3;
+  switch (prop) {
+    case SCEGRA_PROP_POSITION:
+      node->pos   = bevec(values[0], values[1]);
+      scegranode_moved(node);
+      break;
+    case SCEGRA_PROP_SIZE:
+      node->size  = bevec(values[0], values[1]);
+      scegranode_moved(node);
+      break;
+    case SCEGRA_PROP_SPEED:
+      node->speed = bevec(values[0], values[1]);
+      break;
+    case SCEGRA_PROP_COLOR:
+      node->style.color = scegra_values_to_color(values);
+      break;
+    case SCEGRA_PROP_BACKGROUND_COLOR:
+      node->style.background_color = scegra_values_to_color(values);
+      break;
+    case SCEGRA_PROP_BORDER_COLOR:
+      node->style.border_color = scegra_values_to_color(values);
+      break;
+    case SCEGRA_PROP_BORDER_THICKNESS:
+      node->style.border_thickness = values[0];
+      break;
+    case SCEGRA_PROP_MARGIN:
+      node->style.margin = values[0];
+      break;
+    case SCEGRA_PROP_ANGLE:
+      if (node->kind != SCEGRA_NODE_BITMAP) return -3;
+      node->data.bitmap.angle = values[0];
+      break;
+    case SCEGRA_PROP_Z:
+      node->z = (int) values[0];
+      break;
+    case SCEGRA_PROP_VISIBLE:
+      flags_put(&node->flags, SCEGRA_NODE_HIDE, !((int) values[0]));
+      break;
+    case SCEGRA_PROP_FONT_ID:
+      node->style.font_id = (int) values[0];
+      break;
+    case SCEGRA_PROP_IMAGE_ID:
+      if (node->kind != SCEGRA_NODE_BITMAP) return -3;
+      node->data.bitmap.image_id = (int) values[0];
+      break;
+    case SCEGRA_PROP_BACKGROUND_IMAGE_ID:
+      node->style.background_image_id = (int) values[0];
+      break;
+    case SCEGRA_PROP_TEXT_FLAGS:
+      node->style.text_flags = (int) values[0];
+      break;
+    case SCEGRA_PROP_IMAGE_FLAGS:
+      node->style.image_flags = (int) values[0];
+      break;
+    default:
+      return -3;
+  }
+  return node->z;
+}
+
+
+/** Applies amount property changes to the scene graph in one go. 
+ * Changes that fail, for example because the node is not in use, are skipped.
+ * Returns the amount of changes that were applied. */
+int scegra_apply_changes(const ScegraChange * changes, int amount) {
+  int index, applied = 0;
+  if (!changes) return 0;
+  for (index = 0; index < amount; index++) {
+    const ScegraChange * change = changes + index;
+    if (scegra_property_(change->id, change->prop, change->values) >= 0) {
+      applied++;
+    }
+  }
+  return applied;
+}
+
+/** Applies property changes packed in a buffer of size bytes, as
+ * SCEGRA_CHANGE_PACKED_SIZE byte records in the layout of ScegraChange.
+ * Returns the amount of changes that were applied. Trailing bytes that 
+ * don't make up a whole record are ignored. */
+int scegra_apply_packed(const char * buffer, int size) {
+  int index, amount, applied = 0;
+  ScegraChange change;
+  if (!buffer) return 0;
+  amount = size / SCEGRA_CHANGE_PACKED_SIZE;
+  for (index = 0; index < amount; index++) {
+    /* Copy to avoid alignment problems with the buffer. */
+    memcpy(&change, buffer + index * SCEGRA_CHANGE_PACKED_SIZE, 
+           SCEGRA_CHANGE_PACKED_SIZE);
+    if (scegra_property_(change.id, change.prop, change.values) >= 0) {
+      applied++;
+    }
+  }
+  return applied;
+}
+
+/** Makes the node at index a copy of the node at template_index, 
+ * including its style and text. Returns the new node's id or negative 
+ * on error. */
+int scegra_copy_node(int index, int template_index) {
+  ScegraNode * node = scegra_get_node(index);
+  ScegraNode * from = scegra_get_node(template_index);
+  if (!node || !from)      return -2;
+  if (from->id < 0)        return -1;
+  if (node == from)        return -3;
+  tween_stop_node(index);
+  scegranode_done(node);
+  *node     = *from;
+  node->id  = index;
+  if (node->kind == SCEGRA_NODE_LONGTEXT) {
+    /* Long texts own their text, so it must be duplicated. */
+    node->data.longtext.text = NULL;
+    scegranode_set_longtext_text(node, from->data.longtext.text);
+  }
+  scegranode_moved(node);
+  return node->id;
+}
+
+/** Makes amount copies of the node at template_index in free nodes
+ * with an id of at least minimum. Every copy is moved by (dx, dy) relative
+ * to the previous one. If ids is not NULL, it must have space for amount 
+ * ints and receives the id's of the new nodes. Returns the amount of 
+ * nodes made, which may be less than amount if the scene graph is full.  */
+int scegra_make_from_template(int template_index, int minimum, int amount, 
+                              float dx, float dy, int * ids) {
+  int made = 0, id = minimum;
+  BeVec pos, step;
+  ScegraNode * from = scegra_get_node(template_index);
+  if (!from)          return -2;
+  if (from->id < 0)   return -1;
+  pos  = from->pos;
+  step = bevec(dx, dy);
+  while (made < amount) {
+    ScegraNode * node;
+    id = scegra_get_free_id(id);
+    if (id < 0) break;
+    if (scegra_copy_node(id, template_index) < 0) break;
+    pos       = bevec_add(pos, step);
+    node      = scegra_nodes + id;
+    node->pos = pos;
+    scegranode_moved(node);
+    if (ids) ids[made] = id;
+    made++;
+  }
+  return made;
+}
+
+
 
 
 /*
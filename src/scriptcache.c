@@ -0,0 +1,673 @@
+#if defined(__linux__)
+/* Needed for read with -std=c99. */
+#define _POSIX_C_SOURCE 200112L
+#define SCRIPTCACHE_USE_INOTIFY 1
+#endif
+
+#include "eruta.h"
+#include "mem.h"
+#include "monolog.h"
+#include "fifi.h"
+#include "str.h"
+#include "scriptcache.h"
+#include <string.h>
+#include <time.h>
+
+#ifdef SCRIPTCACHE_USE_INOTIFY
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#include <mruby.h>
+#include <mruby/compile.h>
+#include <mruby/dump.h>
+#include <mruby/proc.h>
+
+/*
+ * The key also covers the version of mruby, since the bytecode format and
+ * the meaning of the opcodes may change between versions even when
+ * RITE_BINARY_FORMAT_VER stays the same.
+ */
+#ifdef MRUBY_RELEASE_STRING
+#define SCRIPTCACHE_MRUBY_VERSION MRUBY_RELEASE_STRING " " RITE_BINARY_FORMAT_VER
+#else
+#define SCRIPTCACHE_MRUBY_VERSION RITE_BINARY_FORMAT_VER
+#endif
+
+/* Keep the debug info, older mruby versions take a plain flag. */
+#ifdef DUMP_DEBUG_INFO
+#define SCRIPTCACHE_DUMP_FLAGS DUMP_DEBUG_INFO
+#else
+#define SCRIPTCACHE_DUMP_FLAGS 1
+#endif
+
+/*
+ * Every script that was run is remembered with the key and modification time
+ * of its source, and the script that ran it. On a reload, only the scripts
+ * whose source changed are run again. While reloading, scripts that were
+ * already loaded and didn't change aren't run again when a changed script
+ * runs them, so the classes they define stay as they are.
+ */
+
+typedef struct ScriptCacheLoaded_ ScriptCacheLoaded;
+
+struct ScriptCacheLoaded_ {
+  char   * vpath;
+  char   * filename;
+  uint64_t key;
+  time_t   mtime;
+  off_t    size;
+  /* True if the source may have changed again in the second it was loaded,
+   * so an unchanged mtime and size don't prove it is up to date. */
+  bool     racy;
+  int      parent;
+  /* Equal to scriptcache_generation if up to date during a reload. */
+  int      generation;
+};
+
+static bool              scriptcache_enabled_now = true;
+static ScriptCacheStats  scriptcache_stats_now;
+static ScriptCacheLoaded scriptcache_loaded[SCRIPTCACHE_LOADED_MAX];
+static int               scriptcache_loaded_count = 0;
+static int               scriptcache_current      = -1;
+static int               scriptcache_generation   = 0;
+static bool              scriptcache_reloading    = false;
+
+/* Watching the loaded scripts for changes. */
+static bool              scriptcache_watching     = false;
+static double            scriptcache_checked      = 0.0;
+static bool              scriptcache_touched      = false;
+static double            scriptcache_touched_at   = 0.0;
+#ifdef SCRIPTCACHE_USE_INOTIFY
+static int               scriptcache_inotify      = -1;
+#endif
+
+/* Loaded bytecode that the ruby still uses, see scriptcache_load. */
+static unsigned char  ** scriptcache_kept         = NULL;
+static int               scriptcache_kept_count   = 0;
+
+
+/** Returns the key of the bytecode of the source of size bytes, which
+ * changes if either the source or the version of mruby changes. */
+uint64_t scriptcache_key(const char * source, size_t size) {
+  uint64_t hash = MEM_FNV64_BASIS;
+  hash = mem_fnv64(hash, SCRIPTCACHE_MRUBY_VERSION,
+                   sizeof(SCRIPTCACHE_MRUBY_VERSION));
+  return mem_fnv64(hash, source, size);
+}
+
+/** Returns the path of the cached bytecode of the script with the given
+ * vpath, or NULL if the vpath is too long. Free it with al_destroy_path. */
+ALLEGRO_PATH * scriptcache_path(const char * vpath) {
+  char cached[FIFI_VPATH_MAX];
+  int  length;
+  length = snprintf(cached, sizeof(cached), "%s/%s%s",
+                    SCRIPTCACHE_DIR, vpath, SCRIPTCACHE_EXTENSION);
+  if ((length < 0) || (length >= (int) sizeof(cached))) return NULL;
+  return fifi_data_vpath(cached);
+}
+
+/* Reads the whole file. Returns NULL if it can't be read. The result must be
+ * freed with mem_free. */
+static char * scriptcache_slurp(const char * filename, size_t * size) {
+  ALLEGRO_FILE * file;
+  char         * data;
+  int64_t        length;
+  file = al_fopen(filename, "rb");
+  if (!file) return NULL;
+  length = al_fsize(file);
+  /* Also room for a terminating 0, so the parser always has a string. */
+  data   = (length >= 0) ? mem_alloc(length + 1) : NULL;
+  if (data && (al_fread(file, data, length) != (size_t) length)) {
+    data = mem_free(data);
+  }
+  al_fclose(file);
+  if (!data) return NULL;
+  data[length] = '\0';
+  (*size)      = length;
+  return data;
+}
+
+/** Reads the cached bytecode from the file, if its key is the given key.
+ * Returns NULL if the file is missing, damaged or stale. The result must be
+ * freed with mem_free. */
+unsigned char * scriptcache_read(const char * filename, uint64_t key,
+                                 size_t * size) {
+  ALLEGRO_FILE  * file;
+  unsigned char   header[SCRIPTCACHE_HEADER_SIZE];
+  unsigned char * code = NULL;
+  uint32_t        code_size;
+  file = al_fopen(filename, "rb");
+  if (!file) return NULL;
+  if ((al_fread(file, header, sizeof(header)) == sizeof(header))         &&
+      (memcmp(header, SCRIPTCACHE_MAGIC, 4) == 0)                         &&
+      (mem_get32(header + 4)  == SCRIPTCACHE_VERSION)                     &&
+      (mem_get32(header + 8)  == (uint32_t) (key & 0xffffffff))           &&
+      (mem_get32(header + 12) == (uint32_t) (key >> 32))) {
+    code_size = mem_get32(header + 16);
+    if (al_fsize(file) == (int64_t) (SCRIPTCACHE_HEADER_SIZE + code_size)) {
+      code = mem_alloc(code_size);
+    }
+    if (code && (al_fread(file, code, code_size) != code_size)) {
+      code = mem_free(code);
+    }
+    if (code && size) (*size) = code_size;
+  }
+  al_fclose(file);
+  return code;
+}
+
+/** Writes the bytecode with the given key to the file, creating the
+ * directory of the file if needed. */
+bool scriptcache_write(const char * filename, uint64_t key,
+                       const unsigned char * code, size_t size) {
+  ALLEGRO_FILE  * file;
+  ALLEGRO_PATH  * dir;
+  unsigned char   header[SCRIPTCACHE_HEADER_SIZE];
+  bool            ok;
+  dir = al_create_path(filename);
+  if (dir) {
+    al_set_path_filename(dir, NULL);
+    al_make_directory(PATH_CSTR(dir));
+    al_destroy_path(dir);
+  }
+  file = al_fopen(filename, "wb");
+  if (!file) return false;
+  memset(header, 0, sizeof(header));
+  memcpy(header, SCRIPTCACHE_MAGIC, 4);
+  mem_put32(header + 4,  SCRIPTCACHE_VERSION);
+  mem_put32(header + 8,  (uint32_t) (key & 0xffffffff));
+  mem_put32(header + 12, (uint32_t) (key >> 32));
+  mem_put32(header + 16, (uint32_t) size);
+  ok = (al_fwrite(file, header, sizeof(header)) == sizeof(header)) &&
+       (al_fwrite(file, code, size) == size);
+  al_fclose(file);
+  /* Don't leave a half written file around, it would be rejected anyway. */
+  if (!ok) remove(filename);
+  return ok;
+}
+
+/* Compiles the source. Returns NULL if the source has syntax errors. */
+static struct RProc * scriptcache_generate(Ruby * mrb, mrbc_context * c,
+                                           const char * source, size_t size) {
+  struct mrb_parser_state * parser;
+  struct RProc            * proc;
+  parser = mrb_parse_nstring(mrb, source, (int) size, c);
+  if (!parser) return NULL;
+  if (parser->nerr > 0) {
+    mrb_parser_free(parser);
+    return NULL;
+  }
+  proc = mrb_generate_code(mrb, parser);
+  mrb_parser_free(parser);
+  return proc;
+}
+
+/* Dumps the bytecode of the compiled proc and writes it to the cache file
+ * with the given key. */
+static bool scriptcache_store(Ruby * mrb, struct RProc * proc,
+                              const char * filename, uint64_t key) {
+  uint8_t * code = NULL;
+  size_t    code_size;
+  bool      ok;
+  if (mrb_dump_irep(mrb, proc->body.irep, SCRIPTCACHE_DUMP_FLAGS,
+                    &code, &code_size) != MRB_DUMP_OK) {
+    return false;
+  }
+  ok = scriptcache_write(filename, key, code, code_size);
+  mrb_free(mrb, code);
+  return ok;
+}
+
+/* Runs the compiled proc at the top level, the way mruby runs a loaded
+ * script. */
+static mrb_value scriptcache_exec(Ruby * mrb, struct RProc * proc) {
+#if defined(MRUBY_RELEASE_NO) && (MRUBY_RELEASE_NO >= 10200)
+  return mrb_top_run(mrb, proc, mrb_top_self(mrb), 0);
+#else
+  return mrb_run(mrb, proc, mrb_top_self(mrb));
+#endif
+}
+
+/* Loads and runs the cached bytecode of size bytes, and takes over code.
+ * Before mruby 2.1 the loaded methods point into the bytecode instead of
+ * having a copy, so then it is kept until scriptcache_done, also when the
+ * script is reloaded, since the old methods may still be referenced. */
+static mrb_value scriptcache_load(Ruby * mrb, mrbc_context * c,
+                                  unsigned char * code, size_t size) {
+#if defined(MRUBY_RELEASE_NO) && (MRUBY_RELEASE_NO >= 20100)
+  mrb_value v = mrb_load_irep_buf_cxt(mrb, code, size, c);
+  mem_free(code);
+  return v;
+#else
+  (void) size;
+  scriptcache_kept = mem_realloc(scriptcache_kept, sizeof(*scriptcache_kept)
+                                 * (scriptcache_kept_count + 1));
+  scriptcache_kept[scriptcache_kept_count++] = code;
+  return mrb_load_irep_cxt(mrb, code, c);
+#endif
+}
+
+/* Returns the index of the loaded script with the given vpath, or -1. */
+static int scriptcache_find(const char * vpath) {
+  int index;
+  for (index = 0; index < scriptcache_loaded_count; index++) {
+    if (strcmp(scriptcache_loaded[index].vpath, vpath) == 0) return index;
+  }
+  return -1;
+}
+
+/* Starts watching the directory of the file, if watching is supported. */
+static void scriptcache_watch_file(const char * filename) {
+#ifdef SCRIPTCACHE_USE_INOTIFY
+  ALLEGRO_PATH * dir;
+  if (scriptcache_inotify < 0) return;
+  dir = al_create_path(filename);
+  if (!dir) return;
+  al_set_path_filename(dir, NULL);
+  /* Adding a directory that is already watched just returns its watch. */
+  inotify_add_watch(scriptcache_inotify, PATH_CSTR(dir),
+                    IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+  al_destroy_path(dir);
+#else
+  (void) filename;
+#endif
+}
+
+/* Remembers that the script was loaded with the given key, modification
+ * time and size. Returns its index, or -1 if too many scripts were loaded. */
+static int scriptcache_track(const char * vpath, const char * filename,
+                             uint64_t key, time_t mtime, off_t size) {
+  ScriptCacheLoaded * loaded;
+  int index = scriptcache_find(vpath);
+  if (index < 0) {
+    if (scriptcache_loaded_count >= SCRIPTCACHE_LOADED_MAX) return -1;
+    index           = scriptcache_loaded_count;
+    loaded          = scriptcache_loaded + index;
+    loaded->vpath   = cstr_dup((char *) vpath);
+    loaded->filename= cstr_dup((char *) filename);
+    if ((!loaded->vpath) || (!loaded->filename)) {
+      free(loaded->vpath);
+      free(loaded->filename);
+      return -1;
+    }
+    loaded->parent  = scriptcache_current;
+    scriptcache_loaded_count++;
+    if (scriptcache_watching) scriptcache_watch_file(filename);
+  }
+  loaded             = scriptcache_loaded + index;
+  loaded->key        = key;
+  loaded->mtime      = mtime;
+  loaded->size       = size;
+  loaded->racy       = (mtime >= time(NULL));
+  loaded->generation = scriptcache_generation;
+  return index;
+}
+
+/* Returns true if the source of the loaded script differs from what was
+ * loaded. The modification time and size are compared, and the contents
+ * too if the script was saved in the same second that it was loaded. A
+ * script that is gone isn't changed. */
+static bool scriptcache_stale(ScriptCacheLoaded * loaded) {
+  time_t   mtime;
+  off_t    size;
+  char   * source;
+  size_t   length;
+  bool     stale;
+  if (!fifi_file_stat(loaded->filename, &mtime, &size)) return false;
+  if ((mtime != loaded->mtime) || (size != loaded->size)) return true;
+  if (!loaded->racy) return false;
+  source = scriptcache_slurp(loaded->filename, &length);
+  if (!source) return false;
+  stale  = (scriptcache_key(source, length) != loaded->key);
+  mem_free(source);
+  /* Any later save will change the mtime. */
+  if ((!stale) && (time(NULL) > mtime)) loaded->racy = false;
+  return stale;
+}
+
+/**
+* Runs the script with the given vpath from the data directory, from its
+* cached bytecode if that is up to date. Otherwise the script is compiled,
+* the bytecode is stored in the cache and then run. Scripts with syntax
+* errors are run from source so the errors are reported as usual.
+* During a reload, scripts that are already up to date aren't run again.
+* Returns -1 if the script can't be read.
+*/
+int scriptcache_run(Ruby * mrb, const char * vpath) {
+  ALLEGRO_PATH  * path, * cache_path;
+  char          * source;
+  unsigned char * cached = NULL;
+  struct RProc  * proc;
+  size_t          size, code_size;
+  uint64_t        key;
+  mrbc_context  * c;
+  mrb_value       v;
+  double          start;
+  time_t          mtime   = 0;
+  off_t           length  = 0;
+  int             ai, index, parent;
+
+  index       = scriptcache_find(vpath);
+  if (scriptcache_reloading && (index >= 0) &&
+      (scriptcache_loaded[index].generation == scriptcache_generation)) {
+    return 0;
+  }
+  start       = al_get_time();
+  path        = fifi_data_vpath(vpath);
+  /* Before reading, so changes made while loading are seen next time. */
+  if (path) fifi_file_stat(PATH_CSTR(path), &mtime, &length);
+  source      = path ? scriptcache_slurp(PATH_CSTR(path), &size) : NULL;
+  if (!source) {
+    LOG_ERROR("No such ruby file: %s\n", vpath);
+    if (path) al_destroy_path(path);
+    return -1;
+  }
+  key         = scriptcache_key(source, size);
+  index       = scriptcache_track(vpath, PATH_CSTR(path), key, mtime, length);
+  parent      = scriptcache_current;
+  scriptcache_current = index;
+  cache_path  = scriptcache_path(vpath);
+  if (cache_path) {
+    cached = scriptcache_read(PATH_CSTR(cache_path), key, &code_size);
+  }
+
+  ai = mrb_gc_arena_save(mrb);
+  c  = mrbc_context_new(mrb);
+  mrbc_filename(mrb, c, PATH_CSTR(path));
+  if (cached) {
+    scriptcache_stats_now.hits++;
+    v = scriptcache_load(mrb, c, cached, code_size);
+  } else {
+    /* Errors are reported when the source is loaded below. */
+    c->capture_errors = TRUE;
+    proc = scriptcache_generate(mrb, c, source, size);
+    c->capture_errors = FALSE;
+    if (proc) {
+      scriptcache_stats_now.misses++;
+      if (cache_path &&
+          !scriptcache_store(mrb, proc, PATH_CSTR(cache_path), key)) {
+        LOG_NOTE("Could not cache bytecode in %s\n", PATH_CSTR(cache_path));
+      }
+      v = scriptcache_exec(mrb, proc);
+    } else {
+      scriptcache_stats_now.failed++;
+      v = mrb_load_nstring_cxt(mrb, source, (int) size, c);
+    }
+  }
+  mrbc_context_free(mrb, c);
+  rh_make_report(mrb, v);
+  mrb_gc_arena_restore(mrb, ai);
+  scriptcache_current = parent;
+
+  mem_free(source);
+  if (cache_path) al_destroy_path(cache_path);
+  al_destroy_path(path);
+  scriptcache_stats_now.time += al_get_time() - start;
+  return 0;
+}
+
+/**
+* Compiles the script with the given vpath into the cache without running
+* it, unless the cache is already up to date and force is false.
+* Returns 1 if compiled, 0 if up to date, negative on errors.
+*/
+int scriptcache_compile(Ruby * mrb, const char * vpath, bool force) {
+  ALLEGRO_PATH  * path, * cache_path;
+  char          * source;
+  unsigned char * cached;
+  struct RProc  * proc;
+  size_t          size;
+  uint64_t        key;
+  mrbc_context  * c;
+  int             ai, result = 1;
+
+  path        = fifi_data_vpath(vpath);
+  source      = path ? scriptcache_slurp(PATH_CSTR(path), &size) : NULL;
+  cache_path  = scriptcache_path(vpath);
+  if ((!source) || (!cache_path)) {
+    mem_free(source);
+    if (path)       al_destroy_path(path);
+    if (cache_path) al_destroy_path(cache_path);
+    return -1;
+  }
+  key = scriptcache_key(source, size);
+  if (!force) {
+    cached = scriptcache_read(PATH_CSTR(cache_path), key, NULL);
+    if (cached) result = 0;
+    mem_free(cached);
+  }
+  if (result > 0) {
+    ai = mrb_gc_arena_save(mrb);
+    c  = mrbc_context_new(mrb);
+    mrbc_filename(mrb, c, PATH_CSTR(path));
+    proc = scriptcache_generate(mrb, c, source, size);
+    if (!proc) {
+      LOG_ERROR("Syntax error in %s\n", PATH_CSTR(path));
+      result = -2;
+    } else if (!scriptcache_store(mrb, proc, PATH_CSTR(cache_path), key)) {
+      result = -3;
+    }
+    mrbc_context_free(mrb, c);
+    mrb_gc_arena_restore(mrb, ai);
+  }
+  mem_free(source);
+  al_destroy_path(cache_path);
+  al_destroy_path(path);
+  return result;
+}
+
+/**
+* Compiles all .rb files in the data directory with the given vpath and its
+* subdirectories into the cache. Returns the amount of scripts compiled, or
+* negative if the directory can't be read.
+*/
+int scriptcache_tree(Ruby * mrb, const char * vpath, bool force) {
+  ALLEGRO_PATH     * path;
+  ALLEGRO_FS_ENTRY * dir, * entry;
+  int compiled = 0;
+  path = fifi_data_vpath(vpath);
+  if (!path) return -1;
+  dir  = al_create_fs_entry(PATH_CSTR(path));
+  al_destroy_path(path);
+  if (!dir) return -1;
+  if (!al_open_directory(dir)) {
+    al_destroy_fs_entry(dir);
+    return -2;
+  }
+  while ((entry = al_read_directory(dir))) {
+    ALLEGRO_PATH * name = al_create_path(al_get_fs_entry_name(entry));
+    const char   * base = name ? al_get_path_filename(name) : NULL;
+    char           sub[FIFI_VPATH_MAX];
+    size_t         length;
+    int            res;
+    if (base &&
+        (snprintf(sub, sizeof(sub), "%s/%s", vpath, base) < (int) sizeof(sub))) {
+      length = strlen(base);
+      if (al_get_fs_entry_mode(entry) & ALLEGRO_FILEMODE_ISDIR) {
+        res = scriptcache_tree(mrb, sub, force);
+        if (res > 0) compiled += res;
+      } else if ((length > 3) && (strcmp(base + length - 3, ".rb") == 0)) {
+        res = scriptcache_compile(mrb, sub, force);
+        if (res > 0) compiled++;
+        if (res < 0) LOG_ERROR("Could not compile %s\n", sub);
+      }
+    }
+    if (name) al_destroy_path(name);
+    al_destroy_fs_entry(entry);
+  }
+  al_close_directory(dir);
+  al_destroy_fs_entry(dir);
+  return compiled;
+}
+
+/**
+* Returns the amount of loaded scripts whose source was modified since they
+* were loaded. The modification times and sizes are compared, and only for
+* scripts that were saved in the second they were loaded the contents.
+*/
+int scriptcache_changed(void) {
+  int index, changed = 0;
+  for (index = 0; index < scriptcache_loaded_count; index++) {
+    if (scriptcache_stale(scriptcache_loaded + index)) changed++;
+  }
+  return changed;
+}
+
+/**
+* Runs again only the loaded scripts whose source changed. Scripts that were
+* only touched are not run again. Returns the amount of scripts that were
+* run, or negative if no scripts were loaded yet, in which case they should
+* be loaded in full.
+*/
+int scriptcache_reload(Ruby * mrb) {
+  int index, reloaded = 0;
+  if (scriptcache_loaded_count < 1) return -1;
+  scriptcache_generation++;
+  for (index = 0; index < scriptcache_loaded_count; index++) {
+    ScriptCacheLoaded * loaded = scriptcache_loaded + index;
+    time_t   mtime;
+    off_t    length;
+    char   * source;
+    size_t   size;
+    /* Gone or unchanged, leave it be. */
+    if (!scriptcache_stale(loaded)) {
+      loaded->generation = scriptcache_generation;
+      continue;
+    }
+    if (!fifi_file_stat(loaded->filename, &mtime, &length)) continue;
+    source = scriptcache_slurp(loaded->filename, &size);
+    if (source && (scriptcache_key(source, size) == loaded->key)) {
+      /* Only touched. */
+      loaded->mtime      = mtime;
+      loaded->size       = length;
+      loaded->racy       = (mtime >= time(NULL));
+      loaded->generation = scriptcache_generation;
+    }
+    mem_free(source);
+  }
+  scriptcache_reloading = true;
+  /* Scripts loaded by the changed ones are added at the end while looping,
+   * but they are up to date already. */
+  for (index = 0; index < scriptcache_loaded_count; index++) {
+    if (scriptcache_loaded[index].generation == scriptcache_generation) {
+      continue;
+    }
+    LOG_NOTE("Reloading script %s\n", scriptcache_loaded[index].vpath);
+    scriptcache_run(mrb, scriptcache_loaded[index].vpath);
+    reloaded++;
+  }
+  scriptcache_reloading = false;
+  return reloaded;
+}
+
+/** Forgets which scripts were loaded, so the next reload loads all. */
+void scriptcache_forget(void) {
+  int index;
+  for (index = 0; index < scriptcache_loaded_count; index++) {
+    free(scriptcache_loaded[index].vpath);
+    free(scriptcache_loaded[index].filename);
+  }
+  scriptcache_loaded_count = 0;
+  scriptcache_current      = -1;
+}
+
+/** Frees the bytecode that was kept for the loaded scripts. Call this only
+ * after the ruby that ran them was closed. */
+void scriptcache_done(void) {
+  int index;
+  for (index = 0; index < scriptcache_kept_count; index++) {
+    mem_free(scriptcache_kept[index]);
+  }
+  scriptcache_kept       = mem_free(scriptcache_kept);
+  scriptcache_kept_count = 0;
+}
+
+/** Returns the vpath of the loaded script with the given index, and of the
+ * script that loaded it in parent, or NULL if out of range. parent is set
+ * to NULL for scripts that were loaded by the engine itself. */
+const char * scriptcache_loaded_vpath(int index, const char ** parent) {
+  ScriptCacheLoaded * loaded;
+  if ((index < 0) || (index >= scriptcache_loaded_count)) return NULL;
+  loaded = scriptcache_loaded + index;
+  if (parent) {
+    (*parent) = (loaded->parent < 0) ? NULL :
+                scriptcache_loaded[loaded->parent].vpath;
+  }
+  return loaded->vpath;
+}
+
+/**
+* Starts or stops watching the loaded scripts for changes. On Linux inotify
+* tells when the script directories change, elsewhere the modification times
+* are checked every SCRIPTCACHE_WATCH_INTERVAL seconds.
+*/
+bool scriptcache_watch_(bool watch) {
+#ifdef SCRIPTCACHE_USE_INOTIFY
+  int index;
+  if (watch && (scriptcache_inotify < 0)) {
+    scriptcache_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    for (index = 0; index < scriptcache_loaded_count; index++) {
+      scriptcache_watch_file(scriptcache_loaded[index].filename);
+    }
+  } else if ((!watch) && (scriptcache_inotify >= 0)) {
+    close(scriptcache_inotify);
+    scriptcache_inotify = -1;
+  }
+#endif
+  return scriptcache_watching = watch;
+}
+
+/** Returns true if the loaded scripts are watched for changes. */
+bool scriptcache_watch(void) {
+  return scriptcache_watching;
+}
+
+/**
+* Returns true if the loaded scripts are watched and some of them changed,
+* so they should be reloaded. Cheap enough to call every frame.
+*/
+bool scriptcache_poll(void) {
+  double now;
+  if (!scriptcache_watching) return false;
+  now = al_get_time();
+#ifdef SCRIPTCACHE_USE_INOTIFY
+  if (scriptcache_inotify >= 0) {
+    char    events[4096];
+    ssize_t got;
+    while ((got = read(scriptcache_inotify, events, sizeof(events))) > 0) {
+      scriptcache_touched    = true;
+      scriptcache_touched_at = now;
+    }
+    /* Editors may write a file in steps, check the scripts only once the
+     * events stopped coming in for a while. */
+    if ((!scriptcache_touched) ||
+        ((now - scriptcache_touched_at) < SCRIPTCACHE_WATCH_QUIET)) {
+      return false;
+    }
+    scriptcache_touched = false;
+    return scriptcache_changed() > 0;
+  }
+#endif
+  if ((now - scriptcache_checked) < SCRIPTCACHE_WATCH_INTERVAL) return false;
+  scriptcache_checked = now;
+  return scriptcache_changed() > 0;
+}
+
+/** Returns true if scripts are run through the cache. */
+bool scriptcache_enabled(void) {
+  return scriptcache_enabled_now;
+}
+
+/** Sets whether scripts are run through the cache. */
+bool scriptcache_enabled_(bool enabled) {
+  return scriptcache_enabled_now = enabled;
+}
+
+/** Copies the statistics of the cache to stats. */
+bool scriptcache_stats(ScriptCacheStats * stats) {
+  if (!stats) return false;
+  (*stats) = scriptcache_stats_now;
+  return true;
+}
+
@@ -3,8 +3,10 @@
 #include "draw.h"
 #include "store.h"
 
+/* The textures are indexes in the store, or negative for none. They are 
+ * fetched when drawing, since the store may evict the bitmaps. */
 struct Skybox_ {
-  ALLEGRO_BITMAP * textures[SKYBOX_DIRECTION_MAX];
+  int              textures[SKYBOX_DIRECTION_MAX];
   ALLEGRO_COLOR    colors[SKYBOX_DIRECTION_MAX][4];
 };
 
@@ -18,13 +20,13 @@ int skybox_set_texture(int direction, int texture) {
   if (direction < 0) return -1;
   if (direction >= SKYBOX_DIRECTION_MAX) return -2;
   if (texture < 0) {
-    skybox.textures[direction] = NULL;
+    skybox.textures[direction] = -1;
     return 0;
   }
   
   bitmap = store_get_bitmap(texture);
   if (!bitmap) return -3;
-  skybox.textures[direction] = bitmap;
+  skybox.textures[direction] = texture;
   return 0;
 }
 
@@ -97,34 +99,39 @@ void skybox_init(void) {
 };
 
 
+/* Returns the bitmap of the texture of the direction, or NULL if none. */
+static ALLEGRO_BITMAP * skybox_texture(int direction) {
+  return store_get_bitmap(skybox.textures[direction]);
+}
+
 /* Draws sky box and floor pane. */
 void skybox_draw(void) {
   // floor pane
   draw_tiled_floor(-500, -0.1, -500, 1000, 1000, 
-    skybox.colors[SKYBOX_DIRECTION_DOWN], skybox.textures[SKYBOX_DIRECTION_DOWN]
+    skybox.colors[SKYBOX_DIRECTION_DOWN], skybox_texture(SKYBOX_DIRECTION_DOWN)
   );
     
   // sky box sides
   draw_wall(-500, -500, -500, -1000, 1000,  
-    skybox.colors[SKYBOX_DIRECTION_NORTH], skybox.textures[SKYBOX_DIRECTION_NORTH]    
+    skybox.colors[SKYBOX_DIRECTION_NORTH], skybox_texture(SKYBOX_DIRECTION_NORTH)    
   );  
   
   
   draw_wall(-500, -500, 500,  1000, 1000, 
-    skybox.colors[SKYBOX_DIRECTION_SOUTH], skybox.textures[SKYBOX_DIRECTION_SOUTH]
+    skybox.colors[SKYBOX_DIRECTION_SOUTH], skybox_texture(SKYBOX_DIRECTION_SOUTH)
   );
   
   
   draw_wall2(-500, -500, -500, 1000, 1000,
-    skybox.colors[SKYBOX_DIRECTION_WEST], skybox.textures[SKYBOX_DIRECTION_WEST]      
+    skybox.colors[SKYBOX_DIRECTION_WEST], skybox_texture(SKYBOX_DIRECTION_WEST)      
   );
   
   draw_wall2(500, -500, -500, 1000, -1000, 
-    skybox.colors[SKYBOX_DIRECTION_EAST], skybox.textures[SKYBOX_DIRECTION_EAST]    
+    skybox.colors[SKYBOX_DIRECTION_EAST], skybox_texture(SKYBOX_DIRECTION_EAST)    
   );
   // sky box ceiling.
   draw_floor(-500, 500, -500, -1000, -1000,
-    skybox.colors[SKYBOX_DIRECTION_UP], skybox.textures[SKYBOX_DIRECTION_UP]
+    skybox.colors[SKYBOX_DIRECTION_UP], skybox_texture(SKYBOX_DIRECTION_UP)
   );  
 }
 
@@ -9,6 +9,10 @@
 #include "flags.h"
 #include "fifi.h"
 #include "spritelayout.h"
+#include "atlas.h"
+#include "framecache.h"
+#include "spriteload.h"
+#include "arena.h"
 
 /* Define this to see how the sprites are being loaded. */
 #define SPRITE_LOAD_DISPLAY
@@ -18,9 +22,11 @@
 #define SPRITE_TILE_WIDE 32
 #define SPRITE_TILE_HIGH 32
 
-/* Sprite atlases could be faster, but they waste a lot of memory since 
- * sprites often have a lot of transparent space. Therefore, the Sprite system 
- * uses a non-atlas layered cell design. 
+/* The Sprite system uses a layered cell design. To avoid wasting memory on
+ * the transparent space around the cells, every cell is trimmed to the 
+ * bounding box of it's visible pixels when it is loaded. The trimmed cells of 
+ * all sprites are then packed together into the pages of a shared atlas, so 
+ * drawing the layers of many sprites can be batched by Allegro.
  * 
  * In this design, there is a single sprite list that contains a 
  * list of sprites. 
@@ -147,44 +153,106 @@ struct SpriteCell_ {
   Point   size;
   int     index;
   int     drawflags;
+  /* Page of the sprite atlas that image is a part of, or negative if the 
+   * image is a bitmap of it's own. */
+  int     page;
+  /* Arena the cell was allocated from, or NULL if allocated on it's own. */
+  Arena * arena;
 };
 
 
+/* The atlas shared by all sprites. */
+static Atlas * sprite_atlas = NULL;
+
+/* Returns the sprite atlas, creating it if needed. */
+static Atlas * sprite_get_atlas() {
+  if (!sprite_atlas) {
+    sprite_atlas = atlas_new(ATLAS_PAGE_WIDE, ATLAS_PAGE_HIGH);
+  }
+  return sprite_atlas;
+}
+
+/** Frees the sprite atlas. Must be called after all sprites have been freed.*/
+void sprite_atlas_done() {
+  sprite_atlas = atlas_free(sprite_atlas);
+}
+
+/** Copies the statistics of the sprite atlas into stats. */
+bool sprite_atlas_stats(AtlasStats * stats) {
+  return atlas_stats(sprite_atlas, stats);
+}
+
+
 /* A SpriteFrame is a single frame of animation of a sprite.
  * It consists of a set of cells, a duration, flags, and the amount 
  * of used cells.  
  */
 struct SpriteFrame_ {
   int                index;
-  Dynar            * cells;
+  SpriteCell      ** cells;
+  int                cells_size;
   int                cells_used;
   double             duration;
+  Arena            * arena;
 };
 
 struct SpriteAction_ {
   int                index;
   int                type;
   int                directions;
-  Dynar            * frames;
+  SpriteFrame     ** frames;
+  int                frames_size;
   int                frames_used;
   SpriteFrame      * frame_now;
+  Arena            * arena;
 };
 
 
-/* A sprite has several actions and frames. */
+/* A sprite has several actions and frames. 
+ * The actions, frames and cells of a sprite, and the arrays of pointers 
+ * to them, are allocated from the arena of the sprite, since they are 
+ * many and small, and are freed all at once with the sprite anyway. 
+ * To avoid the 3 pointer deep lookup while animating, the durations of and 
+ * pointers to the used frames of all actions are also kept in flat tables,
+ * where the frames of action a start at flat_first[a]. These tables are 
+ * rebuilt when they are needed after the actions or frames changed. */
 struct Sprite_ {
   Dynar            * actions;
   int                actions_used;
   int                index;
+  int              * flat_first;
+  int              * flat_count;
+  double           * flat_durations;
+  SpriteFrame     ** flat_frames;
+  int                flat_ok;
+  /* Amount of layers still being loaded in the background, and the offset
+   * and size of their cells. */
+  int                loading;
+  Point              loading_offset;
+  Point              loading_size;
+  Arena            * arena;
 };
 
+static void sprite_unflatten(Sprite * self);
+
 
 /* Sprite Cells. */
 
 /* Allocates a sprite cell. */
 SpriteCell * 
 spritecell_alloc() {
-  return STRUCT_ALLOC(SpriteCell);
+  SpriteCell * self = STRUCT_ALLOC(SpriteCell);
+  if (self) self->arena = NULL;
+  return self;
+}
+
+/* Allocates a sprite cell from the arena, or on it's own if arena is NULL. */
+static SpriteCell * spritecell_alloc_in(Arena * arena) {
+  SpriteCell * self;
+  if (!arena) return spritecell_alloc();
+  self = ARENA_ALLOC(arena, SpriteCell);
+  if (self) self->arena = arena;
+  return self;
 }
 
 /* Initialize a sprite cell. */
@@ -196,6 +264,7 @@ spritecell_initall(SpriteCell * self, int index, Image * image, Point size, Poin
   self->offset          = offset;
   self->size            = size;
   self->drawflags       = 0;
+  self->page            = -1;
   return self;
 }
 
@@ -203,7 +272,14 @@ SpriteCell * spritecell_new(int index, Image * image, Point size, Point offset)
   return spritecell_initall(spritecell_alloc(), index, image, size, offset);
 } 
 
+/* Makes a new sprite cell in the arena. */
+static SpriteCell * spritecell_new_in(Arena * arena, 
+  int index, Image * image, Point size, Point offset) {
+  return spritecell_initall(spritecell_alloc_in(arena), index, image, size, offset);
+} 
+
 Image * spritecell_image(SpriteCell * self) {
+  if (!self) return NULL;
   return self->image;
 }
 
@@ -223,7 +299,7 @@ Point spritecell_real_position(SpriteCell * self, Point * at) {
  * the cell will be tinted with the given tint. */
 void spritecell_draw_tinted(SpriteCell * self, Point * at, Color tint) {
   Point real, delta, aid;
-  if(!self) return;
+  if(!self || !self->image) return;
   /* This delta is used for centering the object */
   /* delta = bevec(-self->size.x / 2, -self->size.y); */
   real   = bevec_add((*at), self->offset);
@@ -244,17 +320,27 @@ void spritecell_draw(SpriteCell * self, Point * at) {
 SpriteCell * 
 spritecell_done(SpriteCell * self) {
   if (!self) return NULL;
-  if (self->image) al_destroy_bitmap(self->image);
+  if (self->image) { 
+    if (self->page >= 0) {
+      atlas_release(sprite_atlas, self->image, self->page);
+    } else {
+      al_destroy_bitmap(self->image);
+    }
+  }
   self->image           = NULL;
+  self->page            = -1;
   self->drawflags       = 0;
   self->index           = -1;
   self->offset          = bevec(0.0, 0.0);
   return self;
 }
 
-/* Cleans up and frees memory used by a sprite cell.*/
+/* Cleans up and frees memory used by a sprite cell. The memory of a cell
+ * that was allocated from an arena is freed with the arena. */
 SpriteCell * spritecell_free(SpriteCell * self) {
+  if (!self) return NULL;
   spritecell_done(self);
+  if (self->arena) return NULL;
   return mem_free(self);
 }
 
@@ -271,7 +357,7 @@ spritecell_drawflags_(SpriteCell * self, int drawflags) {
 
 
 int spriteframe_maxlayers(SpriteFrame * self) {
-  return dynar_size(self->cells);
+  return self->cells_size;
 }
 
 int spriteframe_cells(SpriteFrame * self) {
@@ -284,21 +370,34 @@ SpriteFrame * spriteframe_init(SpriteFrame * self,
 
   if (!self) return NULL;
   self->index           = index;
-  self->cells           = dynar_newptr(ncells);
-  dynar_putnullall(self->cells);
+  self->cells           = 
+    arena_reallocate(self->arena, NULL, 0, ncells * sizeof(SpriteCell *));
+  self->cells_size      = (self->cells ? ncells : 0);
   self->cells_used      = 0;
   self->duration        = duration;
   return self;
 } 
 
 SpriteFrame * spriteframe_alloc() {
-  return STRUCT_ALLOC(SpriteFrame);
+  SpriteFrame * self = STRUCT_ALLOC(SpriteFrame);
+  if (self) self->arena = NULL;
+  return self;
+}
+
+/* Allocates a sprite frame from the arena, or on it's own if arena is NULL. */
+static SpriteFrame * spriteframe_alloc_in(Arena * arena) {
+  SpriteFrame * self;
+  if (!arena) return spriteframe_alloc();
+  self = ARENA_ALLOC(arena, SpriteFrame);
+  if (self) self->arena = arena;
+  return self;
 }
 
 /* Gets a cell for this frame or null if not available. */
 SpriteCell * spriteframe_cell(SpriteFrame * self, int index) {
   if(!self) return NULL;
-  return dynar_getptr(self->cells, index);  
+  if (bad_outofboundsi(index, 0, self->cells_size)) return NULL;
+  return self->cells[index];  
 }
 
 
@@ -308,18 +407,21 @@ SpriteFrame * spriteframe_done(SpriteFrame * self) {
   if(!self) return NULL;
   self->duration        = 0.0;
   self->cells_used     = -1;
-  for (index = 0; index < dynar_size(self->cells); index++) {
+  for (index = 0; index < self->cells_size; index++) {
     layer = spriteframe_cell(self, index);
     spritecell_free(layer);
   }
-  dynar_free(self->cells);
+  if (!self->arena) mem_free(self->cells);
   self->cells          = NULL;
+  self->cells_size     = 0;
   self->index           = -1;
   return self;
 }
 
 SpriteFrame * spriteframe_free(SpriteFrame * self) {
+  if (!self) return NULL;
   spriteframe_done(self);
+  if (self->arena) return NULL;
   return mem_free(self);
 }
 
@@ -334,17 +436,18 @@ SpriteCell * spriteframe_cell_(SpriteFrame * self, int index, SpriteCell * layer
 {
   SpriteCell * oldlayer;
   if(!self) return NULL;
+  if (bad_outofboundsi(index, 0, self->cells_size)) return NULL;
   oldlayer = spriteframe_cell(self, index);
   spritecell_free(oldlayer);
-  if(dynar_putptr(self->cells, index, layer)) { 
-    return layer;
-  }
-  return NULL;
+  self->cells[index] = layer;
+  return layer;
 }
 
 SpriteCell * spriteframe_new_cell(SpriteFrame * self, int index, 
                                    Image * image, Point size, Point offset) {
-  SpriteCell * layer = spritecell_new(index, image, size, offset);
+  SpriteCell * layer;
+  if (!self) return NULL;
+  layer = spritecell_new_in(self->arena, index, image, size, offset);
   SpriteCell * aid;
   aid = spriteframe_cell_(self, index, layer);
   if (aid) return aid;
@@ -355,7 +458,7 @@ SpriteCell * spriteframe_new_cell(SpriteFrame * self, int index,
 
 int spriteaction_maxframes(SpriteAction *self) {
   if(!self) return 0;
-  return dynar_size(self->frames);
+  return self->frames_size;
 }
 
 int spriteaction_frames(SpriteAction *self) {
@@ -366,7 +469,8 @@ int spriteaction_frames(SpriteAction *self) {
 SpriteFrame * 
 spriteaction_frame(SpriteAction *self, int index) {
   if(!self) return 0;
-  return dynar_getptr(self->frames, index);
+  if (bad_outofboundsi(index, 0, self->frames_size)) return NULL;
+  return self->frames[index];
 }
 
 /* Sets a frame for this action, frees the old frame if it was set. 
@@ -376,12 +480,11 @@ SpriteFrame *
 spriteaction_frame_(SpriteAction *self, int index, SpriteFrame * frame) {
   SpriteFrame * oldframe;
   if(!self) return 0;
+  if (bad_outofboundsi(index, 0, self->frames_size)) return NULL;
   oldframe = spriteaction_frame(self, index);
   spriteframe_free(oldframe);
-  if (dynar_putptr(self->frames, index, frame)) { 
-    return frame;
-  } 
-  return NULL;
+  self->frames[index] = frame;
+  return frame;
 }
 
 
@@ -389,14 +492,15 @@ SpriteAction *
 spriteaction_initall(SpriteAction * self, 
   int index, int type, int directions, int nframes) {
   
-  int aid;
+  if (!self) return NULL;
   self->index           = index;
   self->type            = type;
-  self->frames          = dynar_new(nframes, sizeof(SpriteFrame *));
+  self->frames          = 
+    arena_reallocate(self->arena, NULL, 0, nframes * sizeof(SpriteFrame *));
+  self->frames_size     = (self->frames ? nframes : 0);
   self->frames_used     = 0;
   self->directions      = directions;
   self->frame_now       = NULL;
-  dynar_putnullall(self->frames);
   return self;
 }
 
@@ -414,20 +518,34 @@ spriteaction_done(SpriteAction * self) {
     SpriteFrame * frame = spriteaction_frame(self, aid);
     spriteframe_free(frame); 
   }
-  dynar_free(self->frames);
-  self->frames = NULL;
-  self->frame_now = NULL;
+  if (!self->arena) mem_free(self->frames);
+  self->frames      = NULL;
+  self->frames_size = 0;
+  self->frame_now   = NULL;
   return self;
 }
 
 SpriteAction * spriteaction_free(SpriteAction * self) {
+  if (!self) return NULL;
   spriteaction_done(self);
+  if (self->arena) return NULL;
   return mem_free(self);
 }
 
 
 SpriteAction * spriteaction_alloc() {
-  return STRUCT_ALLOC(SpriteAction);
+  SpriteAction * self = STRUCT_ALLOC(SpriteAction);
+  if (self) self->arena = NULL;
+  return self;
+}
+
+/* Allocates a sprite action from the arena, or on it's own if arena is NULL. */
+static SpriteAction * spriteaction_alloc_in(Arena * arena) {
+  SpriteAction * self;
+  if (!arena) return spriteaction_alloc();
+  self = ARENA_ALLOC(arena, SpriteAction);
+  if (self) self->arena = arena;
+  return self;
 }
 
 SpriteAction * spriteaction_newall(int index, int type, int flags, int nframes) {
@@ -438,6 +556,12 @@ SpriteAction * spriteaction_new(int index, int type, int flags) {
   return spriteaction_init(spriteaction_alloc(), index, type, flags);
 }
 
+/* Makes a new sprite action in the arena. */
+static SpriteAction * spriteaction_new_in(Arena * arena, 
+                                          int index, int type, int flags) {
+  return spriteaction_init(spriteaction_alloc_in(arena), index, type, flags);
+}
+
 /* Returns nonzero if this action matches the pose and direction. 
  * This compares the flag direction as a using the & operator.
  */
@@ -471,6 +595,13 @@ SpriteFrame * spriteframe_new(int index, double duration) {
   return spriteframe_newall(index, duration, SPRITEFRAME_NLAYERS_DEFAULT);  
 }
 
+/* Makes a new sprite frame in the arena. */
+static SpriteFrame * spriteframe_new_in(Arena * arena, 
+                                        int index, double duration) {
+  return spriteframe_init(spriteframe_alloc_in(arena), index, duration, 
+                          SPRITEFRAME_NLAYERS_DEFAULT);  
+}
+
 
 /* Gets the used actions of a sprite. */
 int sprite_actionsused(Sprite * sprite) {
@@ -533,6 +664,7 @@ SpriteAction * sprite_action(Sprite *self, int index) {
 SpriteAction * sprite_action_(Sprite *self, int index, SpriteAction * action) {
   SpriteAction * oldact;
   if(!self) return 0;
+  sprite_unflatten(self);
   oldact = sprite_action(self, index);
   if (oldact) {
     spriteaction_free(oldact);
@@ -592,6 +724,40 @@ int sprite_id(Sprite * sprite) {
   return sprite->index;
 }
 
+/** Returns the amount of layers of the sprite that are still being loaded
+ * in the background. */
+int sprite_loading(Sprite * sprite) {
+  if (sprite == NULL) return 0;
+  return sprite->loading;
+}
+
+/** Adds delta to the amount of layers of the sprite that are still being
+ * loaded in the background. Returns the new amount. */
+int sprite_loading_(Sprite * sprite, int delta) {
+  if (sprite == NULL) return 0;
+  sprite->loading += delta;
+  if (sprite->loading < 0) sprite->loading = 0;
+  return sprite->loading;
+}
+
+/** Gets the offset and size of the cells of the layers that are being
+ * loaded. Returns FALSE if they aren't known. */
+int sprite_loading_box(Sprite * sprite, Point * offset, Point * size) {
+  if ((sprite == NULL) || (sprite->loading_size.x <= 0.0) ||
+      (sprite->loading_size.y <= 0.0)) return FALSE;
+  if (offset) (*offset) = sprite->loading_offset;
+  if (size)   (*size)   = sprite->loading_size;
+  return TRUE;
+}
+
+/** Sets the offset and size of the cells of the layers that are being
+ * loaded, so something of the right size can be drawn meanwhile. */
+void sprite_loading_box_(Sprite * sprite, Point offset, Point size) {
+  if (sprite == NULL) return;
+  sprite->loading_offset = offset;
+  sprite->loading_size   = size;
+}
+
 
 /* Returns the amount of frames an action has. */
 int sprite_frames(Sprite *self, int action) {
@@ -607,6 +773,74 @@ SpriteFrame * sprite_frame(Sprite *self, int action, int index) {
 }
 
 
+/* Frees the flat frame tables of the sprite, they will be rebuilt when
+ * needed. Must be called whenever actions or frames are added or removed. */
+static void sprite_unflatten(Sprite * self) {
+  self->flat_first     = mem_free(self->flat_first);
+  self->flat_count     = mem_free(self->flat_count);
+  self->flat_durations = mem_free(self->flat_durations);
+  self->flat_frames    = mem_free(self->flat_frames);
+  self->flat_ok        = FALSE;
+}
+
+/* Builds the flat frame tables of the sprite. Returns FALSE if out of memory.*/
+static int sprite_flatten(Sprite * self) {
+  int action, frame, total = 0, max;
+  sprite_unflatten(self);
+  max = sprite_maxactions(self);
+  if (max < 1) return FALSE;
+  self->flat_first = STRUCT_NALLOC(int, max);
+  self->flat_count = STRUCT_NALLOC(int, max);
+  if (!self->flat_first || !self->flat_count) {
+    sprite_unflatten(self);
+    return FALSE;
+  }
+  for (action = 0; action < max; action++) {
+    self->flat_first[action] = total;
+    self->flat_count[action] = sprite_framesused(self, action);
+    total += self->flat_count[action];
+  }
+  if (total > 0) {
+    self->flat_durations = STRUCT_NALLOC(double, total);
+    self->flat_frames    = STRUCT_NALLOC(SpriteFrame *, total);
+    if (!self->flat_durations || !self->flat_frames) {
+      sprite_unflatten(self);
+      return FALSE;
+    }
+  }
+  for (action = 0; action < max; action++) {
+    for (frame = 0; frame < self->flat_count[action]; frame++) {
+      SpriteFrame * now = sprite_frame(self, action, frame);
+      self->flat_frames[self->flat_first[action] + frame]    = now;
+      self->flat_durations[self->flat_first[action] + frame] = 
+        spriteframe_duration(now);
+    }
+  }
+  self->flat_ok = TRUE;
+  return TRUE;
+}
+
+/** Returns the amount of used frames of the action of the sprite, using the
+ * flat frame tables. Returns 0 if the action doesn't exist. */
+int sprite_flat_frames(Sprite * self, int action) {
+  if (!self) return 0;
+  if (!self->flat_ok && !sprite_flatten(self)) return 0;
+  if (bad_outofboundsi(action, 0, sprite_maxactions(self))) return 0;
+  return self->flat_count[action];
+}
+
+/** Looks up a used frame of an action of the sprite in the flat frame
+ * tables. Stores it's duration in duration if that is not NULL.
+ * Returns NULL if the action or frame doesn't exist. */
+SpriteFrame * 
+sprite_flat_frame(Sprite * self, int action, int frame, double * duration) {
+  int index;
+  if (bad_outofboundsi(frame, 0, sprite_flat_frames(self, action))) return NULL;
+  index = self->flat_first[action] + frame;
+  if (duration) (*duration) = self->flat_durations[index];
+  return self->flat_frames[index];
+}
+
 /** Returns a layer of the sprite that's at the given the action, frame,
  * and layer indexes of NULL if not found. */
 SpriteCell * sprite_layer(Sprite * self, int action ,int frame, int layer) {
@@ -619,6 +853,15 @@ Sprite * sprite_initall(Sprite * self, int index, int nactions) {
   self->actions_used = 0;
   self->actions      = dynar_newptr(nactions);
   self->index        = index; 
+  self->flat_first     = NULL;
+  self->flat_count     = NULL;
+  self->flat_durations = NULL;
+  self->flat_frames    = NULL;
+  self->flat_ok        = FALSE;
+  self->loading        = 0;
+  self->loading_offset = bevec(0.0, 0.0);
+  self->loading_size   = bevec(0.0, 0.0);
+  self->arena          = arena_new(SPRITE_ARENA_BLOCK);
   dynar_putnullall(self->actions);
   return self;
 }
@@ -632,12 +875,19 @@ Sprite * sprite_init(Sprite * self, int index) {
 Sprite * sprite_done(Sprite * self) {
   int aid;
   if(!self) return NULL;
+  /* Composited frames of this sprite become invalid. */
+  framecache_drop_sprite(self);
+  /* Layers that are still loading have nowhere to go. */
+  spriteload_cancel_sprite(self);
+  sprite_unflatten(self);
   for (aid = 0; aid < sprite_maxactions(self); aid++) {
     SpriteAction * act = sprite_action(self, aid); 
     spriteaction_free(act);
   }   
   dynar_free(self->actions);
   self->actions    = NULL; 
+  /* All actions, frames and cells are freed in one go. */
+  self->arena      = arena_free(self->arena);
   return self;
 }
 
@@ -659,7 +909,8 @@ Sprite * sprite_new(int index) {
 SpriteFrame * spriteaction_newframe(SpriteAction * self, int index, 
                                     double duration) {
   SpriteFrame * frame, * aid;
-  frame = spriteframe_new(index, duration);
+  if (!self) return NULL;
+  frame = spriteframe_new_in(self->arena, index, duration);
   if(!frame) return NULL;
   aid = spriteaction_frame_(self, index, frame);
   /* Free if could not set. */
@@ -686,7 +937,8 @@ int sprite_unused_action_index(Sprite * me) {
 SpriteAction * 
 sprite_set_new_action(Sprite * self, int actionindex, int type, int direction) {
   SpriteAction * action, * aid;
-  action = spriteaction_new(actionindex, type, direction);
+  if (!self) return NULL;
+  action = spriteaction_new_in(self->arena, actionindex, type, direction);
   if(!action) return NULL;
   aid = sprite_action_(self, actionindex, action);
   if (aid) return aid;
@@ -716,6 +968,7 @@ SpriteFrame * sprite_newframe(Sprite * self, int actionindex, int frameindex,
     LOG_WARNING("Could not create new frame %d for action %d\n", frameindex, actionindex);
     return NULL;
   } 
+  sprite_unflatten(self);
   return spriteaction_newframe(action, frameindex, duration);
 }
 
@@ -791,11 +1044,19 @@ void * spritecell_destructor(void * ptr) {
 /* Change the amount of cells the sprite frame can have. Returns self 
  on success, null if failed. */
 SpriteFrame * spriteframe_maxcells_(SpriteFrame * self, int newcells) {
-  int last, toclean, index;
-  Dynar * aid;
-  if(!self) return NULL;
-  aid = dynar_resize(self->cells, newcells, spritecell_destructor);  
-  if(!aid) return NULL;
+  int index;
+  SpriteCell ** aid;
+  if(!self || (newcells < 0)) return NULL;
+  for (index = newcells; index < self->cells_size; index++) {
+    spritecell_free(self->cells[index]);
+    self->cells[index] = NULL;
+  }
+  aid = arena_reallocate(self->arena, self->cells, 
+                         self->cells_size * sizeof(SpriteCell *),
+                         newcells * sizeof(SpriteCell *));  
+  if(!aid && (newcells > 0)) return NULL;
+  self->cells      = aid;
+  self->cells_size = newcells;
   return self;
 }
 
@@ -803,11 +1064,19 @@ SpriteFrame * spriteframe_maxcells_(SpriteFrame * self, int newcells) {
 /* Change the amount of frames the sprite action can have. Returns self 
  on success, null if failed. */
 SpriteAction * spriteaction_maxframes_(SpriteAction * self, int newframes) {
-  int last, toclean, index;
-  Dynar * aid;
-  if(!self) return NULL;
-  aid = dynar_resize(self->frames, newframes, spriteframe_destructor);  
-  if(!aid) return NULL;
+  int index;
+  SpriteFrame ** aid;
+  if(!self || (newframes < 0)) return NULL;
+  for (index = newframes; index < self->frames_size; index++) {
+    spriteframe_free(self->frames[index]);
+    self->frames[index] = NULL;
+  }
+  aid = arena_reallocate(self->arena, self->frames, 
+                         self->frames_size * sizeof(SpriteFrame *),
+                         newframes * sizeof(SpriteFrame *));  
+  if(!aid && (newframes > 0)) return NULL;
+  self->frames      = aid;
+  self->frames_size = newframes;
   return self;
 }
 
@@ -818,6 +1087,7 @@ Sprite * sprite_maxactions_(Sprite * self, int newactions) {
   int last, toclean, index;
   Dynar * aid;
   if(!self) return NULL;
+  sprite_unflatten(self);
   aid = dynar_resize(self->actions, newactions, spriteaction_destructor);  
   if(!aid) return NULL;
   return self;
@@ -903,6 +1173,7 @@ SpriteCell * sprite_append_cell
   
   action = sprite_need_action(me, pose, direction);
   if (!action) return NULL;
+  sprite_unflatten(me);
   frame  = spriteaction_need_frame_for_layer(action, layeri, duration);
   if (!frame) return NULL;
   cell = spriteframe_new_cell(frame, layeri, region, size, where);
@@ -914,19 +1185,14 @@ SpriteCell * sprite_append_cell
   return cell;
 }
 
-/** Loads a cell of the sprite from the given image. 
-* The indicated sprite sizes and locations will be used. 
-* If they don't exist yet an appropriate action and frame will be created
-* and placed in the correct layer. Part of the image will be duplicated.
-*
-* Returns the cell on success of NULL if something went wrong.
-*/
-SpriteCell * sprite_load_cell_from
-  (Sprite * self, int pose, int direction, int layeri, 
-   Image * source, Point size, Point where, Point offset, double duration) {
+/* Appends a region that was copied for a cell, from the atlas page with 
+ * index page or in a bitmap of it's own if page is negative, as a cell of 
+ * the sprite. Frees the region on failure. */
+static SpriteCell * sprite_add_region_cell
+  (Sprite * self, int pose, int direction, int layeri, Image * region, 
+   int page, Point size, Point offset, double duration) {
   SpriteCell * res;
-  Image * region;
-  region = image_copy_region(source, where.x, where.y, size.x, size.y, 0);
+  Atlas * atlas = sprite_get_atlas();
   
   if(!region) { 
     LOG_ERROR("Cannot copy region loading cell for: %d %d %d\n", 
@@ -940,13 +1206,75 @@ SpriteCell * sprite_load_cell_from
 
   if(!res) {
     LOG_ERROR("Could not make new sprite cell: %d\n", layeri);
-    al_destroy_bitmap(region);
+    if (page >= 0) {
+      atlas_release(atlas, region, page);
+    } else {
+      al_destroy_bitmap(region);
+    }
     return NULL;
   }
+  res->page = page;
+  /* Composited frames of this sprite no longer have all layers. */
+  framecache_drop_sprite(self);
   
   return res;
 }
 
+/** Loads a cell of the sprite from the given image. 
+* The indicated sprite sizes and locations will be used. 
+* If they don't exist yet an appropriate action and frame will be created
+* and placed in the correct layer. Part of the image will be duplicated
+* into the sprite atlas, trimmed of it's transparent borders. The offset
+* of the cell is adjusted for the trimming.
+*
+* Returns the cell on success of NULL if something went wrong.
+*/
+SpriteCell * sprite_load_cell_from
+  (Sprite * self, int pose, int direction, int layeri, 
+   Image * source, Point size, Point where, Point offset, double duration) {
+  Image * region;
+  Point trim = bevec(0.0, 0.0);
+  int page   = -1;
+  Atlas * atlas = sprite_get_atlas();
+  region = atlas_add_trimmed(atlas, source, where.x, where.y, size.x, size.y,
+                             &page, &trim);
+  if (!region) {
+    /* Too large for the atlas, use a bitmap of it's own. */
+    page   = -1;
+    trim   = bevec(0.0, 0.0);
+    region = image_copy_region(source, where.x, where.y, size.x, size.y, 0);
+  }
+  return sprite_add_region_cell(self, pose, direction, layeri, region, page,
+                                size, bevec_add(offset, trim), duration);
+}
+
+/** Loads a cell of the sprite from the given image, like 
+* sprite_load_cell_from, but with the trimming already done. trim is the 
+* top left corner and trimsize the size of the part of the cell at where 
+* that is not transparent. Used to load cells that were trimmed in the 
+* background.
+*
+* Returns the cell on success of NULL if something went wrong.
+*/
+SpriteCell * sprite_load_trimmed_cell_from
+  (Sprite * self, int pose, int direction, int layeri, Image * source, 
+   Point size, Point where, Point trim, Point trimsize, Point offset, 
+   double duration) {
+  Image * region;
+  int page   = -1;
+  Atlas * atlas = sprite_get_atlas();
+  Point from = bevec_add(where, trim);
+  region = atlas_add_region(atlas, source, from.x, from.y, 
+                            trimsize.x, trimsize.y, &page);
+  if (!region) {
+    page   = -1;
+    region = image_copy_region(source, from.x, from.y, 
+                               trimsize.x, trimsize.y, 0);
+  }
+  return sprite_add_region_cell(self, pose, direction, layeri, region, page,
+                                size, bevec_add(offset, trim), duration);
+}
+
 
 /** Loads a sprite cell from file with the given layout data. 
 The file name is in FIFI vpath format (subdir of data) */
@@ -0,0 +1,174 @@
+#include "eruta.h"
+#include "mem.h"
+#include "spriteanim.h"
+#include "callrb.h"
+
+/*
+ * The timing data of the active sprite states is kept in packed arrays,
+ * in the same order as spriteanim_states, so the update can run through them
+ * without touching the sprite states or sprites at all. The time of a
+ * registered sprite state lives in spriteanim_time, not in the state.
+ *
+ * A sprite state that is removed is replaced by the last one, so the arrays
+ * stay packed. Every sprite state knows it's own slot in anim_slot.
+ */
+
+static SpriteState    ** spriteanim_states    = NULL;
+static double          * spriteanim_time      = NULL;
+static double          * spriteanim_speedup   = NULL;
+static double          * spriteanim_duration  = NULL;
+static int               spriteanim_used      = 0;
+static int               spriteanim_size      = 0;
+
+/* Events waiting to be sent in a batch, and whether they should be batched
+ * at all, which is only while spriteanim_update is running. */
+static SpriteAnimEvent * spriteanim_events      = NULL;
+static int               spriteanim_events_used = 0;
+static int               spriteanim_events_size = 0;
+static int               spriteanim_batching    = FALSE;
+
+
+/* Makes sure there is room for at least one more sprite state. */
+static void spriteanim_grow(void) {
+  int newsize;
+  if (spriteanim_used < spriteanim_size) return;
+  newsize = (spriteanim_size < 1) ? 64 : spriteanim_size * 2;
+  spriteanim_states   = mem_realloc(spriteanim_states,
+                                    newsize * sizeof(SpriteState *));
+  spriteanim_time     = mem_realloc(spriteanim_time, newsize * sizeof(double));
+  spriteanim_speedup  = mem_realloc(spriteanim_speedup, newsize * sizeof(double));
+  spriteanim_duration = mem_realloc(spriteanim_duration, newsize * sizeof(double));
+  spriteanim_size     = newsize;
+}
+
+/** Adds the sprite state to the animation system. From then on it is
+ * advanced by spriteanim_update. Returns it's slot or negative on error. */
+int spriteanim_add(SpriteState * state) {
+  int slot;
+  if (!state) return -1;
+  if (state->anim_slot >= 0) return state->anim_slot;
+  spriteanim_grow();
+  slot                     = spriteanim_used;
+  spriteanim_states[slot]  = state;
+  state->anim_slot         = slot;
+  spriteanim_used++;
+  spriteanim_sync(state);
+  return slot;
+}
+
+/** Removes the sprite state from the animation system. Returns 0 on success
+ * or negative if it wasn't in it. */
+int spriteanim_remove(SpriteState * state) {
+  int slot, last;
+  if (!state) return -1;
+  slot = state->anim_slot;
+  if ((slot < 0) || (slot >= spriteanim_used)) return -2;
+  if (spriteanim_states[slot] != state) return -3;
+  /* Copy the time back, so the state can go on if it is updated by hand. */
+  state->time      = spriteanim_time[slot];
+  state->anim_slot = -1;
+  last             = spriteanim_used - 1;
+  if (slot != last) {
+    spriteanim_states[slot]   = spriteanim_states[last];
+    spriteanim_time[slot]     = spriteanim_time[last];
+    spriteanim_speedup[slot]  = spriteanim_speedup[last];
+    spriteanim_duration[slot] = spriteanim_duration[last];
+    spriteanim_states[slot]->anim_slot = slot;
+  }
+  spriteanim_used--;
+  return 0;
+}
+
+/** Copies the timing of the sprite state's current frame into the packed
+ * arrays. Must be called when the frame or the speedup of a registered
+ * sprite state changes. */
+void spriteanim_sync(SpriteState * state) {
+  int slot;
+  double duration = -1.0;
+  if (!state) return;
+  slot = state->anim_slot;
+  if ((slot < 0) || (slot >= spriteanim_used)) return;
+  if (state->frame_now) {
+    sprite_flat_frame(state->sprite, state->action_index, state->frame_index,
+                      &duration);
+  }
+  spriteanim_time[slot]     = state->time;
+  spriteanim_speedup[slot]  = state->speedup;
+  /* A state without a frame or sprite is looked at every update to
+   * try to restore it, like spritestate_update does. A state without a
+   * sprite can't do anything, so it's never looked at. */
+  if (!state->sprite) duration = HUGE_VAL;
+  spriteanim_duration[slot] = duration;
+}
+
+/* Sends the waiting events to the scripting side in one go. */
+static void spriteanim_flush_events(void) {
+  if (spriteanim_events_used < 1) return;
+  callrb_sprite_events(spriteanim_events, spriteanim_events_used);
+  spriteanim_events_used = 0;
+}
+
+/** Advances the animations of all registered sprite states by dt seconds.
+ * Returns the amount of sprite states that changed frames. */
+int spriteanim_update(double dt) {
+  int slot, changed = 0;
+  spriteanim_batching = TRUE;
+  for (slot = 0; slot < spriteanim_used; slot++) {
+    double time = spriteanim_time[slot] + (spriteanim_speedup[slot] * dt);
+    spriteanim_time[slot] = time;
+    if (time <= spriteanim_duration[slot]) continue;
+    /* The frame is over. This will call spriteanim_sync through
+     * spritestate_now_, and can't add or remove sprite states since the
+     * events are delayed. */
+    spritestate_advance(spriteanim_states[slot]);
+    changed++;
+  }
+  spriteanim_batching = FALSE;
+  spriteanim_flush_events();
+  return changed;
+}
+
+/** Notifies the scripting side of a sprite event. During spriteanim_update
+ * the event is delayed so all events can be sent in one batch, otherwise it
+ * is sent right away. */
+int spriteanim_notify(SpriteState * state, int kind) {
+  SpriteAnimEvent * event;
+  if (!state) return -1;
+  if (!spriteanim_batching) {
+    return callrb_sprite_event(state, kind, NULL);
+  }
+  if (spriteanim_events_used >= spriteanim_events_size) {
+    int newsize = (spriteanim_events_size < 1) ? 32 : spriteanim_events_size * 2;
+    spriteanim_events      = mem_realloc(spriteanim_events,
+                                         newsize * sizeof(SpriteAnimEvent));
+    spriteanim_events_size = newsize;
+  }
+  event            = spriteanim_events + spriteanim_events_used;
+  event->sprite    = sprite_id(spritestate_sprite(state));
+  event->pose      = spritestate_pose(state);
+  event->direction = spritestate_direction(state);
+  event->kind      = kind;
+  spriteanim_events_used++;
+  return 0;
+}
+
+/** Returns the amount of sprite states in the animation system. */
+int spriteanim_count(void) {
+  return spriteanim_used;
+}
+
+/** Cleans up the animation system. Any sprite states still in it are
+ * removed first. */
+void spriteanim_done(void) {
+  while (spriteanim_used > 0) {
+    spriteanim_remove(spriteanim_states[spriteanim_used - 1]);
+  }
+  spriteanim_states      = mem_free(spriteanim_states);
+  spriteanim_time        = mem_free(spriteanim_time);
+  spriteanim_speedup     = mem_free(spriteanim_speedup);
+  spriteanim_duration    = mem_free(spriteanim_duration);
+  spriteanim_events      = mem_free(spriteanim_events);
+  spriteanim_size        = 0;
+  spriteanim_events_size = 0;
+  spriteanim_events_used = 0;
+}
@@ -120,6 +120,43 @@ Sprite * sprite_loadlayerlayout_standinwalk(Sprite * self,
 */
 
 
+/* Amount of cells in a layout. */
+int spritelayout_cells(SpriteLayout * layout) {
+  int rowi, cells = 0;
+  for (rowi = 0; rowi < spritelayout_rows(layout); rowi++) {
+    cells += layout->per_row[rowi];
+  }
+  return cells;
+}
+
+/* Describes the cell at the given row and column of the layout: where it is 
+ * on the sprite sheet, it's size and offset, and the pose, direction and
+ * duration of the frame it belongs to. This does the same as 
+ * spritelayout_load_rc, without loading anything, so it can be used to slice 
+ * a sprite sheet that is loaded in the background. Returns negative on error. 
+ */
+int spritelayout_cell(SpriteLayout * layout, int rowi, int coli, 
+  int * pose, int * direction, Point * where, Point * size, Point * offset, 
+  double * duration) {
+  if ((rowi < 0) || (rowi >= spritelayout_rows(layout))) return -1;
+  if ((coli < 0) || (coli >= layout->per_row[rowi]))     return -2;
+  (*pose)      = layout->row_type[rowi];
+  (*direction) = layout->row_dir[rowi];
+  (*where)     = bevec(layout->size_x * coli, layout->size_y * rowi);
+  (*size)      = bevec(layout->size_x, layout->size_y);
+  (*offset)    = bevec(layout->offset_x, layout->offset_y);
+  (*duration)  = layout->row_duration[rowi];
+  /* special case for stand-in-walk cells. */
+  if (   (layout->standinwalk >= 0) 
+      && (coli == layout->standinwalk)
+      && ((*pose) == SPRITE_WALK)
+     ) {
+    (*pose) = SPRITE_STAND;
+  }
+  return 1;
+}
+
+
 /* Loads a single row and column of a sprite layout from the given image
  * into the given layer for a normal cell. */
 int spritelayout_load_rc_normal(
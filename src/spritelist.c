@@ -1,15 +1,32 @@
 
 #include "eruta.h"
+#include "mem.h"
 #include "dynar.h"
 #include "sprite.h"
 #include "spritelist.h"
 
 
 /* Sprite list functions. */
-/* The list of all loaded sprites. Some may be drawn and some not. */
+/* The list of all loaded sprites. Some may be drawn and some not. 
+ * 
+ * The sprites are kept in an array indexed by id that grows when needed, 
+ * up to maxsprites. Ids of deleted sprites are kept on a stack of free ids 
+ * so they can be reused without searching. Furthermore the ids of the live 
+ * sprites are also kept packed together in the live array, so they can be 
+ * walked without looking at the unused ids. live_slots maps the id of a 
+ * sprite to it's place in the live array.
+ */
 struct SpriteList_ {
-  Dynar * sprites;
-  int     sprites_used;
+  Sprite ** sprites;
+  int     * live_slots;
+  int       sprites_size;
+  int       sprites_max;
+  int       sprites_used;
+  int     * live;
+  int     * free_ids;
+  int       free_used;
+  /* Ids from here up to sprites_max have never been used. */
+  int       fresh_id;
 };
 
 
@@ -18,11 +35,18 @@ SpriteList * spritelist_alloc() {
   return STRUCT_ALLOC(SpriteList);
 }
 
+/* Initializes a sprite list that can hold up to maxsprites sprites. */
 SpriteList * spritelist_initall(SpriteList * self, int maxsprites) {
   if (!self) return NULL;
-  self->sprites         = dynar_newptr(maxsprites);
+  self->sprites         = NULL;
+  self->live_slots      = NULL;
+  self->live            = NULL;
+  self->free_ids        = NULL;
+  self->sprites_size    = 0;
+  self->sprites_max     = maxsprites;
   self->sprites_used    = 0;
-  dynar_putnullall(self->sprites);
+  self->free_used       = 0;
+  self->fresh_id        = 0;
   return self;
 }
 
@@ -32,10 +56,17 @@ SpriteList * spritelist_init(SpriteList * self) {
 
 SpriteList * spritelist_done(SpriteList * self) {
   if (!self) return NULL;
-  /* Clean up using a walker callback. */
-  dynar_walkptr(self->sprites, sprite_cleanup_walker, NULL);
-  self->sprites      = dynar_free(self->sprites);
-  self->sprites_used = 0;
+  /* Free the live sprites, last first so the live array stays packed. */
+  while (self->sprites_used > 0) {
+    spritelist_delete_sprite(self, self->live[self->sprites_used - 1]);
+  }
+  self->sprites      = mem_free(self->sprites);
+  self->live_slots   = mem_free(self->live_slots);
+  self->live         = mem_free(self->live);
+  self->free_ids     = mem_free(self->free_ids);
+  self->sprites_size = 0;
+  self->free_used    = 0;
+  self->fresh_id     = 0;
   return self;
 }
 
@@ -52,32 +83,107 @@ SpriteList * spritelist_free(SpriteList * self) {
 /* Gets a sprite from a sprite list. Returns NULL if not found;*/
 Sprite * spritelist_sprite(SpriteList * self, int index)  {
   if (!self) return NULL;
-  return dynar_getptr(self->sprites, index);
+  if ((index < 0) || (index >= self->sprites_size)) return NULL;
+  return self->sprites[index];
+}
+
+/* Makes sure the sprite list has room for a sprite with the given id. 
+ * Returns FALSE if the id is out of range or out of memory. The arrays that
+ * did grow before running out of memory are kept, they're only larger than
+ * sprites_size needs. */
+static int spritelist_grow(SpriteList * self, int index) {
+  int newsize, aid;
+  void * aid_ptr;
+  if ((index < 0) || (index >= self->sprites_max)) return FALSE;
+  if (index < self->sprites_size) return TRUE;
+  newsize = (self->sprites_size < 1) ? 64 : self->sprites_size;
+  while (newsize <= index) newsize *= 2;
+  if (newsize > self->sprites_max) newsize = self->sprites_max;
+  aid_ptr = mem_realloc(self->sprites, newsize * sizeof(Sprite *));
+  if (!aid_ptr) return FALSE;
+  self->sprites    = aid_ptr;
+  aid_ptr = mem_realloc(self->live_slots, newsize * sizeof(int));
+  if (!aid_ptr) return FALSE;
+  self->live_slots = aid_ptr;
+  aid_ptr = mem_realloc(self->live, newsize * sizeof(int));
+  if (!aid_ptr) return FALSE;
+  self->live       = aid_ptr;
+  aid_ptr = mem_realloc(self->free_ids, newsize * sizeof(int));
+  if (!aid_ptr) return FALSE;
+  self->free_ids   = aid_ptr;
+  for (aid = self->sprites_size; aid < newsize; aid++) {
+    self->sprites[aid]    = NULL;
+    self->live_slots[aid] = -1;
+  }
+  self->sprites_size = newsize;
+  return TRUE;
+}
+
+/* Takes the unused id index out of the free ids. */
+static void spritelist_claim_id(SpriteList * self, int index) {
+  int aid;
+  /* Ids that are skipped over become free. */
+  while (self->fresh_id < index) {
+    self->free_ids[self->free_used++] = self->fresh_id++;
+  }
+  if (self->fresh_id == index) {
+    self->fresh_id++;
+    return;
+  }
+  /* Normally the id is the last one freed, otherwise search for it. */
+  for (aid = self->free_used - 1; aid >= 0; aid--) {
+    if (self->free_ids[aid] != index) continue;
+    self->free_ids[aid] = self->free_ids[self->free_used - 1];
+    self->free_used--;
+    return;
+  }
+}
+
+/* Takes the sprite with the given id out of the sprite list without 
+ * freeing it. */
+static Sprite * spritelist_unlink(SpriteList * self, int index) {
+  Sprite * sprite;
+  int slot, last;
+  sprite = spritelist_sprite(self, index);
+  if (!sprite) return NULL;
+  slot = self->live_slots[index];
+  last = self->live[self->sprites_used - 1];
+  self->live[slot]                   = last;
+  self->live_slots[last]             = slot;
+  self->live_slots[index]            = -1;
+  self->sprites[index]               = NULL;
+  self->sprites_used--;
+  self->free_ids[self->free_used++]  = index;
+  return sprite;
 }
 
 
-/** Deletes a sprite with the given id from the sprite list and frees it. 
+/** Deletes a sprite with the given id from the sprite list and frees it,
+ * along with all it's actions, frames and cells. 
  * Returns negative on failure (sprite didn't exist), or 0
  * on success.  */
 int spritelist_delete_sprite(SpriteList * self, int index) {
   Sprite * sprite;
   if (!self) return -1;  
-  sprite = spritelist_sprite(self, index);
+  sprite = spritelist_unlink(self, index);
   if (!sprite) return -2;
   sprite_free(sprite);
-  dynar_putptr(self->sprites, index, NULL); 
   return 0;
 }
 
 
 /* Puts a sprite into a sprite list. If there was a sprite there already it will 
- * be freed */
+ * be freed. The sprite must have index as it's id. */
 Sprite * spritelist_sprite_(SpriteList * self, int index, Sprite * sprite) {
-  Sprite * old;
   if (!self) return NULL;
-  old = spritelist_sprite(self, index);
-  sprite_free(old);
-  dynar_putptr(self->sprites, index, sprite);  
+  spritelist_delete_sprite(self, index);
+  if (!sprite) return NULL;
+  if (!spritelist_grow(self, index)) return NULL;
+  spritelist_claim_id(self, index);
+  self->sprites[index]               = sprite;
+  self->live_slots[index]            = self->sprites_used;
+  self->live[self->sprites_used]     = index;
+  self->sprites_used++;
   return sprite;
 }
 
@@ -90,7 +196,8 @@ Sprite * spritelist_new_sprite(SpriteList * self) {
   if (index < 0) return NULL;  
   sprite = sprite_new(index);  
   if(!sprite) return NULL;
-  return spritelist_sprite_(self, index, sprite);
+  if (!spritelist_sprite_(self, index, sprite)) return sprite_free(sprite);
+  return sprite;
 }
 
 /** Makes a new sprite and returns it's ID or negative on error
@@ -101,6 +208,33 @@ int spritelist_new_sprite_id(SpriteList * self) {
   return sprite_id(sprite);
 }
 
+/** Returns the amount of live sprites in the sprite list. */
+int spritelist_count(SpriteList * self) {
+  if (!self) return 0;
+  return self->sprites_used;
+}
+
+/** Returns the nth live sprite in the sprite list, or NULL if out of range.
+ * The order of the live sprites changes when sprites are deleted. */
+Sprite * spritelist_live(SpriteList * self, int nth) {
+  if (!self) return NULL;
+  if ((nth < 0) || (nth >= self->sprites_used)) return NULL;
+  return self->sprites[self->live[nth]];
+}
+
+/** Calls walker for every live sprite in the sprite list, without looking at
+ * unused ids. Stops and returns the result of the walker if it returns non
+ * NULL. The walker must not add or delete sprites. */
+void * spritelist_walk(SpriteList * self, Walker * walker, void * extra) {
+  int index;
+  if (!self || !walker) return NULL;
+  for (index = 0; index < self->sprites_used; index++) {
+    void * aid = walker(self->sprites[self->live[index]], extra);
+    if (aid) return aid;
+  }
+  return NULL;
+}
+
 
 /* Makes a new sprite if it doesn't exist yet or otherwise returns the old one 
  at the given index. 
@@ -130,17 +264,12 @@ Sprite * spritelist_loadlayer_ulpcss_vpath(
 }
 
 
-/* Returns the first unused sprite ID larger than minimum. */
+/* Returns the first unused sprite ID, which is the last id that was freed, 
+ * or negative if the sprite list is full. */
 int spritelist_get_unused_sprite_id(SpriteList * self) {
-  int index, stop;
   if (!self) return -1;  
-  stop = dynar_size(self->sprites);
-  for (index = 0; index < stop; index++) {
-    Sprite * sprite = spritelist_sprite(self, index);
-    if (!sprite) {
-      return index;
-    }
-  }
+  if (self->free_used > 0) return self->free_ids[self->free_used - 1];
+  if (self->fresh_id < self->sprites_max) return self->fresh_id;
   return -3;
 }
 
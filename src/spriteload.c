@@ -0,0 +1,454 @@
+#include "eruta.h"
+#include "mem.h"
+#include "str.h"
+#include "fifi.h"
+#include "pack.h"
+#include "cook.h"
+#include "atlas.h"
+#include "spriteload.h"
+#include "spritelayout.h"
+#include "callrb.h"
+
+/*
+ * Loading the 8 or so layers of a ULPCSS sprite on the display thread stalls
+ * the game, mostly because of decoding the PNG files. Therefore the sprite
+ * sheets are loaded in the background.
+ *
+ * A job goes through the following stages:
+ * 1) QUEUED: spriteload_start made the job and put it in the queue.
+ * 2) SLICING: a worker thread decodes the sheet into a memory bitmap, and
+ *    works out where the cells are and how they should be trimmed. Like 
+ *    storeload, spriteload_start looks the sheet up in the data pack, and 
+ *    uses the cooked texture of it if there is one, so the worker only reads
+ *    from memory or from a file.
+ * 3) SLICED or FAILED: the worker is done with the job.
+ * 4) COPYING: spriteload_update copies the cells into the sprite atlas until
+ *    it runs out of time for this update, and goes on in the next update.
+ * 5) When all cells are copied, or if the job failed, the job is removed and
+ *    the scripting side is told through eruta_on_sprite_loaded.
+ *
+ * The queue and the status of the jobs are protected by spriteload_mutex.
+ * The other fields of a job are only touched by the thread that has the job
+ * in the SLICING stage, or by the display thread in the other stages.
+ * A sprite that is freed while it's layers are loading cancels it's jobs by
+ * setting their sprite to NULL, so they're dropped when they reach the
+ * display thread.
+ */
+
+enum SpriteLoadStatus_ {
+  SPRITELOAD_QUEUED  = 0,
+  SPRITELOAD_SLICING = 1,
+  SPRITELOAD_SLICED  = 2,
+  SPRITELOAD_FAILED  = 3,
+  SPRITELOAD_COPYING = 4
+};
+
+typedef struct SpriteLoadCell_ SpriteLoadCell;
+typedef struct SpriteLoadJob_  SpriteLoadJob;
+
+/* A cell of a sprite sheet, sliced and trimmed by a worker. */
+struct SpriteLoadCell_ {
+  int     pose;
+  int     direction;
+  Point   where;
+  Point   size;
+  Point   offset;
+  Point   trim;
+  Point   trimsize;
+  double  duration;
+};
+
+struct SpriteLoadJob_ {
+  int              id;
+  Sprite         * sprite;
+  int              sprite_id;
+  int              layer;
+  int              load_type;
+  char           * path;
+  char           * vpath;
+  /* True if path or packed is the cooked texture of the sheet. */
+  int              cooked;
+  /* Data of the sheet in the data pack, or NULL to load from path. */
+  const void     * packed;
+  size_t           packed_size;
+  int              status;
+  Image          * sheet;
+  SpriteLoadCell * cells;
+  int              ncells;
+  int              copied;
+  SpriteLoadJob  * next;
+};
+
+static ALLEGRO_THREAD * spriteload_workers[SPRITELOAD_WORKERS];
+static ALLEGRO_MUTEX  * spriteload_mutex    = NULL;
+static ALLEGRO_COND   * spriteload_cond     = NULL;
+static int              spriteload_stopping = FALSE;
+static SpriteLoadJob  * spriteload_first    = NULL;
+static SpriteLoadJob  * spriteload_last     = NULL;
+static int              spriteload_last_id  = 0;
+static double           spriteload_budget_now = SPRITELOAD_BUDGET_DEFAULT;
+static SpriteLoadStats  spriteload_stats_now;
+
+
+/* Frees a job and the sheet it still has, and releases the packed data it 
+ * used. */
+static void spriteload_job_free(SpriteLoadJob * job) {
+  if (job->sheet) al_destroy_bitmap(job->sheet);
+  if (job->packed) pack_forget(fifi_pack(), job->vpath);
+  free(job->path);
+  free(job->vpath);
+  mem_free(job->cells);
+  mem_free(job);
+}
+
+/* Finds the cells of the sheet of the job according to the layout, and trims
+ * them to the part that isn't transparent. The sheet must be locked. */
+static void spriteload_slice(SpriteLoadJob * job, SpriteLayout * layout,
+                             ALLEGRO_LOCKED_REGION * lock) {
+  int rowi, coli, index = 0;
+  int sheet_wide = al_get_bitmap_width(job->sheet);
+  int sheet_high = al_get_bitmap_height(job->sheet);
+  for (rowi = 0; rowi < spritelayout_rows(layout); rowi++) {
+    for (coli = 0; coli < layout->per_row[rowi]; coli++) {
+      SpriteLoadCell * cell = job->cells + index;
+      int x, y, wide, high, bx = 0, by = 0, bw = 1, bh = 1;
+      const unsigned char * data;
+      spritelayout_cell(layout, rowi, coli, &cell->pose, &cell->direction,
+                        &cell->where, &cell->size, &cell->offset,
+                        &cell->duration);
+      x    = cell->where.x;
+      y    = cell->where.y;
+      /* Only look at the part of the cell that is on the sheet. */
+      wide = cell->size.x;
+      high = cell->size.y;
+      if ((x + wide) > sheet_wide) wide = sheet_wide - x;
+      if ((y + high) > sheet_high) high = sheet_high - y;
+      if ((wide > 0) && (high > 0)) {
+        /* In ABGR_8888_LE the alpha is the last of the 4 bytes of a pixel. */
+        data = ((const unsigned char *) lock->data) + (y * lock->pitch) +
+               (x * lock->pixel_size) + 3;
+        if (!atlas_alpha_bounds(data, lock->pitch, lock->pixel_size,
+                                wide, high, &bx, &by, &bw, &bh)) {
+          bx = 0; by = 0; bw = 1; bh = 1;
+        }
+      }
+      cell->trim     = bevec(bx, by);
+      cell->trimsize = bevec(bw, bh);
+      index++;
+    }
+  }
+}
+
+/* Decodes and slices the sheet of the job. Runs on a worker thread.
+ * Returns true on success. */
+static bool spriteload_decode(SpriteLoadJob * job) {
+  ALLEGRO_LOCKED_REGION * lock;
+  ALLEGRO_FILE * file   = NULL;
+  SpriteLayout * layout = spritelayout_for(job->load_type);
+  if (!layout) return false;
+  if (job->packed) {
+    file = al_open_memfile((void *) job->packed, job->packed_size, "r");
+    if (!file) return false;
+  }
+  if (job->cooked) {
+    job->sheet = (file ? cook_load_bitmap_f(file)
+                       : cook_load_bitmap(job->path));
+  } else {
+    job->sheet = (file ? al_load_bitmap_f(file, 
+                                          fifi_vpath_extension(job->vpath))
+                       : al_load_bitmap(job->path));
+  }
+  if (file) al_fclose(file);
+  if (!job->sheet) {
+    LOG_WARNING("Could not load sprite sheet %s\n", job->vpath);
+    return false;
+  }
+  job->ncells = spritelayout_cells(layout);
+  job->cells  = STRUCT_NALLOC(SpriteLoadCell, job->ncells);
+  if (!job->cells) return false;
+  lock = al_lock_bitmap(job->sheet, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE,
+                        ALLEGRO_LOCK_READONLY);
+  if (!lock) return false;
+  spriteload_slice(job, layout, lock);
+  al_unlock_bitmap(job->sheet);
+  return true;
+}
+
+/* Returns the first job with the given status, or NULL if none.
+ * The mutex must be locked. */
+static SpriteLoadJob * spriteload_find(int status) {
+  SpriteLoadJob * job;
+  for (job = spriteload_first; job; job = job->next) {
+    if (job->status == status) return job;
+  }
+  return NULL;
+}
+
+/* The worker threads take queued jobs and decode them until stopped. */
+static void * spriteload_worker(ALLEGRO_THREAD * thread, void * arg) {
+  SpriteLoadJob * job;
+  bool ok;
+  (void) thread; (void) arg;
+  /* Memory bitmaps can be made on any thread, and are fast to lock. */
+  al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+  al_lock_mutex(spriteload_mutex);
+  while (!spriteload_stopping) {
+    job = spriteload_find(SPRITELOAD_QUEUED);
+    if (!job) {
+      al_wait_cond(spriteload_cond, spriteload_mutex);
+      continue;
+    }
+    /* Don't bother with jobs that were cancelled while queued. */
+    if (!job->sprite) {
+      job->status = SPRITELOAD_FAILED;
+      continue;
+    }
+    job->status = SPRITELOAD_SLICING;
+    al_unlock_mutex(spriteload_mutex);
+    ok = spriteload_decode(job);
+    al_lock_mutex(spriteload_mutex);
+    job->status = (ok ? SPRITELOAD_SLICED : SPRITELOAD_FAILED);
+  }
+  al_unlock_mutex(spriteload_mutex);
+  return NULL;
+}
+
+/* Starts the worker threads if they aren't running yet. */
+static bool spriteload_setup(void) {
+  int index;
+  if (spriteload_mutex) return true;
+  spriteload_mutex = al_create_mutex();
+  spriteload_cond  = al_create_cond();
+  if (!spriteload_mutex || !spriteload_cond) {
+    LOG_ERROR("Could not set up background sprite loading.\n");
+    spriteload_done();
+    return false;
+  }
+  spriteload_stopping = FALSE;
+  for (index = 0; index < SPRITELOAD_WORKERS; index++) {
+    spriteload_workers[index] = al_create_thread(spriteload_worker, NULL);
+    if (spriteload_workers[index]) al_start_thread(spriteload_workers[index]);
+  }
+  return true;
+}
+
+/* Makes the job load the cooked texture of its sheet, from the data pack or
+ * from the data directory, if there is one. */
+static void spriteload_use_cooked(SpriteLoadJob * job) {
+  char cooked[FIFI_VPATH_MAX];
+  ALLEGRO_PATH * path;
+  if (!cook_vpath(cooked, sizeof(cooked), job->vpath)) return;
+  if (pack_has(fifi_pack(), cooked)) {
+    job->packed = pack_data(fifi_pack(), cooked, &job->packed_size);
+    if (!job->packed) return;
+    free(job->vpath);
+    job->vpath  = cstr_dup(cooked);
+    job->cooked = TRUE;
+    return;
+  }
+  path = fifi_cooked_path(job->vpath);
+  if (!path) return;
+  free(job->path);
+  job->path   = cstr_dup((char *) PATH_CSTR(path));
+  job->cooked = TRUE;
+  al_destroy_path(path);
+}
+
+/** Starts loading a layer of the sprite from the sprite sheet at vpath, which
+ * has the built in layout load_type, in the background. The sprite counts
+ * as loading until the layer is done, and eruta_on_sprite_loaded is called
+ * when it's done. Returns the positive id of the load job, or negative on
+ * error. */
+int spriteload_start(Sprite * sprite, int layer, char * vpath, int load_type) {
+  SpriteLoadJob * job;
+  ALLEGRO_PATH  * path;
+  SpriteLayout  * layout = spritelayout_for(load_type);
+  if (!sprite || !vpath)                return -1;
+  if (!layout)                          return -2;
+  /* Work out the path here, since fifi isn't thread safe. */
+  path = fifi_data_vpath(vpath);
+  if (!path)                            return -3;
+  if (!spriteload_setup()) {
+    al_destroy_path(path);
+    return -4;
+  }
+  job             = STRUCT_ALLOC(SpriteLoadJob);
+  if (!job) {
+    al_destroy_path(path);
+    return -5;
+  }
+  job->path       = cstr_dup((char *) PATH_CSTR(path));
+  al_destroy_path(path);
+  job->vpath      = cstr_dup(vpath);
+  job->cooked     = FALSE;
+  job->packed     = NULL;
+  job->packed_size = 0;
+  /* The pack isn't thread safe either, so get the data here. */
+  spriteload_use_cooked(job);
+  if (!job->cooked && pack_has(fifi_pack(), vpath)) {
+    job->packed   = pack_data(fifi_pack(), vpath, &job->packed_size);
+  }
+  job->sprite     = sprite;
+  job->sprite_id  = sprite_id(sprite);
+  job->layer      = layer;
+  job->load_type  = load_type;
+  job->status     = SPRITELOAD_QUEUED;
+  job->sheet      = NULL;
+  job->cells      = NULL;
+  job->ncells     = 0;
+  job->copied     = 0;
+  job->next       = NULL;
+  sprite_loading_(sprite, 1);
+  sprite_loading_box_(sprite, bevec(layout->offset_x, layout->offset_y),
+                      bevec(layout->size_x, layout->size_y));
+  spriteload_stats_now.started++;
+  spriteload_stats_now.pending++;
+  al_lock_mutex(spriteload_mutex);
+  job->id         = ++spriteload_last_id;
+  if (spriteload_last) {
+    spriteload_last->next = job;
+  } else {
+    spriteload_first      = job;
+  }
+  spriteload_last = job;
+  al_signal_cond(spriteload_cond);
+  al_unlock_mutex(spriteload_mutex);
+  return job->id;
+}
+
+/* Returns the first job that the display thread can work on, and moves it
+ * to the copying stage if it's sliced. */
+static SpriteLoadJob * spriteload_next_ready(void) {
+  SpriteLoadJob * job;
+  al_lock_mutex(spriteload_mutex);
+  for (job = spriteload_first; job; job = job->next) {
+    if (job->status == SPRITELOAD_SLICED) job->status = SPRITELOAD_COPYING;
+    if ((job->status == SPRITELOAD_COPYING) ||
+        (job->status == SPRITELOAD_FAILED)) break;
+  }
+  al_unlock_mutex(spriteload_mutex);
+  return job;
+}
+
+/* Removes the job from the queue, tells the scripting side about it and
+ * frees it. */
+static void spriteload_finish(SpriteLoadJob * job) {
+  SpriteLoadJob * now, * prev = NULL;
+  int ok;
+  al_lock_mutex(spriteload_mutex);
+  for (now = spriteload_first; now; prev = now, now = now->next) {
+    if (now != job) continue;
+    if (prev) prev->next = job->next; else spriteload_first = job->next;
+    if (spriteload_last == job) spriteload_last = prev;
+    break;
+  }
+  al_unlock_mutex(spriteload_mutex);
+  ok = (job->sprite && (job->status == SPRITELOAD_COPYING));
+  if (job->sprite) sprite_loading_(job->sprite, -1);
+  if (ok) {
+    spriteload_stats_now.loaded++;
+  } else {
+    spriteload_stats_now.failed++;
+  }
+  spriteload_stats_now.pending--;
+  callrb_sprite_loaded(job->id, job->sprite_id, job->layer, ok);
+  spriteload_job_free(job);
+}
+
+/** Copies the cells of the sprite sheets that were decoded in the background
+ * into the sprite atlas, until budget seconds have passed. At least one cell
+ * is copied every call, so loading always makes progress. Must be called
+ * from the display thread. Returns the amount of cells copied. */
+int spriteload_update(double budget) {
+  SpriteLoadJob * job;
+  double start;
+  int copied = 0;
+  if (!spriteload_mutex) return 0;
+  start = al_get_time();
+  while ((job = spriteload_next_ready())) {
+    while (job->sprite && (job->status == SPRITELOAD_COPYING) &&
+           (job->copied < job->ncells)) {
+      SpriteLoadCell * cell = job->cells + job->copied;
+      if ((copied > 0) && ((al_get_time() - start) >= budget)) return copied;
+      sprite_load_trimmed_cell_from(job->sprite, cell->pose, cell->direction,
+        job->layer, job->sheet, cell->size, cell->where, cell->trim,
+        cell->trimsize, cell->offset, cell->duration);
+      job->copied++;
+      copied++;
+      spriteload_stats_now.cells++;
+    }
+    spriteload_finish(job);
+  }
+  return copied;
+}
+
+/** Cancels the loading of all layers of the sprite. Must be called before
+ * the sprite is freed. Returns the amount of jobs cancelled. */
+int spriteload_cancel_sprite(Sprite * sprite) {
+  SpriteLoadJob * job;
+  int cancelled = 0;
+  if (!spriteload_mutex || !sprite) return 0;
+  al_lock_mutex(spriteload_mutex);
+  for (job = spriteload_first; job; job = job->next) {
+    if (job->sprite != sprite) continue;
+    job->sprite = NULL;
+    cancelled++;
+  }
+  al_unlock_mutex(spriteload_mutex);
+  return cancelled;
+}
+
+/** Returns the amount of sprite layers that are still being loaded. */
+int spriteload_pending(void) {
+  return spriteload_stats_now.pending;
+}
+
+/** Returns the time in seconds spent on copying cells per update. */
+double spriteload_budget(void) {
+  return spriteload_budget_now;
+}
+
+/** Sets the time in seconds spent on copying cells per update.
+ * Returns the new budget. */
+double spriteload_budget_(double budget) {
+  if (budget < 0.0) budget = 0.0;
+  spriteload_budget_now = budget;
+  return budget;
+}
+
+/** Copies the statistics of the background loading into stats. */
+bool spriteload_stats(SpriteLoadStats * stats) {
+  if (!stats) return false;
+  (*stats) = spriteload_stats_now;
+  return true;
+}
+
+/** Stops the worker threads and drops all jobs that are still pending,
+ * without telling the scripting side. */
+void spriteload_done(void) {
+  SpriteLoadJob * job, * next;
+  int index;
+  if (spriteload_mutex && spriteload_cond) {
+    al_lock_mutex(spriteload_mutex);
+    spriteload_stopping = TRUE;
+    al_broadcast_cond(spriteload_cond);
+    al_unlock_mutex(spriteload_mutex);
+  }
+  for (index = 0; index < SPRITELOAD_WORKERS; index++) {
+    if (!spriteload_workers[index]) continue;
+    al_join_thread(spriteload_workers[index], NULL);
+    al_destroy_thread(spriteload_workers[index]);
+    spriteload_workers[index] = NULL;
+  }
+  for (job = spriteload_first; job; job = next) {
+    next = job->next;
+    if (job->sprite) sprite_loading_(job->sprite, -1);
+    spriteload_job_free(job);
+  }
+  spriteload_first = spriteload_last = NULL;
+  spriteload_stats_now.pending = 0;
+  if (spriteload_cond)  al_destroy_cond(spriteload_cond);
+  if (spriteload_mutex) al_destroy_mutex(spriteload_mutex);
+  spriteload_cond  = NULL;
+  spriteload_mutex = NULL;
+}
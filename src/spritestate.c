@@ -6,6 +6,9 @@
 #include "bad.h"
 #include "monolog.h"
 #include "callrb.h"
+#include "framecache.h"
+#include "spriteanim.h"
+#include <string.h>
 
 /* Sprite state layer functions. */
 SpriteStateLayer * spritestatelayer_init_empty(SpriteStateLayer * me) {
@@ -42,6 +45,7 @@ Sprite * spritestate_sprite_(SpriteState * self, Sprite * sprite) {
   self->time            = 0.0;
   self->pose_now        = SPRITE_STAND;
   self->direction_now   = SPRITE_ALL;
+  spriteanim_sync(self);
 
   /* No cleanup of sprite as it is not owned by the sprite state. */
   return self->sprite;
@@ -53,6 +57,8 @@ Sprite * spritestate_sprite_(SpriteState * self, Sprite * sprite) {
 */
 SpriteState * spritestate_done(SpriteState * self) { 
   int index;
+  if (!self) return NULL;
+  spriteanim_remove(self);
   return self;
 } 
 
@@ -72,8 +78,9 @@ SpriteState * spritestate_init(SpriteState * self, Sprite * sprite, void * data)
   int index;
   
   if(!self) return NULL;
+  self->anim_slot = -1;
+  self->speedup   = 1.0;
   spritestate_sprite_(self, sprite);
-  self->speedup = 1.0;
     
   for (index = 0 ; index < SPRITESTATE_LAYER_MAX; index ++) {
     spritestatelayer_init_empty(self->layers + index);
@@ -84,6 +91,10 @@ SpriteState * spritestate_init(SpriteState * self, Sprite * sprite, void * data)
   }
   
   self->data = data;
+  self->cache_frames = TRUE;
+  self->cache_dirty  = TRUE;
+  /* Let the animation system advance this sprite state. */
+  spriteanim_add(self);
   
   return self;
 }
@@ -101,7 +112,9 @@ double spritestate_speedup(SpriteState * self) {
 
 double spritestate_speedup_(SpriteState * self, double speedup) {
   if (!self) return 0.0;
-  return self->speedup = speedup;
+  self->speedup = speedup;
+  spriteanim_sync(self);
+  return self->speedup;
 }
 
 SpriteState * spritestate_new(Sprite *  sprite, void * data) {
@@ -118,18 +131,12 @@ int spritestate_can_draw_p(SpriteState * self) {
 
 /* Draws the given layer of the sprite using the sprite state.   
  */
-void spritestate_draw_frame(SpriteState * me, SpriteFrame * frame, Point * at) 
-{
+/* Draws the visible layers of the frame one by one. */
+static void spritestate_draw_layers
+(SpriteState * me, SpriteFrame * frame, Point * at) {
   int index, stop;
   SpriteCell * cell;
   Color * tint; 
-  if (!me) return;
-  if (!frame) { 
-    /* Draw a red box to show the missing frame */
-    al_draw_filled_rectangle(at->x, at->y, at->x+16, at->y+16, al_map_rgb(255, 64, 64));  
-    return;
-  };  
-  
   al_hold_bitmap_drawing(true);
   stop = spriteframe_maxlayers(frame);
   for (index = 0; index < stop ; index++) {
@@ -147,6 +154,146 @@ void spritestate_draw_frame(SpriteState * me, SpriteFrame * frame, Point * at)
   al_hold_bitmap_drawing(false);
 }
 
+/* Rebuilds the layer settings part of the frame cache key. */
+static void spritestate_build_cache_key(SpriteState * me) {
+  int index;
+  memset(&me->cache_key, 0, sizeof(me->cache_key));
+  for (index = 0; index < FRAMECACHE_LAYERS; index++) {
+    SpriteStateLayer * layer = me->layers + index;
+    if (BIT_ISFLAG(layer->flags, SPRITESTATE_LAYER_HIDDEN)) {
+      me->cache_key.hidden |= ((uint64_t)1) << index;
+    }
+    if (BIT_ISFLAG(layer->flags, SPRITESTATE_LAYER_TINTED)) {
+      unsigned char r, g, b, a;
+      al_unmap_rgba(layer->tint, &r, &g, &b, &a);
+      me->cache_key.tinted |= ((uint64_t)1) << index;
+      me->cache_key.tints[index] = 
+        (((uint32_t)r) << 24) | (((uint32_t)g) << 16) | (((uint32_t)b) << 8) | a;
+    }
+  }
+  me->cache_config_hash = framecache_config_hash(&me->cache_key);
+  me->cache_dirty       = FALSE;
+}
+
+/* Finds the rectangle that holds the visible layers of the frame, relative to
+ * the position of the sprite. Stores the top left corner in origin and the
+ * size in w and h. Returns FALSE if nothing is visible. */
+static int spritestate_frame_bounds
+(SpriteState * me, SpriteFrame * frame, Point * origin, int * w, int * h) {
+  int index, stop, found = FALSE;
+  float x1 = 0.0, y1 = 0.0, x2 = 0.0, y2 = 0.0;
+  Point zero = bevec(0.0, 0.0), pos;
+  stop = spriteframe_maxlayers(frame);
+  for (index = 0; index < stop ; index++) {
+    SpriteCell * cell;
+    Image      * image;
+    if ((BIT_ISFLAG(me->layers[index].flags, SPRITESTATE_LAYER_HIDDEN))) {
+      continue;
+    }
+    cell  = spriteframe_cell(frame, index);
+    image = spritecell_image(cell);
+    if (!image) continue;
+    pos   = spritecell_real_position(cell, &zero);
+    if (!found || (pos.x < x1)) x1 = pos.x;
+    if (!found || (pos.y < y1)) y1 = pos.y;
+    if (!found || ((pos.x + al_get_bitmap_width(image)) > x2)) {
+      x2 = pos.x + al_get_bitmap_width(image);
+    }
+    if (!found || ((pos.y + al_get_bitmap_height(image)) > y2)) {
+      y2 = pos.y + al_get_bitmap_height(image);
+    }
+    found = TRUE;
+  }
+  if (!found) return FALSE;
+  x1        = floor(x1);
+  y1        = floor(y1);
+  (*w)      = (int) ceil(x2 - x1);
+  (*h)      = (int) ceil(y2 - y1);
+  (*origin) = bevec(x1, y1);
+  return TRUE;
+}
+
+/* Composites the visible layers of the frame into a new bitmap of w by h 
+ * pixels, of which the top left corner is at origin relative to the position
+ * of the sprite, as found by spritestate_frame_bounds. Returns NULL on 
+ * error. */
+static Image * spritestate_composite_frame
+(SpriteState * me, SpriteFrame * frame, Point origin, int w, int h) {
+  Image * result, * target;
+  Point   pos;
+  result = al_create_bitmap(w, h);
+  if (!result) return NULL;
+  target = al_get_target_bitmap();
+  al_set_target_bitmap(result);
+  al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+  pos    = bevec(-origin.x, -origin.y);
+  spritestate_draw_layers(me, frame, &pos);
+  al_set_target_bitmap(target);
+  return result;
+}
+
+/* Draws the current frame from the frame cache, compositing it first if
+ * needed. Returns FALSE if the frame could not be drawn like that, also when
+ * the cache is disabled or the frame is too large for it, so no bitmap is
+ * composited only to be thrown away. */
+static int spritestate_draw_cached(SpriteState * me, Point * at) {
+  Image * image;
+  Point origin;
+  uint32_t hash;
+  int w, h;
+  if (framecache_budget() <= 0) return FALSE;
+  if (me->cache_dirty) spritestate_build_cache_key(me);
+  me->cache_key.sprite = me->sprite;
+  me->cache_key.action = me->action_index;
+  me->cache_key.frame  = me->frame_index;
+  hash  = framecache_hash(&me->cache_key, me->cache_config_hash);
+  image = framecache_get(&me->cache_key, hash, &origin);
+  if (!image) {
+    if (!spritestate_frame_bounds(me, me->frame_now, &origin, &w, &h)) {
+      return FALSE;
+    }
+    if (!framecache_fits(w, h)) return FALSE;
+    image = spritestate_composite_frame(me, me->frame_now, origin, w, h);
+    if (!image) return FALSE;
+    image = framecache_put(&me->cache_key, hash, image, origin);
+    if (!image) return FALSE;
+  }
+  al_draw_bitmap(image, at->x + origin.x, at->y + origin.y, 0);
+  return TRUE;
+}
+
+void spritestate_draw_frame(SpriteState * me, SpriteFrame * frame, Point * at) 
+{
+  if (!me) return;
+  if (!frame) { 
+    /* Draw a red box to show the missing frame */
+    al_draw_filled_rectangle(at->x, at->y, at->x+16, at->y+16, al_map_rgb(255, 64, 64));  
+    return;
+  };  
+  
+  /* The cached bitmaps are only made for the current frame. */
+  if (me->cache_frames && (frame == me->frame_now)) {
+    if (spritestate_draw_cached(me, at)) return;
+  }
+  spritestate_draw_layers(me, frame, at);
+}
+
+/** Enables or disables drawing the sprite state's frames from composited 
+ * bitmaps in the frame cache. Worthwhile for sprites of which the tint and 
+ * visibility of the layers rarely change. Returns the new setting. */
+int spritestate_cache_frames_(SpriteState * self, int enable) {
+  if (!self) return FALSE;
+  self->cache_frames = (enable ? TRUE : FALSE);
+  return self->cache_frames;
+}
+
+/** Returns whether the frames of the sprite state are drawn from the frame 
+ * cache or not. */
+int spritestate_cache_frames(SpriteState * self) {
+  if (!self) return FALSE;
+  return self->cache_frames;
+}
+
 
 
 /* Draw the SpriteState at the given location. This takes
@@ -154,6 +301,23 @@ void spritestate_draw_frame(SpriteState * me, SpriteFrame * frame, Point * at)
 void spritestate_draw(SpriteState * self, Point * at) {
   if (!self) return;
   if (!self->sprite) return;
+  if (sprite_loading(self->sprite) > 0) {
+    Point origin, size;
+    int w, h;
+    /* Draw a grey box in stead of the half loaded sprite, as large as the
+     * layers that are there already, or else as the cells being loaded. */
+    if (self->frame_now &&
+        spritestate_frame_bounds(self, self->frame_now, &origin, &w, &h)) {
+      size = bevec(w, h);
+    } else if (!sprite_loading_box(self->sprite, &origin, &size)) {
+      return;
+    }
+    al_draw_filled_rectangle(at->x + origin.x, at->y + origin.y,
+                             at->x + origin.x + size.x,
+                             at->y + origin.y + size.y,
+                             al_map_rgba(128, 128, 128, 128));
+    return;
+  }
   spritestate_draw_frame(self, self->frame_now, at);
 }
 
@@ -167,13 +331,13 @@ spritestate_now_(SpriteState * self, int actionnow, int framenow) {
   if (!self) return NULL;
   sprite = self->sprite;
   if (!sprite) return NULL;
-  if (bad_outofboundsi(actionnow, 0, sprite_maxactions(sprite))) return NULL; 
-  frame = sprite_frame(sprite, actionnow, framenow);
+  frame = sprite_flat_frame(sprite, actionnow, framenow, NULL);
   if (!frame) { return NULL; }
   self->frame_index   = framenow;
   self->action_index  = actionnow;
   self->frame_now     = frame;
   self->time          = 0.0;
+  spriteanim_sync(self);
   return self;
 }
 
@@ -187,7 +351,7 @@ void spritestate_next_frame(SpriteState * self) {
   int action_loop;
   
   /* Loop if needed. */
-  if (next >= sprite_framesused(self->sprite, self->action_index)) {
+  if (next >= sprite_flat_frames(self->sprite, self->action_index)) {
     action_loop = spritestate_get_action_loop(self, self->action_index);
     /* It's a one-shot action. Do NOT cycle. */
     if (action_loop & SPRITESTATE_ACTION_ONESHOT) { 
@@ -196,13 +360,13 @@ void spritestate_next_frame(SpriteState * self) {
         /* First time at end of a one shot stop action...  */
         if (!self->actions[self->action_index].done) {
           /* Notify scripting of end of this loop. */
-          callrb_sprite_event(self, action_loop, NULL); 
+          spriteanim_notify(self, action_loop); 
           /* Set action to done to prevent double emitting the event above. */
           self->actions[self->action_index].done = TRUE;
         }
       } else {
         /* Notify script side. */
-        callrb_sprite_event(self, action_loop, NULL);
+        spriteanim_notify(self, action_loop);
         /* Go to back to first frame of standing pose with current direction. */
         action = sprite_action_index_for
           (self->sprite, SPRITE_WALK, self->direction_now);
@@ -226,23 +390,36 @@ void spritestate_next_frame(SpriteState * self) {
 }
 
 
-/* Updates the spritestate. 
- * dt is the time passed since the last update in seconds (usuallu around 0.02). */
-void spritestate_update(SpriteState * self, double dt) {
-  Sprite * sprite;
+/* Goes to the next frame of the spritestate, or tries to restore the first
+ * frame if the current one is missing. Called when the current frame is over.
+ */
+void spritestate_advance(SpriteState * self) {
   if (!self) return;
-  sprite = self->sprite;
-  if (!sprite) return;
+  if (!self->sprite) return;
   if(!self->frame_now) { 
-    int x, y, w, h;
     LOG_LEVEL(__FILE__, "NULL current sprite frame!: %d\n", self->action_index);
     // try to restore back to first frame if out of whack somehow.
     spritestate_now_(self, self->action_index, 0);
     return;
   }
+  spritestate_next_frame(self);
+}
+
+/* Updates the spritestate. 
+ * dt is the time passed since the last update in seconds (usuallu around 0.02). 
+ * Sprite states that are in the sprite animation system are updated by 
+ * spriteanim_update all at once, so this does nothing for them. */
+void spritestate_update(SpriteState * self, double dt) {
+  if (!self) return;
+  if (self->anim_slot >= 0) return;
+  if (!self->sprite) return;
+  if(!self->frame_now) { 
+    spritestate_advance(self);
+    return;
+  }
   self->time += (self->speedup * dt);
   if(self->time > spriteframe_duration(self->frame_now)) {
-    spritestate_next_frame(self);
+    spritestate_advance(self);
   }
 }
 
@@ -318,6 +495,7 @@ int spritestate_tint_layer(SpriteState * self, int layer, Color color) {
   if (spritestate_is_bad_layer(self, layer)) return -1;
   self->layers[layer].tint = color;
   self->layers[layer].flags = BIT_SETFLAG(self->layers[layer].flags, SPRITESTATE_LAYER_TINTED);
+  self->cache_dirty         = TRUE;
   return layer;    
 }
 
@@ -325,6 +503,7 @@ int spritestate_tint_layer(SpriteState * self, int layer, Color color) {
 int spritestate_remove_tint_layer(SpriteState * self, int layer) {
   if (!spritestate_is_layer_tinted(self, layer)) return -1;
   self->layers[layer].flags = BIT_UNFLAG(self->layers[layer].flags, SPRITESTATE_LAYER_TINTED);
+  self->cache_dirty         = TRUE;
   return layer;    
 }
 
@@ -345,6 +524,8 @@ Color * spritestate_get_layer_tint(SpriteState * self, int layer) {
 
 /** Hides or unhides the given layer of the sprite. */
 int spritestate_set_layer_hidden(SpriteState * self, int layer, int hidden) {
+  if (spritestate_is_bad_layer(self, layer)) return TRUE;
+  self->cache_dirty = TRUE;
   if (hidden) {
     self->layers[layer].flags = BIT_SETFLAG(self->layers[layer].flags, SPRITESTATE_LAYER_HIDDEN);
   } else {
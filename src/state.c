@@ -11,6 +11,12 @@
 #include "event.h"
 #include "widget.h"
 #include "sprite.h"
+#include "framecache.h"
+#include "spriteanim.h"
+#include "thing.h"
+#include "rhtask.h"
+#include "spriteload.h"
+#include "storeload.h"
 #include "scegra.h"
 #include "monolog.h"
 #include "callrb.h"
@@ -52,6 +58,8 @@ struct State_ {
   /* FPS handling. */
   double                fpsnow, fpstime, fps;
   int                   frames;
+  /* When the work on the current frame started, for idle time GC. */
+  double                frame_start;
   
   /* Background image that can be set behind the tile map. */
   ALLEGRO_BITMAP      * background_image;
@@ -152,13 +160,22 @@ void state_free(State * self) {
   /* Shut down audio */
   audio_done();
   
+  spriteload_done();
+  storeload_done();
+  thing_done();
+  rhtask_done();
+  spriteanim_done();
   spritelist_free(self->sprites);
   self->sprites = NULL;
+  sprite_atlas_done();
+  framecache_done();
   rh_free(self->ruby);
   bbconsole_free((BBWidget *)self->console, NULL);
   self->console = NULL; /* disable console immediately. */
   /* Deallocate stored objects. */
   store_done();
+  /* Fonts and streams may read from the pack until they're destroyed. */
+  fifi_pack_close();
  
   // font_free(self->font);
   al_destroy_display(self->display);
@@ -251,6 +268,17 @@ int state_sprite_load_builtin
 }
  
  
+/* Starts loading a layer of a sprite from a vpath in the background. Sprite 
+ layer is in ulpcss format. Returns the id of the load job or negative on
+ error. */
+int state_sprite_load_builtin_async
+(State * state, int sprite_index, int layer_index, char * vpath, int layout) { 
+  Sprite * sprite = state_sprite(state, sprite_index);
+  if (!sprite) return -1;
+  return spriteload_start(sprite, layer_index, vpath, layout);
+}
+ 
+ 
 /* Looks up the thing by index and let the state's camera track it. 
  * If index is negative, stop tracking in stead.
  */
@@ -425,6 +453,8 @@ State * state_init(State * self, BOOL fullscreen) {
     return state_errmsg_(self, "Error loading " STATE_FONTNAME);
   }
   
+  /* The font is used through self->font, so it may never be evicted. */
+  store_pin(STATE_FONT_INDEX);
   self->font = store_get_font(STATE_FONT_INDEX);
   
   // fifi_loadfont(STATE_FONTNAME, 16, 0);
@@ -445,6 +475,7 @@ State * state_init(State * self, BOOL fullscreen) {
   self->fps        = 60.0;
   self->fpstime    = al_get_time();
   self->frames     = 60;    
+  self->frame_start= self->fpstime;
   /* No active maze yet. */
   /* state_active_maze_id_(self, -1); */
   
@@ -735,6 +766,17 @@ void draw_test_2d(void) {
 
 
 
+/* Draws the memory and GC statistics of the ruby at x, y. */
+static void state_draw_gc_stats(State * self, int x, int y) {
+  RhGcStats stats;
+  if (!rh_gc_stats(self->ruby, &stats)) return;
+  al_draw_textf(state_font(self), COLOR_WHITE, x, y, 0,
+                "GC: %lu kB, %lu live, %.2f ms (max %.2f ms), arena %d",
+                (unsigned long) (stats.heap / 1024),
+                (unsigned long) stats.live, stats.frame_time * 1000.0,
+                stats.time_max * 1000.0, stats.arena_max);
+}
+
 /* Draws all inside the state that needs to be drawn. */
 void state_draw(State * self) {
   int layer;
@@ -784,6 +826,9 @@ void state_draw(State * self) {
   // al_draw_filled_rectangle(0, 100, 200, 300, al_map_rgb(50, 100, 150));
 
   
+  /* Draw the things, with their collision bounds if wanted. */
+  thing_draw(self->show_area);
+  
   /* Draw 2D UI scene graph */
   if (self->show_graph) { 
     scegra_draw();
@@ -796,6 +841,7 @@ void state_draw(State * self) {
   if (self->show_fps) { 
     al_draw_textf(state_font(self), COLOR_WHITE,
                       10, 10, 0, "FPS: %.0f", state_fps(self));
+    state_draw_gc_stats(self, 10, 30);
                       
     al_draw_textf(state_font(self), COLOR_WHITE,
                       10, 20, 0, "Cam: %f %f %f %f %f %f", 
@@ -816,8 +862,13 @@ void state_draw(State * self) {
 
 /* Updates the state's display. */
 void state_flip_display(State * self) {
-  al_flip_display();
+  /* If the frame was done early, use the time that's left for GC work
+   * before the flip, so mruby has less to do while the scripts run. */
+  self->frame_start = rh_gc_flip(self->ruby, self->frame_start,
+                                 al_flip_display);
   state_frames_update(self);
+  /* The resources drawn during this frame may be evicted again. */
+  store_frame();
 }
 
 /* Updates the state's elements. */
@@ -828,6 +879,17 @@ void state_update(State * self) {
   camera_update(self->camera, state_frametime(self));
   // call ruby update callback 
   callrb_on_update(self);
+  // Move and animate the things, after the ruby update so it's changes to 
+  // them are used.
+  thing_update(state_frametime(self));
+  // Resume the script tasks for as long as their budget allows.
+  rhtask_run(callrb_task_resume, NULL);
+  // Advance the sprite animations, after the ruby update for the same reason.
+  spriteanim_update(state_frametime(self));
+  // Copy the sprite layers that were loaded in the background to the atlas.
+  spriteload_update(spriteload_budget());
+  // Put the resources that were loaded in the background in the store.
+  storeload_update(storeload_budget());
   // Update the scene graph (after the Ruby upate so anty ruby side-changes take 
   // effect immediately.
   scegra_update(state_frametime(self));
@@ -955,7 +1017,7 @@ int global_state_show_area_(int show) {
 
 /* Transforms a mask color of an image in storage into an alpha. */
 int state_image_mask_to_alpha(State * state, int store_index, int r, int g, int b) {
-  Image * image = store_get_bitmap(store_index);
+  Image * image = resor_bitmap(store_unshare(store_index));
   Color color   = al_map_rgb(r, g, b);
   (void) state;
 
@@ -968,7 +1030,7 @@ int state_image_mask_to_alpha(State * state, int store_index, int r, int g, int
 
 /* Transforms an image in storage where the average is assigned to the alpha value. */
 int state_image_average_to_alpha(State * state, int store_index, int r, int g, int b) {
-  Image * image = store_get_bitmap(store_index);
+  Image * image = resor_bitmap(store_unshare(store_index));
   Color color   = al_map_rgb(r, g, b);
   (void) state;
   if (!image) return -1;  
@@ -983,8 +1045,45 @@ int state_get_unused_sprite_id() {
 
 /** Deletes a sprite from the sprite list of the state. */
 int state_delete_sprite(int index) {
+  Sprite * sprite = state_sprite(state_get(), index);
+  /* Things may not go on showing the deleted sprite. */
+  if (sprite) thing_forget_sprite(sprite);
   return spritelist_delete_sprite(state_sprites(state_get()), index);
 }
 
+/** Makes a new thing and returns it's id, or negative on error. */
+int state_newthingindex(State * state, int kind, 
+                        int x, int y, int z, int w, int h) {
+  (void) state;
+  return thing_new(kind, x, y, z, w, h);
+}
+
+/** Lets the thing show the sprite with the given index. Returns negative if 
+ * the thing or the sprite doesn't exist. */
+int state_thing_sprite_(State * state, int thing_index, int sprite_index) {
+  Sprite * sprite = state_sprite(state, sprite_index);
+  if (!sprite) return -1;
+  return thing_sprite_(thing_index, sprite);
+}
+
+/** Sets the pose of the thing. */
+int state_thing_pose_(State * state, int thing_index, int pose) {
+  (void) state;
+  return thing_pose_(thing_index, pose);
+}
+
+/** Sets the direction of the thing. */
+int state_thing_direction_(State * state, int thing_index, int direction) {
+  (void) state;
+  return thing_direction_(thing_index, direction);
+}
+
+/** Tints a layer of the sprite of the thing. */
+int state_thing_tint_layer
+(State * state, int thing_index, int layer_index, int r, int g, int b, int a) {
+  (void) state;
+  return thing_tint_layer(thing_index, layer_index, r, g, b, a);
+}
+
 
 
@@ -1,6 +1,10 @@
 
 #include "eruta.h"
+#include "mem.h"
+#include "monolog.h"
+#include <string.h>
 #include "store.h"
+#include "storeload.h"
 
 
 /** 
@@ -14,19 +18,268 @@
 
 static  Resor * store_array[STORE_MAX];
 
+/**
+ * Loaded resources are also kept in a cache, which is a hash table with 
+ * chaining, keyed by a string that describes the kind, the vpath and the 
+ * parameters of the load. Loading the same resource again into another index
+ * shares the resource, which is reference counted, in stead of loading it 
+ * again. A resource leaves the cache when its last index is dropped.
+ * Audio streams and grabbed fonts are never shared.
+ */
+
+#define STORE_CACHE_BUCKETS 1024
+
+typedef struct StoreCacheEntry_ StoreCacheEntry;
+
+struct StoreCacheEntry_ {
+  Resor           * resor;
+  StoreCacheEntry * next;
+};
+
+static StoreCacheEntry * store_cache[STORE_CACHE_BUCKETS];
+static StoreCacheStats   store_cache_statistics;
+
+/* FNV-1a hash of a key. */
+static uint32_t store_key_hash(const char * key) {
+  return mem_fnv32(MEM_FNV32_BASIS, key, strlen(key));
+}
+
+/* Finds the cached resource with the given key, or NULL if not cached. */
+static Resor * store_cache_find(const char * key) {
+  StoreCacheEntry * entry;
+  uint32_t bucket = store_key_hash(key) % STORE_CACHE_BUCKETS;
+  for (entry = store_cache[bucket]; entry; entry = entry->next) {
+    if (strcmp(resor_key(entry->resor), key) == 0) return entry->resor;
+  }
+  return NULL;
+}
+
+/* Adds a resource, which must have a key, to the cache. */
+static bool store_cache_add(Resor * resor) {
+  StoreCacheEntry * entry;
+  uint32_t bucket = store_key_hash(resor_key(resor)) % STORE_CACHE_BUCKETS;
+  entry = STRUCT_ALLOC(StoreCacheEntry);
+  if (!entry) return false;
+  entry->resor        = resor;
+  entry->next         = store_cache[bucket];
+  store_cache[bucket] = entry;
+  store_cache_statistics.entries++;
+  return true;
+}
+
+/* Removes a resource from the cache, and clears its key. */
+static bool store_cache_remove(Resor * resor) {
+  StoreCacheEntry ** link, * entry;
+  uint32_t bucket;
+  if (!resor_key(resor)) return false;
+  bucket = store_key_hash(resor_key(resor)) % STORE_CACHE_BUCKETS;
+  for (link = store_cache + bucket; (*link); link = &(*link)->next) {
+    entry = (*link);
+    if (entry->resor == resor) {
+      (*link) = entry->next;
+      mem_free(entry);
+      store_cache_statistics.entries--;
+      resor_key_(resor, NULL);
+      return true;
+    }
+  }
+  resor_key_(resor, NULL);
+  return false;
+}
+
+/**
+ * The memory used by the stored resources is counted per kind of resource.
+ * Each kind can have a memory budget. When a kind goes over its budget, the
+ * data of the least recently used bitmaps, samples and fonts that can be 
+ * loaded again from their vpath is evicted, while the resource itself stays 
+ * in the store. An evicted resource is loaded again when it's next fetched
+ * with store_get. Pinned resources are never evicted, and neither are the 
+ * resources that were used during the current frame, so the pointers that 
+ * were fetched from the store stay valid until store_frame is called.
+ * The resources of each kind are kept in a list by last use, so the least 
+ * recently used one is found right away.
+ */
+
+#define STORE_KINDS (RESOR_MAZE + 1)
+
+static long              store_budgets[STORE_KINDS];
+static long              store_used_bytes[STORE_KINDS];
+static bool              store_pinned_array[STORE_MAX];
+/* Counts uses of the store, to find the least recently used resources. */
+static long              store_clock = 0;
+/* The value of store_clock when the current frame started. */
+static long              store_frame_clock = 0;
+/* The resources of each kind that aren't evicted, by last use. */
+static Resor           * store_oldest[STORE_KINDS];
+static Resor           * store_newest[STORE_KINDS];
+
+static bool store_kind_ok(int kind) {
+  return (kind >= 0) && (kind < STORE_KINDS);
+}
+
+/* Adds sign times the memory used by the resource to its kind's total. */
+static void store_account(Resor * resor, int sign) {
+  int kind = resor_kind(resor);
+  if (!store_kind_ok(kind)) return;
+  store_used_bytes[kind] += sign * resor_bytes(resor);
+}
+
+/* Takes the resource out of the list by last use of its kind, if it's 
+ * in it. */
+static void store_unlink(Resor * resor) {
+  int kind = resor_kind(resor);
+  Resor * newer = resor_newer(resor);
+  Resor * older = resor_older(resor);
+  if (!store_kind_ok(kind)) return;
+  if (!newer && (store_newest[kind] != resor)) return;
+  if (newer) resor_older_(newer, older); else store_newest[kind] = older;
+  if (older) resor_newer_(older, newer); else store_oldest[kind] = newer;
+  resor_newer_(resor, NULL);
+  resor_older_(resor, NULL);
+}
+
+/* Marks the resource as used now, which makes it the newest of its kind. */
+static void store_touch(Resor * resor) {
+  int kind = resor_kind(resor);
+  resor_used_(resor, ++store_clock);
+  if (!store_kind_ok(kind) || resor_evicted(resor)) return;
+  store_unlink(resor);
+  resor_older_(resor, store_newest[kind]);
+  if (store_newest[kind]) resor_newer_(store_newest[kind], resor);
+  else store_oldest[kind] = resor;
+  store_newest[kind] = resor;
+}
+
+/* Returns true if the data of the resource can be evicted and loaded again 
+ * later. */
+static bool store_evictable(Resor * resor) {
+  if (!resor_reloadable(resor))  return false;
+  if (resor_pins(resor) > 0)     return false;
+  if (resor_evicted(resor))      return false;
+  return resor_used(resor) <= store_frame_clock;
+}
+
+/* Evicts the least recently used resources of the given kind until it's 
+ * within budget, or there is nothing left to evict. keep is never evicted. 
+ * Returns the amount of resources evicted. */
+static int store_enforce_budget(int kind, Resor * keep) {
+  Resor * resor, * newer;
+  int evicted = 0;
+  if (!store_kind_ok(kind) || (store_budgets[kind] < 1)) return 0;
+  resor = store_oldest[kind];
+  while (resor && (store_used_bytes[kind] > store_budgets[kind])) {
+    /* The rest of the list was used during this frame as well. */
+    if (resor_used(resor) > store_frame_clock) break;
+    newer = resor_newer(resor);
+    if ((resor != keep) && store_evictable(resor)) {
+      store_unlink(resor);
+      store_account(resor, -1);
+      resor_evict(resor);
+      store_cache_statistics.evictions++;
+      evicted++;
+    }
+    resor = newer;
+  }
+  return evicted;
+}
+
+/* Loads the data of an evicted resource again. Returns true on success. */
+static bool store_reload(Resor * resor) {
+  if (!resor_reload(resor)) {
+    LOG_WARNING("Could not reload evicted resource %s\n", resor_vpath(resor));
+    return false;
+  }
+  store_cache_statistics.reloads++;
+  store_account(resor, 1);
+  store_enforce_budget(resor_kind(resor), resor);
+  return true;
+}
+
+/** Tells the store that a new frame starts. The resources that were used 
+ * during the last frame may be evicted again from now on, so the kinds that
+ * are over budget are brought within it. */
+void store_frame(void) {
+  int kind;
+  store_frame_clock = store_clock;
+  for (kind = 0; kind < STORE_KINDS; kind++) {
+    store_enforce_budget(kind, NULL);
+  }
+}
+
+/* Returns the memory budget in bytes for resources of the given kind, 
+ * or 0 if there is no budget. */
+long store_budget(int kind) {
+  if (!store_kind_ok(kind)) return 0;
+  return store_budgets[kind];
+}
+
+/* Sets the memory budget in bytes for resources of the given kind. 
+ * 0 or less means there is no budget. Resources are evicted right away if 
+ * the kind is over budget. Returns the new budget. */
+long store_budget_(int kind, long bytes) {
+  if (!store_kind_ok(kind)) return 0;
+  if (bytes < 0) bytes = 0;
+  store_budgets[kind] = bytes;
+  store_enforce_budget(kind, NULL);
+  return bytes;
+}
+
+/* Returns the estimated memory in bytes used by resources of the given kind
+ * in the store. */
+long store_used(int kind) {
+  if (!store_kind_ok(kind)) return 0;
+  return store_used_bytes[kind];
+}
+
+/* Pins the resource at index so it's never evicted. The pin is removed when
+ * the index is dropped. Returns true if there was a resource to pin. */
+bool store_pin(int index) {
+  Resor * resor;
+  if (!store_index_ok(index)) return false;
+  resor = store_array[index];
+  if (!resor) return false;
+  if (!store_pinned_array[index]) resor_pins_(resor, 1);
+  store_pinned_array[index] = true;
+  return true;
+}
+
+/* Unpins the resource at index. Returns true if it was pinned. */
+bool store_unpin(int index) {
+  if (!store_index_ok(index) || !store_pinned_array[index]) return false;
+  resor_pins_(store_array[index], -1);
+  store_pinned_array[index] = false;
+  return true;
+}
+
+/* Returns true if the resource at index is pinned. */
+bool store_pinned(int index) {
+  if (!store_index_ok(index)) return false;
+  return store_pinned_array[index];
+}
+
 /* Initialises the resource storage. */
 bool store_init() {
   int index;
   for (index =0; index < STORE_MAX; index ++) { 
     store_array[index] = NULL;
   }
+  for (index =0; index < STORE_CACHE_BUCKETS; index ++) { 
+    store_cache[index] = NULL;
+  }
+  memset(&store_cache_statistics, 0, sizeof(store_cache_statistics));
+  memset(store_pinned_array, 0, sizeof(store_pinned_array));
+  memset(store_used_bytes, 0, sizeof(store_used_bytes));
+  memset(store_oldest, 0, sizeof(store_oldest));
+  memset(store_newest, 0, sizeof(store_newest));
+  store_clock       = 0;
+  store_frame_clock = 0;
   return true;
 }
 
 /* Range check for the index. */
 bool store_index_ok(int index) {
   if (index < 0)          return FALSE;
-  if (index > STORE_MAX)  return FALSE;
+  if (index >= STORE_MAX) return FALSE;
   return TRUE;
 }
 
@@ -35,12 +288,23 @@ int store_max() {
   return STORE_MAX;
 }
 
-/* Gets a resource with the given index. */
-Resor * store_get(int index) {
+/* Gets a resource with the given index, without loading it again if it 
+ * was evicted. */
+static Resor * store_get_raw(int index) {
   if(!store_index_ok(index)) return NULL;
   return store_array[index];
 }
 
+/* Gets a resource with the given index. It's marked as used, and its data 
+ * is loaded again if it was evicted. */
+Resor * store_get(int index) {
+  Resor * resor = store_get_raw(index);
+  if (!resor) return NULL;
+  if (resor_evicted(resor)) store_reload(resor);
+  store_touch(resor);
+  return resor;
+}
+
 /* Puts a resource in the store without cleaning up what was there before. */
 static Resor * store_put_raw(int index, Resor * value) {
   if(!store_index_ok(index)) return NULL;
@@ -53,13 +317,19 @@ static Resor * store_put_null(int index) {
 }
 
 /* Drops the stores resouce with the given index. 
- * The resource will be cleaned up. 
+ * The resource will be cleaned up if no other index shares it. 
  */
 bool store_drop(int index) {
   bool res = false;
-  Resor * old = store_get(index);
+  Resor * old = store_get_raw(index);
   if (old) {
-    resor_free(old);
+    store_unpin(index);
+    if (resor_refs(old) <= 1) { 
+      store_unlink(old);
+      store_account(old, -1);
+      store_cache_remove(old);
+    }
+    resor_release(old);
     res = true;
   } 
   store_put_null(index);
@@ -72,7 +342,114 @@ Resor * store_put(int index, Resor * value) {
   Resor * old; 
   if(!store_index_ok(index)) return NULL;
   store_drop(index);
-  return store_put_raw(index, value);
+  store_put_raw(index, value);
+  /* A resource that isn't shared is new to the store. */
+  if (value && (resor_refs(value) == 1)) { 
+    store_touch(value);
+    store_account(value, 1);
+    store_enforce_budget(resor_kind(value), value);
+  }
+  return value;
+}
+
+/* Writes the cache key made from format to buffer, which must be 
+ * STORE_KEY_MAX long. Returns buffer, or NULL if the key is too long, 
+ * in which case the resource isn't cached. */
+static char * store_key_format(char * buffer, const char * format, ...) {
+  int size;
+  va_list args;
+  va_start(args, format);
+  size = vsnprintf(buffer, STORE_KEY_MAX, format, args);
+  va_end(args);
+  if ((size < 0) || (size >= STORE_KEY_MAX)) return NULL;
+  return buffer;
+}
+
+/* Cache key of a bitmap loaded from vpath with the given loader flags. 
+ * The current new bitmap flags are part of the key as well. */
+char * store_key_bitmap(char * buffer, const char * vpath, int flags) {
+  return store_key_format(buffer, "bitmap:%d:%d:%s", flags, 
+                          al_get_new_bitmap_flags(), vpath);
+}
+
+/* Cache key of a sample loaded from vpath. */
+char * store_key_sample(char * buffer, const char * vpath) {
+  return store_key_format(buffer, "sample:%s", vpath);
+}
+
+/* Cache key of a TTF font loaded from vpath with the given size and flags. 
+ * w is 0 for fonts that aren't stretched. */
+char * store_key_ttf_font(char * buffer, const char * vpath, int w, int h, 
+                          int flags) {
+  return store_key_format(buffer, "ttf:%d:%d:%d:%s", w, h, flags, vpath);
+}
+
+/* Cache key of a bitmap font loaded from vpath with the given flags. */
+static char * store_key_bitmap_font(char * buffer, const char * vpath, 
+                                    int flags) {
+  return store_key_format(buffer, "bitmap_font:%d:%s", flags, vpath);
+}
+
+/* Returns the cached resource for key, or NULL if it's not cached or 
+ * key is NULL. */
+Resor * store_cached(const char * key) {
+  if (!key) return NULL;
+  return store_cache_find(key);
+}
+
+/* Puts the cached resource for key in the store, sharing it with the other 
+ * indexes it's stored at. Returns NULL if it's not cached. */
+Resor * store_share(int index, const char * key) {
+  Resor * value = store_cached(key);
+  if (!value) return NULL;
+  if(!store_index_ok(index)) return NULL;
+  store_cache_statistics.hits++;
+  store_cache_statistics.bytes_saved += resor_bytes(value);
+  /* Already there, nothing to do. */
+  if (store_get_raw(index) == value) return value;
+  return store_put(index, resor_acquire(value));
+}
+
+/* Puts a resource that was loaded for the given cache key in the store,
+ * and caches it so later loads with the same key can share it. If key is 
+ * NULL the resource isn't cached. */
+Resor * store_put_keyed(int index, const char * key, Resor * value) {
+  if(!store_index_ok(index)) { 
+    resor_free(value);
+    return NULL;
+  }
+  store_cache_statistics.misses++;
+  if (value && key && resor_key_(value, key)) {
+    if (!store_cache_add(value)) resor_key_(value, NULL);
+  }
+  return store_put(index, value);
+}
+
+/* Makes sure the resource at index isn't shared with any other index, 
+ * so it can be modified in place. If it's shared, a bitmap is copied, 
+ * other kinds of resources can't be copied and NULL is returned. 
+ * The resource leaves the cache and won't be evicted anymore, since it 
+ * won't match the loaded file once it's modified. Returns the unshared 
+ * resource. */
+Resor * store_unshare(int index) {
+  Resor * resor = store_get(index);
+  ALLEGRO_BITMAP * copy;
+  if (!resor) return NULL;
+  if (resor_refs(resor) <= 1) { 
+    store_cache_remove(resor);
+    return resor_forget_source(resor);
+  }
+  if (!resor_bitmap(resor)) return NULL;
+  copy = al_clone_bitmap(resor_bitmap(resor));
+  if (!copy) return NULL;
+  return store_put(index, resor_new_bitmap(copy));
+}
+
+/* Copies the statistics of the resource cache into stats. */
+bool store_cache_stats(StoreCacheStats * stats) {
+  if (!stats) return false;
+  (*stats) = store_cache_statistics;
+  return true;
 }
 
 /* Cleans up the store. */
@@ -87,27 +464,44 @@ bool store_done() {
 /* Loads a font and puts it in the store.  */
 Resor * 
 store_load_ttf_font_stretch(int index, const char * vpath, int w, int h, int f) {  
-  return store_put(index, resor_load_ttf_font_stretch(vpath, w, h, f));
+  char    buffer[STORE_KEY_MAX];
+  char  * key = store_key_ttf_font(buffer, vpath, w, h, f);
+  Resor * cached = store_share(index, key);
+  if (cached) return cached;
+  return store_put_keyed(index, key,
+                         resor_load_ttf_font_stretch(vpath, w, h, f));
 }
 
 /* Loads a font and puts it in the store.  */
 Resor * 
 store_load_ttf_font(int index, const char * vpath, int h, int f) {  
-  return store_put(index, resor_load_ttf_font(vpath, h, f));
+  char    buffer[STORE_KEY_MAX];
+  char  * key = store_key_ttf_font(buffer, vpath, 0, h, f);
+  Resor * cached = store_share(index, key);
+  if (cached) return cached;
+  return store_put_keyed(index, key, resor_load_ttf_font(vpath, h, f));
 }
 
 
 /* Loads a font and puts it in the store.  */
 Resor * 
 store_load_bitmap_font_flags(int index, const char * vpath, int f) {  
-  return store_put(index, resor_load_bitmap_font_flags(vpath, f));
+  char    buffer[STORE_KEY_MAX];
+  char  * key = store_key_bitmap_font(buffer, vpath, f);
+  Resor * cached = store_share(index, key);
+  if (cached) return cached;
+  return store_put_keyed(index, key, resor_load_bitmap_font_flags(vpath, f));
 }
 
 
 /* Loads a font and puts it in the store.  */
 Resor * 
 store_load_bitmap_font(int index, const char * vpath) {  
-  return store_put(index, resor_load_bitmap_font(vpath));
+  char    buffer[STORE_KEY_MAX];
+  char  * key = store_key_bitmap_font(buffer, vpath, 0);
+  Resor * cached = store_share(index, key);
+  if (cached) return cached;
+  return store_put_keyed(index, key, resor_load_bitmap_font(vpath));
 }
 
 
@@ -137,20 +531,32 @@ store_load_audio_stream
 Resor * 
 store_load_sample
 (int index, const char * vpath) {
-  return store_put(index, resor_load_sample(vpath));
+  char    buffer[STORE_KEY_MAX];
+  char  * key = store_key_sample(buffer, vpath);
+  Resor * cached = store_share(index, key);
+  if (cached) return cached;
+  return store_put_keyed(index, key, resor_load_sample(vpath));
 }
 
 /* Loads a bitmap and puts it in the storage. */
 Resor * 
 store_load_bitmap_flags
 (int index, const char * vpath, int flags) {
-  return store_put(index, resor_load_bitmap_flags(vpath, flags));
+  char    buffer[STORE_KEY_MAX];
+  char  * key = store_key_bitmap(buffer, vpath, flags);
+  Resor * cached = store_share(index, key);
+  if (cached) return cached;
+  return store_put_keyed(index, key, resor_load_bitmap_flags(vpath, flags));
 }
 
 /* Loads a bitmap and puts it in the storage. */
 Resor * 
 store_load_bitmap(int index, const char * vpath) {
-  return store_put(index, resor_load_bitmap(vpath));
+  char    buffer[STORE_KEY_MAX];
+  char  * key = store_key_bitmap(buffer, vpath, 0);
+  Resor * cached = store_share(index, key);
+  if (cached) return cached;
+  return store_put_keyed(index, key, resor_load_bitmap(vpath));
 }
 
 
@@ -158,12 +564,19 @@ store_load_bitmap(int index, const char * vpath) {
 Resor * 
 store_load_other(int index, const char* vpath, ResorKind kind, ResorLoader* loader, 
                  ResorDestructor* destroy, void* extra) {
-  return store_put(index, resor_load_other(vpath, kind, loader, destroy, extra));
+  char    buffer[STORE_KEY_MAX];
+  char  * key = store_key_format(buffer, "other:%d:%p:%p:%p:%s", kind,
+                                 (void *) loader, (void *) destroy, extra, 
+                                 vpath);
+  Resor * cached = store_share(index, key);
+  if (cached) return cached;
+  return store_put_keyed(index, key,
+                         resor_load_other(vpath, kind, loader, destroy, extra));
 }
 
 /* Returns the kind of stored item. */
 int store_kind(int index) {
-  return resor_kind(store_get(index));
+  return resor_kind(store_get_raw(index));
 }
 
 /* Returns the font stored at the index or nil if nothing there or not a font. */
@@ -239,16 +652,27 @@ bool store_get_font_descent(int index, int * value) {
 bool store_get_font_line_height(int index, int * value) {
   return resor_get_font_line_height(store_get(index), value);  
 }
+
+/* Prewarms the text measurement cache of the font at index. */
+bool store_prewarm_font(int index) {
+  return resor_prewarm_font(store_get(index));  
+}
+
+/* Gets the text measurement cache statistics of the font at index. */
+bool store_get_text_cache_stats(int index, TextCacheStats * stats) {
+  return resor_get_text_cache_stats(store_get(index), stats);  
+}
   
 
-/* Returns the first unused store ID larger than minimum. */
+/* Returns the first unused store ID larger than minimum. IDs that a
+ * resource is being loaded into in the background count as used. */
 int store_get_unused_id(int minimum) {
   int index, stop;
   if (minimum < 0) return -2;
   stop = store_max();
   for (index = minimum; index < stop; index++) {
-    Resor * resource =  store_get(index);
-    if (!resource) {
+    Resor * resource =  store_get_raw(index);
+    if (!resource && !storeload_index_pending(index)) {
       return index;
     }
   }
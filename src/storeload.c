@@ -0,0 +1,530 @@
+#include "eruta.h"
+#include "mem.h"
+#include "str.h"
+#include "fifi.h"
+#include "monolog.h"
+#include "storeload.h"
+#include "cook.h"
+#include "callrb.h"
+
+/*
+ * Loading bitmaps, samples and fonts with the store_load functions stalls the
+ * game while the files are read and decoded, which is noticeable when
+ * switching scenes. Therefore they can also be loaded in the background.
+ *
+ * A job goes through the following stages:
+ * 1) QUEUED: storeload_start made the job and put it in the queue. If the
+ *    resource is already in the store cache, the job is SHARED in stead, and
+ *    no worker needs to look at it.
+ * 2) LOADING: a worker thread reads and decodes the file. Bitmaps are decoded
+ *    into memory bitmaps, since video bitmaps can only be made on the display
+ *    thread. Files in the data pack are looked up by storeload_start, so the
+ *    worker only decodes them from memory. storeload_start also looks for a
+ *    cooked texture of a bitmap, which the worker then just copies.
+ * 3) LOADED or FAILED: the worker is done with the job.
+ * 4) storeload_update turns memory bitmaps into video bitmaps, and puts the
+ *    resources in the store, until it runs out of time for this update.
+ *    The job is removed and the scripting side is told through
+ *    eruta_on_resource_loaded.
+ *
+ * The queue and the status of the jobs are protected by storeload_mutex.
+ * The other fields of a job are only touched by the thread that has the job
+ * in the LOADING stage, or by the display thread in the other stages.
+ * A cancelled job is dropped when it reaches the display thread.
+ */
+
+enum StoreLoadStatus_ {
+  STORELOAD_QUEUED  = 0,
+  STORELOAD_LOADING = 1,
+  STORELOAD_LOADED  = 2,
+  STORELOAD_FAILED  = 3,
+  STORELOAD_SHARED  = 4
+};
+
+typedef struct StoreLoadJob_ StoreLoadJob;
+
+struct StoreLoadJob_ {
+  int             id;
+  int             kind;
+  int             index;
+  int             w;
+  int             h;
+  int             flags;
+  /* New bitmap flags of the display thread when the job was started. */
+  int             bitmap_flags;
+  char          * path;
+  char          * vpath;
+  char          * key;
+  /* True if path or packed is the cooked texture of the bitmap. */
+  int             cooked;
+  /* Data of the file in the data pack, or NULL to load from path. */
+  const void    * packed;
+  size_t          packed_size;
+  int             status;
+  int             cancelled;
+  void          * data;
+  StoreLoadJob  * next;
+};
+
+static ALLEGRO_THREAD * storeload_workers[STORELOAD_WORKERS];
+static ALLEGRO_MUTEX  * storeload_mutex    = NULL;
+static ALLEGRO_COND   * storeload_cond     = NULL;
+static int              storeload_stopping = FALSE;
+static StoreLoadJob   * storeload_first    = NULL;
+static StoreLoadJob   * storeload_last     = NULL;
+static int              storeload_last_id  = 0;
+static double           storeload_budget_now = STORELOAD_BUDGET_DEFAULT;
+static StoreLoadStats   storeload_stats_now;
+/* Jobs started and finished since the queue was last empty, for progress. */
+static int              storeload_batch_started  = 0;
+static int              storeload_batch_finished = 0;
+
+
+/* Destroys the decoded data of a job, if any. */
+static void storeload_job_drop_data(StoreLoadJob * job) {
+  if (!job->data) return;
+  switch (job->kind) {
+    case RESOR_BITMAP: al_destroy_bitmap(job->data); break;
+    case RESOR_SAMPLE: al_destroy_sample(job->data); break;
+    case RESOR_FONT  : al_destroy_font(job->data);   break;
+    default: break;
+  }
+  job->data = NULL;
+}
+
+/* Frees a job, that must not be in the queue anymore, and the data it still
+ * has. Fonts keep reading from the packed data, so only the use of it by
+ * bitmaps and samples is released. The pack keeps the data while other jobs
+ * or loads still use it. */
+static void storeload_job_free(StoreLoadJob * job) {
+  storeload_job_drop_data(job);
+  if (job->packed && (job->kind != RESOR_FONT)) {
+    pack_forget(fifi_pack(), job->vpath);
+  }
+  free(job->path);
+  free(job->vpath);
+  free(job->key);
+  mem_free(job);
+}
+
+/* Reads and decodes the file of the job. Runs on a worker thread.
+ * Returns true on success. */
+static bool storeload_decode(StoreLoadJob * job) {
+  ALLEGRO_FILE * file  = NULL;
+  const char   * ident = fifi_vpath_extension(job->vpath);
+  if (job->packed) {
+    file = al_open_memfile((void *) job->packed, job->packed_size, "r");
+    if (!file) return false;
+  }
+  switch (job->kind) {
+    case RESOR_BITMAP:
+      al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+      if (job->cooked) {
+        job->data = (file ? cook_load_bitmap_f(file)
+                          : cook_load_bitmap(job->path));
+      } else {
+        job->data = (file ? al_load_bitmap_flags_f(file, ident, job->flags)
+                          : al_load_bitmap_flags(job->path, job->flags));
+      }
+      break;
+    case RESOR_SAMPLE:
+      job->data = (file ? al_load_sample_f(file, ident)
+                        : al_load_sample(job->path));
+      break;
+    case RESOR_FONT:
+      /* The glyph pages are made later with the flags set at load time. */
+      al_set_new_bitmap_flags(job->bitmap_flags);
+      if (file) {
+        /* The font closes the file when it's destroyed. */
+        job->data = al_load_ttf_font_stretch_f(file, ident, job->w, job->h,
+                                               job->flags);
+        if (job->data) file = NULL;
+      } else {
+        job->data = al_load_ttf_font_stretch(job->path, job->w, job->h,
+                                             job->flags);
+      }
+      break;
+    default:
+      break;
+  }
+  if (file) al_fclose(file);
+  if (!job->data) {
+    LOG_WARNING("Could not load resource %s\n", job->path);
+    return false;
+  }
+  return true;
+}
+
+/* Returns the first job with the given status, or NULL if none.
+ * The mutex must be locked. */
+static StoreLoadJob * storeload_find(int status) {
+  StoreLoadJob * job;
+  for (job = storeload_first; job; job = job->next) {
+    if (job->status == status) return job;
+  }
+  return NULL;
+}
+
+/* The worker threads take queued jobs and decode them until stopped. */
+static void * storeload_worker(ALLEGRO_THREAD * thread, void * arg) {
+  StoreLoadJob * job;
+  bool ok;
+  (void) thread; (void) arg;
+  al_lock_mutex(storeload_mutex);
+  while (!storeload_stopping) {
+    job = storeload_find(STORELOAD_QUEUED);
+    if (!job) {
+      al_wait_cond(storeload_cond, storeload_mutex);
+      continue;
+    }
+    /* Don't bother with jobs that were cancelled while queued. */
+    if (job->cancelled) {
+      job->status = STORELOAD_FAILED;
+      continue;
+    }
+    job->status = STORELOAD_LOADING;
+    al_unlock_mutex(storeload_mutex);
+    ok = storeload_decode(job);
+    al_lock_mutex(storeload_mutex);
+    job->status = (ok ? STORELOAD_LOADED : STORELOAD_FAILED);
+  }
+  al_unlock_mutex(storeload_mutex);
+  return NULL;
+}
+
+/* Starts the worker threads if they aren't running yet. */
+static bool storeload_setup(void) {
+  int index;
+  if (storeload_mutex) return true;
+  storeload_mutex = al_create_mutex();
+  storeload_cond  = al_create_cond();
+  if (!storeload_mutex || !storeload_cond) {
+    LOG_ERROR("Could not set up background resource loading.\n");
+    storeload_done();
+    return false;
+  }
+  storeload_stopping = FALSE;
+  for (index = 0; index < STORELOAD_WORKERS; index++) {
+    storeload_workers[index] = al_create_thread(storeload_worker, NULL);
+    if (storeload_workers[index]) al_start_thread(storeload_workers[index]);
+  }
+  return true;
+}
+
+/* Makes the job load the cooked texture of its bitmap, from the data pack
+ * or from the data directory, if there is one. */
+static void storeload_use_cooked(StoreLoadJob * job) {
+  char cooked[FIFI_VPATH_MAX];
+  ALLEGRO_PATH * path;
+  if (!cook_vpath(cooked, sizeof(cooked), job->vpath)) return;
+  if (pack_has(fifi_pack(), cooked)) {
+    job->packed = pack_data(fifi_pack(), cooked, &job->packed_size);
+    if (!job->packed) return;
+    free(job->vpath);
+    job->vpath  = cstr_dup(cooked);
+    job->cooked = TRUE;
+    return;
+  }
+  path = fifi_cooked_path(job->vpath);
+  if (!path) return;
+  free(job->path);
+  job->path   = cstr_dup((char *) PATH_CSTR(path));
+  job->cooked = TRUE;
+  al_destroy_path(path);
+}
+
+/* Starts loading a resource of the given kind from vpath into the store at
+ * index in the background. key is the store cache key of the resource, or
+ * NULL if it can't be cached. Returns the positive id of the load job,
+ * or negative on error. */
+static int storeload_start(int kind, int index, const char * vpath,
+                           const char * key, int w, int h, int flags) {
+  StoreLoadJob * job;
+  ALLEGRO_PATH * path;
+  if (!vpath)                           return -1;
+  if (!store_index_ok(index))           return -2;
+  /* Work out the path here, since fifi isn't thread safe. */
+  path = fifi_data_vpath(vpath);
+  if (!path)                            return -3;
+  if (!storeload_setup()) {
+    al_destroy_path(path);
+    return -4;
+  }
+  job               = STRUCT_ALLOC(StoreLoadJob);
+  if (!job) {
+    al_destroy_path(path);
+    return -5;
+  }
+  job->path         = cstr_dup((char *) PATH_CSTR(path));
+  al_destroy_path(path);
+  job->vpath        = cstr_dup((char *) vpath);
+  job->cooked       = FALSE;
+  job->packed       = NULL;
+  job->packed_size  = 0;
+  job->key          = (key ? cstr_dup((char *) key) : NULL);
+  job->kind         = kind;
+  job->index        = index;
+  job->w            = w;
+  job->h            = h;
+  job->flags        = flags;
+  job->bitmap_flags = al_get_new_bitmap_flags();
+  job->status       = (store_cached(key) ? STORELOAD_SHARED : STORELOAD_QUEUED);
+  if ((job->status == STORELOAD_QUEUED) && (kind == RESOR_BITMAP) &&
+      cook_flags_ok(flags)) {
+    storeload_use_cooked(job);
+  }
+  /* The pack isn't thread safe either, so get the data here. */
+  if ((job->status == STORELOAD_QUEUED) && !job->cooked &&
+      pack_has(fifi_pack(), vpath)) {
+    job->packed     = pack_data(fifi_pack(), vpath, &job->packed_size);
+  }
+  job->cancelled    = FALSE;
+  job->data         = NULL;
+  job->next         = NULL;
+  if (storeload_stats_now.pending < 1) {
+    storeload_batch_started  = 0;
+    storeload_batch_finished = 0;
+  }
+  storeload_batch_started++;
+  storeload_stats_now.started++;
+  storeload_stats_now.pending++;
+  al_lock_mutex(storeload_mutex);
+  job->id           = ++storeload_last_id;
+  if (storeload_last) {
+    storeload_last->next = job;
+  } else {
+    storeload_first      = job;
+  }
+  storeload_last = job;
+  al_signal_cond(storeload_cond);
+  al_unlock_mutex(storeload_mutex);
+  return job->id;
+}
+
+/** Starts loading a bitmap into the store at index in the background.
+ * eruta_on_resource_loaded is called when it's done. Returns the positive
+ * id of the load job, or negative on error. */
+int storeload_bitmap(int index, const char * vpath) {
+  return storeload_bitmap_flags(index, vpath, 0);
+}
+
+/** Starts loading a bitmap with the given loader flags into the store at
+ * index in the background. */
+int storeload_bitmap_flags(int index, const char * vpath, int flags) {
+  char buffer[STORE_KEY_MAX];
+  char * key = (vpath ? store_key_bitmap(buffer, vpath, flags) : NULL);
+  return storeload_start(RESOR_BITMAP, index, vpath, key, 0, 0, flags);
+}
+
+/** Starts loading a sample into the store at index in the background. */
+int storeload_sample(int index, const char * vpath) {
+  char buffer[STORE_KEY_MAX];
+  char * key = (vpath ? store_key_sample(buffer, vpath) : NULL);
+  return storeload_start(RESOR_SAMPLE, index, vpath, key, 0, 0, 0);
+}
+
+/** Starts loading a TTF font into the store at index in the background. */
+int storeload_ttf_font(int index, const char * vpath, int h, int flags) {
+  return storeload_ttf_font_stretch(index, vpath, 0, h, flags);
+}
+
+/** Starts loading a stretched TTF font into the store at index in the
+ * background. */
+int storeload_ttf_font_stretch(int index, const char * vpath, int w, int h,
+                               int flags) {
+  char buffer[STORE_KEY_MAX];
+  char * key = (vpath ? store_key_ttf_font(buffer, vpath, w, h, flags) : NULL);
+  return storeload_start(RESOR_FONT, index, vpath, key, w, h, flags);
+}
+
+/* Returns the first job that the display thread can work on, or NULL if
+ * none. */
+static StoreLoadJob * storeload_next_ready(void) {
+  StoreLoadJob * job;
+  al_lock_mutex(storeload_mutex);
+  for (job = storeload_first; job; job = job->next) {
+    if ((job->status == STORELOAD_LOADED) ||
+        (job->status == STORELOAD_FAILED) ||
+        (job->status == STORELOAD_SHARED)) break;
+  }
+  al_unlock_mutex(storeload_mutex);
+  return job;
+}
+
+/* Makes a resource from the decoded data of the job, and takes the data
+ * from the job. Bitmaps are turned into video bitmaps unless a memory
+ * bitmap was asked for. Returns NULL on failure. */
+static Resor * storeload_resor(StoreLoadJob * job) {
+  void * data = job->data;
+  job->data   = NULL;
+  switch (job->kind) {
+    case RESOR_BITMAP:
+      if (!(job->bitmap_flags & ALLEGRO_MEMORY_BITMAP)) {
+        ALLEGRO_BITMAP * video;
+        int old_flags = al_get_new_bitmap_flags();
+        al_set_new_bitmap_flags(job->bitmap_flags);
+        video = al_clone_bitmap(data);
+        al_set_new_bitmap_flags(old_flags);
+        al_destroy_bitmap(data);
+        data = video;
+      }
+      return resor_source_bitmap_(data ? resor_new_bitmap(data) : NULL,
+                                  job->vpath, job->flags, job->bitmap_flags);
+    case RESOR_SAMPLE:
+      return resor_source_sample_(resor_new_sample(data), job->vpath);
+    case RESOR_FONT:
+      return resor_source_ttf_font_(resor_new_font(data), job->vpath,
+                                    job->w, job->h, job->flags);
+    default:
+      return NULL;
+  }
+}
+
+/* Removes the job from the queue, puts the resource in the store, tells the
+ * scripting side about it and frees the job. */
+static void storeload_finish(StoreLoadJob * job) {
+  StoreLoadJob * now, * prev = NULL;
+  Resor * resor = NULL;
+  al_lock_mutex(storeload_mutex);
+  for (now = storeload_first; now; prev = now, now = now->next) {
+    if (now != job) continue;
+    if (prev) prev->next = job->next; else storeload_first = job->next;
+    if (storeload_last == job) storeload_last = prev;
+    break;
+  }
+  al_unlock_mutex(storeload_mutex);
+  if (!job->cancelled) {
+    /* Another load may have put the same resource in the cache meanwhile. */
+    resor = store_share(job->index, job->key);
+    if (resor) {
+      storeload_stats_now.shared++;
+    } else if (job->status == STORELOAD_LOADED) {
+      resor = store_put_keyed(job->index, job->key, storeload_resor(job));
+    }
+  }
+  if (resor) {
+    storeload_stats_now.loaded++;
+  } else {
+    storeload_stats_now.failed++;
+  }
+  storeload_stats_now.pending--;
+  storeload_batch_finished++;
+  callrb_resource_loaded(job->id, job->index, job->kind, resor != NULL);
+  storeload_job_free(job);
+}
+
+/** Puts the resources that were loaded in the background in the store,
+ * until budget seconds have passed. At least one resource is done every
+ * call, so loading always makes progress. Must be called from the display
+ * thread. Returns the amount of jobs finished. */
+int storeload_update(double budget) {
+  StoreLoadJob * job;
+  double start;
+  int finished = 0;
+  if (!storeload_mutex) return 0;
+  start = al_get_time();
+  while ((job = storeload_next_ready())) {
+    if ((finished > 0) && ((al_get_time() - start) >= budget)) break;
+    storeload_finish(job);
+    finished++;
+  }
+  return finished;
+}
+
+/** Cancels the background loading of all resources into the store at
+ * index. Returns the amount of jobs cancelled. */
+int storeload_cancel(int index) {
+  StoreLoadJob * job;
+  int cancelled = 0;
+  if (!storeload_mutex || (index < 0)) return 0;
+  al_lock_mutex(storeload_mutex);
+  for (job = storeload_first; job; job = job->next) {
+    if ((job->index != index) || job->cancelled) continue;
+    job->cancelled = TRUE;
+    cancelled++;
+  }
+  al_unlock_mutex(storeload_mutex);
+  return cancelled;
+}
+
+/** Returns true if a resource is being loaded into the store at index in
+ * the background. */
+bool storeload_index_pending(int index) {
+  StoreLoadJob * job;
+  bool found = false;
+  if (!storeload_mutex || (index < 0)) return false;
+  al_lock_mutex(storeload_mutex);
+  for (job = storeload_first; job; job = job->next) {
+    if ((job->index == index) && !job->cancelled) {
+      found = true;
+      break;
+    }
+  }
+  al_unlock_mutex(storeload_mutex);
+  return found;
+}
+
+/** Returns the amount of resources that are still being loaded. */
+int storeload_pending(void) {
+  return storeload_stats_now.pending;
+}
+
+/** Returns how far along the loading of the resources started since the
+ * queue was last empty is, between 0.0 and 1.0. Returns 1.0 if nothing is
+ * loading. */
+double storeload_progress(void) {
+  if (storeload_batch_started < 1) return 1.0;
+  return ((double) storeload_batch_finished) / storeload_batch_started;
+}
+
+/** Returns the time in seconds spent on finishing resources per update. */
+double storeload_budget(void) {
+  return storeload_budget_now;
+}
+
+/** Sets the time in seconds spent on finishing resources per update.
+ * Returns the new budget. */
+double storeload_budget_(double budget) {
+  if (budget < 0.0) budget = 0.0;
+  storeload_budget_now = budget;
+  return budget;
+}
+
+/** Copies the statistics of the background loading into stats. */
+bool storeload_stats(StoreLoadStats * stats) {
+  if (!stats) return false;
+  (*stats) = storeload_stats_now;
+  return true;
+}
+
+/** Stops the worker threads and drops all jobs that are still pending,
+ * without telling the scripting side. */
+void storeload_done(void) {
+  StoreLoadJob * job, * next;
+  int index;
+  if (storeload_mutex && storeload_cond) {
+    al_lock_mutex(storeload_mutex);
+    storeload_stopping = TRUE;
+    al_broadcast_cond(storeload_cond);
+    al_unlock_mutex(storeload_mutex);
+  }
+  for (index = 0; index < STORELOAD_WORKERS; index++) {
+    if (!storeload_workers[index]) continue;
+    al_join_thread(storeload_workers[index], NULL);
+    al_destroy_thread(storeload_workers[index]);
+    storeload_workers[index] = NULL;
+  }
+  for (job = storeload_first; job; job = next) {
+    next            = job->next;
+    storeload_first = next;
+    storeload_job_free(job);
+  }
+  storeload_first = storeload_last = NULL;
+  storeload_stats_now.pending = 0;
+  storeload_batch_started     = 0;
+  storeload_batch_finished    = 0;
+  if (storeload_cond)  al_destroy_cond(storeload_cond);
+  if (storeload_mutex) al_destroy_mutex(storeload_mutex);
+  storeload_cond  = NULL;
+  storeload_mutex = NULL;
+}
@@ -0,0 +1,337 @@
+#include "textcache.h"
+#include "mem.h"
+#include <string.h>
+
+/*
+ * TextCache is a cache of text measurements for a single font. Menus and the
+ * console measure the same texts with the same fonts over and over again,
+ * and every measurement makes Allegro walk the glyphs of the text.
+ *
+ * The cache is a fixed size hash table with chaining, keyed by the hash of
+ * the text, and the entries are kept in a least recently used list so the
+ * oldest measurement is dropped when the cache is full. Since the entries
+ * keep a copy of the text, hash collisions can't return a wrong result.
+ *
+ * Optionally, the cache can be prewarmed, that is, the widths of the
+ * glyphs for the Latin-1 range of unicode are measured once. The width
+ * of texts that only use those glyphs is then calculated by adding up
+ * the glyph widths. This ignores kerning, so it's only correct for fonts
+ * without kerning, like the bitmap fonts, hence it's optional.
+ */
+
+enum TextCacheEntryFlags_ {
+  TEXTCACHE_HAS_WIDTH      = 1,
+  TEXTCACHE_HAS_DIMENSIONS = 2
+};
+
+#define TEXTCACHE_GLYPHS 256
+
+struct TextCacheEntry_ {
+  uint32_t hash;
+  int      size;
+  int      flags;
+  int      width;
+  int      bbx, bby, bbw, bbh;
+  /* Next entry in the same hash bucket, or -1. */
+  int      next;
+  /* Neighbours in the least recently used list, or -1. */
+  int      older;
+  int      newer;
+  char     text[TEXTCACHE_TEXT_MAX];
+};
+
+struct TextCache_ {
+  struct TextCacheEntry_  * entries;
+  int                     * buckets;
+  int                       nbuckets;
+  int                       size;
+  int                       used;
+  int                       newest;
+  int                       oldest;
+  int                       prewarmed;
+  int                       glyph_widths[TEXTCACHE_GLYPHS];
+  TextCacheStats            stats;
+};
+
+
+/* Allocates a text cache. */
+TextCache * textcache_alloc() {
+  return STRUCT_ALLOC(TextCache);
+}
+
+/* Initializes a text cache that can hold up to size measurements. */
+TextCache * textcache_init(TextCache * self, int size) {
+  int index;
+  if (!self) return NULL;
+  if (size < 1) size = TEXTCACHE_SIZE_DEFAULT;
+  /* Twice as many buckets as entries, rounded up to a power of two. */
+  self->nbuckets = 1;
+  while (self->nbuckets < (size * 2)) self->nbuckets *= 2;
+  self->entries  = STRUCT_NALLOC(struct TextCacheEntry_, size);
+  self->buckets  = STRUCT_NALLOC(int, self->nbuckets);
+  self->size     = size;
+  textcache_clear(self);
+  self->prewarmed = FALSE;
+  for (index = 0; index < TEXTCACHE_GLYPHS; index++) {
+    self->glyph_widths[index] = -1;
+  }
+  memset(&self->stats, 0, sizeof(self->stats));
+  return self;
+}
+
+/* Allocates and initializes a text cache. */
+TextCache * textcache_new(int size) {
+  return textcache_init(textcache_alloc(), size);
+}
+
+/* Cleans up the text cache. */
+TextCache * textcache_done(TextCache * self) {
+  if (!self) return NULL;
+  self->entries = mem_free(self->entries);
+  self->buckets = mem_free(self->buckets);
+  self->size    = 0;
+  self->used    = 0;
+  return self;
+}
+
+/* Cleans up and frees the text cache. Returns NULL. */
+TextCache * textcache_free(TextCache * self) {
+  textcache_done(self);
+  return mem_free(self);
+}
+
+/* Empties the text cache, but keeps the prewarmed glyph widths. */
+void textcache_clear(TextCache * self) {
+  int index;
+  if (!self || !self->buckets) return;
+  for (index = 0; index < self->nbuckets; index++) {
+    self->buckets[index] = -1;
+  }
+  self->used   = 0;
+  self->newest = -1;
+  self->oldest = -1;
+}
+
+/* Removes the entry at index from the least recently used list. */
+static void textcache_unlink(TextCache * self, int index) {
+  struct TextCacheEntry_ * entry = self->entries + index;
+  if (entry->older >= 0) {
+    self->entries[entry->older].newer = entry->newer;
+  } else {
+    self->oldest = entry->newer;
+  }
+  if (entry->newer >= 0) {
+    self->entries[entry->newer].older = entry->older;
+  } else {
+    self->newest = entry->older;
+  }
+  entry->older = entry->newer = -1;
+}
+
+/* Puts the entry at index at the newest end of the least recently used list. */
+static void textcache_link_newest(TextCache * self, int index) {
+  struct TextCacheEntry_ * entry = self->entries + index;
+  entry->older = self->newest;
+  entry->newer = -1;
+  if (self->newest >= 0) {
+    self->entries[self->newest].newer = index;
+  }
+  self->newest = index;
+  if (self->oldest < 0) self->oldest = index;
+}
+
+/* Removes the entry at index from its hash bucket. */
+static void textcache_unbucket(TextCache * self, int index) {
+  struct TextCacheEntry_ * entry = self->entries + index;
+  int * link = self->buckets + (entry->hash & (self->nbuckets - 1));
+  while ((*link) >= 0) {
+    if ((*link) == index) {
+      (*link) = entry->next;
+      return;
+    }
+    link = &self->entries[*link].next;
+  }
+}
+
+/* Looks up the entry for the text. Returns it, marked as the most recently
+ * used, or NULL if not found. */
+static struct TextCacheEntry_ *
+textcache_lookup(TextCache * self, uint32_t hash, const char * text, int size) {
+  int index = self->buckets[hash & (self->nbuckets - 1)];
+  while (index >= 0) {
+    struct TextCacheEntry_ * entry = self->entries + index;
+    if ((entry->hash == hash) && (entry->size == size) &&
+        (memcmp(entry->text, text, size) == 0)) {
+      if (self->newest != index) {
+        textcache_unlink(self, index);
+        textcache_link_newest(self, index);
+      }
+      return entry;
+    }
+    index = entry->next;
+  }
+  return NULL;
+}
+
+/* Makes a new, empty entry for the text, dropping the least recently used
+ * entry if the cache is full. */
+static struct TextCacheEntry_ *
+textcache_insert(TextCache * self, uint32_t hash, const char * text, int size) {
+  struct TextCacheEntry_ * entry;
+  int index, bucket;
+  if (self->used < self->size) {
+    index = self->used;
+    self->used++;
+  } else {
+    index = self->oldest;
+    textcache_unlink(self, index);
+    textcache_unbucket(self, index);
+    self->stats.evictions++;
+  }
+  entry         = self->entries + index;
+  entry->hash   = hash;
+  entry->size   = size;
+  entry->flags  = 0;
+  memcpy(entry->text, text, size);
+  bucket        = hash & (self->nbuckets - 1);
+  entry->next   = self->buckets[bucket];
+  self->buckets[bucket] = index;
+  textcache_link_newest(self, index);
+  return entry;
+}
+
+/* Finds or makes the entry for the text. Returns NULL if the text can't be
+ * cached. */
+static struct TextCacheEntry_ *
+textcache_entry(TextCache * self, const char * text, int size) {
+  uint32_t hash;
+  struct TextCacheEntry_ * entry;
+  if (!self || !self->entries)    return NULL;
+  if (size >= TEXTCACHE_TEXT_MAX) return NULL;
+  hash  = mem_fnv32(MEM_FNV32_BASIS, text, size);
+  entry = textcache_lookup(self, hash, text, size);
+  if (entry) return entry;
+  return textcache_insert(self, hash, text, size);
+}
+
+/* Calculates the width of the text from the prewarmed glyph widths.
+ * Returns false if that's not possible because the text has characters
+ * outside of the Latin-1 range. */
+static bool textcache_compute_width(TextCache * self, const char * text,
+                                    int size, int * value) {
+  int index = 0, width = 0;
+  if (!self->prewarmed) return false;
+  while (index < size) {
+    int glyph;
+    unsigned char ch = text[index];
+    if (ch < 0x80) {
+      glyph = ch;
+      index++;
+    } else if (((ch == 0xC2) || (ch == 0xC3)) && ((index + 1) < size)) {
+      /* Two byte UTF-8 for U+0080 to U+00FF. */
+      unsigned char next = text[index + 1];
+      if ((next & 0xC0) != 0x80) return false;
+      glyph  = ((ch & 0x1F) << 6) | (next & 0x3F);
+      index += 2;
+    } else {
+      return false;
+    }
+    if (self->glyph_widths[glyph] < 0) return false;
+    width += self->glyph_widths[glyph];
+  }
+  (*value) = width;
+  return true;
+}
+
+/** Stores the width of the size bytes of UTF-8 text in the font into value,
+ * using the cache if possible. Returns false if font or value is NULL. */
+bool textcache_get_width(TextCache * self, ALLEGRO_FONT * font,
+                         const char * text, int size, int * value) {
+  ALLEGRO_USTR_INFO info;
+  struct TextCacheEntry_ * entry;
+  if (!font || !value) return false;
+  if (!text) { text = ""; size = 0; }
+  entry = textcache_entry(self, text, size);
+  if (entry && (entry->flags & TEXTCACHE_HAS_WIDTH)) {
+    self->stats.hits++;
+    (*value) = entry->width;
+    return true;
+  }
+  if (self && textcache_compute_width(self, text, size, value)) {
+    self->stats.computed++;
+  } else {
+    if (self) {
+      if (entry) self->stats.misses++; else self->stats.skipped++;
+    }
+    (*value) = al_get_ustr_width(font, al_ref_buffer(&info, text, size));
+  }
+  if (entry) {
+    entry->width  = (*value);
+    entry->flags |= TEXTCACHE_HAS_WIDTH;
+  }
+  return true;
+}
+
+/** Stores the dimensions of the size bytes of UTF-8 text in the font,
+ * using the cache if possible. Returns false if font is NULL. */
+bool textcache_get_dimensions(TextCache * self, ALLEGRO_FONT * font,
+                              const char * text, int size,
+                              int * bbx, int * bby, int * bbw, int * bbh) {
+  ALLEGRO_USTR_INFO info;
+  struct TextCacheEntry_ * entry;
+  if (!font || !bbx || !bby || !bbw || !bbh) return false;
+  if (!text) { text = ""; size = 0; }
+  entry = textcache_entry(self, text, size);
+  if (entry && (entry->flags & TEXTCACHE_HAS_DIMENSIONS)) {
+    self->stats.hits++;
+  } else {
+    if (self) {
+      if (entry) self->stats.misses++; else self->stats.skipped++;
+    }
+    al_get_ustr_dimensions(font, al_ref_buffer(&info, text, size),
+                           bbx, bby, bbw, bbh);
+    if (!entry) return true;
+    entry->bbx    = (*bbx);
+    entry->bby    = (*bby);
+    entry->bbw    = (*bbw);
+    entry->bbh    = (*bbh);
+    entry->flags |= TEXTCACHE_HAS_DIMENSIONS;
+  }
+  (*bbx) = entry->bbx;
+  (*bby) = entry->bby;
+  (*bbw) = entry->bbw;
+  (*bbh) = entry->bbh;
+  return true;
+}
+
+/** Measures the width of all printable glyphs of the font in the Latin-1
+ * range once, so the width of texts that use only those can be calculated
+ * without calling Allegro. Returns true on success. */
+bool textcache_prewarm(TextCache * self, ALLEGRO_FONT * font) {
+  ALLEGRO_USTR * aid;
+  int glyph;
+  if (!self || !font) return false;
+  aid = al_ustr_new("");
+  if (!aid) return false;
+  for (glyph = 0; glyph < TEXTCACHE_GLYPHS; glyph++) {
+    /* Skip the control characters. */
+    if ((glyph < 0x20) || ((glyph >= 0x7F) && (glyph < 0xA0))) {
+      self->glyph_widths[glyph] = -1;
+      continue;
+    }
+    al_ustr_truncate(aid, 0);
+    al_ustr_append_chr(aid, glyph);
+    self->glyph_widths[glyph] = al_get_ustr_width(font, aid);
+  }
+  al_ustr_free(aid);
+  self->prewarmed = TRUE;
+  /* The cached widths stay valid, so no need to clear the cache. */
+  return true;
+}
+
+/** Copies the statistics of the text cache into stats. */
+bool textcache_stats(TextCache * self, TextCacheStats * stats) {
+  if (!self || !stats) return false;
+  (*stats) = self->stats;
+  return true;
+}
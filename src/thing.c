@@ -0,0 +1,557 @@
+#include "eruta.h"
+#include "mem.h"
+#include "draw.h"
+#include "thing.h"
+#include <string.h>
+
+/*
+ * The components of the things are kept in packed arrays, one entry per live
+ * thing, so the systems in thing_update run through them without any
+ * indirection. A thing that is deleted is replaced by the last one, so the
+ * arrays stay packed. Ids stay the same however: thing_store.slot maps an id
+ * to the current slot of the thing, or to -1 if the id isn't in use. The ids
+ * of deleted things are reused, the last one deleted first.
+ *
+ * The sprite state of a thing only gets its pose and direction from the packed
+ * arrays during thing_sync_sprites, and only if they changed, so scripts and
+ * thing_animate can change them as often as they like.
+ */
+
+typedef struct ThingStore_ ThingStore;
+
+struct ThingStore_ {
+  /* Components, indexed by slot. */
+  int           * id;
+  int           * kind;
+  int           * flags;
+  int           * group;
+  float         * x;
+  float         * y;
+  float         * z;
+  float         * w;
+  float         * h;
+  float         * vx;
+  float         * vy;
+  int           * pose;
+  int           * direction;
+  /* Pose and direction last passed to the sprite state. */
+  int           * shown_pose;
+  int           * shown_direction;
+  SpriteState  ** sprite;
+  int             used;
+  int             size;
+  /* Slots, indexed by id, and the ids that can be reused. */
+  int           * slot;
+  int           * free_ids;
+  int             free_used;
+  int             next_id;
+  int             ids_size;
+  /* Ids in drawing order. */
+  int           * order;
+};
+
+static ThingStore thing_store = { NULL };
+
+/* Reallocates a component array to size elements. */
+#define THING_GROW(ARRAY, SIZE) \
+  (ARRAY) = mem_realloc((ARRAY), (SIZE) * sizeof(*(ARRAY)))
+
+/* Makes sure there is room for at least one more thing. */
+static void thing_grow(void) {
+  int newsize;
+  if (thing_store.used < thing_store.size) return;
+  newsize = (thing_store.size < 1) ? 64 : thing_store.size * 2;
+  THING_GROW(thing_store.id, newsize);
+  THING_GROW(thing_store.kind, newsize);
+  THING_GROW(thing_store.flags, newsize);
+  THING_GROW(thing_store.group, newsize);
+  THING_GROW(thing_store.x, newsize);
+  THING_GROW(thing_store.y, newsize);
+  THING_GROW(thing_store.z, newsize);
+  THING_GROW(thing_store.w, newsize);
+  THING_GROW(thing_store.h, newsize);
+  THING_GROW(thing_store.vx, newsize);
+  THING_GROW(thing_store.vy, newsize);
+  THING_GROW(thing_store.pose, newsize);
+  THING_GROW(thing_store.direction, newsize);
+  THING_GROW(thing_store.shown_pose, newsize);
+  THING_GROW(thing_store.shown_direction, newsize);
+  THING_GROW(thing_store.sprite, newsize);
+  THING_GROW(thing_store.order, newsize);
+  thing_store.size = newsize;
+}
+
+/* Returns an id for a new thing, or negative if out of memory. */
+static int thing_new_id(void) {
+  int newsize;
+  if (thing_store.free_used > 0) {
+    thing_store.free_used--;
+    return thing_store.free_ids[thing_store.free_used];
+  }
+  if (thing_store.next_id >= thing_store.ids_size) {
+    newsize = (thing_store.ids_size < 1) ? 64 : thing_store.ids_size * 2;
+    THING_GROW(thing_store.slot, newsize);
+    THING_GROW(thing_store.free_ids, newsize);
+    if ((!thing_store.slot) || (!thing_store.free_ids)) return -1;
+    thing_store.ids_size = newsize;
+  }
+  return thing_store.next_id++;
+}
+
+/* Returns the slot of the thing with the given id, or negative if there is
+ * no such thing. */
+static int thing_slot(int id) {
+  if ((id < 0) || (id >= thing_store.next_id)) return -1;
+  return thing_store.slot[id];
+}
+
+/** Makes a new thing of the given kind, at x, y and z and with collision
+ * bounds of w by h. Returns it's id, or negative on error. */
+int thing_new(int kind, float x, float y, float z, float w, float h) {
+  int id, slot;
+  if ((w < 0.0f) || (h < 0.0f)) return -1;
+  thing_grow();
+  if (!thing_store.order) return -2;
+  id = thing_new_id();
+  if (id < 0) return -3;
+  slot                              = thing_store.used;
+  thing_store.slot[id]              = slot;
+  thing_store.id[slot]              = id;
+  thing_store.kind[slot]            = kind;
+  thing_store.flags[slot]           = 0;
+  thing_store.group[slot]           = 0;
+  thing_store.x[slot]               = x;
+  thing_store.y[slot]               = y;
+  thing_store.z[slot]               = z;
+  thing_store.w[slot]               = w;
+  thing_store.h[slot]               = h;
+  thing_store.vx[slot]              = 0.0f;
+  thing_store.vy[slot]              = 0.0f;
+  thing_store.pose[slot]            = SPRITE_STAND;
+  thing_store.direction[slot]       = SPRITE_SOUTH;
+  thing_store.shown_pose[slot]      = -1;
+  thing_store.shown_direction[slot] = -1;
+  thing_store.sprite[slot]          = NULL;
+  thing_store.order[slot]           = id;
+  thing_store.used++;
+  return id;
+}
+
+/** Deletes the thing with the given id and it's sprite state. The id may be
+ * reused by a later thing_new. Returns 0 on success or negative if there is
+ * no such thing. */
+int thing_delete(int id) {
+  int slot, last, index;
+  slot = thing_slot(id);
+  if (slot < 0) return -1;
+  thing_store.sprite[slot] = spritestate_free(thing_store.sprite[slot]);
+  last = thing_store.used - 1;
+  if (slot != last) {
+    thing_store.id[slot]              = thing_store.id[last];
+    thing_store.kind[slot]            = thing_store.kind[last];
+    thing_store.flags[slot]           = thing_store.flags[last];
+    thing_store.group[slot]           = thing_store.group[last];
+    thing_store.x[slot]               = thing_store.x[last];
+    thing_store.y[slot]               = thing_store.y[last];
+    thing_store.z[slot]               = thing_store.z[last];
+    thing_store.w[slot]               = thing_store.w[last];
+    thing_store.h[slot]               = thing_store.h[last];
+    thing_store.vx[slot]              = thing_store.vx[last];
+    thing_store.vy[slot]              = thing_store.vy[last];
+    thing_store.pose[slot]            = thing_store.pose[last];
+    thing_store.direction[slot]       = thing_store.direction[last];
+    thing_store.shown_pose[slot]      = thing_store.shown_pose[last];
+    thing_store.shown_direction[slot] = thing_store.shown_direction[last];
+    thing_store.sprite[slot]          = thing_store.sprite[last];
+    thing_store.slot[thing_store.id[slot]] = slot;
+  }
+  /* The rest of the drawing order stays as it was, so sorting stays cheap. */
+  for (index = 0; index < thing_store.used; index++) {
+    if (thing_store.order[index] == id) break;
+  }
+  for (; index < last; index++) {
+    thing_store.order[index] = thing_store.order[index + 1];
+  }
+  thing_store.used--;
+  thing_store.slot[id] = -1;
+  thing_store.free_ids[thing_store.free_used] = id;
+  thing_store.free_used++;
+  return 0;
+}
+
+/** Returns true if there is a thing with the given id, false if not. */
+int thing_exists(int id) {
+  return thing_slot(id) >= 0;
+}
+
+/** Returns the amount of things. */
+int thing_count(void) {
+  return thing_store.used;
+}
+
+/** Returns the id of the nth thing, for going through all things, or
+ * negative if there are no more. The order changes when things are
+ * deleted. */
+int thing_nth(int nth) {
+  if ((nth < 0) || (nth >= thing_store.used)) return -1;
+  return thing_store.id[nth];
+}
+
+/* Getters of the float components. They return 0 for a thing that doesn't
+ * exist. */
+#define THING_FLOAT_GETTER(NAME, EXPRESSION)                                   \
+float NAME(int id) {                                                           \
+  int slot = thing_slot(id);                                                   \
+  if (slot < 0) return 0.0f;                                                   \
+  return (EXPRESSION);                                                         \
+}
+
+THING_FLOAT_GETTER(thing_x, thing_store.x[slot])
+THING_FLOAT_GETTER(thing_y, thing_store.y[slot])
+THING_FLOAT_GETTER(thing_z, thing_store.z[slot])
+THING_FLOAT_GETTER(thing_w, thing_store.w[slot])
+THING_FLOAT_GETTER(thing_h, thing_store.h[slot])
+THING_FLOAT_GETTER(thing_cx, thing_store.x[slot] + thing_store.w[slot] / 2.0f)
+THING_FLOAT_GETTER(thing_cy, thing_store.y[slot] + thing_store.h[slot] / 2.0f)
+THING_FLOAT_GETTER(thing_vx, thing_store.vx[slot])
+THING_FLOAT_GETTER(thing_vy, thing_store.vy[slot])
+
+/* Getters of the int components. They return negative for a thing that
+ * doesn't exist. */
+#define THING_INT_GETTER(NAME, ARRAY)                                          \
+int NAME(int id) {                                                             \
+  int slot = thing_slot(id);                                                   \
+  if (slot < 0) return -1;                                                     \
+  return thing_store.ARRAY[slot];                                              \
+}
+
+THING_INT_GETTER(thing_kind, kind)
+THING_INT_GETTER(thing_flags, flags)
+THING_INT_GETTER(thing_group, group)
+THING_INT_GETTER(thing_pose, pose)
+THING_INT_GETTER(thing_direction, direction)
+
+/* Setters of one int component. They return the new value, or negative for a
+ * thing that doesn't exist. */
+#define THING_INT_SETTER(NAME, ARRAY, EXPRESSION)                              \
+int NAME(int id, int value) {                                                  \
+  int slot = thing_slot(id);                                                   \
+  if (slot < 0) return -1;                                                     \
+  thing_store.ARRAY[slot] = (EXPRESSION);                                      \
+  return thing_store.ARRAY[slot];                                              \
+}
+
+THING_INT_SETTER(thing_flags_, flags, value)
+THING_INT_SETTER(thing_set_flag, flags, thing_store.flags[slot] | value)
+THING_INT_SETTER(thing_unset_flag, flags, thing_store.flags[slot] & (~value))
+THING_INT_SETTER(thing_group_, group, value)
+THING_INT_SETTER(thing_pose_, pose, value)
+THING_INT_SETTER(thing_direction_, direction, value)
+
+/** Moves the thing to x and y. Returns 0, or negative if there is no such
+ * thing. */
+int thing_position_(int id, float x, float y) {
+  int slot = thing_slot(id);
+  if (slot < 0) return -1;
+  thing_store.x[slot] = x;
+  thing_store.y[slot] = y;
+  return 0;
+}
+
+/** Sets the z of the thing, which determines the drawing order. Returns 0, or
+ * negative if there is no such thing. */
+int thing_z_(int id, float z) {
+  int slot = thing_slot(id);
+  if (slot < 0) return -1;
+  thing_store.z[slot] = z;
+  return 0;
+}
+
+/** Sets the size of the collision bounds of the thing. Returns 0, or negative
+ * if there is no such thing or the size is negative. */
+int thing_size_(int id, float w, float h) {
+  int slot = thing_slot(id);
+  if (slot < 0) return -1;
+  if ((w < 0.0f) || (h < 0.0f)) return -2;
+  thing_store.w[slot] = w;
+  thing_store.h[slot] = h;
+  return 0;
+}
+
+/** Sets the velocity of the thing, in units per second. Returns 0, or
+ * negative if there is no such thing. */
+int thing_v_(int id, float vx, float vy) {
+  int slot = thing_slot(id);
+  if (slot < 0) return -1;
+  thing_store.vx[slot] = vx;
+  thing_store.vy[slot] = vy;
+  return 0;
+}
+
+/** Gives the thing a new sprite state that shows sprite, or takes away it's
+ * sprite state if sprite is NULL. Returns 0 on success, or negative if there
+ * is no such thing or on out of memory. */
+int thing_sprite_(int id, Sprite * sprite) {
+  SpriteState * state;
+  int slot = thing_slot(id);
+  if (slot < 0) return -1;
+  thing_store.sprite[slot] = spritestate_free(thing_store.sprite[slot]);
+  if (!sprite) return 0;
+  state = spritestate_new(sprite, NULL);
+  if (!state) return -2;
+  thing_store.sprite[slot]          = state;
+  thing_store.shown_pose[slot]      = thing_store.pose[slot];
+  thing_store.shown_direction[slot] = thing_store.direction[slot];
+  spritestate_posedirection_(state, thing_store.pose[slot],
+                             thing_store.direction[slot]);
+  return 0;
+}
+
+/** Returns the sprite state of the thing, or NULL if it has none. */
+SpriteState * thing_spritestate(int id) {
+  int slot = thing_slot(id);
+  if (slot < 0) return NULL;
+  return thing_store.sprite[slot];
+}
+
+/** Takes away the sprite states of all things that show sprite, for when it
+ * is deleted. Returns the amount of things that showed it. */
+int thing_forget_sprite(Sprite * sprite) {
+  int slot, forgot = 0;
+  for (slot = 0; slot < thing_store.used; slot++) {
+    if (!thing_store.sprite[slot]) continue;
+    if (spritestate_sprite(thing_store.sprite[slot]) != sprite) continue;
+    thing_store.sprite[slot] = spritestate_free(thing_store.sprite[slot]);
+    forgot++;
+  }
+  return forgot;
+}
+
+/** Tints the layer of the sprite of the thing. Returns negative if the thing
+ * doesn't exist or has no sprite. */
+int thing_tint_layer(int id, int layer, int r, int g, int b, int a) {
+  SpriteState * state = thing_spritestate(id);
+  if (!state) return -1;
+  return spritestate_tint_layer(state, layer, al_map_rgba(r, g, b, a));
+}
+
+/** Hides or shows the layer of the sprite of the thing. Returns negative if
+ * the thing doesn't exist or has no sprite. */
+int thing_hide_layer(int id, int layer, int hidden) {
+  SpriteState * state = thing_spritestate(id);
+  if (!state) return -1;
+  return spritestate_set_layer_hidden(state, layer, hidden);
+}
+
+/** Returns true if the layer of the sprite of the thing is hidden. */
+int thing_layer_hidden(int id, int layer) {
+  SpriteState * state = thing_spritestate(id);
+  if (!state) return FALSE;
+  return spritestate_get_layer_hidden(state, layer);
+}
+
+/** Sets the loop mode of an action of the sprite of the thing. */
+int thing_set_action_loop(int id, int action, int loopmode) {
+  SpriteState * state = thing_spritestate(id);
+  if (!state) return -1;
+  return spritestate_set_action_loop(state, action, loopmode);
+}
+
+/** Returns the loop mode of an action of the sprite of the thing. */
+int thing_get_action_loop(int id, int action) {
+  SpriteState * state = thing_spritestate(id);
+  if (!state) return -1;
+  return spritestate_get_action_loop(state, action);
+}
+
+/** Sets the loop mode of the actions for the pose and direction of the sprite
+ * of the thing. */
+int thing_set_pose_direction_loop(int id, int pose, int direction, int loopmode) {
+  SpriteState * state = thing_spritestate(id);
+  if (!state) return -1;
+  return spritestate_set_pose_direction_loop(state, pose, direction, loopmode);
+}
+
+/** Returns the loop mode of the action for the pose and direction of the
+ * sprite of the thing. */
+int thing_get_pose_direction_loop(int id, int pose, int direction) {
+  SpriteState * state = thing_spritestate(id);
+  if (!state) return -1;
+  return spritestate_get_pose_direction_loop(state, pose, direction);
+}
+
+/** Returns true if the action of the sprite of the thing is done. */
+int thing_action_done(int id, int action) {
+  SpriteState * state = thing_spritestate(id);
+  if (!state) return FALSE;
+  return spritestate_is_action_done(state, action);
+}
+
+/** Stores the ids of at most max enabled things of which the collision bounds
+ * overlap the rectangle in ids. Returns the amount of ids stored. */
+int thing_find_in_rectangle(float x, float y, float w, float h,
+                            int * ids, int max) {
+  int slot, found = 0;
+  float x2 = x + w, y2 = y + h;
+  for (slot = 0; (slot < thing_store.used) && (found < max); slot++) {
+    float tx = thing_store.x[slot], ty = thing_store.y[slot];
+    if (thing_store.flags[slot] & THING_FLAG_DISABLED) continue;
+    if ((tx > x2) || (ty > y2)) continue;
+    if ((tx + thing_store.w[slot] < x) || (ty + thing_store.h[slot] < y)) continue;
+    ids[found] = thing_store.id[slot];
+    found++;
+  }
+  return found;
+}
+
+/** Moves all things that aren't disabled or static by their velocity for dt
+ * seconds. Returns the amount of things that moved. */
+int thing_integrate(double dt) {
+  int slot, moved = 0;
+  float step = (float) dt;
+  for (slot = 0; slot < thing_store.used; slot++) {
+    float vx = thing_store.vx[slot], vy = thing_store.vy[slot];
+    if (thing_store.flags[slot] & (THING_FLAG_DISABLED | THING_FLAG_STATIC)) {
+      continue;
+    }
+    if ((vx == 0.0f) && (vy == 0.0f)) continue;
+    thing_store.x[slot] += vx * step;
+    thing_store.y[slot] += vy * step;
+    moved++;
+  }
+  return moved;
+}
+
+/** Lets the pose and direction of the things with THING_FLAG_ANIMATE follow
+ * their velocity: they walk in the direction they move in most, and stand
+ * when they don't move. Things in any other pose, such as an attack, are
+ * left alone. Returns the amount of things of which the pose or direction
+ * changed. */
+int thing_animate(void) {
+  int slot, changed = 0;
+  for (slot = 0; slot < thing_store.used; slot++) {
+    int flags = thing_store.flags[slot];
+    int pose  = thing_store.pose[slot];
+    int direction = thing_store.direction[slot];
+    float vx  = thing_store.vx[slot], vy = thing_store.vy[slot];
+    if ((flags & (THING_FLAG_ANIMATE | THING_FLAG_DISABLED))
+        != THING_FLAG_ANIMATE) continue;
+    if ((pose != SPRITE_WALK) && (pose != SPRITE_STAND)) continue;
+    if ((vx == 0.0f) && (vy == 0.0f)) {
+      pose = SPRITE_STAND;
+    } else {
+      pose = SPRITE_WALK;
+      if (fabsf(vx) > fabsf(vy)) {
+        direction = (vx > 0.0f) ? SPRITE_EAST  : SPRITE_WEST;
+      } else {
+        direction = (vy > 0.0f) ? SPRITE_SOUTH : SPRITE_NORTH;
+      }
+    }
+    if ((pose == thing_store.pose[slot])
+        && (direction == thing_store.direction[slot])) continue;
+    thing_store.pose[slot]      = pose;
+    thing_store.direction[slot] = direction;
+    changed++;
+  }
+  return changed;
+}
+
+/** Passes the pose and direction of the things that changed them to their
+ * sprite states. Returns the amount of sprite states changed. */
+int thing_sync_sprites(void) {
+  int slot, synced = 0;
+  for (slot = 0; slot < thing_store.used; slot++) {
+    int pose      = thing_store.pose[slot];
+    int direction = thing_store.direction[slot];
+    if (!thing_store.sprite[slot]) continue;
+    if ((pose == thing_store.shown_pose[slot])
+        && (direction == thing_store.shown_direction[slot])) continue;
+    spritestate_posedirection_(thing_store.sprite[slot], pose, direction);
+    thing_store.shown_pose[slot]      = pose;
+    thing_store.shown_direction[slot] = direction;
+    synced++;
+  }
+  return synced;
+}
+
+/** Runs the systems of the things for a frame of dt seconds: moves them,
+ * animates them and passes the result to their sprite states. The sprite
+ * animation system then advances the sprite states themselves. Returns the
+ * amount of things that moved. */
+int thing_update(double dt) {
+  int moved = thing_integrate(dt);
+  thing_animate();
+  thing_sync_sprites();
+  return moved;
+}
+
+/* Returns true if the thing with id a should be drawn after the one with id
+ * b: things with a higher z are drawn later, and if z is the same, things that
+ * are lower on the screen are drawn later. */
+static int thing_draw_after(int a, int b) {
+  int sa = thing_store.slot[a], sb = thing_store.slot[b];
+  if (thing_store.z[sa] != thing_store.z[sb]) {
+    return thing_store.z[sa] > thing_store.z[sb];
+  }
+  return (thing_store.y[sa] + thing_store.h[sa])
+       > (thing_store.y[sb] + thing_store.h[sb]);
+}
+
+/** Draws the sprites of all things that aren't hidden or disabled, and their
+ * collision bounds if show_bounds is set. */
+void thing_draw(int show_bounds) {
+  int index, slot;
+  /* The order changes little between frames, so an insertion sort of the
+   * previous order is about linear. */
+  for (index = 1; index < thing_store.used; index++) {
+    int id   = thing_store.order[index];
+    int move = index;
+    while ((move > 0) && thing_draw_after(thing_store.order[move - 1], id)) {
+      thing_store.order[move] = thing_store.order[move - 1];
+      move--;
+    }
+    thing_store.order[move] = id;
+  }
+  for (index = 0; index < thing_store.used; index++) {
+    Point at;
+    slot = thing_store.slot[thing_store.order[index]];
+    if (thing_store.flags[slot] & (THING_FLAG_HIDDEN | THING_FLAG_DISABLED)) {
+      continue;
+    }
+    at = bevec(thing_store.x[slot], thing_store.y[slot]);
+    if (thing_store.sprite[slot]) spritestate_draw(thing_store.sprite[slot], &at);
+    if (show_bounds) {
+      draw_box(thing_store.x[slot], thing_store.y[slot],
+               thing_store.w[slot], thing_store.h[slot],
+               al_map_rgb(255, 255, 0), 1);
+    }
+  }
+}
+
+/** Deletes all things and frees the thing store. */
+void thing_done(void) {
+  int slot;
+  for (slot = 0; slot < thing_store.used; slot++) {
+    spritestate_free(thing_store.sprite[slot]);
+  }
+  mem_free(thing_store.id);
+  mem_free(thing_store.kind);
+  mem_free(thing_store.flags);
+  mem_free(thing_store.group);
+  mem_free(thing_store.x);
+  mem_free(thing_store.y);
+  mem_free(thing_store.z);
+  mem_free(thing_store.w);
+  mem_free(thing_store.h);
+  mem_free(thing_store.vx);
+  mem_free(thing_store.vy);
+  mem_free(thing_store.pose);
+  mem_free(thing_store.direction);
+  mem_free(thing_store.shown_pose);
+  mem_free(thing_store.shown_direction);
+  mem_free(thing_store.sprite);
+  mem_free(thing_store.order);
+  mem_free(thing_store.slot);
+  mem_free(thing_store.free_ids);
+  memset(&thing_store, 0, sizeof(thing_store));
+}
@@ -16,6 +16,11 @@
 #include "camera.h"
 #include "monolog.h"
 #include "skybox.h"
+#include "callrb.h"
+#include "scriptcache.h"
+#include "rhalloc.h"
+#include "rhprof.h"
+#include "rhtask.h"
 
 #include <mruby/hash.h>
 #include <mruby/class.h>
@@ -26,6 +31,8 @@
 #include "tr_graph.h"
 #include "tr_store.h"
 #include "tr_sprite.h"
+#include "tr_thing.h"
+#include "toruby_bind.h"
 
 
 /* Documentation of mrb_get_args: 
@@ -249,105 +256,6 @@ static mrb_value tr_lockin_maplayer(mrb_state * mrb, mrb_value self) {
 }
 
 
-static mrb_value tr_skybox_set_texture(mrb_state * mrb, mrb_value self) {
-  State * state    = state_get();
-  int result;
-  mrb_int   direction, texture;
-  (void) self; (void) mrb;
-  mrb_get_args(mrb, "ii", &direction, &texture);  
-  result = skybox_set_texture(direction, texture);
-  return mrb_fixnum_value(result);
-}
-
-
-static mrb_value tr_skybox_set_rgb(mrb_state * mrb, mrb_value self) {
-  State * state    = state_get();
-  int result;
-  mrb_int   direction, point, r, g, b;
-  (void) self; (void) mrb;
-  mrb_get_args(mrb, "iiiii", &direction, &point, &r, &g, &b);  
-  result = skybox_set_rgb(direction, point, r, g ,b);
-  return mrb_fixnum_value(result);
-}
-
-
-#define TORUBY_CAMERA_TYPE_GETTER(NAME, TOCALL, TYPE, CONVERT)  \
-static mrb_value NAME(mrb_state * mrb, mrb_value self) {  \
-  State * state    = state_get();                         \
-  Camera * camera  = state_camera(state);                 \
-  TYPE result;                                            \
-  (void) self; (void) mrb;                                \
-  result           = TOCALL(camera);                      \
-  return CONVERT(result);                                 \
-}
-
-#define TORUBY_CAMERA_TYPE_MRB_GETTER(NAME, TOCALL, TYPE, CONVERT)  \
-static mrb_value NAME(mrb_state * mrb, mrb_value self) {  \
-  State * state    = state_get();                         \
-  Camera * camera  = state_camera(state);                 \
-  TYPE result;                                            \
-  (void) self; (void) mrb;                                \
-  result           = TOCALL(camera);                      \
-  return CONVERT(mrb, result);                            \
-}
-
-#define TORUBY_CAMERA_TYPE_SETTER(NAME, TOCALL, TYPE, CONVERT, PARAMSTR)  \
-static mrb_value NAME(mrb_state * mrb, mrb_value self) {  \
-  State * state    = state_get();                         \
-  Camera * camera  = state_camera(state);                 \
-  TYPE result, value;                                     \
-  (void) self; (void) mrb;                                \
-  mrb_get_args(mrb, PARAMSTR, &value);                    \
-  result           = TOCALL(camera, value);               \
-  return CONVERT(result);                                 \
-}
-
-#define TORUBY_CAMERA_TYPE_MRB_SETTER(NAME, TOCALL, TYPE, CONVERT, PARAMSTR)  \
-static mrb_value NAME(mrb_state * mrb, mrb_value self) {  \
-  State * state    = state_get();                         \
-  Camera * camera  = state_camera(state);                 \
-  TYPE result, value;                                     \
-  (void) self; (void) mrb;                                \
-  mrb_get_args(mrb, PARAMSTR, &value);                    \
-  result           = TOCALL(camera, value);               \
-  return CONVERT(mrb, result);                            \
-}
-
-
-
-#define TORUBY_CAMERA_FLOAT_GETTER(NAME, TOCALL)          \
-  TORUBY_CAMERA_TYPE_MRB_GETTER(NAME, TOCALL, mrb_float, mrb_float_value)
-
-#define TORUBY_CAMERA_INT_GETTER(NAME, TOCALL)          \
-  TORUBY_CAMERA_TYPE_GETTER(NAME, TOCALL, mrb_int, mrb_fixnum_value)
-
-#define TORUBY_CAMERA_FLOAT_SETTER(NAME, TOCALL)          \
-  TORUBY_CAMERA_TYPE_MRB_SETTER(NAME, TOCALL, mrb_float, mrb_float_value, "f")
-
-#define TORUBY_CAMERA_INT_SETTER(NAME, TOCALL)          \
-  TORUBY_CAMERA_TYPE_SETTER(NAME, TOCALL, mrb_int, mrb_fixnum_value, "i")
-
-
-  
-TORUBY_CAMERA_FLOAT_GETTER(tr_camera_x, camera_at_x)
-TORUBY_CAMERA_FLOAT_GETTER(tr_camera_y, camera_at_y)
-TORUBY_CAMERA_FLOAT_GETTER(tr_camera_z, camera_at_z)
-TORUBY_CAMERA_FLOAT_GETTER(tr_camera_alpha, camera_alpha)
-TORUBY_CAMERA_FLOAT_GETTER(tr_camera_theta, camera_theta)
-TORUBY_CAMERA_FLOAT_GETTER(tr_camera_fov, camera_fov)
-
-
-TORUBY_CAMERA_INT_GETTER(tr_camera_w, camera_w)
-TORUBY_CAMERA_INT_GETTER(tr_camera_h, camera_h)
-
-TORUBY_CAMERA_FLOAT_SETTER(tr_camera_x_, camera_at_x_)
-TORUBY_CAMERA_FLOAT_SETTER(tr_camera_y_, camera_at_y_)
-TORUBY_CAMERA_FLOAT_SETTER(tr_camera_z_, camera_at_z_)
-TORUBY_CAMERA_FLOAT_SETTER(tr_camera_alpha_, camera_alpha_)
-TORUBY_CAMERA_FLOAT_SETTER(tr_camera_theta_, camera_theta_)
-TORUBY_CAMERA_FLOAT_SETTER(tr_camera_fov_, camera_fov_)
-
-
 /* Obsolete, tile maps will be loaded through store. 
 static mrb_value tr_loadtilemap_vpath(mrb_state * mrb, mrb_value self) {
   State * state    = state_get();
@@ -392,15 +300,307 @@ tr_actorindex
 
 
 
-TORUBY_0_FGETTER(tr_get_time, al_get_time)
-TR_WRAP_NOARG_BOOL(tr_show_fps, global_state_show_fps)
-TR_WRAP_NOARG_BOOL(tr_show_graph, global_state_show_graph)
-TR_WRAP_NOARG_BOOL(tr_show_area, global_state_show_area)
-TR_WRAP_B_BOOL(tr_show_fps_, global_state_show_fps_)
-TR_WRAP_B_BOOL(tr_show_graph_, global_state_show_graph_)
-TR_WRAP_B_BOOL(tr_show_area_, global_state_show_area_)
-TR_WRAP_B_BOOL(tr_show_mouse_cursor_, scegra_show_system_mouse_cursor)
 
+/** Returns the statistics of the callbacks from the engine into the scripts
+ * as an array of [name, calls, total time, longest time] arrays, with the
+ * times in seconds. */
+static mrb_value tr_callback_stats(mrb_state * mrb, mrb_value self) {
+  RhCallbackStats stats;
+  mrb_value       result, vals[4];
+  int             index;
+  (void) self;
+  result = mrb_ary_new_capa(mrb, CALLRB_CALLBACKS);
+  for (index = 0; index < CALLRB_CALLBACKS; index++) {
+    if (!callrb_stats(index, &stats)) continue;
+    vals[0] = mrb_str_new_cstr(mrb, callrb_name(index));
+    vals[1] = mrb_fixnum_value(stats.calls);
+    vals[2] = mrb_float_value(mrb, stats.time);
+    vals[3] = mrb_float_value(mrb, stats.time_max);
+    mrb_ary_push(mrb, result, mrb_ary_new_from_values(mrb, 4, vals));
+  }
+  return result;
+}
+
+/** Clears the statistics of the callbacks into the scripts. */
+static mrb_value tr_callback_stats_reset(mrb_state * mrb, mrb_value self) {
+  (void) mrb; (void) self;
+  callrb_stats_reset();
+  return mrb_nil_value();
+}
+
+/** Returns the statistics of the script cache as an array of
+ * [hits, misses, failed, total load time in seconds]. */
+static mrb_value tr_script_cache_stats(mrb_state * mrb, mrb_value self) {
+  ScriptCacheStats stats;
+  mrb_value        vals[4];
+  (void) self;
+  if (!scriptcache_stats(&stats)) return mrb_nil_value();
+  vals[0] = mrb_fixnum_value(stats.hits);
+  vals[1] = mrb_fixnum_value(stats.misses);
+  vals[2] = mrb_fixnum_value(stats.failed);
+  vals[3] = mrb_float_value(mrb, stats.time);
+  return mrb_ary_new_from_values(mrb, 4, vals);
+}
+
+/** Returns the loaded scripts as an array of [vpath, vpath of the script
+ * that loaded it or nil]. */
+static mrb_value tr_loaded_scripts(mrb_state * mrb, mrb_value self) {
+  mrb_value    result, vals[2];
+  const char * vpath, * parent;
+  int          index;
+  (void) self;
+  result = mrb_ary_new(mrb);
+  for (index = 0; (vpath = scriptcache_loaded_vpath(index, &parent)); 
+       index++) {
+    vals[0] = mrb_str_new_cstr(mrb, vpath);
+    vals[1] = parent ? mrb_str_new_cstr(mrb, parent) : mrb_nil_value();
+    mrb_ary_push(mrb, result, mrb_ary_new_from_values(mrb, 2, vals));
+  }
+  return result;
+}
+
+/** Returns whether the loaded scripts are reloaded when they change. */
+static mrb_value tr_watch_scripts(mrb_state * mrb, mrb_value self) {
+  (void) mrb; (void) self;
+  return rh_bool_value(scriptcache_watch());
+}
+
+/** Sets whether the loaded scripts are reloaded when they change. */
+static mrb_value tr_watch_scripts_(mrb_state * mrb, mrb_value self) {
+  mrb_value watch;
+  (void) self;
+  mrb_get_args(mrb, "o", &watch);
+  return rh_bool_value(scriptcache_watch_(mrb_test(watch)));
+}
+
+/** Returns the memory and GC statistics of the scripts as an array of
+ * [heap bytes, most heap bytes, live objects, GC threshold, GC time this
+ * frame, total GC time, longest GC time, incremental steps, full 
+ * collections, highest arena index], with the times in seconds. */
+static mrb_value tr_gc_stats(mrb_state * mrb, mrb_value self) {
+  RhGcStats stats;
+  mrb_value vals[10];
+  (void) self;
+  if (!rh_gc_stats(mrb, &stats)) return mrb_nil_value();
+  vals[0] = mrb_fixnum_value(stats.heap);
+  vals[1] = mrb_fixnum_value(stats.heap_max);
+  vals[2] = mrb_fixnum_value(stats.live);
+  vals[3] = mrb_fixnum_value(stats.threshold);
+  vals[4] = mrb_float_value(mrb, stats.frame_time);
+  vals[5] = mrb_float_value(mrb, stats.time);
+  vals[6] = mrb_float_value(mrb, stats.time_max);
+  vals[7] = mrb_fixnum_value(stats.steps);
+  vals[8] = mrb_fixnum_value(stats.full);
+  vals[9] = mrb_fixnum_value(stats.arena_max);
+  return mrb_ary_new_from_values(mrb, 10, vals);
+}
+
+/** Returns the statistics of the script allocator as an array of
+ * [largest size, allocations, frees, live blocks, bytes] per size class,
+ * followed by those of the frame regions and of the large blocks, which have
+ * nil as size. Empty when the scripts use the system allocator. */
+static mrb_value tr_alloc_stats(mrb_state * mrb, mrb_value self) {
+  RhallocStats stats;
+  mrb_value    result, vals[5];
+  int          index;
+  (void) self;
+  result = mrb_ary_new_capa(mrb, RHALLOC_STATS);
+  if (rh_allocator() != RH_ALLOC_POOL) return result;
+  for (index = 0; index < RHALLOC_STATS; index++) {
+    int size = rhalloc_class_size(index);
+    if (!rhalloc_stats(index, &stats)) continue;
+    vals[0] = (size < 0) ? mrb_nil_value() : mrb_fixnum_value(size);
+    vals[1] = mrb_fixnum_value(stats.allocs);
+    vals[2] = mrb_fixnum_value(stats.frees);
+    vals[3] = mrb_fixnum_value(stats.live);
+    vals[4] = mrb_fixnum_value(stats.bytes);
+    mrb_ary_push(mrb, result, mrb_ary_new_from_values(mrb, 5, vals));
+  }
+  return result;
+}
+
+/** Returns the statistics of the script tasks as an array of [id, name,
+ * resumes, overruns, total time, longest time, time last frame] arrays, with
+ * the times in seconds. */
+static mrb_value tr_task_stats(mrb_state * mrb, mrb_value self) {
+  RhTaskStats stats;
+  mrb_value   result, vals[7];
+  int         index;
+  (void) self;
+  result = mrb_ary_new_capa(mrb, rhtask_count());
+  for (index = 0; rhtask_stats(index, &stats); index++) {
+    vals[0] = mrb_fixnum_value(stats.id);
+    vals[1] = mrb_str_new_cstr(mrb, stats.name);
+    vals[2] = mrb_fixnum_value(stats.resumes);
+    vals[3] = mrb_fixnum_value(stats.overruns);
+    vals[4] = mrb_float_value(mrb, stats.time);
+    vals[5] = mrb_float_value(mrb, stats.time_max);
+    vals[6] = mrb_float_value(mrb, stats.frame_time);
+    mrb_ary_push(mrb, result, mrb_ary_new_from_values(mrb, 7, vals));
+  }
+  return result;
+}
+
+/** Returns the statistics of the script tasks in the last frame as an array
+ * of [tasks, resumed, finished, waiting, time, budget], with the times in
+ * seconds. */
+static mrb_value tr_task_frame_stats(mrb_state * mrb, mrb_value self) {
+  RhTaskFrameStats stats;
+  mrb_value        vals[6];
+  (void) self;
+  if (!rhtask_frame_stats(&stats)) return mrb_nil_value();
+  vals[0] = mrb_fixnum_value(stats.tasks);
+  vals[1] = mrb_fixnum_value(stats.resumed);
+  vals[2] = mrb_fixnum_value(stats.finished);
+  vals[3] = mrb_fixnum_value(stats.waiting);
+  vals[4] = mrb_float_value(mrb, stats.time);
+  vals[5] = mrb_float_value(mrb, stats.budget);
+  return mrb_ary_new_from_values(mrb, 6, vals);
+}
+
+/** Clears the GC times, counts and high water marks. */
+static mrb_value tr_gc_stats_reset(mrb_state * mrb, mrb_value self) {
+  (void) mrb; (void) self;
+  rh_gc_stats_reset();
+  return mrb_nil_value();
+}
+
+/** Sets the interval and step ratios of the incremental GC. Negative values
+ * are left as they are. */
+static mrb_value tr_gc_configure(mrb_state * mrb, mrb_value self) {
+  mrb_int interval, step;
+  (void) self;
+  mrb_get_args(mrb, "ii", &interval, &step);
+  rh_gc_configure(mrb, interval, step);
+  return mrb_nil_value();
+}
+
+/** Sets the frame time and the most GC time per frame, in seconds, for the
+ * GC work done when a frame is finished early. */
+static mrb_value tr_gc_idle_budget(mrb_state * mrb, mrb_value self) {
+  mrb_float frame_time, idle_max;
+  (void) self;
+  mrb_get_args(mrb, "ff", &frame_time, &idle_max);
+  rh_gc_idle_budget_(frame_time, idle_max);
+  return mrb_nil_value();
+}
+
+/** Runs a full garbage collection now. Returns the time it took. */
+static mrb_value tr_gc_full(mrb_state * mrb, mrb_value self) {
+  (void) self;
+  return mrb_float_value(mrb, rh_gc_full(mrb));
+}
+
+/** Runs a full garbage collection at the end of this frame. */
+static mrb_value tr_gc_full_later(mrb_state * mrb, mrb_value self) {
+  (void) mrb; (void) self;
+  rh_gc_full_later();
+  return mrb_nil_value();
+}
+
+/** Returns whether consecutive mouse and joystick axis moves are merged
+ * before they are sent to eruta_on_events. */
+static mrb_value tr_coalesce_events(mrb_state * mrb, mrb_value self) {
+  (void) mrb; (void) self;
+  return rh_bool_value(rh_events_coalesce());
+}
+
+/** Sets whether consecutive mouse and joystick axis moves are merged. */
+static mrb_value tr_coalesce_events_(mrb_state * mrb, mrb_value self) {
+  mrb_value coalesce;
+  (void) self;
+  mrb_get_args(mrb, "o", &coalesce);
+  return rh_bool_value(rh_events_coalesce_(mrb_test(coalesce)));
+}
+
+/** Returns the statistics of the batched events as an array of
+ * [queued, coalesced, sent, batches]. */
+static mrb_value tr_event_stats(mrb_state * mrb, mrb_value self) {
+  RhEventStats stats;
+  mrb_value    vals[4];
+  (void) self;
+  if (!rh_event_stats(&stats)) return mrb_nil_value();
+  vals[0] = mrb_fixnum_value(stats.queued);
+  vals[1] = mrb_fixnum_value(stats.coalesced);
+  vals[2] = mrb_fixnum_value(stats.sent);
+  vals[3] = mrb_fixnum_value(stats.batches);
+  return mrb_ary_new_from_values(mrb, 4, vals);
+}
+
+/** Returns whether the script profiler is running. */
+static mrb_value tr_profile(mrb_state * mrb, mrb_value self) {
+  (void) mrb; (void) self;
+  return rh_bool_value(rhprof_active());
+}
+
+/** Starts or stops the script profiler. Returns whether it runs, which is
+ * never if eruta was built without it. */
+static mrb_value tr_profile_(mrb_state * mrb, mrb_value self) {
+  mrb_value profile;
+  (void) self;
+  mrb_get_args(mrb, "o", &profile);
+  if (mrb_test(profile)) {
+    if (!rhprof_active()) rhprof_start(mrb, rhprof_interval());
+  } else {
+    rhprof_stop(mrb);
+  }
+  return rh_bool_value(rhprof_active());
+}
+
+/** Returns the time between samples of the profiler in seconds. */
+static mrb_value tr_profile_interval(mrb_state * mrb, mrb_value self) {
+  (void) self;
+  return mrb_float_value(mrb, rhprof_interval());
+}
+
+/** Sets the time between samples of the profiler in seconds. */
+static mrb_value tr_profile_interval_(mrb_state * mrb, mrb_value self) {
+  mrb_float interval;
+  (void) self;
+  mrb_get_args(mrb, "f", &interval);
+  return mrb_float_value(mrb, rhprof_interval_(interval));
+}
+
+/** Returns the methods in which the profiler found the scripts most often
+ * as an array of [method, self time, total time], with the times in
+ * seconds, at most as many as the argument. */
+static mrb_value tr_profile_report(mrb_state * mrb, mrb_value self) {
+  RhprofEntry entries[64];
+  mrb_value   result, vals[3];
+  mrb_int     max;
+  int         index, amount;
+  (void) self;
+  mrb_get_args(mrb, "i", &max);
+  if (max > 64) max = 64;
+  amount = rhprof_top(entries, (int) max);
+  result = mrb_ary_new_capa(mrb, (amount > 0) ? amount : 0);
+  for (index = 0; index < amount; index++) {
+    vals[0] = mrb_str_new_cstr(mrb, entries[index].label);
+    vals[1] = mrb_float_value(mrb, entries[index].self  * rhprof_interval());
+    vals[2] = mrb_float_value(mrb, entries[index].total * rhprof_interval());
+    mrb_ary_push(mrb, result, mrb_ary_new_from_values(mrb, 3, vals));
+  }
+  return result;
+}
+
+/** Writes the sampled call stacks to the named file in the folded format of
+ * flamegraph.pl. Returns the amount of stacks written, or nil on failure. */
+static mrb_value tr_profile_dump(mrb_state * mrb, mrb_value self) {
+  char * filename = NULL;
+  int    lines;
+  (void) self;
+  mrb_get_args(mrb, "z", &filename);
+  lines = rhprof_dump(filename);
+  if (lines < 0) return mrb_nil_value();
+  return mrb_fixnum_value(lines);
+}
+
+/** Forgets all samples of the profiler. */
+static mrb_value tr_profile_reset(mrb_state * mrb, mrb_value self) {
+  (void) mrb; (void) self;
+  rhprof_reset();
+  return mrb_nil_value();
+}
 
 
 /* Initializes the functionality that Eruta exposes to Ruby. */
@@ -417,6 +617,7 @@ int tr_init(mrb_state * mrb) {
   struct RClass *aud;
   struct RClass *cam;
   struct RClass *sky;
+  struct RClass *tsk;
   
   mrb->ud = state_get();
   
@@ -454,36 +655,16 @@ int tr_init(mrb_state * mrb) {
 
   TR_METHOD_ARGC(mrb, krn, "camera_track" , tr_camera_track, 1);
   TR_METHOD_ARGC(mrb, krn, "camera_lockin", tr_lockin_maplayer, 1);
-  TR_METHOD_NOARG(mrb, krn, "camera_x"    , tr_camera_x);
-  TR_METHOD_NOARG(mrb, krn, "camera_y"    , tr_camera_y);
-  TR_METHOD_NOARG(mrb, krn, "camera_w"    , tr_camera_w);
-  TR_METHOD_NOARG(mrb, krn, "camera_h"    , tr_camera_h);
-  TR_METHOD_NOARG(mrb, krn, "camera_alpha", tr_camera_alpha);
-  TR_METHOD_NOARG(mrb, krn, "camera_theta", tr_camera_theta);
-  TR_METHOD_NOARG(mrb, krn, "camera_fov"  , tr_camera_fov);
-
-  
- 
-  TR_CLASS_METHOD_NOARG(mrb, cam, "x"    , tr_camera_x);
-  TR_CLASS_METHOD_NOARG(mrb, cam, "y"    , tr_camera_y);
-  TR_CLASS_METHOD_NOARG(mrb, cam, "z"    , tr_camera_z);
-  TR_CLASS_METHOD_NOARG(mrb, cam, "w"    , tr_camera_w);
-  TR_CLASS_METHOD_NOARG(mrb, cam, "h"    , tr_camera_h);
-  TR_CLASS_METHOD_NOARG(mrb, cam, "alpha", tr_camera_alpha);
-  TR_CLASS_METHOD_NOARG(mrb, cam, "theta", tr_camera_theta);
-  TR_CLASS_METHOD_NOARG(mrb, cam, "fov"  , tr_camera_fov);
-
-  TR_CLASS_METHOD_ARGC(mrb, cam, "x="    , tr_camera_x_, 1);
-  TR_CLASS_METHOD_ARGC(mrb, cam, "y="    , tr_camera_y_, 1);
-  TR_CLASS_METHOD_ARGC(mrb, cam, "z="    , tr_camera_z_, 1);
-  TR_CLASS_METHOD_ARGC(mrb, cam, "alpha=", tr_camera_alpha_, 1);
-  TR_CLASS_METHOD_ARGC(mrb, cam, "theta=", tr_camera_theta_, 1);
-  TR_CLASS_METHOD_ARGC(mrb, cam, "fov="  , tr_camera_fov_, 1);
-
+  toruby_bind_kernel(mrb, krn);
+  toruby_bind_camera(mrb, cam);
 
   sky = mrb_define_module_under(mrb, eru, "Sky");
-  TR_CLASS_METHOD_ARGC(mrb, sky, "set_texture", tr_skybox_set_texture, 2);
-  TR_CLASS_METHOD_ARGC(mrb, sky, "set_rgb"  , tr_skybox_set_rgb, 5);
+  toruby_bind_sky(mrb, sky);
+
+  tsk = mrb_define_module_under(mrb, eru, "Task");
+  toruby_bind_task(mrb, tsk);
+  TR_CLASS_METHOD_NOARG(mrb, tsk, "stats", tr_task_stats);
+  TR_CLASS_METHOD_NOARG(mrb, tsk, "frame_stats", tr_task_frame_stats);
   
   TR_CONST_INT_EASY(mrb, sky, SKYBOX_, DIRECTION_UP);
   TR_CONST_INT_EASY(mrb, sky, SKYBOX_, DIRECTION_DOWN);
@@ -502,21 +683,38 @@ int tr_init(mrb_state * mrb) {
   */ 
    
   
-  TR_CLASS_METHOD_NOARG(mrb, eru, "show_fps", tr_show_fps);
-  TR_CLASS_METHOD_NOARG(mrb, eru, "show_area", tr_show_area);
-  TR_CLASS_METHOD_NOARG(mrb, eru, "show_graph", tr_show_graph);
-  TR_CLASS_METHOD_ARGC(mrb, eru, "show_fps="  , tr_show_fps_, 1);
-  TR_CLASS_METHOD_ARGC(mrb, eru, "show_area=" , tr_show_area_, 1);
-  TR_CLASS_METHOD_ARGC(mrb, eru, "show_graph=", tr_show_graph_, 1);
-  TR_CLASS_METHOD_ARGC(mrb, eru, "show_mouse_cursor=", tr_show_mouse_cursor_, 1);
-  
-  
-  TR_CLASS_METHOD_NOARG(mrb, eru, "time", tr_get_time);
+  toruby_bind(mrb, eru);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "callback_stats", tr_callback_stats);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "callback_stats_reset", 
+                        tr_callback_stats_reset);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "coalesce_events", tr_coalesce_events);
+  TR_CLASS_METHOD_ARGC(mrb, eru, "coalesce_events=", tr_coalesce_events_, 1);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "event_stats", tr_event_stats);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "script_cache_stats", 
+                        tr_script_cache_stats);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "loaded_scripts", tr_loaded_scripts);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "gc_stats", tr_gc_stats);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "gc_stats_reset", tr_gc_stats_reset);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "alloc_stats", tr_alloc_stats);
+  TR_CLASS_METHOD_ARGC(mrb, eru, "gc_configure", tr_gc_configure, 2);
+  TR_CLASS_METHOD_ARGC(mrb, eru, "gc_idle_budget", tr_gc_idle_budget, 2);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "gc_full", tr_gc_full);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "gc_full_later", tr_gc_full_later);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "watch_scripts", tr_watch_scripts);
+  TR_CLASS_METHOD_ARGC(mrb, eru, "watch_scripts=", tr_watch_scripts_, 1);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "profile", tr_profile);
+  TR_CLASS_METHOD_ARGC(mrb, eru, "profile=", tr_profile_, 1);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "profile_interval", tr_profile_interval);
+  TR_CLASS_METHOD_ARGC(mrb, eru, "profile_interval=", tr_profile_interval_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, eru, "profile_report", tr_profile_report, 1);
+  TR_CLASS_METHOD_ARGC(mrb, eru, "profile_dump", tr_profile_dump, 1);
+  TR_CLASS_METHOD_NOARG(mrb, eru, "profile_reset", tr_profile_reset);
   
 
   
   /* Set up submodules. */
   tr_sprite_init(mrb, eru);
+  tr_thing_init(mrb, eru);
   tr_store_init(mrb, eru);
   tr_graph_init(mrb, eru);
   tr_audio_init(mrb, eru);
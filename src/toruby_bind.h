@@ -0,0 +1,381 @@
+/*
+ * Generated by bin/trgen from toruby.bind, don't edit.
+ */
+#ifndef toruby_bind_h_INCLUDED
+#define toruby_bind_h_INCLUDED
+
+#include "tr_bind.h"
+
+/* global_state_show_fps() -> bool */
+static mrb_value tr_bind_global_state_show_fps(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return rh_bool_value(global_state_show_fps());
+}
+
+/* global_state_show_area() -> bool */
+static mrb_value tr_bind_global_state_show_area(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return rh_bool_value(global_state_show_area());
+}
+
+/* global_state_show_graph() -> bool */
+static mrb_value tr_bind_global_state_show_graph(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return rh_bool_value(global_state_show_graph());
+}
+
+/* global_state_show_fps_(bool) -> bool */
+static mrb_value tr_bind_global_state_show_fps_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(global_state_show_fps_(TR_BIND_BOOL(mrb, argv[0])));
+}
+
+/* global_state_show_area_(bool) -> bool */
+static mrb_value tr_bind_global_state_show_area_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(global_state_show_area_(TR_BIND_BOOL(mrb, argv[0])));
+}
+
+/* global_state_show_graph_(bool) -> bool */
+static mrb_value tr_bind_global_state_show_graph_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(global_state_show_graph_(TR_BIND_BOOL(mrb, argv[0])));
+}
+
+/* scegra_show_system_mouse_cursor(bool) -> bool */
+static mrb_value tr_bind_scegra_show_system_mouse_cursor(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(scegra_show_system_mouse_cursor(TR_BIND_BOOL(mrb, argv[0])));
+}
+
+/* al_get_time() -> float */
+static mrb_value tr_bind_al_get_time(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, al_get_time());
+}
+
+/* camera_at_x() -> float */
+static mrb_value tr_bind_camera_at_x(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, camera_at_x(state_camera(state_get())));
+}
+
+/* camera_at_y() -> float */
+static mrb_value tr_bind_camera_at_y(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, camera_at_y(state_camera(state_get())));
+}
+
+/* camera_w() -> int */
+static mrb_value tr_bind_camera_w(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(camera_w(state_camera(state_get())));
+}
+
+/* camera_h() -> int */
+static mrb_value tr_bind_camera_h(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(camera_h(state_camera(state_get())));
+}
+
+/* camera_alpha() -> float */
+static mrb_value tr_bind_camera_alpha(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, camera_alpha(state_camera(state_get())));
+}
+
+/* camera_theta() -> float */
+static mrb_value tr_bind_camera_theta(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, camera_theta(state_camera(state_get())));
+}
+
+/* camera_fov() -> float */
+static mrb_value tr_bind_camera_fov(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, camera_fov(state_camera(state_get())));
+}
+
+/* camera_at_z() -> float */
+static mrb_value tr_bind_camera_at_z(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, camera_at_z(state_camera(state_get())));
+}
+
+/* camera_at_x_(float) -> float */
+static mrb_value tr_bind_camera_at_x_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, camera_at_x_(state_camera(state_get()), TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* camera_at_y_(float) -> float */
+static mrb_value tr_bind_camera_at_y_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, camera_at_y_(state_camera(state_get()), TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* camera_at_z_(float) -> float */
+static mrb_value tr_bind_camera_at_z_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, camera_at_z_(state_camera(state_get()), TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* camera_alpha_(float) -> float */
+static mrb_value tr_bind_camera_alpha_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, camera_alpha_(state_camera(state_get()), TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* camera_theta_(float) -> float */
+static mrb_value tr_bind_camera_theta_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, camera_theta_(state_camera(state_get()), TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* camera_fov_(float) -> float */
+static mrb_value tr_bind_camera_fov_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, camera_fov_(state_camera(state_get()), TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* skybox_set_texture(int, int) -> int */
+static mrb_value tr_bind_skybox_set_texture(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(skybox_set_texture(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* skybox_set_rgb(int, int, int, int, int) -> int */
+static mrb_value tr_bind_skybox_set_rgb(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 5) return tr_bind_arity_error(mrb, argc, 5);
+  return mrb_fixnum_value(skybox_set_rgb(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3]), TR_BIND_INT(mrb, argv[4])));
+}
+
+/* rhtask_add(string) -> int */
+static mrb_value tr_bind_rhtask_add(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(rhtask_add(TR_BIND_STRING(mrb, argv[0])));
+}
+
+/* rhtask_remove(int) -> int */
+static mrb_value tr_bind_rhtask_remove(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(rhtask_remove(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* rhtask_count() -> int */
+static mrb_value tr_bind_rhtask_count(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(rhtask_count());
+}
+
+/* rhtask_budget() -> float */
+static mrb_value tr_bind_rhtask_budget(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, rhtask_budget());
+}
+
+/* rhtask_budget_(float) -> float */
+static mrb_value tr_bind_rhtask_budget_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, rhtask_budget_(TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* rhtask_time_left() -> float */
+static mrb_value tr_bind_rhtask_time_left(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, rhtask_time_left());
+}
+
+/* Defines the class methods of Eruta on klass. */
+static void toruby_bind(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_NOARG(mrb, klass, "show_fps"              , tr_bind_global_state_show_fps);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "show_area"             , tr_bind_global_state_show_area);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "show_graph"            , tr_bind_global_state_show_graph);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "show_fps="             , tr_bind_global_state_show_fps_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "show_area="            , tr_bind_global_state_show_area_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "show_graph="           , tr_bind_global_state_show_graph_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "show_mouse_cursor="    , tr_bind_scegra_show_system_mouse_cursor, 1);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "time"                  , tr_bind_al_get_time);
+}
+
+/* Defines the instance methods of Kernel on klass. */
+static void toruby_bind_kernel(mrb_state * mrb, struct RClass * klass) {
+  TR_METHOD_NOARG(mrb, klass, "camera_x"              , tr_bind_camera_at_x);
+  TR_METHOD_NOARG(mrb, klass, "camera_y"              , tr_bind_camera_at_y);
+  TR_METHOD_NOARG(mrb, klass, "camera_w"              , tr_bind_camera_w);
+  TR_METHOD_NOARG(mrb, klass, "camera_h"              , tr_bind_camera_h);
+  TR_METHOD_NOARG(mrb, klass, "camera_alpha"          , tr_bind_camera_alpha);
+  TR_METHOD_NOARG(mrb, klass, "camera_theta"          , tr_bind_camera_theta);
+  TR_METHOD_NOARG(mrb, klass, "camera_fov"            , tr_bind_camera_fov);
+}
+
+/* Defines the class methods of Eruta::Camera on klass. */
+static void toruby_bind_camera(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_NOARG(mrb, klass, "x"                     , tr_bind_camera_at_x);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "y"                     , tr_bind_camera_at_y);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "z"                     , tr_bind_camera_at_z);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "w"                     , tr_bind_camera_w);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "h"                     , tr_bind_camera_h);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "alpha"                 , tr_bind_camera_alpha);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "theta"                 , tr_bind_camera_theta);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "fov"                   , tr_bind_camera_fov);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "x="                    , tr_bind_camera_at_x_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "y="                    , tr_bind_camera_at_y_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "z="                    , tr_bind_camera_at_z_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "alpha="                , tr_bind_camera_alpha_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "theta="                , tr_bind_camera_theta_, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "fov="                  , tr_bind_camera_fov_, 1);
+}
+
+/* Defines the class methods of Eruta::Sky on klass. */
+static void toruby_bind_sky(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_ARGC(mrb, klass, "set_texture"           , tr_bind_skybox_set_texture, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "set_rgb"               , tr_bind_skybox_set_rgb, 5);
+}
+
+/* Defines the class methods of Eruta::Task on klass. */
+static void toruby_bind_task(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_ARGC(mrb, klass, "add"                   , tr_bind_rhtask_add, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "remove"                , tr_bind_rhtask_remove, 1);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "count"                 , tr_bind_rhtask_count);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "budget"                , tr_bind_rhtask_budget);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "budget="               , tr_bind_rhtask_budget_, 1);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "time_left"             , tr_bind_rhtask_time_left);
+}
+
+#endif
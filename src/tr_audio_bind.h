@@ -0,0 +1,105 @@
+/*
+ * Generated by bin/trgen from tr_audio.bind, don't edit.
+ */
+#ifndef tr_audio_bind_h_INCLUDED
+#define tr_audio_bind_h_INCLUDED
+
+#include "tr_bind.h"
+
+/* audio_playing_samples_max() -> int */
+static mrb_value tr_bind_audio_playing_samples_max(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(audio_playing_samples_max());
+}
+
+/* audio_play_sound_ex(int, float, float, float, bool) -> int */
+static mrb_value tr_bind_audio_play_sound_ex(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 5) return tr_bind_arity_error(mrb, argc, 5);
+  return mrb_fixnum_value(audio_play_sound_ex(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1]), TR_BIND_FLOAT(mrb, argv[2]), TR_BIND_FLOAT(mrb, argv[3]), TR_BIND_BOOL(mrb, argv[4])));
+}
+
+/* audio_play_sound(int) -> int */
+static mrb_value tr_bind_audio_play_sound(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(audio_play_sound(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* audio_stop_sound(int) -> bool */
+static mrb_value tr_bind_audio_stop_sound(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(audio_stop_sound(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* audio_set_music(int) -> bool */
+static mrb_value tr_bind_audio_set_music(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(audio_set_music(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* audio_play_music() -> bool */
+static mrb_value tr_bind_audio_play_music(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return rh_bool_value(audio_play_music());
+}
+
+/* audio_stop_music() -> bool */
+static mrb_value tr_bind_audio_stop_music(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return rh_bool_value(audio_stop_music());
+}
+
+/* audio_music_playing_p() -> bool */
+static mrb_value tr_bind_audio_music_playing_p(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return rh_bool_value(audio_music_playing_p());
+}
+
+/* Defines the class methods of Eruta::Audio on klass. */
+static void tr_audio_bind(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_NOARG(mrb, klass, "playing_sounds_max"    , tr_bind_audio_playing_samples_max);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "play_sound_ex"         , tr_bind_audio_play_sound_ex, 5);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "play_sound"            , tr_bind_audio_play_sound, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "stop_sound"            , tr_bind_audio_stop_sound, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "music_id="             , tr_bind_audio_set_music, 1);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "play_music"            , tr_bind_audio_play_music);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "stop_music"            , tr_bind_audio_stop_music);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "music_playing?"        , tr_bind_audio_music_playing_p);
+}
+
+#endif
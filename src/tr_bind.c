@@ -0,0 +1,69 @@
+/*
+* tr_bind.c has the slow paths of the argument conversions of the bindings
+* generated by bin/trgen. See include/tr_bind.h.
+*/
+
+#include "eruta.h"
+#include "tr_bind.h"
+#include <mruby/string.h>
+
+/** Converts a float argument to an integer, by truncating it like
+ * mrb_get_args does. Raises a TypeError for anything that isn't a number,
+ * and a RangeError if the float doesn't fit. */
+mrb_int tr_bind_int(mrb_state * mrb, mrb_value value) {
+  mrb_float number;
+  if (mrb_fixnum_p(value)) return mrb_fixnum(value);
+  if (!mrb_float_p(value)) {
+    mrb_raise(mrb, E_TYPE_ERROR, "expected Integer");
+  }
+  number = mrb_float(value);
+  if ((number < (mrb_float) MRB_INT_MIN) || (number > (mrb_float) MRB_INT_MAX)
+      || (number != number)) {
+    mrb_raise(mrb, E_RANGE_ERROR, "float out of range of integer");
+  }
+  return (mrb_int) number;
+}
+
+/** Converts an integer argument to a float. Raises a TypeError for anything
+ * that isn't a number. */
+mrb_float tr_bind_float(mrb_state * mrb, mrb_value value) {
+  if (mrb_float_p(value))  return mrb_float(value);
+  if (mrb_fixnum_p(value)) return (mrb_float) mrb_fixnum(value);
+  mrb_raise(mrb, E_TYPE_ERROR, "expected Float");
+  return 0.0;
+}
+
+/** Returns the nul terminated contents of a string argument. Raises a
+ * TypeError for anything that isn't a string. */
+const char * tr_bind_string(mrb_state * mrb, mrb_value value) {
+  if (!mrb_string_p(value)) {
+    mrb_raise(mrb, E_TYPE_ERROR, "expected String");
+  }
+  return mrb_string_value_cstr(mrb, &value);
+}
+
+/** Raises an ArgumentError for a call with argc arguments in stead of
+ * expected. Never returns, but has a return type so the generated code can
+ * return its result. */
+mrb_value tr_bind_arity_error(mrb_state * mrb, mrb_int argc, int expected) {
+  mrb_raisef(mrb, E_ARGUMENT_ERROR, "wrong number of arguments (%S for %S)",
+             mrb_fixnum_value(argc), mrb_fixnum_value(expected));
+  return mrb_nil_value();
+}
+
+/** Checks the argument of a batch call, which must be a flat array of the
+ * arguments of stride calls after each other. Returns its length, raises an
+ * ArgumentError if it isn't such an array. */
+mrb_int tr_bind_batch_size(mrb_state * mrb, mrb_value list, int stride) {
+  mrb_int size;
+  if (!mrb_array_p(list)) {
+    mrb_raise(mrb, E_ARGUMENT_ERROR, "expected Array");
+  }
+  size = RARRAY_LEN(list);
+  if ((size % stride) != 0) {
+    mrb_raisef(mrb, E_ARGUMENT_ERROR,
+               "batch of %S values is not a multiple of %S",
+               mrb_fixnum_value(size), mrb_fixnum_value(stride));
+  }
+  return size;
+}
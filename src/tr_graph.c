@@ -7,6 +7,7 @@
 #include "fifi.h"
 #include "store.h"
 #include "scegra.h"
+#include "tween.h"
 #include "sound.h"
 #include <mruby/hash.h>
 #include <mruby/class.h>
@@ -14,33 +15,9 @@
 #include <mruby/array.h>
 #include "tr_macro.h"
 #include "tr_graph.h"
+#include "tr_graph_bind.h"
 
 
-TORUBY_0_ICALLER(tr_scegra_nodes_max, scegra_nodes_max)
-
-SCEGRA_ICALLER(tr_scegra_z, scegra_z)
-SCEGRA_ICALLER(tr_scegra_disable_node, scegra_disable_node)
-SCEGRA_ICALLER(tr_scegra_get_id, scegra_get_id)
-SCEGRA_ICALLER(tr_scegra_out_of_bounds, scegra_out_of_bounds)
-
-SCEGRA_ISETTER(tr_scegra_z_, scegra_z_)
-SCEGRA_ISETTER(tr_scegra_visible_, scegra_visible_)
-SCEGRA_ISETTER(tr_scegra_image_id_, scegra_image_id_)
-SCEGRA_ISETTER(tr_scegra_font_id_, scegra_font_id_)
-SCEGRA_ISETTER(tr_scegra_background_image_id_, scegra_background_image_id_)
-SCEGRA_ISETTER(tr_scegra_border_thickness_, scegra_border_thickness_)
-SCEGRA_ISETTER(tr_scegra_margin_, scegra_margin_)
-
-SCEGRA_PSETTER(tr_scegra_speed_, scegra_speed_)
-SCEGRA_PSETTER(tr_scegra_size_ , scegra_size_)
-SCEGRA_PSETTER(tr_scegra_position_, scegra_position_)
-  
-SCEGRA_CSETTER(tr_scegra_background_color_, scegra_background_color_)
-SCEGRA_CSETTER(tr_scegra_border_color_, scegra_border_color_)
-SCEGRA_CSETTER(tr_scegra_color_, scegra_color_)
-  
-SCEGRA_FSETTER(tr_scegra_angle_, scegra_angle_)
-
 static mrb_value tr_scegra_make_box(mrb_state * mrb, mrb_value self) {
   mrb_int id            = -1, sindex = -1;
   mrb_int x             =  0, y      =  0;
@@ -88,32 +65,110 @@ static mrb_value tr_scegra_make_image(mrb_state * mrb, mrb_value self) {
 
 
 
-TR_WRAP_II_INT(tr_scegra_image_flags_ ,  scegra_image_flags_)
-TR_WRAP_II_INT(tr_scegra_text_flags_  ,  scegra_text_flags_)
-TR_WRAP_IZ_INT(tr_scegra_text_        ,  scegra_text_)
+/* Helper that converts a ruby number to a float. */
+static float tr_graph_tofloat(mrb_state * mrb, mrb_value value) {
+  if (mrb_fixnum_p(value)) return mrb_fixnum(value);
+  if (mrb_float_p(value))  return mrb_float(value);
+  (void) mrb;
+  return 0.0;
+}
 
-SCEGRA_ISETTER(tr_scegra_line_stop_   , scegra_line_stop_)
-SCEGRA_ISETTER(tr_scegra_line_start_  , scegra_line_start_)
-SCEGRA_FSETTER(tr_scegra_delay_       , scegra_delay_)
+/* Applies many changes to the scene graph in one call. Changes is either 
+ * an array of [id, prop, v1, v2, v3, v4] arrays, where the values after prop
+ * are optional, or a string of packed changes. Returns the amount of 
+ * changes applied. */
+static mrb_value tr_scegra_apply(mrb_state * mrb, mrb_value self) {
+  mrb_value     changes;
+  ScegraChange  buffer[64];
+  int           index, size, used = 0, applied = 0;
+  (void) self;
 
-SCEGRA_ICALLER(tr_scegra_line_stop     , scegra_line_stop)
-SCEGRA_ICALLER(tr_scegra_line_start    , scegra_line_start)
-SCEGRA_FCALLER(tr_scegra_delay         , scegra_delay)
+  mrb_get_args(mrb, "o", &changes);
+  if (mrb_string_p(changes)) {
+    applied = scegra_apply_packed(RSTRING_PTR(changes), RSTRING_LEN(changes));
+    return mrb_fixnum_value(applied);
+  }
+  if (!mrb_array_p(changes)) return mrb_fixnum_value(-3);
+
+  size = RARRAY_LEN(changes);
+  /* Convert in chunks on the stack to avoid allocating. */
+  for (index = 0; index < size; index++) {
+    mrb_value      item   = mrb_ary_ref(mrb, changes, index);
+    ScegraChange * change = buffer + used;
+    int            length, value;
+    if (!mrb_array_p(item)) continue;
+    length = RARRAY_LEN(item);
+    if (length < 2) continue;
+    change->id   = tr_graph_tofloat(mrb, mrb_ary_ref(mrb, item, 0));
+    change->prop = tr_graph_tofloat(mrb, mrb_ary_ref(mrb, item, 1));
+    for (value = 0; value < SCEGRA_PROP_VALUES_MAX; value++) {
+      change->values[value] = ((value + 2) < length) ?
+        tr_graph_tofloat(mrb, mrb_ary_ref(mrb, item, value + 2)) : 0.0;
+    }
+    used++;
+    if (used >= 64) {
+      applied += scegra_apply_changes(buffer, used);
+      used     = 0;
+    }
+  }
+  applied += scegra_apply_changes(buffer, used);
+  return mrb_fixnum_value(applied);
+}
 
-TR_PAIR_DO(SCEGRA_ISETTER, scegra_page_lines_)
-TR_PAIR_DO(SCEGRA_ICALLER, scegra_page_lines)
-TR_PAIR_DO(SCEGRA_BSETTER, scegra_paused_)
+/* Makes amount copies of a template node, at id's of at least minimum,
+ * each one offset by dx, dy from the previous one. Returns an array with 
+ * the id's of the new nodes. */
+static mrb_value tr_scegra_make_from_template(mrb_state * mrb, mrb_value self) {
+  mrb_int   template_id = -1, minimum = 0, amount = 0;
+  mrb_float dx = 0.0, dy = 0.0;
+  mrb_value result;
+  int     * ids;
+  int       made, index;
+  (void) self;
 
-TR_PAIR_DO(SCEGRA_BCALLER, scegra_paused)
-TR_PAIR_DO(SCEGRA_BCALLER, scegra_at_end)
-TR_PAIR_DO(SCEGRA_ISETTER, scegra_page_)
-TR_PAIR_DO(SCEGRA_ICALLER, scegra_page)
-TR_PAIR_DO(SCEGRA_ICALLER, scegra_last_page)
-TR_PAIR_DO(TR_WRAP_I_INT, scegra_next_page)
-TR_PAIR_DO(TR_WRAP_I_INT, scegra_previous_page)
+  mrb_get_args(mrb, "iiiff", &template_id, &minimum, &amount, &dx, &dy);
+  if (amount <= 0) return mrb_ary_new(mrb);
+  ids  = calloc(amount, sizeof(int));
+  if (!ids) return mrb_nil_value();
+  made = scegra_make_from_template(template_id, minimum, amount, dx, dy, ids);
+  result = mrb_ary_new_capa(mrb, made > 0 ? made : 0);
+  for (index = 0; index < made; index++) {
+    mrb_ary_push(mrb, result, mrb_fixnum_value(ids[index]));
+  }
+  free(ids);
+  return result;
+}
 
+/* Returns the id of the topmost visible node at x, y, or nil if none. */
+static mrb_value tr_scegra_pick(mrb_state * mrb, mrb_value self) {
+  mrb_float x = 0.0, y = 0.0;
+  int       id;
+  (void) self;
+  mrb_get_args(mrb, "ff", &x, &y);
+  id = scegra_pick(x, y);
+  if (id < 0) return mrb_nil_value();
+  return mrb_fixnum_value(id);
+}
 
 
+/* Starts a tween of a property of a scene graph node. 
+ * Ruby signature: tween(id, prop, duration, delay, ease, loop, loops, notify,
+ * v1, v2 = 0, v3 = 0, v4 = 0). */
+static mrb_value tr_tween_start(mrb_state * mrb, mrb_value self) {
+  mrb_int   id = -1, prop = 0, ease = 0, loop = 0, loops = 0;
+  mrb_float duration = 0.0, delay = 0.0;
+  mrb_float v1 = 0.0, v2 = 0.0, v3 = 0.0, v4 = 0.0;
+  mrb_value notify;
+  float     to[SCEGRA_PROP_VALUES_MAX];
+  (void) self;
+
+  mrb_get_args(mrb, "iiffiiiof|fff", &id, &prop, &duration, &delay, 
+               &ease, &loop, &loops, &notify, &v1, &v2, &v3, &v4);
+  to[0] = v1; to[1] = v2; to[2] = v3; to[3] = v4;
+  return mrb_fixnum_value(tween_start(id, prop, to, duration, delay, 
+                          ease, loop, loops, rh_tobool(notify)));
+}
+
 /** Initialize mruby bindings to 2D scene graph functionality.
  * Eru is the parent module, which is normally named "Eruta" on the
  * ruby side. */
@@ -122,56 +177,59 @@ int tr_graph_init(mrb_state * mrb, struct RClass * eru) {
   /* graph class/module and class/module methods. */
   gra = mrb_define_class_under(mrb, eru, "Graph" , mrb->object_class);
 
-  TR_CLASS_METHOD_ARGC(mrb, gra, "nodes_max"       , tr_scegra_nodes_max, 0);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "z"               , tr_scegra_z, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "disable"         , tr_scegra_disable_node, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "id"              , tr_scegra_get_id, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "out_of_bounds?"  , tr_scegra_out_of_bounds, 1);
-  
-  TR_CLASS_METHOD_ARGC(mrb, gra, "z_"               , tr_scegra_z_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "visible_"         , tr_scegra_visible_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "image_"           , tr_scegra_image_id_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "font_"            , tr_scegra_font_id_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "background_image_", tr_scegra_background_image_id_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "border_thickness_", tr_scegra_border_thickness_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "margin_"          , tr_scegra_margin_, 2);
-  /*TR_CLASS_METHOD_ARGC(mrb, gra, "speed"          , tr_scegra_speed, 1);*/
-  TR_CLASS_METHOD_ARGC(mrb, gra, "size_"            , tr_scegra_size_, 3);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "position_"        , tr_scegra_position_, 3);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "speed_"           , tr_scegra_speed_, 3);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "text_"            , tr_scegra_text_, 2); 
+  tr_graph_bind(mrb, gra);
 
-  
-  TR_CLASS_METHOD_ARGC(mrb, gra, "image_flags_"     , tr_scegra_image_flags_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "text_flags_"      , tr_scegra_text_flags_ , 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "angle_"           , tr_scegra_angle_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "background_color_", tr_scegra_background_color_, 4);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "border_color_"    , tr_scegra_border_color_, 4);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "color_"           , tr_scegra_color_       , 4);
   TR_CLASS_METHOD_ARGC(mrb, gra, "make_box"         , tr_scegra_make_box,  8); 
   TR_CLASS_METHOD_ARGC(mrb, gra, "make_image"       , tr_scegra_make_image, 5); 
   TR_CLASS_METHOD_ARGC(mrb, gra, "make_text"        , tr_scegra_make_text, 5); 
   TR_CLASS_METHOD_ARGC(mrb, gra, "make_longtext"    , tr_scegra_make_longtext, 7);
 
-  TR_CLASS_METHOD_ARGC(mrb, gra, "line_stop_" , tr_scegra_line_stop_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "line_start_", tr_scegra_line_start_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "delay_"     , tr_scegra_delay_, 2);
-
-  TR_CLASS_METHOD_ARGC(mrb, gra, "line_stop"  , tr_scegra_line_stop, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "line_start" , tr_scegra_line_start, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "delay"      , tr_scegra_delay, 1);
-
-  /* Long text paging. */ 
-  TR_CLASS_METHOD_ARGC(mrb, gra, "page_lines_", tr_scegra_page_lines_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "page_lines" , tr_scegra_page_lines, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "paused_"    , tr_scegra_paused_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "paused"     , tr_scegra_paused, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "page_"      , tr_scegra_page_, 2);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "page"       , tr_scegra_page, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "last_page"  , tr_scegra_page, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "next_page"  , tr_scegra_next_page, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "previous_page", tr_scegra_previous_page, 1);
-  TR_CLASS_METHOD_ARGC(mrb, gra, "at_end_p"   ,   tr_scegra_at_end, 1);
+  TR_CLASS_METHOD_ARGC(mrb, gra, "pick"        , tr_scegra_pick, 2);
+
+  /* Bulk changes. */
+  TR_CLASS_METHOD_ARGC(mrb, gra, "apply"       , tr_scegra_apply, 1);
+  TR_CLASS_METHOD_ARGC(mrb, gra, "make_from_template", tr_scegra_make_from_template, 5);
+
+  /* Tweening of node properties. */
+  TR_CLASS_METHOD_OPTARG(mrb, gra, "tween"     , tr_tween_start, 9, 3);
+
+  TR_CONST_INT(mrb, gra, "PROP_POSITION"        , SCEGRA_PROP_POSITION);
+  TR_CONST_INT(mrb, gra, "PROP_SIZE"            , SCEGRA_PROP_SIZE);
+  TR_CONST_INT(mrb, gra, "PROP_SPEED"           , SCEGRA_PROP_SPEED);
+  TR_CONST_INT(mrb, gra, "PROP_COLOR"           , SCEGRA_PROP_COLOR);
+  TR_CONST_INT(mrb, gra, "PROP_BACKGROUND_COLOR", SCEGRA_PROP_BACKGROUND_COLOR);
+  TR_CONST_INT(mrb, gra, "PROP_BORDER_COLOR"    , SCEGRA_PROP_BORDER_COLOR);
+  TR_CONST_INT(mrb, gra, "PROP_BORDER_THICKNESS", SCEGRA_PROP_BORDER_THICKNESS);
+  TR_CONST_INT(mrb, gra, "PROP_MARGIN"          , SCEGRA_PROP_MARGIN);
+  TR_CONST_INT(mrb, gra, "PROP_ANGLE"           , SCEGRA_PROP_ANGLE);
+  TR_CONST_INT(mrb, gra, "PROP_Z"               , SCEGRA_PROP_Z);
+  TR_CONST_INT(mrb, gra, "PROP_VISIBLE"         , SCEGRA_PROP_VISIBLE);
+  TR_CONST_INT(mrb, gra, "PROP_FONT_ID"         , SCEGRA_PROP_FONT_ID);
+  TR_CONST_INT(mrb, gra, "PROP_IMAGE_ID"        , SCEGRA_PROP_IMAGE_ID);
+  TR_CONST_INT(mrb, gra, "PROP_BACKGROUND_IMAGE_ID", SCEGRA_PROP_BACKGROUND_IMAGE_ID);
+  TR_CONST_INT(mrb, gra, "PROP_TEXT_FLAGS"      , SCEGRA_PROP_TEXT_FLAGS);
+  TR_CONST_INT(mrb, gra, "PROP_IMAGE_FLAGS"     , SCEGRA_PROP_IMAGE_FLAGS);
+  TR_CONST_INT(mrb, gra, "CHANGE_PACKED_SIZE"   , SCEGRA_CHANGE_PACKED_SIZE);
+
+  TR_CONST_INT(mrb, gra, "EASE_LINEAR"          , TWEEN_EASE_LINEAR);
+  TR_CONST_INT(mrb, gra, "EASE_QUAD_IN"         , TWEEN_EASE_QUAD_IN);
+  TR_CONST_INT(mrb, gra, "EASE_QUAD_OUT"        , TWEEN_EASE_QUAD_OUT);
+  TR_CONST_INT(mrb, gra, "EASE_QUAD_INOUT"      , TWEEN_EASE_QUAD_INOUT);
+  TR_CONST_INT(mrb, gra, "EASE_CUBIC_IN"        , TWEEN_EASE_CUBIC_IN);
+  TR_CONST_INT(mrb, gra, "EASE_CUBIC_OUT"       , TWEEN_EASE_CUBIC_OUT);
+  TR_CONST_INT(mrb, gra, "EASE_CUBIC_INOUT"     , TWEEN_EASE_CUBIC_INOUT);
+  TR_CONST_INT(mrb, gra, "EASE_SINE_IN"         , TWEEN_EASE_SINE_IN);
+  TR_CONST_INT(mrb, gra, "EASE_SINE_OUT"        , TWEEN_EASE_SINE_OUT);
+  TR_CONST_INT(mrb, gra, "EASE_SINE_INOUT"      , TWEEN_EASE_SINE_INOUT);
+  TR_CONST_INT(mrb, gra, "EASE_BACK_OUT"        , TWEEN_EASE_BACK_OUT);
+  TR_CONST_INT(mrb, gra, "EASE_ELASTIC_OUT"     , TWEEN_EASE_ELASTIC_OUT);
+  TR_CONST_INT(mrb, gra, "EASE_BOUNCE_OUT"      , TWEEN_EASE_BOUNCE_OUT);
+
+  TR_CONST_INT(mrb, gra, "LOOP_NONE"            , TWEEN_LOOP_NONE);
+  TR_CONST_INT(mrb, gra, "LOOP_REPEAT"          , TWEEN_LOOP_REPEAT);
+  TR_CONST_INT(mrb, gra, "LOOP_PINGPONG"        , TWEEN_LOOP_PINGPONG);
+  TR_CONST_INT(mrb, gra, "TWEEN_DONE"           , TWEEN_EVENT_DONE);
+  TR_CONST_INT(mrb, gra, "TWEEN_LOOP"           , TWEEN_EVENT_LOOP);
   
   return 0;
 }
@@ -0,0 +1,600 @@
+/*
+ * Generated by bin/trgen from tr_graph.bind, don't edit.
+ */
+#ifndef tr_graph_bind_h_INCLUDED
+#define tr_graph_bind_h_INCLUDED
+
+#include "tr_bind.h"
+
+/* scegra_nodes_max() -> int */
+static mrb_value tr_bind_scegra_nodes_max(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(scegra_nodes_max());
+}
+
+/* scegra_z(int) -> int */
+static mrb_value tr_bind_scegra_z(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_z(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_disable_node(int) -> int */
+static mrb_value tr_bind_scegra_disable_node(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_disable_node(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_get_id(int) -> int */
+static mrb_value tr_bind_scegra_get_id(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_get_id(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_out_of_bounds(int) -> int */
+static mrb_value tr_bind_scegra_out_of_bounds(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_out_of_bounds(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_z_(int, int) -> int */
+static mrb_value tr_bind_scegra_z_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_z_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_z_ for each 2 values of a flat array -> calls */
+static mrb_value tr_bind_scegra_z__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 2);
+  for (index = 0; index < size; index += 2) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    scegra_z_(TR_BIND_INT(mrb, item[0]), TR_BIND_INT(mrb, item[1]));
+  }
+  return mrb_fixnum_value(size / 2);
+}
+
+/* scegra_visible_(int, int) -> int */
+static mrb_value tr_bind_scegra_visible_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_visible_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_visible_ for each 2 values of a flat array -> calls */
+static mrb_value tr_bind_scegra_visible__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 2);
+  for (index = 0; index < size; index += 2) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    scegra_visible_(TR_BIND_INT(mrb, item[0]), TR_BIND_INT(mrb, item[1]));
+  }
+  return mrb_fixnum_value(size / 2);
+}
+
+/* scegra_image_id_(int, int) -> int */
+static mrb_value tr_bind_scegra_image_id_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_image_id_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_font_id_(int, int) -> int */
+static mrb_value tr_bind_scegra_font_id_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_font_id_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_background_image_id_(int, int) -> int */
+static mrb_value tr_bind_scegra_background_image_id_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_background_image_id_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_border_thickness_(int, float) -> int */
+static mrb_value tr_bind_scegra_border_thickness_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_border_thickness_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1])));
+}
+
+/* scegra_margin_(int, float) -> int */
+static mrb_value tr_bind_scegra_margin_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_margin_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1])));
+}
+
+/* scegra_size_(int, float, float) -> int */
+static mrb_value tr_bind_scegra_size_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(scegra_size_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1]), TR_BIND_FLOAT(mrb, argv[2])));
+}
+
+/* scegra_size_ for each 3 values of a flat array -> calls */
+static mrb_value tr_bind_scegra_size__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 3);
+  for (index = 0; index < size; index += 3) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    scegra_size_(TR_BIND_INT(mrb, item[0]), TR_BIND_FLOAT(mrb, item[1]), TR_BIND_FLOAT(mrb, item[2]));
+  }
+  return mrb_fixnum_value(size / 3);
+}
+
+/* scegra_position_(int, float, float) -> int */
+static mrb_value tr_bind_scegra_position_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(scegra_position_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1]), TR_BIND_FLOAT(mrb, argv[2])));
+}
+
+/* scegra_position_ for each 3 values of a flat array -> calls */
+static mrb_value tr_bind_scegra_position__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 3);
+  for (index = 0; index < size; index += 3) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    scegra_position_(TR_BIND_INT(mrb, item[0]), TR_BIND_FLOAT(mrb, item[1]), TR_BIND_FLOAT(mrb, item[2]));
+  }
+  return mrb_fixnum_value(size / 3);
+}
+
+/* scegra_speed_(int, float, float) -> int */
+static mrb_value tr_bind_scegra_speed_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(scegra_speed_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1]), TR_BIND_FLOAT(mrb, argv[2])));
+}
+
+/* scegra_speed_ for each 3 values of a flat array -> calls */
+static mrb_value tr_bind_scegra_speed__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 3);
+  for (index = 0; index < size; index += 3) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    scegra_speed_(TR_BIND_INT(mrb, item[0]), TR_BIND_FLOAT(mrb, item[1]), TR_BIND_FLOAT(mrb, item[2]));
+  }
+  return mrb_fixnum_value(size / 3);
+}
+
+/* scegra_text_(int, string) -> int */
+static mrb_value tr_bind_scegra_text_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_text_(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1])));
+}
+
+/* scegra_image_flags_(int, int) -> int */
+static mrb_value tr_bind_scegra_image_flags_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_image_flags_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_text_flags_(int, int) -> int */
+static mrb_value tr_bind_scegra_text_flags_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_text_flags_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_angle_(int, float) -> int */
+static mrb_value tr_bind_scegra_angle_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_angle_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1])));
+}
+
+/* scegra_angle_ for each 2 values of a flat array -> calls */
+static mrb_value tr_bind_scegra_angle__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 2);
+  for (index = 0; index < size; index += 2) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    scegra_angle_(TR_BIND_INT(mrb, item[0]), TR_BIND_FLOAT(mrb, item[1]));
+  }
+  return mrb_fixnum_value(size / 2);
+}
+
+/* scegra_background_color_(int, int, int, int, int) -> int */
+static mrb_value tr_bind_scegra_background_color_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 5) return tr_bind_arity_error(mrb, argc, 5);
+  return mrb_fixnum_value(scegra_background_color_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3]), TR_BIND_INT(mrb, argv[4])));
+}
+
+/* scegra_border_color_(int, int, int, int, int) -> int */
+static mrb_value tr_bind_scegra_border_color_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 5) return tr_bind_arity_error(mrb, argc, 5);
+  return mrb_fixnum_value(scegra_border_color_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3]), TR_BIND_INT(mrb, argv[4])));
+}
+
+/* scegra_color_(int, int, int, int, int) -> int */
+static mrb_value tr_bind_scegra_color_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 5) return tr_bind_arity_error(mrb, argc, 5);
+  return mrb_fixnum_value(scegra_color_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3]), TR_BIND_INT(mrb, argv[4])));
+}
+
+/* scegra_color_ for each 5 values of a flat array -> calls */
+static mrb_value tr_bind_scegra_color__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 5);
+  for (index = 0; index < size; index += 5) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    scegra_color_(TR_BIND_INT(mrb, item[0]), TR_BIND_INT(mrb, item[1]), TR_BIND_INT(mrb, item[2]), TR_BIND_INT(mrb, item[3]), TR_BIND_INT(mrb, item[4]));
+  }
+  return mrb_fixnum_value(size / 5);
+}
+
+/* scegra_line_stop_(int, int) -> int */
+static mrb_value tr_bind_scegra_line_stop_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_line_stop_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_line_start_(int, int) -> int */
+static mrb_value tr_bind_scegra_line_start_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_line_start_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_delay_(int, float) -> int */
+static mrb_value tr_bind_scegra_delay_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_delay_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1])));
+}
+
+/* scegra_line_stop(int) -> int */
+static mrb_value tr_bind_scegra_line_stop(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_line_stop(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_line_start(int) -> int */
+static mrb_value tr_bind_scegra_line_start(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_line_start(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_delay(int) -> float */
+static mrb_value tr_bind_scegra_delay(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, scegra_delay(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_page_lines_(int, int) -> int */
+static mrb_value tr_bind_scegra_page_lines_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_page_lines_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_page_lines(int) -> int */
+static mrb_value tr_bind_scegra_page_lines(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_page_lines(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_paused_(int, bool) -> int */
+static mrb_value tr_bind_scegra_paused_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_paused_(TR_BIND_INT(mrb, argv[0]), TR_BIND_BOOL(mrb, argv[1])));
+}
+
+/* scegra_paused(int) -> bool */
+static mrb_value tr_bind_scegra_paused(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(scegra_paused(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_page_(int, int) -> int */
+static mrb_value tr_bind_scegra_page_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_page_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* scegra_page(int) -> int */
+static mrb_value tr_bind_scegra_page(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_page(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_last_page(int) -> int */
+static mrb_value tr_bind_scegra_last_page(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_last_page(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_next_page(int) -> int */
+static mrb_value tr_bind_scegra_next_page(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_next_page(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_previous_page(int) -> int */
+static mrb_value tr_bind_scegra_previous_page(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(scegra_previous_page(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_at_end(int) -> bool */
+static mrb_value tr_bind_scegra_at_end(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(scegra_at_end(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* scegra_copy_node(int, int) -> int */
+static mrb_value tr_bind_scegra_copy_node(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(scegra_copy_node(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* tween_stop(int, int) -> int */
+static mrb_value tr_bind_tween_stop(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(tween_stop(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* tween_stop_node(int) -> int */
+static mrb_value tr_bind_tween_stop_node(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(tween_stop_node(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* tween_active_p(int, int) -> bool */
+static mrb_value tr_bind_tween_active_p(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return rh_bool_value(tween_active_p(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* tween_count() -> int */
+static mrb_value tr_bind_tween_count(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(tween_count());
+}
+
+/* Defines the class methods of Eruta::Graph on klass. */
+static void tr_graph_bind(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_NOARG(mrb, klass, "nodes_max"             , tr_bind_scegra_nodes_max);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "z"                     , tr_bind_scegra_z, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "disable"               , tr_bind_scegra_disable_node, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "id"                    , tr_bind_scegra_get_id, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "out_of_bounds?"        , tr_bind_scegra_out_of_bounds, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "z_"                    , tr_bind_scegra_z_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "z_batch"               , tr_bind_scegra_z__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "visible_"              , tr_bind_scegra_visible_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "visible_batch"         , tr_bind_scegra_visible__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "image_"                , tr_bind_scegra_image_id_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "font_"                 , tr_bind_scegra_font_id_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "background_image_"     , tr_bind_scegra_background_image_id_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "border_thickness_"     , tr_bind_scegra_border_thickness_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "margin_"               , tr_bind_scegra_margin_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "size_"                 , tr_bind_scegra_size_, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "size_batch"            , tr_bind_scegra_size__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "position_"             , tr_bind_scegra_position_, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "position_batch"        , tr_bind_scegra_position__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "speed_"                , tr_bind_scegra_speed_, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "speed_batch"           , tr_bind_scegra_speed__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "text_"                 , tr_bind_scegra_text_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "image_flags_"          , tr_bind_scegra_image_flags_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "text_flags_"           , tr_bind_scegra_text_flags_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "angle_"                , tr_bind_scegra_angle_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "angle_batch"           , tr_bind_scegra_angle__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "background_color_"     , tr_bind_scegra_background_color_, 5);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "border_color_"         , tr_bind_scegra_border_color_, 5);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "color_"                , tr_bind_scegra_color_, 5);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "color_batch"           , tr_bind_scegra_color__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "line_stop_"            , tr_bind_scegra_line_stop_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "line_start_"           , tr_bind_scegra_line_start_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "delay_"                , tr_bind_scegra_delay_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "line_stop"             , tr_bind_scegra_line_stop, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "line_start"            , tr_bind_scegra_line_start, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "delay"                 , tr_bind_scegra_delay, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "page_lines_"           , tr_bind_scegra_page_lines_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "page_lines"            , tr_bind_scegra_page_lines, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "paused_"               , tr_bind_scegra_paused_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "paused"                , tr_bind_scegra_paused, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "page_"                 , tr_bind_scegra_page_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "page"                  , tr_bind_scegra_page, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "last_page"             , tr_bind_scegra_last_page, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "next_page"             , tr_bind_scegra_next_page, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "previous_page"         , tr_bind_scegra_previous_page, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "at_end_p"              , tr_bind_scegra_at_end, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "copy"                  , tr_bind_scegra_copy_node, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "tween_stop"            , tr_bind_tween_stop, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "tween_stop_all"        , tr_bind_tween_stop_node, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "tween_p"               , tr_bind_tween_active_p, 2);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "tween_count"           , tr_bind_tween_count);
+}
+
+#endif
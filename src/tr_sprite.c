@@ -10,21 +10,17 @@
 #include "scegra.h"
 #include "sound.h"
 #include "spritestate.h"
+#include "framecache.h"
+#include "spriteload.h"
 #include <mruby/hash.h>
 #include <mruby/class.h>
 #include <mruby/data.h>
 #include <mruby/array.h>
 #include "tr_macro.h"
 #include "tr_sprite.h"
+#include "tr_sprite_bind.h"
 
 
-static mrb_value tr_new_sprite(mrb_state * mrb, mrb_value self) {
-  Sprite * sprite = NULL;
-  State * state   = state_get();
-  (void) self;  
-  return mrb_fixnum_value(state_new_sprite_id(state));
-} 
-
 static mrb_value tr_sprite(mrb_state * mrb, mrb_value self) {
   Sprite * sprite = NULL;
   State * state   = state_get();
@@ -65,11 +61,68 @@ static mrb_value tr_sprite_load_builtin(mrb_state * mrb, mrb_value self) {
 }
 
 
-TR_WRAP_NOARG_INT(tr_sprite_get_unused_id, state_get_unused_sprite_id);
+/* Starts loading a sprite layer in the background. Returns the id of the 
+ * load job, which is passed to eruta_on_sprite_loaded when it's done. */
+static mrb_value tr_sprite_load_builtin_async(mrb_state * mrb, mrb_value self) {
+  State * state    = state_get();
+  char * vpath;
+  int result;
+  mrb_int   rindex = -1;
+  mrb_int   rlayer = -1;
+  mrb_int   rlayout=  SPRITE_LOAD_ULPCSS_NORMAL;
+  mrb_value rvpath = mrb_nil_value();
+  (void) self;
+
+  mrb_get_args(mrb, "iiS|i", &rindex, &rlayer, &rvpath, &rlayout); 
+  if ((rindex<0) || (rlayer<0)) {
+    return mrb_nil_value();
+  }
+  vpath = mrb_str_to_cstr(mrb, rvpath);
+  result =
+  state_sprite_load_builtin_async(state, rindex, rlayer, vpath, rlayout);
+  return mrb_fixnum_value(result);
+}
+
+/* Returns the amount of layers of the sprite that are still loading. */
+static mrb_value tr_sprite_loading(mrb_state * mrb, mrb_value self) {
+  TR_SPRITE_FUNC_INIT(sprite, state, index)
+  mrb_get_args(mrb, "i", &index);
+  TR_SPRITE_GET(sprite, state, index);
+  return mrb_fixnum_value(sprite_loading(sprite));
+}
+
+/* Returns the statistics of the background loading of sprite layers as an 
+ * array of [started, loaded, failed, cells, pending]. */
+static mrb_value tr_sprite_load_stats(mrb_state * mrb, mrb_value self) {
+  SpriteLoadStats stats;
+  mrb_value       vals[5];
+  (void) self;
+  spriteload_stats(&stats);
+  vals[0] = mrb_fixnum_value(stats.started);
+  vals[1] = mrb_fixnum_value(stats.loaded);
+  vals[2] = mrb_fixnum_value(stats.failed);
+  vals[3] = mrb_fixnum_value(stats.cells);
+  vals[4] = mrb_fixnum_value(stats.pending);
+  return mrb_ary_new_from_values(mrb, 5, vals);
+}
 
 TR_SPRITE_II_INT(tr_sprite_action_index_for, sprite_action_index_for);
 
-TR_WRAP_I_INT(tr_delete_sprite, state_delete_sprite);
+/* Returns the statistics of the cache of composited sprite frames as an array
+ * of [hits, misses, evictions, bytes, budget, entries]. */
+static mrb_value tr_sprite_frame_cache_stats(mrb_state * mrb, mrb_value self) {
+  FrameCacheStats stats;
+  mrb_value       vals[6];
+  (void) self;
+  framecache_stats(&stats);
+  vals[0] = mrb_fixnum_value(stats.hits);
+  vals[1] = mrb_fixnum_value(stats.misses);
+  vals[2] = mrb_fixnum_value(stats.evictions);
+  vals[3] = mrb_fixnum_value(stats.bytes);
+  vals[4] = mrb_fixnum_value(stats.budget);
+  vals[5] = mrb_fixnum_value(stats.entries);
+  return mrb_ary_new_from_values(mrb, 6, vals);
+}
 
 
 
@@ -156,12 +209,14 @@ int tr_sprite_init(mrb_state * mrb, struct RClass * eru) {
   TR_CONST_INT_EASY(mrb, spr, SPRITE_, LOAD_ULPCSS_OVERSIZED_SLASH);
    
   
-  TR_CLASS_METHOD_ARGC(mrb  , spr, "sprite_new"    , tr_new_sprite, 1);
+  tr_sprite_bind(mrb, spr);
   TR_CLASS_METHOD_ARGC(mrb  , spr, "get"           , tr_sprite, 1);
   TR_CLASS_METHOD_OPTARG(mrb, spr, "load_builtin"  , tr_sprite_load_builtin, 3, 1);
-  TR_CLASS_METHOD_ARGC(mrb  , spr, "get_unused_id" , tr_sprite_get_unused_id, 1);
   TR_CLASS_METHOD_ARGC(mrb  , spr, "action_id_for" , tr_sprite_action_index_for, 3);
-  TR_CLASS_METHOD_ARGC(mrb  , spr, "delete"        , tr_delete_sprite, 1);
+  TR_CLASS_METHOD_NOARG(mrb , spr, "frame_cache_stats"  , tr_sprite_frame_cache_stats);
+  TR_CLASS_METHOD_OPTARG(mrb, spr, "load_builtin_async" , tr_sprite_load_builtin_async, 3, 1);
+  TR_CLASS_METHOD_ARGC(mrb  , spr, "loading"            , tr_sprite_loading, 1);
+  TR_CLASS_METHOD_NOARG(mrb , spr, "load_stats"         , tr_sprite_load_stats);
 
 
   return 0;
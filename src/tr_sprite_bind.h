@@ -0,0 +1,94 @@
+/*
+ * Generated by bin/trgen from tr_sprite.bind, don't edit.
+ */
+#ifndef tr_sprite_bind_h_INCLUDED
+#define tr_sprite_bind_h_INCLUDED
+
+#include "tr_bind.h"
+
+/* state_new_sprite_id() -> int */
+static mrb_value tr_bind_state_new_sprite_id(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(state_new_sprite_id(state_get()));
+}
+
+/* state_get_unused_sprite_id() -> int */
+static mrb_value tr_bind_state_get_unused_sprite_id(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(state_get_unused_sprite_id());
+}
+
+/* state_delete_sprite(int) -> int */
+static mrb_value tr_bind_state_delete_sprite(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(state_delete_sprite(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* framecache_budget() -> int */
+static mrb_value tr_bind_framecache_budget(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(framecache_budget());
+}
+
+/* framecache_budget_(int) -> int */
+static mrb_value tr_bind_framecache_budget_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(framecache_budget_(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* spriteload_budget() -> float */
+static mrb_value tr_bind_spriteload_budget(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, spriteload_budget());
+}
+
+/* spriteload_budget_(float) -> float */
+static mrb_value tr_bind_spriteload_budget_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, spriteload_budget_(TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* Defines the class methods of Eruta::Sprite on klass. */
+static void tr_sprite_bind(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_NOARG(mrb, klass, "sprite_new"            , tr_bind_state_new_sprite_id);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "get_unused_id"         , tr_bind_state_get_unused_sprite_id);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "delete"                , tr_bind_state_delete_sprite, 1);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "frame_cache_budget"    , tr_bind_framecache_budget);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "frame_cache_budget="   , tr_bind_framecache_budget_, 1);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "load_budget"           , tr_bind_spriteload_budget);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_budget="          , tr_bind_spriteload_budget_, 1);
+}
+
+#endif
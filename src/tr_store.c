@@ -6,6 +6,7 @@
 #include "image.h"
 #include "fifi.h"
 #include "store.h"
+#include "storeload.h"
 #include "scegra.h"
 #include "sound.h"
 #include <mruby/hash.h>
@@ -14,125 +15,30 @@
 #include <mruby/array.h>
 #include "tr_macro.h"
 #include "tr_store.h"
-
-static mrb_value tr_store_kind(mrb_state * mrb, mrb_value self) {
-  mrb_int index = -1;
-  (void) self;
-  mrb_get_args(mrb, "i", &index);  
-  return mrb_fixnum_value(store_kind(index));
-}
-
-static mrb_value tr_store_load_bitmap(mrb_state * mrb, mrb_value self) {
-  char * vpath = NULL; 
-  mrb_int index    = -1;
-  (void) self;
-
-  mrb_get_args(mrb, "iz", &index, &vpath);  
-  return rh_bool_value(store_load_bitmap(index, (const char *) vpath));
-}
-
-static mrb_value tr_store_load_bitmap_flags(mrb_state * mrb, mrb_value self) {
-  char * vpath = NULL; 
-  mrb_int index    = -1;
-  mrb_int flags    =  0;
-  (void) self;
-
-  mrb_get_args(mrb, "izi", &index, &vpath, &flags);  
-  return rh_bool_value(store_load_bitmap_flags(index, (const char *)vpath, flags));
-}
-
-static mrb_value tr_store_load_sample(mrb_state * mrb, mrb_value self) {
-  char * vpath = NULL; 
-  mrb_int index    = -1;
-  (void) self;
-
-  mrb_get_args(mrb, "iz", &index, &vpath);  
-  return rh_bool_value(store_load_sample(index, (const char *) vpath));
-}
-
-static mrb_value tr_store_load_audio_stream(mrb_state * mrb, mrb_value self) {
-  char * vpath          = NULL; 
-  mrb_int  index          =   -1;
-  size_t buffer_count   =    0;
-  int    samples        =    0;
-  int    bc             =    0;
-  (void) self;
-
-  mrb_get_args(mrb, "izii", &index, &vpath, &bc, &samples );
-  buffer_count          = (size_t) bc;
-  return rh_bool_value(
-    store_load_audio_stream(index, (const char *)vpath, buffer_count, samples)
-  );
-}
-
-static mrb_value tr_store_load_bitmap_font(mrb_state * mrb, mrb_value self) {
-  char * vpath = NULL; 
-  mrb_int index    = -1;
-  (void) self;
-
-  mrb_get_args(mrb, "iz", &index, &vpath);  
-  return rh_bool_value(store_load_bitmap_font(index, (const char *) vpath));
-}
-
-static mrb_value tr_store_load_bitmap_font_flags(mrb_state * mrb, mrb_value self) {
-  char * vpath = NULL; 
-  mrb_int index    = -1;
-  mrb_int flags    =  0;
-  (void) self;
-
-  mrb_get_args(mrb, "izi", &index, &vpath, &flags);  
-  return rh_bool_value(
-    store_load_bitmap_font_flags(index, (const char *)vpath, flags)
-  );
-}
-
-
-static mrb_value tr_store_load_ttf_font(mrb_state * mrb, mrb_value self) {
-  char * vpath     = NULL; 
-  mrb_int index    = -1;
-  mrb_int h        = 10;  
-  mrb_int flags    =  0;
-  (void) self;
-
-  mrb_get_args(mrb, "izii", &index, &vpath, &h, &flags);
-  return rh_bool_value(
-    store_load_ttf_font(index, (const char *)vpath, h, flags)
-  );
-}
-
-
-static mrb_value tr_store_load_ttf_font_stretch(mrb_state * mrb, mrb_value self) {
-  char * vpath     = NULL; 
-  mrb_int index    = -1;
-  mrb_int w        = 10;
-  mrb_int h        = 10;  
-  mrb_int flags    =  0;
-  (void) self;
-
-  mrb_get_args(mrb, "iziii", &index, &vpath, &w, &h, &flags);  
-  return rh_bool_value(
-    store_load_ttf_font_stretch(index, (const char *)vpath, w, h, flags)
-  );
-}
-
+#include "tr_store_bind.h"
 
 static mrb_value tr_store_drop(mrb_state * mrb, mrb_value self) {
   mrb_int index    = -1;
   (void) self;
   mrb_get_args(mrb, "i", &index);  
+  /* Don't let a background load fill in the index again later. */
+  storeload_cancel(index);
   return rh_bool_value(store_drop(index));
 }
 
-static mrb_value tr_store_index_ok(mrb_state * mrb, mrb_value self) {
-  mrb_int index    = -1;
+/** Returns the statistics of the background loading of resources as an 
+ * array of started, loaded, failed, shared and pending jobs. */
+static mrb_value tr_store_load_stats(mrb_state * mrb, mrb_value self) {
+  StoreLoadStats stats;
+  mrb_value      vals[5];
   (void) self;
-  mrb_get_args(mrb, "i", &index);  
-  return rh_bool_value(store_index_ok(index));
-}
-
-static mrb_value tr_store_max(mrb_state * mrb, mrb_value self) {
-  (void) self; (void) mrb;
-  return rh_bool_value(store_max());
+  storeload_stats(&stats);
+  vals[0] = mrb_fixnum_value(stats.started);
+  vals[1] = mrb_fixnum_value(stats.loaded);
+  vals[2] = mrb_fixnum_value(stats.failed);
+  vals[3] = mrb_fixnum_value(stats.shared);
+  vals[4] = mrb_fixnum_value(stats.pending);
+  return mrb_ary_new_from_values(mrb, 5, vals);
 }
 
 static mrb_value tr_store_get_bitmap_format(mrb_state * mrb, mrb_value self) {
@@ -257,34 +163,40 @@ static mrb_value tr_store_grab_font(mrb_state * mrb, mrb_value self) {
   return rh_bool_value(res);
 } 
 
-/* Allows to set a color of a loaded image as the mask color. Somewhat slow. */
-static mrb_value tr_image_mask_to_alpha(mrb_state * mrb, mrb_value self) {
-  State * state    = state_get();
-  BeVec result;
-  int store_index, r, g, b;
-  mrb_int thingid; mrb_float x, y;
+/* Returns the statistics of the text measurement cache of a font as an array
+ * of [hits, misses, skipped, evictions, computed], or nil if not a font. */
+static mrb_value tr_store_get_text_cache_stats(mrb_state * mrb, mrb_value self) {
+  mrb_int        index = -1;
+  TextCacheStats stats;
+  mrb_value      vals[5];
   (void) self;
-  
-  mrb_get_args(mrb, "iiii", &store_index, &r, &g, &b); 
-  return mrb_fixnum_value(state_image_mask_to_alpha(state, store_index, r, g, b));
-}
 
-/* Allows to set the colors of a loaded image with the image itselmf acting as a mask. 
- * Somewhat slow. */
-static mrb_value tr_image_average_to_alpha(mrb_state * mrb, mrb_value self) {
-  State * state    = state_get();
-  BeVec result;
-  int store_index, r, g, b;
-  mrb_int thingid; mrb_float x, y;
-  (void) self;
-  
-  mrb_get_args(mrb, "iiii", &store_index, &r, &g, &b); 
-  return mrb_fixnum_value(state_image_average_to_alpha(state, store_index, r, g, b));
+  mrb_get_args(mrb, "i", &index);  
+  if (!store_get_text_cache_stats(index, &stats)) return mrb_nil_value();
+  vals[0] = mrb_fixnum_value(stats.hits);
+  vals[1] = mrb_fixnum_value(stats.misses);
+  vals[2] = mrb_fixnum_value(stats.skipped);
+  vals[3] = mrb_fixnum_value(stats.evictions);
+  vals[4] = mrb_fixnum_value(stats.computed);
+  return mrb_ary_new_from_values(mrb, 5, vals);
 }
 
+/** Returns the statistics of the sharing of loaded resources as an array
+ * of hits, misses, bytes saved, cached entries, evictions and reloads. */
+static mrb_value tr_store_cache_stats(mrb_state * mrb, mrb_value self) {
+  StoreCacheStats stats;
+  mrb_value       vals[6];
+  (void) self;
 
-TR_WRAP_I_INT(tr_store_get_unused_id, store_get_unused_id);
-
+  if (!store_cache_stats(&stats)) return mrb_nil_value();
+  vals[0] = mrb_fixnum_value(stats.hits);
+  vals[1] = mrb_fixnum_value(stats.misses);
+  vals[2] = mrb_fixnum_value(stats.bytes_saved);
+  vals[3] = mrb_fixnum_value(stats.entries);
+  vals[4] = mrb_fixnum_value(stats.evictions);
+  vals[5] = mrb_fixnum_value(stats.reloads);
+  return mrb_ary_new_from_values(mrb, 6, vals);
+}
 
 /** Initialize mruby bindings to data storage functionality.
  * Eru is the parent module, which is normally named "Eruta" on the
@@ -298,37 +210,9 @@ int tr_store_init(mrb_state * mrb, struct RClass * eru) {
   krn = mrb_module_get(mrb, "Kernel");
 
   
-  if (krn) {
-    TR_METHOD_ARGC(mrb, krn, "store_kind", tr_store_kind, 1);
-    TR_METHOD_ARGC(mrb, krn, "load_bitmap", tr_store_load_bitmap, 2);
-    TR_METHOD_ARGC(mrb, krn, "load_bitmap", tr_store_load_bitmap, 2);  
-    TR_METHOD_ARGC(mrb, krn, "load_bitmap_flags", 
-                         tr_store_load_bitmap_flags, 3);
-    TR_METHOD_ARGC(mrb, krn, "load_audio_stream", tr_store_load_audio_stream, 4);
-    TR_METHOD_ARGC(mrb, krn, "load_sample", tr_store_load_sample, 2);
-    TR_METHOD_ARGC(mrb, krn, "load_ttf_font", tr_store_load_ttf_font, 4);
-    TR_METHOD_ARGC(mrb, krn, "load_ttf_stretch", tr_store_load_ttf_font_stretch, 5);
-    TR_METHOD_ARGC(mrb, krn, "load_bitmap_font", tr_store_load_bitmap_font, 2);
-    TR_METHOD_ARGC(mrb, krn, "load_bitmap_font_flags", tr_store_load_bitmap, 3);
-  }
- 
-  
-  TR_CLASS_METHOD_ARGC(mrb, sto, "kind", tr_store_kind, 1);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "load_bitmap", tr_store_load_bitmap, 2);  
-  TR_CLASS_METHOD_ARGC(mrb, sto, "load_bitmap_flags", 
-                       tr_store_load_bitmap_flags, 3);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "load_audio_stream", tr_store_load_audio_stream, 4);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "load_sample", tr_store_load_sample, 2);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "load_ttf_font", tr_store_load_ttf_font, 4);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "load_ttf_stretch", tr_store_load_ttf_font_stretch, 5);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "load_bitmap_font", tr_store_load_bitmap_font, 2);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "load_bitmap_font_flags", tr_store_load_bitmap, 3);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "mask_to_alpha", tr_image_mask_to_alpha, 4);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "average_to_alpha", tr_image_average_to_alpha, 4);
-  
-  
-  
-  
+  if (krn) tr_store_bind_kernel(mrb, krn);
+  tr_store_bind(mrb, sto);
+
   TR_CLASS_METHOD_ARGC(mrb, sto, "drop"             , tr_store_drop, 1);
   TR_CLASS_METHOD_ARGC(mrb, sto, "bitmap_flags"     , tr_store_get_bitmap_flags, 1);
   TR_CLASS_METHOD_ARGC(mrb, sto, "bitmap_width"     , tr_store_get_bitmap_width, 1);
@@ -339,7 +223,10 @@ int tr_store_init(mrb_state * mrb, struct RClass * eru) {
   TR_CLASS_METHOD_ARGC(mrb, sto, "font_line_height" , tr_store_get_font_line_height, 1);
   TR_CLASS_METHOD_ARGC(mrb, sto, "text_dimensions"  , tr_store_get_text_dimensions, 2);
   TR_CLASS_METHOD_ARGC(mrb, sto, "text_width"       , tr_store_get_text_width, 2);
-  TR_CLASS_METHOD_ARGC(mrb, sto, "get_unused_id"    , tr_store_get_unused_id, 1);
+  TR_CLASS_METHOD_ARGC(mrb, sto, "text_cache_stats" , tr_store_get_text_cache_stats, 1);
+  TR_CLASS_METHOD_NOARG(mrb, sto, "cache_stats" , tr_store_cache_stats);
+  
+  TR_CLASS_METHOD_NOARG(mrb, sto, "load_stats"      , tr_store_load_stats);
 
 
   return 0;
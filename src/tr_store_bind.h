@@ -0,0 +1,337 @@
+/*
+ * Generated by bin/trgen from tr_store.bind, don't edit.
+ */
+#ifndef tr_store_bind_h_INCLUDED
+#define tr_store_bind_h_INCLUDED
+
+#include "tr_bind.h"
+
+/* store_kind(int) -> int */
+static mrb_value tr_bind_store_kind(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(store_kind(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* store_load_bitmap(int, string) -> bool */
+static mrb_value tr_bind_store_load_bitmap(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return rh_bool_value(store_load_bitmap(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1])));
+}
+
+/* store_load_bitmap_flags(int, string, int) -> bool */
+static mrb_value tr_bind_store_load_bitmap_flags(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return rh_bool_value(store_load_bitmap_flags(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1]), TR_BIND_INT(mrb, argv[2])));
+}
+
+/* store_load_audio_stream(int, string, int, int) -> bool */
+static mrb_value tr_bind_store_load_audio_stream(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 4) return tr_bind_arity_error(mrb, argc, 4);
+  return rh_bool_value(store_load_audio_stream(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3])));
+}
+
+/* store_load_sample(int, string) -> bool */
+static mrb_value tr_bind_store_load_sample(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return rh_bool_value(store_load_sample(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1])));
+}
+
+/* store_load_ttf_font(int, string, int, int) -> bool */
+static mrb_value tr_bind_store_load_ttf_font(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 4) return tr_bind_arity_error(mrb, argc, 4);
+  return rh_bool_value(store_load_ttf_font(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3])));
+}
+
+/* store_load_ttf_font_stretch(int, string, int, int, int) -> bool */
+static mrb_value tr_bind_store_load_ttf_font_stretch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 5) return tr_bind_arity_error(mrb, argc, 5);
+  return rh_bool_value(store_load_ttf_font_stretch(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3]), TR_BIND_INT(mrb, argv[4])));
+}
+
+/* store_load_bitmap_font(int, string) -> bool */
+static mrb_value tr_bind_store_load_bitmap_font(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return rh_bool_value(store_load_bitmap_font(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1])));
+}
+
+/* store_load_bitmap_font_flags(int, string, int) -> bool */
+static mrb_value tr_bind_store_load_bitmap_font_flags(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return rh_bool_value(store_load_bitmap_font_flags(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1]), TR_BIND_INT(mrb, argv[2])));
+}
+
+/* state_image_mask_to_alpha(int, int, int, int) -> int */
+static mrb_value tr_bind_state_image_mask_to_alpha(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 4) return tr_bind_arity_error(mrb, argc, 4);
+  return mrb_fixnum_value(state_image_mask_to_alpha(state_get(), TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3])));
+}
+
+/* state_image_average_to_alpha(int, int, int, int) -> int */
+static mrb_value tr_bind_state_image_average_to_alpha(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 4) return tr_bind_arity_error(mrb, argc, 4);
+  return mrb_fixnum_value(state_image_average_to_alpha(state_get(), TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3])));
+}
+
+/* store_get_unused_id(int) -> int */
+static mrb_value tr_bind_store_get_unused_id(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(store_get_unused_id(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* store_prewarm_font(int) -> bool */
+static mrb_value tr_bind_store_prewarm_font(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(store_prewarm_font(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* store_budget(int) -> int */
+static mrb_value tr_bind_store_budget(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(store_budget(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* store_budget_(int, int) -> int */
+static mrb_value tr_bind_store_budget_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(store_budget_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* store_used(int) -> int */
+static mrb_value tr_bind_store_used(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(store_used(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* store_pin(int) -> bool */
+static mrb_value tr_bind_store_pin(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(store_pin(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* store_unpin(int) -> bool */
+static mrb_value tr_bind_store_unpin(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(store_unpin(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* store_pinned(int) -> bool */
+static mrb_value tr_bind_store_pinned(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(store_pinned(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* storeload_bitmap(int, string) -> int */
+static mrb_value tr_bind_storeload_bitmap(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(storeload_bitmap(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1])));
+}
+
+/* storeload_bitmap_flags(int, string, int) -> int */
+static mrb_value tr_bind_storeload_bitmap_flags(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(storeload_bitmap_flags(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1]), TR_BIND_INT(mrb, argv[2])));
+}
+
+/* storeload_sample(int, string) -> int */
+static mrb_value tr_bind_storeload_sample(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(storeload_sample(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1])));
+}
+
+/* storeload_ttf_font(int, string, int, int) -> int */
+static mrb_value tr_bind_storeload_ttf_font(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 4) return tr_bind_arity_error(mrb, argc, 4);
+  return mrb_fixnum_value(storeload_ttf_font(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3])));
+}
+
+/* storeload_ttf_font_stretch(int, string, int, int, int) -> int */
+static mrb_value tr_bind_storeload_ttf_font_stretch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 5) return tr_bind_arity_error(mrb, argc, 5);
+  return mrb_fixnum_value(storeload_ttf_font_stretch(TR_BIND_INT(mrb, argv[0]), TR_BIND_STRING(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3]), TR_BIND_INT(mrb, argv[4])));
+}
+
+/* storeload_pending() -> int */
+static mrb_value tr_bind_storeload_pending(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(storeload_pending());
+}
+
+/* storeload_progress() -> float */
+static mrb_value tr_bind_storeload_progress(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, storeload_progress());
+}
+
+/* storeload_budget() -> float */
+static mrb_value tr_bind_storeload_budget(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_float_value(mrb, storeload_budget());
+}
+
+/* storeload_budget_(float) -> float */
+static mrb_value tr_bind_storeload_budget_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, storeload_budget_(TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* Defines the instance methods of Kernel on klass. */
+static void tr_store_bind_kernel(mrb_state * mrb, struct RClass * klass) {
+  TR_METHOD_ARGC(mrb, klass, "store_kind"            , tr_bind_store_kind, 1);
+  TR_METHOD_ARGC(mrb, klass, "load_bitmap"           , tr_bind_store_load_bitmap, 2);
+  TR_METHOD_ARGC(mrb, klass, "load_bitmap_flags"     , tr_bind_store_load_bitmap_flags, 3);
+  TR_METHOD_ARGC(mrb, klass, "load_audio_stream"     , tr_bind_store_load_audio_stream, 4);
+  TR_METHOD_ARGC(mrb, klass, "load_sample"           , tr_bind_store_load_sample, 2);
+  TR_METHOD_ARGC(mrb, klass, "load_ttf_font"         , tr_bind_store_load_ttf_font, 4);
+  TR_METHOD_ARGC(mrb, klass, "load_ttf_stretch"      , tr_bind_store_load_ttf_font_stretch, 5);
+  TR_METHOD_ARGC(mrb, klass, "load_bitmap_font"      , tr_bind_store_load_bitmap_font, 2);
+  TR_METHOD_ARGC(mrb, klass, "load_bitmap_font_flags", tr_bind_store_load_bitmap_font_flags, 3);
+}
+
+/* Defines the class methods of Eruta::Store on klass. */
+static void tr_store_bind(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_ARGC(mrb, klass, "kind"                  , tr_bind_store_kind, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_bitmap"           , tr_bind_store_load_bitmap, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_bitmap_flags"     , tr_bind_store_load_bitmap_flags, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_audio_stream"     , tr_bind_store_load_audio_stream, 4);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_sample"           , tr_bind_store_load_sample, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_ttf_font"         , tr_bind_store_load_ttf_font, 4);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_ttf_stretch"      , tr_bind_store_load_ttf_font_stretch, 5);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_bitmap_font"      , tr_bind_store_load_bitmap_font, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_bitmap_font_flags", tr_bind_store_load_bitmap_font_flags, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "mask_to_alpha"         , tr_bind_state_image_mask_to_alpha, 4);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "average_to_alpha"      , tr_bind_state_image_average_to_alpha, 4);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "get_unused_id"         , tr_bind_store_get_unused_id, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "prewarm_font"          , tr_bind_store_prewarm_font, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "budget"                , tr_bind_store_budget, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "set_budget"            , tr_bind_store_budget_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "used"                  , tr_bind_store_used, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "pin"                   , tr_bind_store_pin, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "unpin"                 , tr_bind_store_unpin, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "pinned"                , tr_bind_store_pinned, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_bitmap_async"     , tr_bind_storeload_bitmap, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_bitmap_flags_async", tr_bind_storeload_bitmap_flags, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_sample_async"     , tr_bind_storeload_sample, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_ttf_font_async"   , tr_bind_storeload_ttf_font, 4);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_ttf_stretch_async", tr_bind_storeload_ttf_font_stretch, 5);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "load_pending"          , tr_bind_storeload_pending);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "load_progress"         , tr_bind_storeload_progress);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "load_budget"           , tr_bind_storeload_budget);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "load_budget="          , tr_bind_storeload_budget_, 1);
+}
+
+#endif
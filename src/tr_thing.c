@@ -0,0 +1,97 @@
+
+#include "eruta.h"
+#include "toruby.h"
+#include "rh.h"
+#include "state.h"
+#include "thing.h"
+#include <mruby/class.h>
+#include <mruby/array.h>
+#include "tr_macro.h"
+#include "tr_thing.h"
+#include "tr_thing_bind.h"
+
+/* Amount of things that find_in_rectangle returns at most. */
+#define TR_THING_FIND_MAX 256
+
+/* Returns the velocity of a thing as an [vx, vy] array, or nil if there is
+ * no such thing. */
+static mrb_value tr_thing_v(mrb_state * mrb, mrb_value self) {
+  mrb_int id;
+  mrb_value values[2];
+  (void) self;
+  mrb_get_args(mrb, "i", &id);
+  if (!thing_exists(id)) return mrb_nil_value();
+  values[0] = mrb_float_value(mrb, thing_vx(id));
+  values[1] = mrb_float_value(mrb, thing_vy(id));
+  return mrb_ary_new_from_values(mrb, 2, values);
+}
+
+/* Returns an array with the ids of the things of which the collision bounds
+ * overlap the given rectangle. */
+static mrb_value tr_thing_find_in_rectangle(mrb_state * mrb, mrb_value self) {
+  mrb_float x, y, w, h;
+  mrb_value result;
+  int ids[TR_THING_FIND_MAX];
+  int index, found;
+  (void) self;
+  mrb_get_args(mrb, "ffff", &x, &y, &w, &h);
+  found  = thing_find_in_rectangle(x, y, w, h, ids, TR_THING_FIND_MAX);
+  result = mrb_ary_new_capa(mrb, found);
+  for (index = 0; index < found; index++) {
+    mrb_ary_push(mrb, result, mrb_fixnum_value(ids[index]));
+  }
+  return result;
+}
+
+/* Returns the positions of all things in one flat array of id, x, y triples,
+ * so scripts can read them all with one call. */
+static mrb_value tr_thing_positions(mrb_state * mrb, mrb_value self) {
+  mrb_value result;
+  int index, count, arena;
+  (void) self;
+  count  = thing_count();
+  result = mrb_ary_new_capa(mrb, count * 3);
+  arena  = mrb_gc_arena_save(mrb);
+  for (index = 0; index < count; index++) {
+    int id = thing_nth(index);
+    mrb_ary_push(mrb, result, mrb_fixnum_value(id));
+    mrb_ary_push(mrb, result, mrb_float_value(mrb, thing_x(id)));
+    mrb_ary_push(mrb, result, mrb_float_value(mrb, thing_y(id)));
+    mrb_gc_arena_restore(mrb, arena);
+  }
+  return result;
+}
+
+/** Initialize mruby bindings to the things.
+ * Eru is the parent module, which is normally named "Eruta" on the
+ * ruby side. */
+int tr_thing_init(mrb_state * mrb, struct RClass * eru) {
+  struct RClass *thi;
+  struct RClass *kin;
+  struct RClass *fla;
+
+  thi = mrb_define_class_under(mrb, eru, "Thing", mrb->object_class);
+  kin = mrb_define_module_under(mrb, thi, "Kind");
+  fla = mrb_define_module_under(mrb, thi, "Flag");
+
+  tr_thing_bind(mrb, thi);
+  TR_CLASS_METHOD_ARGC(mrb, thi, "v", tr_thing_v, 1);
+  TR_CLASS_METHOD_ARGC(mrb, thi, "find_in_rectangle", tr_thing_find_in_rectangle, 4);
+  TR_CLASS_METHOD_NOARG(mrb, thi, "positions", tr_thing_positions);
+
+  TR_CONST_INT_EASY(mrb, kin, THING_KIND_, NONE);
+  TR_CONST_INT_EASY(mrb, kin, THING_KIND_, PLAYER);
+  TR_CONST_INT_EASY(mrb, kin, THING_KIND_, NPC);
+  TR_CONST_INT_EASY(mrb, kin, THING_KIND_, FOE);
+  TR_CONST_INT_EASY(mrb, kin, THING_KIND_, ITEM);
+  TR_CONST_INT_EASY(mrb, kin, THING_KIND_, ATTACK);
+  TR_CONST_INT_EASY(mrb, kin, THING_KIND_, WALL);
+
+  TR_CONST_INT_EASY(mrb, fla, THING_FLAG_, DISABLED);
+  TR_CONST_INT_EASY(mrb, fla, THING_FLAG_, SENSOR);
+  TR_CONST_INT_EASY(mrb, fla, THING_FLAG_, STATIC);
+  TR_CONST_INT_EASY(mrb, fla, THING_FLAG_, ANIMATE);
+  TR_CONST_INT_EASY(mrb, fla, THING_FLAG_, HIDDEN);
+
+  return 0;
+}
@@ -0,0 +1,485 @@
+/*
+ * Generated by bin/trgen from tr_thing.bind, don't edit.
+ */
+#ifndef tr_thing_bind_h_INCLUDED
+#define tr_thing_bind_h_INCLUDED
+
+#include "tr_bind.h"
+
+/* thing_new(int, float, float, float, float, float) -> int */
+static mrb_value tr_bind_thing_new(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 6) return tr_bind_arity_error(mrb, argc, 6);
+  return mrb_fixnum_value(thing_new(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1]), TR_BIND_FLOAT(mrb, argv[2]), TR_BIND_FLOAT(mrb, argv[3]), TR_BIND_FLOAT(mrb, argv[4]), TR_BIND_FLOAT(mrb, argv[5])));
+}
+
+/* thing_delete(int) -> int */
+static mrb_value tr_bind_thing_delete(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(thing_delete(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_exists(int) -> bool */
+static mrb_value tr_bind_thing_exists(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(thing_exists(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_count() -> int */
+static mrb_value tr_bind_thing_count(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 0) return tr_bind_arity_error(mrb, argc, 0);
+  (void) argv;
+  return mrb_fixnum_value(thing_count());
+}
+
+/* thing_x(int) -> float */
+static mrb_value tr_bind_thing_x(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_x(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_y(int) -> float */
+static mrb_value tr_bind_thing_y(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_y(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_z(int) -> float */
+static mrb_value tr_bind_thing_z(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_z(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_w(int) -> float */
+static mrb_value tr_bind_thing_w(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_w(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_h(int) -> float */
+static mrb_value tr_bind_thing_h(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_h(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_cx(int) -> float */
+static mrb_value tr_bind_thing_cx(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_cx(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_cy(int) -> float */
+static mrb_value tr_bind_thing_cy(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_cy(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_vx(int) -> float */
+static mrb_value tr_bind_thing_vx(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_vx(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_vy(int) -> float */
+static mrb_value tr_bind_thing_vy(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, thing_vy(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_position_(int, float, float) -> int */
+static mrb_value tr_bind_thing_position_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(thing_position_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1]), TR_BIND_FLOAT(mrb, argv[2])));
+}
+
+/* thing_position_ for each 3 values of a flat array -> calls */
+static mrb_value tr_bind_thing_position__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 3);
+  for (index = 0; index < size; index += 3) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    thing_position_(TR_BIND_INT(mrb, item[0]), TR_BIND_FLOAT(mrb, item[1]), TR_BIND_FLOAT(mrb, item[2]));
+  }
+  return mrb_fixnum_value(size / 3);
+}
+
+/* thing_z_(int, float) -> int */
+static mrb_value tr_bind_thing_z_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(thing_z_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1])));
+}
+
+/* thing_size_(int, float, float) -> int */
+static mrb_value tr_bind_thing_size_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(thing_size_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1]), TR_BIND_FLOAT(mrb, argv[2])));
+}
+
+/* thing_v_(int, float, float) -> int */
+static mrb_value tr_bind_thing_v_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(thing_v_(TR_BIND_INT(mrb, argv[0]), TR_BIND_FLOAT(mrb, argv[1]), TR_BIND_FLOAT(mrb, argv[2])));
+}
+
+/* thing_v_ for each 3 values of a flat array -> calls */
+static mrb_value tr_bind_thing_v__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 3);
+  for (index = 0; index < size; index += 3) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    thing_v_(TR_BIND_INT(mrb, item[0]), TR_BIND_FLOAT(mrb, item[1]), TR_BIND_FLOAT(mrb, item[2]));
+  }
+  return mrb_fixnum_value(size / 3);
+}
+
+/* thing_kind(int) -> int */
+static mrb_value tr_bind_thing_kind(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(thing_kind(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_flags(int) -> int */
+static mrb_value tr_bind_thing_flags(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(thing_flags(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_flags_(int, int) -> int */
+static mrb_value tr_bind_thing_flags_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(thing_flags_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* thing_set_flag(int, int) -> int */
+static mrb_value tr_bind_thing_set_flag(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(thing_set_flag(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* thing_unset_flag(int, int) -> int */
+static mrb_value tr_bind_thing_unset_flag(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(thing_unset_flag(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* thing_group(int) -> int */
+static mrb_value tr_bind_thing_group(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(thing_group(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_group_(int, int) -> int */
+static mrb_value tr_bind_thing_group_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(thing_group_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* state_thing_sprite_(int, int) -> int */
+static mrb_value tr_bind_state_thing_sprite_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(state_thing_sprite_(state_get(), TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* thing_pose(int) -> int */
+static mrb_value tr_bind_thing_pose(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(thing_pose(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_pose_(int, int) -> int */
+static mrb_value tr_bind_thing_pose_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(thing_pose_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* thing_pose_ for each 2 values of a flat array -> calls */
+static mrb_value tr_bind_thing_pose__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 2);
+  for (index = 0; index < size; index += 2) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    thing_pose_(TR_BIND_INT(mrb, item[0]), TR_BIND_INT(mrb, item[1]));
+  }
+  return mrb_fixnum_value(size / 2);
+}
+
+/* thing_direction(int) -> int */
+static mrb_value tr_bind_thing_direction(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(thing_direction(TR_BIND_INT(mrb, argv[0])));
+}
+
+/* thing_direction_(int, int) -> int */
+static mrb_value tr_bind_thing_direction_(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(thing_direction_(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* thing_direction_ for each 2 values of a flat array -> calls */
+static mrb_value tr_bind_thing_direction__batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 2);
+  for (index = 0; index < size; index += 2) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    thing_direction_(TR_BIND_INT(mrb, item[0]), TR_BIND_INT(mrb, item[1]));
+  }
+  return mrb_fixnum_value(size / 2);
+}
+
+/* thing_tint_layer(int, int, int, int, int, int) -> int */
+static mrb_value tr_bind_thing_tint_layer(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 6) return tr_bind_arity_error(mrb, argc, 6);
+  return mrb_fixnum_value(thing_tint_layer(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3]), TR_BIND_INT(mrb, argv[4]), TR_BIND_INT(mrb, argv[5])));
+}
+
+/* thing_hide_layer(int, int, int) -> int */
+static mrb_value tr_bind_thing_hide_layer(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(thing_hide_layer(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2])));
+}
+
+/* thing_layer_hidden(int, int) -> bool */
+static mrb_value tr_bind_thing_layer_hidden(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return rh_bool_value(thing_layer_hidden(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* thing_set_action_loop(int, int, int) -> int */
+static mrb_value tr_bind_thing_set_action_loop(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(thing_set_action_loop(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2])));
+}
+
+/* thing_get_action_loop(int, int) -> int */
+static mrb_value tr_bind_thing_get_action_loop(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(thing_get_action_loop(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* thing_set_pose_direction_loop(int, int, int, int) -> int */
+static mrb_value tr_bind_thing_set_pose_direction_loop(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 4) return tr_bind_arity_error(mrb, argc, 4);
+  return mrb_fixnum_value(thing_set_pose_direction_loop(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2]), TR_BIND_INT(mrb, argv[3])));
+}
+
+/* thing_get_pose_direction_loop(int, int, int) -> int */
+static mrb_value tr_bind_thing_get_pose_direction_loop(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 3) return tr_bind_arity_error(mrb, argc, 3);
+  return mrb_fixnum_value(thing_get_pose_direction_loop(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]), TR_BIND_INT(mrb, argv[2])));
+}
+
+/* thing_action_done(int, int) -> bool */
+static mrb_value tr_bind_thing_action_done(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return rh_bool_value(thing_action_done(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* Defines the class methods of Eruta::Thing on klass. */
+static void tr_thing_bind(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_ARGC(mrb, klass, "thing_new"             , tr_bind_thing_new, 6);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "delete"                , tr_bind_thing_delete, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "exists?"               , tr_bind_thing_exists, 1);
+  TR_CLASS_METHOD_NOARG(mrb, klass, "count"                 , tr_bind_thing_count);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "x"                     , tr_bind_thing_x, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "y"                     , tr_bind_thing_y, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "z"                     , tr_bind_thing_z, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "w"                     , tr_bind_thing_w, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "h"                     , tr_bind_thing_h, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "cx"                    , tr_bind_thing_cx, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "cy"                    , tr_bind_thing_cy, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "vx"                    , tr_bind_thing_vx, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "vy"                    , tr_bind_thing_vy, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "position_"             , tr_bind_thing_position_, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "position_batch"        , tr_bind_thing_position__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "z_"                    , tr_bind_thing_z_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "size_"                 , tr_bind_thing_size_, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "v_"                    , tr_bind_thing_v_, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "v_batch"               , tr_bind_thing_v__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "kind"                  , tr_bind_thing_kind, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "hull_flags"            , tr_bind_thing_flags, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "hull_flags_"           , tr_bind_thing_flags_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "set_hull_flag"         , tr_bind_thing_set_flag, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "unset_hull_flag"       , tr_bind_thing_unset_flag, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "group"                 , tr_bind_thing_group, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "group_"                , tr_bind_thing_group_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "sprite_"               , tr_bind_state_thing_sprite_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "pose"                  , tr_bind_thing_pose, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "pose_"                 , tr_bind_thing_pose_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "pose_batch"            , tr_bind_thing_pose__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "direction"             , tr_bind_thing_direction, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "direction_"            , tr_bind_thing_direction_, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "direction_batch"       , tr_bind_thing_direction__batch, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "tint_rgba"             , tr_bind_thing_tint_layer, 6);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "hide_layer"            , tr_bind_thing_hide_layer, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "layer_hidden?"         , tr_bind_thing_layer_hidden, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "set_action_loop"       , tr_bind_thing_set_action_loop, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "get_action_loop"       , tr_bind_thing_get_action_loop, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "set_pose_direction_loop", tr_bind_thing_set_pose_direction_loop, 4);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "get_pose_direction_loop", tr_bind_thing_get_pose_direction_loop, 3);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "action_done?"          , tr_bind_thing_action_done, 2);
+}
+
+#endif
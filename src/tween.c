@@ -0,0 +1,330 @@
+#include "eruta.h"
+#include "scegra.h"
+#include "callrb.h"
+#include "tween.h"
+#include <string.h>
+
+/* A simple tween engine for the scene graph. A tween changes a property of
+ * a scene graph node from its current value to a target value over a given
+ * duration, following an easing curve. This is done on the C side so the
+ * scripts don't have to set the properties of the nodes themselves
+ * every frame.
+ *
+ * The active tweens are kept in a compact array that is advanced in one pass
+ * by tween_update, which scegra_update calls. A node can have only one tween
+ * per property, starting a new one replaces the old one.
+ */
+
+struct Tween_ {
+  int    node;
+  int    prop;
+  int    ease;
+  int    loop;
+  /* Amount of loops left to do, negative means loop forever. */
+  int    loops;
+  int    notify;
+  int    started;
+  int    size;
+  float  from[SCEGRA_PROP_VALUES_MAX];
+  float  to[SCEGRA_PROP_VALUES_MAX];
+  double delay;
+  double duration;
+  double time;
+};
+
+typedef struct Tween_ Tween;
+
+/* Notifications that are to be sent to the scripts after the update pass. */
+struct TweenNotice_ {
+  int node;
+  int prop;
+  int kind;
+};
+
+/* Static storage for the tweens. Only the first tween_used are active. */
+static Tween  tween_tracks[TWEEN_TRACKS_MAX];
+static int    tween_used = 0;
+
+static struct TweenNotice_ tween_notices[TWEEN_TRACKS_MAX];
+static int    tween_notices_used = 0;
+
+
+/* Bounce easing helper. */
+static double tween_bounce_out(double t) {
+  if (t < (1.0 / 2.75)) {
+    return 7.5625 * t * t;
+  } else if (t < (2.0 / 2.75)) {
+    t -= (1.5 / 2.75);
+    return 7.5625 * t * t + 0.75;
+  } else if (t < (2.5 / 2.75)) {
+    t -= (2.25 / 2.75);
+    return 7.5625 * t * t + 0.9375;
+  }
+  t -= (2.625 / 2.75);
+  return 7.5625 * t * t + 0.984375;
+}
+
+/** Applies the easing curve ease to t, which should be between 0 and 1.
+ * All curves return 0 for 0 and 1 for 1, but some may overshoot in between.
+ * Unknown curves are linear. */
+double tween_ease(int ease, double t) {
+  double u;
+  if (t <= 0.0) return 0.0;
+  if (t >= 1.0) return 1.0;
+  switch (ease) {
+    case TWEEN_EASE_QUAD_IN:
+      return t * t;
+    case TWEEN_EASE_QUAD_OUT:
+      return t * (2.0 - t);
+    case TWEEN_EASE_QUAD_INOUT:
+      if (t < 0.5) return 2.0 * t * t;
+      u = -2.0 * t + 2.0;
+      return 1.0 - u * u / 2.0;
+    case TWEEN_EASE_CUBIC_IN:
+      return t * t * t;
+    case TWEEN_EASE_CUBIC_OUT:
+      u = 1.0 - t;
+      return 1.0 - u * u * u;
+    case TWEEN_EASE_CUBIC_INOUT:
+      if (t < 0.5) return 4.0 * t * t * t;
+      u = -2.0 * t + 2.0;
+      return 1.0 - u * u * u / 2.0;
+    case TWEEN_EASE_SINE_IN:
+      return 1.0 - cos(t * ALLEGRO_PI / 2.0);
+    case TWEEN_EASE_SINE_OUT:
+      return sin(t * ALLEGRO_PI / 2.0);
+    case TWEEN_EASE_SINE_INOUT:
+      return -(cos(ALLEGRO_PI * t) - 1.0) / 2.0;
+    case TWEEN_EASE_BACK_OUT:
+      u = t - 1.0;
+      return 1.0 + 2.70158 * u * u * u + 1.70158 * u * u;
+    case TWEEN_EASE_ELASTIC_OUT:
+      return pow(2.0, -10.0 * t) *
+             sin((t * 10.0 - 0.75) * (2.0 * ALLEGRO_PI / 3.0)) + 1.0;
+    case TWEEN_EASE_BOUNCE_OUT:
+      return tween_bounce_out(t);
+    case TWEEN_EASE_LINEAR:
+    default:
+      return t;
+  }
+}
+
+/* Initializes the tween engine. */
+void tween_init() {
+  tween_used         = 0;
+  tween_notices_used = 0;
+}
+
+/* Stops all tweens. */
+void tween_done() {
+  tween_used         = 0;
+  tween_notices_used = 0;
+}
+
+/* Returns the index of the tween of property prop of the node,
+ * or negative if not found. */
+static int tween_find(int node, int prop) {
+  int index;
+  for (index = 0; index < tween_used; index++) {
+    Tween * tween = tween_tracks + index;
+    if ((tween->node == node) && (tween->prop == prop)) return index;
+  }
+  return -1;
+}
+
+/* Removes the tween at index by moving the last tween in its place. */
+static void tween_remove(int index) {
+  tween_used--;
+  if (index < tween_used) {
+    tween_tracks[index] = tween_tracks[tween_used];
+  }
+}
+
+/* Queues a notification for the scripts, if the tween wants them. */
+static void tween_notice(Tween * tween, int kind) {
+  struct TweenNotice_ * notice;
+  if (!tween->notify) return;
+  if (tween_notices_used >= TWEEN_TRACKS_MAX) return;
+  notice        = tween_notices + tween_notices_used;
+  notice->node  = tween->node;
+  notice->prop  = tween->prop;
+  notice->kind  = kind;
+  tween_notices_used++;
+}
+
+/* Applies the tween to its node according to its current time.
+ * Returns the progress between 0 and 1, or negative if the node is gone. */
+static double tween_apply(Tween * tween) {
+  float  values[SCEGRA_PROP_VALUES_MAX];
+  double progress, eased;
+  int    index;
+
+  if ((tween->duration <= 0.0) || (tween->time >= tween->duration)) {
+    progress = 1.0;
+  } else {
+    progress = tween->time / tween->duration;
+  }
+
+  eased = tween_ease(tween->ease, progress);
+  for (index = 0; index < tween->size; index++) {
+    values[index] = tween->from[index] +
+                    (tween->to[index] - tween->from[index]) * eased;
+  }
+  if (scegra_property_(tween->node, tween->prop, values) < 0) return -1.0;
+  return progress;
+}
+
+/* Advances a single tween and applies it to its node.
+ * Returns true if the tween is finished and should be removed. */
+static int tween_advance(Tween * tween, double dt) {
+  double progress;
+  int    index;
+
+  if (tween->delay > 0.0) {
+    tween->delay -= dt;
+    if (tween->delay > 0.0) return FALSE;
+    /* Use the remainder of the time step after the delay ran out. */
+    dt           = -tween->delay;
+    tween->delay = 0.0;
+  }
+
+  /* Start from the value the property has when the delay runs out,
+   * so tweens can be queued one after the other with delays. */
+  if (!tween->started) {
+    if (scegra_property(tween->node, tween->prop, tween->from) < 0) return TRUE;
+    tween->started = TRUE;
+  }
+
+  tween->time += dt;
+  progress     = tween_apply(tween);
+  /* If the node went away, so does the tween. */
+  if (progress < 0.0) return TRUE;
+  if (progress < 1.0) return FALSE;
+
+  /* At the end now, see if we must loop. */
+  if ((tween->loop == TWEEN_LOOP_NONE) || (tween->loops == 0)) {
+    tween_notice(tween, TWEEN_EVENT_DONE);
+    return TRUE;
+  }
+
+  if (tween->loops > 0) tween->loops--;
+
+  if (tween->loop == TWEEN_LOOP_PINGPONG) {
+    for (index = 0; index < tween->size; index++) {
+      float aid          = tween->from[index];
+      tween->from[index] = tween->to[index];
+      tween->to[index]   = aid;
+    }
+  }
+
+  /* Carry over the time left into the next loop, but at most one loop,
+   * so a long frame doesn't make us skip loops without notice. */
+  if (tween->duration > 0.0) {
+    tween->time -= tween->duration;
+    if (tween->time >= tween->duration) tween->time = 0.0;
+  } else {
+    tween->time  = 0.0;
+  }
+  tween_apply(tween);
+  tween_notice(tween, TWEEN_EVENT_LOOP);
+  return FALSE;
+}
+
+/** Advances all active tweens by dt seconds. Then sends the done and loop
+ * notifications to the scripts, so they are free to start or stop tweens
+ * from their callbacks. */
+void tween_update(double dt) {
+  int index = 0;
+
+  while (index < tween_used) {
+    if (tween_advance(tween_tracks + index, dt)) {
+      tween_remove(index);
+    } else {
+      index++;
+    }
+  }
+
+  for (index = 0; index < tween_notices_used; index++) {
+    struct TweenNotice_ * notice = tween_notices + index;
+    callrb_tween_event(notice->node, notice->prop, notice->kind);
+  }
+  tween_notices_used = 0;
+}
+
+/** Starts a tween of the property prop of the scene graph node node towards
+ * the values in to, which must contain scegra_property_size(prop) floats.
+ * The tween starts after delay seconds and takes duration seconds.
+ * loop is one of the TWEEN_LOOP_ values, and loops is the amount of times to
+ * loop, negative for forever. If notify is true, eruta_on_tween will be
+ * called when the tween loops or is done. Replaces any existing tween
+ * of the same property of the same node.
+ * Returns the node on success or negative on failure. */
+int tween_start(int node, int prop, const float * to, double duration,
+                double delay, int ease, int loop, int loops, int notify) {
+  Tween * tween;
+  int size, index;
+
+  if (!to) return -3;
+  if (scegra_get_id(node) < 0) return scegra_get_id(node);
+  size = scegra_property_size(prop);
+  if (size < 0) return size;
+
+  index = tween_find(node, prop);
+  if (index < 0) {
+    if (tween_used >= TWEEN_TRACKS_MAX) return -4;
+    index = tween_used;
+    tween_used++;
+  }
+
+  tween           = tween_tracks + index;
+  tween->node     = node;
+  tween->prop     = prop;
+  tween->size     = size;
+  tween->ease     = ease;
+  tween->loop     = loop;
+  tween->loops    = loops;
+  tween->notify   = notify;
+  tween->started  = FALSE;
+  tween->delay    = delay;
+  tween->duration = duration;
+  tween->time     = 0.0;
+  memset(tween->from, 0, sizeof(tween->from));
+  memset(tween->to  , 0, sizeof(tween->to));
+  memcpy(tween->to  , to, sizeof(float) * size);
+  return node;
+}
+
+/** Stops the tween of the property prop of the node, leaving the property
+ * at its current value. Returns the node, or negative if there was no
+ * such tween. */
+int tween_stop(int node, int prop) {
+  int index = tween_find(node, prop);
+  if (index < 0) return -1;
+  tween_remove(index);
+  return node;
+}
+
+/** Stops all tweens of the node. Returns the amount of tweens stopped. */
+int tween_stop_node(int node) {
+  int index   = 0;
+  int stopped = 0;
+  while (index < tween_used) {
+    if (tween_tracks[index].node == node) {
+      tween_remove(index);
+      stopped++;
+    } else {
+      index++;
+    }
+  }
+  return stopped;
+}
+
+/** Returns true if the property prop of the node is being tweened. */
+int tween_active_p(int node, int prop) {
+  return tween_find(node, prop) >= 0;
+}
+
+/** Returns the amount of active tweens. */
+int tween_count() {
+  return tween_used;
+}
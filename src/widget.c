@@ -9,6 +9,7 @@
 #include "widget.h"
 #include "draw.h"
 #include "bad.h"
+#include <string.h>
 
 
 /*
@@ -554,12 +555,27 @@ struct BBWidgetChoose_ {
 
 
 
+/* A line of text in the scrollback of the console, together with the byte
+ * offsets at which each of its wrapped rows starts. The wrapping is done
+ * once, when the line is added, or when the width or font of the console
+ * changes, so drawing doesn't have to split up the text again. */
+struct BBConsoleLine_ {
+  USTR    * text;
+  int     * rows;
+  int       nrows;
+  int       rows_size;
+};
+
 /* A console is a console for command-line interaction and error display. When it's active it captures all input (as long as it's active) */
 struct BBConsole_ {
   BBWidget  widget;
-  USTRList  text;
-  int       count;
+  struct BBConsoleLine_ * lines; // ring buffer of max lines of scrollback.
+  int       first;      // index in lines of the oldest line.
+  int       count;      // amount of lines in use.
   int       max;
+  int       total_rows; // sum of the wrapped rows of all lines.
+  int       wrapw;      // width the lines are currently wrapped for.
+  Font    * wrapfont;   // font the lines are currently wrapped with.
   int       start;
   int       charw;
   int       cursor;
@@ -594,53 +610,126 @@ int bbconsole_docommand(BBConsole * self, const char * text) {
 
 
 
+/* Width available for the text of the console. */
+static int bbconsole_textw(BBConsole * self) {
+  return bbwidget_w(&self->widget) - 10;
+}
+
+/* Stores the byte offset at which a new wrapped row of line starts. */
+static void bbconsoleline_addrow(struct BBConsoleLine_ * line, int offset) {
+  if (line->nrows >= line->rows_size) {
+    int newsize     = (line->rows_size < 1) ? 4 : line->rows_size * 2;
+    line->rows      = mem_realloc(line->rows, newsize * sizeof(int));
+    line->rows_size = newsize;
+  }
+  line->rows[line->nrows] = offset;
+  line->nrows++;
+}
+
+/* Splits the line up in rows that fit in maxwidth when drawn with font.
+ * Every word, including the space after it, is measured only once, so this
+ * takes time in proportion to the length of the line. A word that is too
+ * long to fit on a row is not split up but gets a row of it's own. */
+static int bbconsoleline_wrap(struct BBConsoleLine_ * line, Font * font,
+                              int maxwidth) {
+  USTR_INFO uinfo;
+  int pos = 0, rowstart = 0, roww = 0;
+  int size = ustr_size(line->text);
+  line->nrows = 0;
+  bbconsoleline_addrow(line, 0);
+  if (!font) return line->nrows;
+  while (pos < size) {
+    int wordw;
+    int stop = ustr_findchr(line->text, pos, ' ');
+    stop     = (stop < 0) ? size : stop + 1;
+    wordw    = al_get_ustr_width(font,
+                                 ustr_refustr(&uinfo, line->text, pos, stop));
+    if (((roww + wordw) > maxwidth) && (pos > rowstart)) {
+      bbconsoleline_addrow(line, pos);
+      rowstart = pos;
+      roww     = 0;
+    }
+    roww += wordw;
+    pos   = stop;
+  }
+  return line->nrows;
+}
+
+/* Returns the line that is index lines older than the newest one. No checks. */
+static struct BBConsoleLine_ * bbconsole_line(BBConsole * self, int index) {
+  return self->lines + ((self->first + self->count - 1 - index) % self->max);
+}
+
+/* Wraps all lines again if the width or the font of the console changed. */
+static void bbconsole_rewrap(BBConsole * self) {
+  int index;
+  Font * font = bbwidget_font(&self->widget);
+  int    textw = bbconsole_textw(self);
+  if ((self->wrapw == textw) && (self->wrapfont == font)) return;
+  self->wrapw      = textw;
+  self->wrapfont   = font;
+  self->total_rows = 0;
+  for (index = 0; index < self->count; index++) {
+    struct BBConsoleLine_ * line = bbconsole_line(self, index);
+    self->total_rows += bbconsoleline_wrap(line, font, textw);
+  }
+  self->start = bad_clampi(self->start, 0, self->total_rows);
+}
+
+/* Adds size bytes of buf as a new line to the console, dropping the oldest
+ * line if the scrollback is full. Returns the amount of lines. */
+static int bbconsole_addbuffer(BBConsole * self, const char * buf, int size) {
+  struct BBConsoleLine_ * line;
+  USTR_INFO uinfo;
+  if (!self->lines) return -3;
+  bbconsole_rewrap(self);
+  if (self->count >= self->max) {
+    /* Reuse the oldest line. */
+    line = self->lines + self->first;
+    self->total_rows -= line->nrows;
+    self->first       = (self->first + 1) % self->max;
+    self->count--;
+  } else {
+    line = self->lines + ((self->first + self->count) % self->max);
+  }
+  if (line->text) {
+    ustr_set(line->text, ustr_refbuffer(&uinfo, buf, size));
+  } else {
+    line->text = ustr_newbuffer(buf, size);
+    if (!line->text) return -3;
+  }
+  self->count++;
+  self->total_rows += bbconsoleline_wrap(line, self->wrapfont, self->wrapw);
+  self->start = bad_clampi(self->start, 0, self->total_rows);
+  return self->count;
+}
+
 /** Adds a line of text to the console. */
 int bbconsole_addstr(BBConsole * self, const char * str) {
   if(!self) return -1;
-  if(!ustrlist_shiftcstr(&self->text, str)) { 
-    return -3;
-  }  
-  while(ustrlist_size(&self->text) >= self->max) { // remove last node(s)
-    ustrlist_droplast(&self->text);
-  }
-  return ustrlist_size(&self->text);
+  return bbconsole_addbuffer(self, str, strlen(str));
 }
 
 /** Adds a line of text to the console. */
 int bbconsole_addustr(BBConsole * self, const USTR * ustr) {
   if(!self) return -1;
-  if(!ustrlist_shiftustr(&self->text, ustr)) { 
-    return -3;
-  }  
-  while(ustrlist_size(&self->text) >= self->max) { // remove last node(s)
-    ustrlist_droplast(&self->text);
-  }
-  return ustrlist_size(&self->text);
+  return bbconsole_addbuffer(self, ustr_c(ustr), ustr_size(ustr));
 }
 
 
-/** Puts a string on the console .*/
+/** Puts a string on the console. Every newline in it starts a new line.
+Returns the amount of lines added. */
 int bbconsole_puts(BBConsole * self, const char * str) {
-  int index;
-  int size     = strlen(str);
-  int leftsize = size;
+  const char * stop;
   int lines = 0;
-  USTR_INFO uinfo;
-  BBTextInfo info = { 0, 0, 0, 0};
-  info.maxwidth   = bbwidget_w(&self->widget) - 10;
-  USTR * ustr;
-  const USTR * uline;
-  ustr = ustr_new(str);
-  while(bbtextinfo_linefromtext(&info, ustr, self->widget.style.font)) {
-    uline = bbtextinfo_refustr(&info, &uinfo, ustr);
-    bbconsole_addustr(self, uline);
-    // don't forget to skip to next line!!!
-    bbtextinfo_next(&info);
+  if(!self) return -1;
+  while ((stop = strchr(str, '\n'))) {
+    bbconsole_addbuffer(self, str, stop - str);
+    str = stop + 1;
+    lines++;
   }
-  uline = bbtextinfo_refustr(&info, &uinfo, ustr);
-  bbconsole_addustr(self, uline);
-  ustr_free(ustr);
-  return lines;
+  bbconsole_addbuffer(self, str, strlen(str));
+  return lines + 1;
 } 
 
 #define BBCONSOLE_VPRINTF_MAX 1024
@@ -663,19 +752,21 @@ int bbconsole_printf(BBConsole * self, const char * format, ...) {
 }
 
 
-/** Draws a console. */
+/** Draws a console. Only the rows of text that are visible are drawn. */
 int bbconsole_draw(BBWidget * widget, void * data) {
   BBConsole * self  ;
   Font * font       ;
   Color color       ;
-  USTRListNode * now;
-  int high, linehigh, index, x, y, skip;
+  struct BBConsoleLine_ * line;
+  USTR_INFO uinfo;
+  int high, linehigh, index, x, y, skip, lineindex, row;
   int linew;
   if (!bbwidget_visible(widget)) return BBWIDGET_HANDLE_IGNORE;
   
   self  = bbwidget_console(widget);
   font  = bbwidget_font(widget);
   color = bbwidget_forecolor(widget);
+  bbconsole_rewrap(self);
   
   bbwidget_drawroundframe(widget);
   high        = bbwidget_h(widget) - 10;
@@ -683,18 +774,34 @@ int bbconsole_draw(BBWidget * widget, void * data) {
   y           = bbwidget_y(widget) -  5;
   linehigh    = font_lineheight(font);
   
-  now         = ustrlist_head(&self->text);
-  // skip start lines (to allow scrolling backwards) 
-  now         = ustrlist_skipnode(&self->text, self->start);
+  // skip start rows (to allow scrolling backwards), whole lines at a time.
+  skip        = self->start;
+  lineindex   = 0;
+  while ((lineindex < self->count) &&
+         (skip >= bbconsole_line(self, lineindex)->nrows)) {
+    skip -= bbconsole_line(self, lineindex)->nrows;
+    lineindex++;
+  }
+  line        = NULL;
+  row         = 0;
+  if (lineindex < self->count) {
+    line      = bbconsole_line(self, lineindex);
+    row       = line->nrows - 1 - skip;
+  }
   
   for (index = high-(linehigh*2); index > 0; index -= linehigh) {
-    USTR * textstr;
-    if(!now) break;
-    textstr = ustrlistnode_ustr(now);
-    if(textstr) {
-      font_drawstr(font, color, x, y + index, 0, textstr);
+    int rowstop;
+    if(!line) break;
+    rowstop = (row + 1 < line->nrows) ? line->rows[row + 1] 
+                                      : (int)ustr_size(line->text);
+    font_drawstr(font, color, x, y + index, 0, 
+                 ustr_refustr(&uinfo, line->text, line->rows[row], rowstop));
+    row--;
+    if (row < 0) {
+      lineindex++;
+      line = (lineindex < self->count) ? bbconsole_line(self, lineindex) : NULL;
+      if (line) row = line->nrows - 1;
     }
-    now = ustrlistnode_next(now);
   }
   // draw input string
   font_drawstr(font, color, x, y + high - linehigh, 0, self->input);
@@ -703,10 +810,18 @@ int bbconsole_draw(BBWidget * widget, void * data) {
   al_draw_line(x + linew, y + high - linehigh, x + linew, y + high, color, 1);
   // draw start for debugging
   al_draw_textf(font, color, x, y, 0, "start: %d, size: %d", self->start, 
-                ustrlist_size(&self->text));
+                self->total_rows);
   return BBWIDGET_HANDLE_OK;
 }
 
+/** Returns the amount of rows of text the lines of the console are wrapped
+into at the console's current width. */
+int bbconsole_rows(BBConsole * self) {
+  if(!self) return -1;
+  bbconsole_rewrap(self);
+  return self->total_rows;
+}
+
 /** Activates or deactivates the console. */
 void bbconsole_active_(BBConsole * self, int active) {
   if(!self) return;
@@ -724,8 +839,8 @@ int bbconsole_scroll(BBConsole * self, int direction) {
   if((!self) || (!direction)) return FALSE;
   if(direction < 0) self->start--;
   if(direction > 0) self->start++;
-  /* Clamp start between 0 and size of list. */
-  self->start = bad_clampi(self->start, 0, ustrlist_size(&self->text));
+  /* Clamp start between 0 and the amount of wrapped rows. */
+  self->start = bad_clampi(self->start, 0, self->total_rows);
   return BBWIDGET_HANDLE_OK;
 }
 
@@ -830,12 +945,19 @@ int bbconsole_handle(BBWidget * widget, ALLEGRO_EVENT * event) {
 /** Cleans up a console. */
 int bbconsole_done(BBWidget * widget, void * data) {
   BBConsole * self = bbwidget_console(widget);
-  Lilis * aid;
+  int index;
   if(!self) return BBWIDGET_HANDLE_IGNORE;
   self->buf     = mem_free(self->buf);
   ustr_free(self->input);
   self->input   = NULL;
-  ustrlist_done(&self->text);
+  if (self->lines) {
+    for (index = 0; index < self->max; index++) {
+      if (self->lines[index].text) ustr_free(self->lines[index].text);
+      mem_free(self->lines[index].rows);
+    }
+  }
+  self->lines   = mem_free(self->lines);
+  self->count   = 0;
   return BBWIDGET_HANDLE_OK;
 }
 
@@ -862,12 +984,17 @@ BBConsole * bbconsole_initall(BBConsole * self, int id, Rebox bounds, Style styl
   if(!bbwidget_initall(&self->widget, id, bbconsole_actions, bounds, style)) { 
     return NULL;
   }
-  ustrlist_init(&self->text);
-  // ustrlist_shiftcstr(&self->text, "empty line");
   bbwidget_active_(&self->widget, FALSE);
   self->count = 0;
+  self->first = 0;
   // max MUST be at least 2, 3 to see anything...
   self->max   = BBCONSOLE_MAX;
+  self->lines = STRUCT_NALLOC(struct BBConsoleLine_, self->max);
+  if(!self->lines) { bbconsole_done(&self->widget, NULL); return NULL; }
+  self->total_rows = 0;
+  /* Force wrapping to be set up on the first line. */
+  self->wrapw    = -1;
+  self->wrapfont = NULL;
   self->start = 0;
   self->charw = 80; 
   self->buf   = mem_alloc(self->charw + 1);
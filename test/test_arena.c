@@ -0,0 +1,59 @@
+/**
+* This is a test for arena in $package$
+*/
+#include "si_test.h"
+#include "arena.h"
+#include "mem.h"
+
+
+TEST_FUNC(arena) {
+  Arena      * arena;
+  ArenaStats   stats;
+  int        * small, * other, * big, * grown;
+  int index;
+  arena = arena_new(256);
+  TEST_NOTNULL(arena);
+  TEST_TRUE(arena_stats(arena, &stats));
+  TEST_LONGEQ(0, stats.blocks);
+  small = ARENA_NALLOC(arena, int, 4);
+  other = ARENA_NALLOC(arena, int, 4);
+  TEST_NOTNULL(small);
+  TEST_NOTNULL(other);
+  TEST_INTEQ(0, small[3]);
+  for (index = 0; index < 4; index++) small[index] = index + 1;
+  TEST_INTEQ(0, other[0]);
+  TEST_TRUE(arena_stats(arena, &stats));
+  TEST_LONGEQ(1, stats.blocks);
+  TEST_LONGEQ(2, stats.allocations);
+  /* Larger than a block gets a block of it's own, and the first block is 
+   * still used afterwards. */
+  big   = ARENA_NALLOC(arena, int, 1000);
+  TEST_NOTNULL(big);
+  TEST_NOTNULL(ARENA_ALLOC(arena, int));
+  TEST_TRUE(arena_stats(arena, &stats));
+  TEST_LONGEQ(2, stats.blocks);
+  grown = arena_reallocate(arena, small, 4 * sizeof(int), 8 * sizeof(int));
+  TEST_NOTNULL(grown);
+  TEST_INTEQ(4, grown[3]);
+  TEST_INTEQ(0, grown[7]);
+  /* Without an arena, reallocate uses the heap. */
+  grown = arena_reallocate(NULL, NULL, 0, 8 * sizeof(int));
+  TEST_NOTNULL(grown);
+  TEST_INTEQ(0, grown[7]);
+  mem_free(grown);
+  TEST_NOTNULL(arena_done(arena));
+  TEST_TRUE(arena_stats(arena, &stats));
+  TEST_LONGEQ(0, stats.bytes);
+  TEST_NULL(arena_free(arena));
+  TEST_FALSE(arena_stats(NULL, &stats));
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(arena);
+  TEST_REPORT();
+}
+
+
@@ -0,0 +1,61 @@
+/**
+* This is a test for atlas in $package$
+*/
+#include "si_test.h"
+#include "atlas.h"
+
+
+TEST_FUNC(skyline) {
+  Skyline skyline;
+  int x = -1, y = -1;
+  TEST_NOTNULL(skyline_init(&skyline, 100, 50));
+  TEST_TRUE(skyline_insert(&skyline, 60, 20, &x, &y));
+  TEST_INTEQ(0, x);
+  TEST_INTEQ(0, y);
+  /* Goes right of the first one, since that's lower. */
+  TEST_TRUE(skyline_insert(&skyline, 40, 10, &x, &y));
+  TEST_INTEQ(60, x);
+  TEST_INTEQ(0, y);
+  /* Goes on top of the lowest part of the skyline. */
+  TEST_TRUE(skyline_insert(&skyline, 40, 10, &x, &y));
+  TEST_INTEQ(60, x);
+  TEST_INTEQ(10, y);
+  /* Both top parts are now at 20, so they are merged. */
+  TEST_INTEQ(1, skyline.used);
+  TEST_TRUE(skyline_insert(&skyline, 100, 30, &x, &y));
+  TEST_INTEQ(0, x);
+  TEST_INTEQ(20, y);
+  /* Full now. */
+  TEST_FALSE(skyline_insert(&skyline, 1, 1, &x, &y));
+  TEST_LONGEQ(5000, skyline.area);
+  TEST_FALSE(skyline_insert(&skyline, 101, 1, &x, &y));
+  skyline_done(&skyline);
+  TEST_DONE();
+}
+
+TEST_FUNC(atlas_alpha_bounds) {
+  /* 4 by 3 pixels of 2 bytes, of which the second is the alpha. */
+  unsigned char pixels[3][8] = {
+    { 9, 0,  9, 0,  9, 0,  9, 0 },
+    { 9, 0,  9, 1,  9, 0,  9, 0 },
+    { 9, 0,  9, 0,  9, 5,  9, 0 }
+  };
+  int bx = -1, by = -1, bw = -1, bh = -1;
+  TEST_TRUE(atlas_alpha_bounds(&pixels[0][1], 8, 2, 4, 3, &bx, &by, &bw, &bh));
+  TEST_INTEQ(1, bx);
+  TEST_INTEQ(1, by);
+  TEST_INTEQ(2, bw);
+  TEST_INTEQ(2, bh);
+  pixels[1][3] = 0;
+  pixels[2][5] = 0;
+  TEST_FALSE(atlas_alpha_bounds(&pixels[0][1], 8, 2, 4, 3, &bx, &by, &bw, &bh));
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(skyline);
+  TEST_RUN(atlas_alpha_bounds);
+  TEST_REPORT();
+}
@@ -0,0 +1,143 @@
+/**
+* This is a test for cook in $package$
+*/
+#include "si_test.h"
+#include "cook.h"
+#include <string.h>
+
+#define TEST_COOK_IMAGE   "test_cook.png"
+#define TEST_COOK_SIZE    512
+#define TEST_COOK_ROUNDS  20
+
+/* Makes a memory bitmap with a pattern that doesn't compress too well. */
+static ALLEGRO_BITMAP * test_cook_bitmap(int w, int h) {
+  ALLEGRO_BITMAP * bitmap;
+  int x, y;
+  al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+  bitmap = al_create_bitmap(w, h);
+  if (!bitmap) return NULL;
+  al_lock_bitmap(bitmap, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_WRITEONLY);
+  al_set_target_bitmap(bitmap);
+  for (y = 0; y < h; y++) {
+    for (x = 0; x < w; x++) {
+      al_put_pixel(x, y, al_map_rgba(x * 7, y * 3, (x ^ y), 255));
+    }
+  }
+  al_unlock_bitmap(bitmap);
+  return bitmap;
+}
+
+/* Returns true if both bitmaps have the same size and pixels. */
+static bool test_cook_same(ALLEGRO_BITMAP * one, ALLEGRO_BITMAP * two) {
+  int x, y, w, h;
+  w = al_get_bitmap_width(one);
+  h = al_get_bitmap_height(one);
+  if ((w != al_get_bitmap_width(two)) || (h != al_get_bitmap_height(two))) {
+    return false;
+  }
+  for (y = 0; y < h; y++) {
+    for (x = 0; x < w; x++) {
+      ALLEGRO_COLOR c1 = al_get_pixel(one, x, y);
+      ALLEGRO_COLOR c2 = al_get_pixel(two, x, y);
+      if (memcmp(&c1, &c2, sizeof(c1)) != 0) return false;
+    }
+  }
+  return true;
+}
+
+
+TEST_FUNC(cook) {
+  ALLEGRO_BITMAP * bitmap, * loaded;
+  char cooked[64];
+  al_init();
+  al_init_image_addon();
+  bitmap = test_cook_bitmap(37, 21);
+  TEST_NOTNULL(bitmap);
+  TEST_TRUE(cook_save_bitmap("test_cook_store.tmp", bitmap, COOK_STORE));
+  TEST_TRUE(cook_save_bitmap("test_cook_deflate.tmp", bitmap, COOK_DEFLATE));
+  TEST_FALSE(cook_save_bitmap("test_cook_bad.tmp", bitmap, 7));
+  loaded = cook_load_bitmap("test_cook_store.tmp");
+  TEST_NOTNULL(loaded);
+  TEST_TRUE(test_cook_same(bitmap, loaded));
+  al_destroy_bitmap(loaded);
+  loaded = cook_load_bitmap("test_cook_deflate.tmp");
+  TEST_NOTNULL(loaded);
+  TEST_TRUE(test_cook_same(bitmap, loaded));
+  al_destroy_bitmap(loaded);
+  /* Not a cooked texture. */
+  TEST_NULL(cook_load_bitmap("test_cook_missing.tmp"));
+  TEST_TRUE(cook_source_ok("image/tile/tiles.PNG"));
+  TEST_TRUE(cook_source_ok("texture/sky.jpg"));
+  TEST_FALSE(cook_source_ok("sprite/sprite_woman.xcf"));
+  TEST_FALSE(cook_source_ok("image/tile/tiles.png" COOK_EXTENSION));
+  TEST_STREQ("image/a.png" COOK_EXTENSION,
+             cook_vpath(cooked, sizeof(cooked), "image/a.png"));
+  TEST_NULL(cook_vpath(cooked, 8, "image/a.png"));
+  TEST_TRUE(cook_flags_ok(0));
+  TEST_FALSE(cook_flags_ok(ALLEGRO_NO_PREMULTIPLIED_ALPHA));
+  TEST_TRUE(cook_fresh("test_cook_missing.png", "test_cook_store.tmp"));
+  TEST_FALSE(cook_fresh("test_cook_store.tmp", "test_cook_missing.tmp"));
+  al_destroy_bitmap(bitmap);
+  remove("test_cook_store.tmp");
+  remove("test_cook_deflate.tmp");
+  TEST_DONE();
+}
+
+/* Compares loading a PNG image with loading its cooked texture. Only checks
+ * the pixels, the times are informational. */
+TEST_FUNC(cook_bench) {
+  ALLEGRO_BITMAP * bitmap, * loaded;
+  char cooked[64];
+  double start, png_time, store_time, deflate_time;
+  int round;
+  al_init();
+  al_init_image_addon();
+  bitmap = test_cook_bitmap(TEST_COOK_SIZE, TEST_COOK_SIZE);
+  TEST_NOTNULL(bitmap);
+  TEST_TRUE(al_save_bitmap(TEST_COOK_IMAGE, bitmap));
+  TEST_TRUE(cook_file(TEST_COOK_IMAGE, COOK_STORE));
+  cook_vpath(cooked, sizeof(cooked), TEST_COOK_IMAGE);
+  TEST_TRUE(cook_fresh(TEST_COOK_IMAGE, cooked));
+
+  start = al_get_time();
+  for (round = 0; round < TEST_COOK_ROUNDS; round++) {
+    loaded = al_load_bitmap(TEST_COOK_IMAGE);
+    if (loaded) al_destroy_bitmap(loaded);
+  }
+  png_time = al_get_time() - start;
+
+  start = al_get_time();
+  for (round = 0; round < TEST_COOK_ROUNDS; round++) {
+    loaded = cook_load_bitmap(cooked);
+    if (round < (TEST_COOK_ROUNDS - 1)) al_destroy_bitmap(loaded);
+  }
+  store_time = al_get_time() - start;
+  TEST_TRUE(test_cook_same(bitmap, loaded));
+  al_destroy_bitmap(loaded);
+
+  TEST_TRUE(cook_file(TEST_COOK_IMAGE, COOK_DEFLATE));
+  start = al_get_time();
+  for (round = 0; round < TEST_COOK_ROUNDS; round++) {
+    loaded = cook_load_bitmap(cooked);
+    if (round < (TEST_COOK_ROUNDS - 1)) al_destroy_bitmap(loaded);
+  }
+  deflate_time = al_get_time() - start;
+  TEST_TRUE(test_cook_same(bitmap, loaded));
+  al_destroy_bitmap(loaded);
+
+  printf("%d loads of %dx%d: png %f s, cooked %f s, cooked deflate %f s\n",
+         TEST_COOK_ROUNDS, TEST_COOK_SIZE, TEST_COOK_SIZE,
+         png_time, store_time, deflate_time);
+  al_destroy_bitmap(bitmap);
+  remove(TEST_COOK_IMAGE);
+  remove(cooked);
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(cook);
+  TEST_RUN(cook_bench);
+  TEST_REPORT();
+}
@@ -0,0 +1,65 @@
+/**
+* This is a test for framecache in $package$
+*/
+#include "si_test.h"
+#include "framecache.h"
+#include <string.h>
+
+
+TEST_FUNC(framecache) {
+  FrameCacheKey   key1, key2, key3;
+  FrameCacheStats stats;
+  Point           origin = bevec(0.0, 0.0);
+  uint32_t        hash1, hash2, hash3;
+  int             sprite1, sprite2;
+  al_init();
+  /* Bitmaps of 10 by 10 take 400 bytes, so 2 fit in the budget. */
+  TEST_LONGEQ(1000, framecache_budget_(1000));
+  memset(&key1, 0, sizeof(key1));
+  key1.sprite = &sprite1;
+  key1.action = 1;
+  key1.frame  = 2;
+  key2        = key1;
+  key2.tinted = 1;
+  key2.tints[0] = 0xff0000ff;
+  key3        = key1;
+  key3.sprite = &sprite2;
+  hash1 = framecache_hash(&key1, framecache_config_hash(&key1));
+  hash2 = framecache_hash(&key2, framecache_config_hash(&key2));
+  hash3 = framecache_hash(&key3, framecache_config_hash(&key3));
+  TEST_NULL(framecache_get(&key1, hash1, &origin));
+  TEST_NOTNULL(framecache_put(&key1, hash1, al_create_bitmap(10, 10), bevec(-5, -7)));
+  TEST_NOTNULL(framecache_put(&key2, hash2, al_create_bitmap(10, 10), bevec(0, 0)));
+  TEST_NOTNULL(framecache_get(&key1, hash1, &origin));
+  TEST_FLOATEQ(-5.0, origin.x);
+  TEST_FLOATEQ(-7.0, origin.y);
+  /* key2 is the least recently used, so it's evicted. */
+  TEST_NOTNULL(framecache_put(&key3, hash3, al_create_bitmap(10, 10), bevec(0, 0)));
+  TEST_NULL(framecache_get(&key2, hash2, &origin));
+  TEST_NOTNULL(framecache_get(&key1, hash1, &origin));
+  TEST_TRUE(framecache_stats(&stats));
+  TEST_LONGEQ(1, stats.evictions);
+  TEST_LONGEQ(800, stats.bytes);
+  TEST_INTEQ(2, stats.entries);
+  /* Too large for the budget. */
+  TEST_TRUE(framecache_fits(10, 10));
+  TEST_FALSE(framecache_fits(20, 20));
+  TEST_NULL(framecache_put(&key2, hash2, al_create_bitmap(20, 20), bevec(0, 0)));
+  TEST_INTEQ(1, framecache_drop_sprite(&sprite1));
+  TEST_NULL(framecache_get(&key1, hash1, &origin));
+  framecache_done();
+  TEST_TRUE(framecache_stats(&stats));
+  TEST_LONGEQ(0, stats.bytes);
+  TEST_INTEQ(0, stats.entries);
+  /* Nothing fits when the cache is disabled. */
+  TEST_LONGEQ(0, framecache_budget_(0));
+  TEST_FALSE(framecache_fits(1, 1));
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(framecache);
+  TEST_REPORT();
+}
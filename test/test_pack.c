@@ -0,0 +1,225 @@
+/**
+* This is a test for pack in $package$
+*/
+#include "si_test.h"
+#include "pack.h"
+#include "mem.h"
+#include <string.h>
+#include <time.h>
+
+#define TEST_PACK_FILE      "test_pack.tmp"
+#define TEST_PACK_BENCH     "test_pack_bench.tmp"
+#define TEST_PACK_FILES     200
+#define TEST_PACK_FILE_SIZE 4096
+#define TEST_PACK_ROUNDS    20
+
+/* "Eruta packs data files together. " 8 times, as raw deflate. */
+static const unsigned char test_pack_deflated[] = {
+  0x73, 0x2d, 0x2a, 0x2d, 0x49, 0x54, 0x28, 0x48, 0x4c, 0xce, 0x2e, 0x56,
+  0x48, 0x49, 0x04, 0x32, 0xd3, 0x32, 0x73, 0x52, 0x8b, 0x15, 0x4a, 0xf2,
+  0xd3, 0x53, 0x4b, 0x32, 0x52, 0x8b, 0xf4, 0x14, 0x5c, 0x47, 0x86, 0x02,
+  0x00
+};
+
+#define TEST_PACK_SENTENCE "Eruta packs data files together. "
+
+
+TEST_FUNC(pack) {
+  Pack       * pack;
+  PackSource   sources[3];
+  char       * data;
+  size_t       size;
+  char         expected[8 * sizeof(TEST_PACK_SENTENCE)];
+  int index;
+  expected[0] = '\0';
+  for (index = 0; index < 8; index++) strcat(expected, TEST_PACK_SENTENCE);
+  /* Unsorted on purpose, pack_write sorts them. */
+  sources[0].name        = "image/tile.png";
+  sources[0].data        = "PNGDATA";
+  sources[0].size        = 7;
+  sources[0].packed_size = 0;
+  sources[0].method      = PACK_STORE;
+  sources[1].name        = "font/text.txt";
+  sources[1].data        = test_pack_deflated;
+  sources[1].size        = strlen(expected);
+  sources[1].packed_size = sizeof(test_pack_deflated);
+  sources[1].method      = PACK_DEFLATE;
+  sources[2].name        = "audio/empty.wav";
+  sources[2].data        = "";
+  sources[2].size        = 0;
+  sources[2].packed_size = 0;
+  sources[2].method      = PACK_STORE;
+  TEST_TRUE(pack_write(TEST_PACK_FILE, 3, sources));
+  TEST_NULL(pack_open("test_pack_does_not_exist.tmp"));
+  pack = pack_open(TEST_PACK_FILE);
+  TEST_NOTNULL(pack);
+  TEST_INTEQ(3, pack_count(pack));
+  TEST_STREQ("audio/empty.wav", pack_name(pack, 0));
+  TEST_STREQ("image/tile.png", pack_name(pack, 2));
+  TEST_NULL((char *) pack_name(pack, 3));
+  TEST_INTEQ(1, pack_find(pack, "font/text.txt"));
+  TEST_TRUE(pack_find(pack, "font/missing.txt") < 0);
+  TEST_FALSE(pack_has(pack, "image"));
+  TEST_TRUE(pack_has(pack, "image/tile.png"));
+  data = (char *) pack_data(pack, "image/tile.png", &size);
+  TEST_NOTNULL(data);
+  TEST_INTEQ(7, (int) size);
+  TEST_MEMEQ("PNGDATA", 7, data);
+  /* Stored data is aligned in the pack. */
+  TEST_INTEQ(0, (int) (((size_t) data) % PACK_ALIGN));
+  TEST_FALSE(pack_forget(pack, "image/tile.png"));
+  data = (char *) pack_data(pack, "font/text.txt", &size);
+  TEST_NOTNULL(data);
+  TEST_INTEQ((int) strlen(expected), (int) size);
+  TEST_MEMEQ(expected, size, data);
+  /* Inflated once, and kept until every use is forgotten. */
+  TEST_PTREQ(data, (char *) pack_data(pack, "font/text.txt", NULL));
+  TEST_FALSE(pack_forget(pack, "font/text.txt"));
+  TEST_MEMEQ(expected, size, data);
+  TEST_TRUE(pack_forget(pack, "font/text.txt"));
+  TEST_FALSE(pack_forget(pack, "font/text.txt"));
+  data = (char *) pack_data(pack, "audio/empty.wav", &size);
+  TEST_NOTNULL(data);
+  TEST_INTEQ(0, (int) size);
+  TEST_NULL((char *) pack_data(pack, "audio/missing.wav", &size));
+  TEST_NULL(pack_close(pack));
+  remove(TEST_PACK_FILE);
+  TEST_DONE();
+}
+
+/* Writes a pack with one stored entry, changes the 32 bits little endian 
+ * number at offset in it to value, and truncates it to size bytes, or leaves
+ * the size as it is if size is negative. */
+static void test_pack_write_corrupt(size_t offset, uint32_t value, long size) {
+  PackSource     source;
+  unsigned char  buffer[256];
+  size_t         read;
+  FILE         * file;
+  source.name        = "image/tile.png";
+  source.data        = "PNGDATA";
+  source.size        = 7;
+  source.packed_size = 0;
+  source.method      = PACK_STORE;
+  pack_write(TEST_PACK_FILE, 1, &source);
+  file = fopen(TEST_PACK_FILE, "rb");
+  read = fread(buffer, 1, sizeof(buffer), file);
+  fclose(file);
+  buffer[offset]     = value & 0xff;
+  buffer[offset + 1] = (value >> 8)  & 0xff;
+  buffer[offset + 2] = (value >> 16) & 0xff;
+  buffer[offset + 3] = (value >> 24) & 0xff;
+  if ((size >= 0) && ((size_t) size < read)) read = size;
+  file = fopen(TEST_PACK_FILE, "wb");
+  fwrite(buffer, 1, read, file);
+  fclose(file);
+}
+
+/* Packs with entries that don't fit in them are rejected. */
+TEST_FUNC(pack_corrupt) {
+  const size_t entry = PACK_HEADER_SIZE;
+  Pack * pack;
+  /* Unchanged, to be sure the test pack itself is fine. */
+  test_pack_write_corrupt(entry + 24, 7, -1);
+  pack = pack_open(TEST_PACK_FILE);
+  TEST_NOTNULL(pack);
+  pack_close(pack);
+  /* A stored entry that claims to be larger than the data in the pack. */
+  test_pack_write_corrupt(entry + 24, 1000000, -1);
+  TEST_NULL(pack_open(TEST_PACK_FILE));
+  /* An entry that starts past the end of the pack. */
+  test_pack_write_corrupt(entry + 16, 0xfffffff0, -1);
+  TEST_NULL(pack_open(TEST_PACK_FILE));
+  /* A truncated pack. */
+  test_pack_write_corrupt(entry + 24, 7, PACK_HEADER_SIZE + PACK_ENTRY_SIZE + 20);
+  TEST_NULL(pack_open(TEST_PACK_FILE));
+  remove(TEST_PACK_FILE);
+  TEST_DONE();
+}
+
+/* Compares reading many small files one by one with getting them from a
+ * pack. Only checks the data, the times are informational. */
+TEST_FUNC(pack_bench) {
+  PackSource * sources;
+  char      ** names;
+  char       * content, * buffer;
+  Pack       * pack;
+  clock_t      start;
+  double       loose_time, pack_time;
+  long         total = 0;
+  int index, round;
+  sources = STRUCT_NALLOC(PackSource, TEST_PACK_FILES);
+  names   = STRUCT_NALLOC(char *, TEST_PACK_FILES);
+  content = mem_alloc(TEST_PACK_FILE_SIZE);
+  buffer  = mem_alloc(TEST_PACK_FILE_SIZE);
+  TEST_NOTNULL(sources);
+  TEST_NOTNULL(names);
+  for (index = 0; index < TEST_PACK_FILE_SIZE; index++) {
+    content[index] = (char) index;
+  }
+  for (index = 0; index < TEST_PACK_FILES; index++) {
+    FILE * file;
+    names[index] = mem_alloc(64);
+    sprintf(names[index], "test_pack_%03d.tmp", index);
+    file = fopen(names[index], "wb");
+    TEST_NOTNULL(file);
+    fwrite(content, 1, TEST_PACK_FILE_SIZE, file);
+    fclose(file);
+    sources[index].name        = names[index];
+    sources[index].data        = content;
+    sources[index].size        = TEST_PACK_FILE_SIZE;
+    sources[index].packed_size = 0;
+    sources[index].method      = PACK_STORE;
+  }
+  TEST_TRUE(pack_write(TEST_PACK_BENCH, TEST_PACK_FILES, sources));
+
+  start = clock();
+  for (round = 0; round < TEST_PACK_ROUNDS; round++) {
+    for (index = 0; index < TEST_PACK_FILES; index++) {
+      FILE * file = fopen(names[index], "rb");
+      if (!file) continue;
+      total += fread(buffer, 1, TEST_PACK_FILE_SIZE, file);
+      fclose(file);
+    }
+  }
+  loose_time = ((double) (clock() - start)) / CLOCKS_PER_SEC;
+
+  start = clock();
+  for (round = 0; round < TEST_PACK_ROUNDS; round++) {
+    size_t size = 0;
+    pack = pack_open(TEST_PACK_BENCH);
+    for (index = 0; index < TEST_PACK_FILES; index++) {
+      const void * data = pack_data(pack, names[index], &size);
+      if (!data) continue;
+      memcpy(buffer, data, size);
+      total += size;
+    }
+    pack = pack_close(pack);
+  }
+  pack_time = ((double) (clock() - start)) / CLOCKS_PER_SEC;
+  TEST_LONGEQ(2L * TEST_PACK_ROUNDS * TEST_PACK_FILES * TEST_PACK_FILE_SIZE,
+              total);
+  TEST_MEMEQ(content, TEST_PACK_FILE_SIZE, buffer);
+  printf("%d files of %d bytes, %d times: loose %f s, pack %f s\n",
+         TEST_PACK_FILES, TEST_PACK_FILE_SIZE, TEST_PACK_ROUNDS,
+         loose_time, pack_time);
+
+  for (index = 0; index < TEST_PACK_FILES; index++) {
+    remove(names[index]);
+    mem_free(names[index]);
+  }
+  remove(TEST_PACK_BENCH);
+  mem_free(names);
+  mem_free(sources);
+  mem_free(content);
+  mem_free(buffer);
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(pack);
+  TEST_RUN(pack_corrupt);
+  TEST_RUN(pack_bench);
+  TEST_REPORT();
+}
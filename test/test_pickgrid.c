@@ -0,0 +1,43 @@
+/**
+* This is a test for pickgrid in $package$
+*/
+#include "si_test.h"
+#include "pickgrid.h"
+
+
+TEST_FUNC(pickgrid) {
+  int ids[8];
+  PickGrid * grid = pickgrid_new(640, 480, 32, 32, 100);
+  TEST_NOTNULL(grid);
+  TEST_INTEQ(1 , pickgrid_put(grid, 1, 10, 10, 100, 100));
+  TEST_INTEQ(2 , pickgrid_put(grid, 2, 50, 50, 20, 20));
+  TEST_INTEQ(-2, pickgrid_put(grid, 100, 0, 0, 10, 10));
+  TEST_INTEQ(2 , pickgrid_query(grid, 60, 60, ids, 8));
+  TEST_INTEQ(1 , pickgrid_query(grid, 20, 20, ids, 8));
+  TEST_INTEQ(1 , ids[0]);
+  TEST_INTEQ(0 , pickgrid_query(grid, 200, 200, ids, 8));
+  /* Move 2 far away, even outside of the grid. */
+  TEST_INTEQ(2 , pickgrid_put(grid, 2, 700, 500, 20, 20));
+  TEST_INTEQ(1 , pickgrid_query(grid, 60, 60, ids, 8));
+  TEST_INTEQ(1 , pickgrid_query(grid, 710, 510, ids, 8));
+  TEST_INTEQ(2 , ids[0]);
+  /* Small move inside the same cells. */
+  TEST_INTEQ(1 , pickgrid_put(grid, 1, 11, 11, 100, 100));
+  TEST_INTEQ(0 , pickgrid_query(grid, 10, 10, ids, 8));
+  TEST_INTEQ(1 , pickgrid_remove(grid, 1));
+  TEST_INTEQ(-1, pickgrid_remove(grid, 1));
+  TEST_INTEQ(0 , pickgrid_query(grid, 60, 60, ids, 8));
+  TEST_ZERO(pickgrid_clear(grid));
+  TEST_INTEQ(0 , pickgrid_query(grid, 710, 510, ids, 8));
+  TEST_NULL(pickgrid_free(grid));
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(pickgrid);
+  TEST_REPORT();
+}
+
+
@@ -2,19 +2,158 @@
 * This is a test for rh in $package$
 */
 #include "si_test.h"
+#include "eruta.h"
 #include "rh.h"
+#include <string.h>
 
+#define TEST_RH_ROUTED_MAX 16
+#define TEST_RH_FRAMES     10
+#define TEST_RH_GARBAGE    100000
+
+/* The events that the test route got, in order. */
+static ALLEGRO_EVENT test_rh_routed[TEST_RH_ROUTED_MAX];
+static int           test_rh_routed_count = 0;
+
+/* Takes all events away from the scripts, and records them. */
+static int test_rh_route(ALLEGRO_EVENT * event, void * data) {
+  (void) data;
+  if (test_rh_routed_count < TEST_RH_ROUTED_MAX) {
+    test_rh_routed[test_rh_routed_count] = (*event);
+  }
+  test_rh_routed_count++;
+  return TRUE;
+}
+
+static void test_rh_queue_mouse(int dx, int x) {
+  ALLEGRO_EVENT event;
+  memset(&event, 0, sizeof(event));
+  event.type     = ALLEGRO_EVENT_MOUSE_AXES;
+  event.mouse.x  = x;
+  event.mouse.dx = dx;
+  rh_queue_event(NULL, &event);
+}
+
+static void test_rh_queue_axis(int axis, float pos) {
+  ALLEGRO_EVENT event;
+  memset(&event, 0, sizeof(event));
+  event.type          = ALLEGRO_EVENT_JOYSTICK_AXIS;
+  event.joystick.axis = axis;
+  event.joystick.pos  = pos;
+  rh_queue_event(NULL, &event);
+}
+
+static void test_rh_queue_key(int keycode) {
+  ALLEGRO_EVENT event;
+  memset(&event, 0, sizeof(event));
+  event.type              = ALLEGRO_EVENT_KEY_DOWN;
+  event.keyboard.keycode  = keycode;
+  rh_queue_event(NULL, &event);
+}
 
 TEST_FUNC(rh) {
   TEST_DONE();
 }
 
+/* When the next vertical blank is, for the fake vsync of test_rh_flip. */
+static double test_rh_vblank = 0.0;
+
+/* Flips like a display with vsync on: waits until the next vertical blank. */
+static void test_rh_flip(void) {
+  while (al_get_time() < test_rh_vblank) al_rest(0.0005);
+  test_rh_vblank += RH_GC_FRAME_TIME;
+}
+
+/* Frames that leave time before a vsync flip get GC steps done. */
+TEST_FUNC(rh_gc_flip) {
+  RhGcStats stats;
+  Ruby * ruby;
+  double start, work;
+  int index, ai;
+  ruby = mrb_open();
+  TEST_NOTNULL(ruby);
+  ai = mrb_gc_arena_save(ruby);
+  for (index = 0; index < TEST_RH_GARBAGE; index++) {
+    mrb_str_new_cstr(ruby, "garbage");
+    mrb_gc_arena_restore(ruby, ai);
+  }
+  /* Start a GC cycle, sweeping all that takes more than one step. */
+  mrb_incremental_gc(ruby);
+  rh_gc_idle_budget_(RH_GC_FRAME_TIME, RH_GC_IDLE_MAX);
+  rh_gc_stats_reset();
+  /* Only a vsync flip left, it isn't idle time any more. */
+  start = al_get_time();
+  test_rh_vblank = start + RH_GC_FRAME_TIME;
+  test_rh_flip();
+  TEST_FLOATEQ(0.0, rh_gc_idle(ruby, al_get_time() - start));
+  start = al_get_time();
+  test_rh_vblank = start + RH_GC_FRAME_TIME;
+  for (index = 0; index < TEST_RH_FRAMES; index++) {
+    /* A few milliseconds of work, then the flip. */
+    work = start + 0.002;
+    while (al_get_time() < work);
+    start = rh_gc_flip(ruby, start, test_rh_flip);
+    TEST_TRUE(rh_gc_stats(ruby, &stats));
+    TEST_TRUE((stats.frame_time <= RH_GC_IDLE_MAX + 0.002));
+  }
+  TEST_TRUE(rh_gc_stats(ruby, &stats));
+  TEST_TRUE(stats.steps > 0);
+  TEST_TRUE((stats.time > 0.0));
+  mrb_close(ruby);
+  TEST_DONE();
+}
+
+/* Consecutive moves are merged, other events keep their place. */
+TEST_FUNC(rh_events) {
+  RhEventStats stats;
+  rh_events_route_(test_rh_route, NULL);
+  TEST_TRUE(rh_events_coalesce());
+  test_rh_queue_mouse(1, 10);
+  test_rh_queue_mouse(2, 12);
+  test_rh_queue_key(5);
+  test_rh_queue_mouse(4, 16);
+  test_rh_queue_axis(0, 0.1);
+  test_rh_queue_axis(0, 0.5);
+  test_rh_queue_axis(1, 0.7);
+  test_rh_queue_key(6);
+  /* None of them went to the scripts. */
+  TEST_INTEQ(0, rh_flush_events(NULL));
+  TEST_INTEQ(6, test_rh_routed_count);
+  TEST_INTEQ(ALLEGRO_EVENT_MOUSE_AXES, test_rh_routed[0].type);
+  TEST_INTEQ(3 , test_rh_routed[0].mouse.dx);
+  TEST_INTEQ(12, test_rh_routed[0].mouse.x);
+  TEST_INTEQ(ALLEGRO_EVENT_KEY_DOWN, test_rh_routed[1].type);
+  TEST_INTEQ(5 , test_rh_routed[1].keyboard.keycode);
+  TEST_INTEQ(ALLEGRO_EVENT_MOUSE_AXES, test_rh_routed[2].type);
+  TEST_INTEQ(4 , test_rh_routed[2].mouse.dx);
+  TEST_INTEQ(ALLEGRO_EVENT_JOYSTICK_AXIS, test_rh_routed[3].type);
+  TEST_INTEQ(0 , test_rh_routed[3].joystick.axis);
+  TEST_FLOATEQ(0.5, test_rh_routed[3].joystick.pos);
+  TEST_INTEQ(1 , test_rh_routed[4].joystick.axis);
+  TEST_INTEQ(6 , test_rh_routed[5].keyboard.keycode);
+  TEST_TRUE(rh_event_stats(&stats));
+  TEST_LONGEQ(6, stats.queued);
+  TEST_LONGEQ(2, stats.coalesced);
+  TEST_LONGEQ(0, stats.sent);
+  /* Nothing is merged when that's turned off. */
+  test_rh_routed_count = 0;
+  TEST_FALSE(rh_events_coalesce_(FALSE));
+  test_rh_queue_mouse(1, 10);
+  test_rh_queue_mouse(2, 12);
+  TEST_INTEQ(0, rh_flush_events(NULL));
+  TEST_INTEQ(2, test_rh_routed_count);
+  TEST_INTEQ(1, test_rh_routed[0].mouse.dx);
+  TEST_INTEQ(2, test_rh_routed[1].mouse.dx);
+  rh_events_coalesce_(TRUE);
+  rh_events_route_(NULL, NULL);
+  TEST_DONE();
+}
+
 
 int main(void) {
   TEST_INIT();
+  al_init();
   TEST_RUN(rh);
+  TEST_RUN(rh_gc_flip);
+  TEST_RUN(rh_events);
   TEST_REPORT();
 }
-
-
-
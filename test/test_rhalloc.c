@@ -0,0 +1,169 @@
+/**
+* This is a test for rhalloc in $package$
+*/
+#include "si_test.h"
+#include "rhalloc.h"
+#include <string.h>
+#include <time.h>
+
+#define TEST_RHALLOC_BLOCKS 4096
+#define TEST_RHALLOC_ROUNDS 200
+/* More blocks of the largest class than fit in one frame region. */
+#define TEST_RHALLOC_REGION_BLOCKS (RHALLOC_REGION_SIZE / 256 + 16)
+
+/* Like mruby's default allocator. */
+static void * test_rhalloc_system(struct mrb_state * mrb, void * ptr,
+                                  size_t size, void * ud) {
+  (void) mrb; (void) ud;
+  if (size == 0) {
+    free(ptr);
+    return NULL;
+  }
+  return realloc(ptr, size);
+}
+
+/* Makes and frees blocks in a pattern that looks like a frame of script
+ * work: mostly small strings and arrays, some of them growing, and a few
+ * large ones. Returns a checksum so the work can't be optimized away. */
+static long test_rhalloc_frame(void * (*allocf)(struct mrb_state *, void *,
+                                                size_t, void *),
+                               void ** blocks) {
+  long sum = 0;
+  int index;
+  for (index = 0; index < TEST_RHALLOC_BLOCKS; index++) {
+    size_t size = 8 + ((index * 37) % 200);
+    if ((index % 64) == 0) size = 4096;
+    blocks[index] = allocf(NULL, NULL, size, NULL);
+    ((char *) blocks[index])[0] = (char) index;
+    if ((index % 8) == 0) {
+      blocks[index] = allocf(NULL, blocks[index], size * 2, NULL);
+    }
+  }
+  for (index = 0; index < TEST_RHALLOC_BLOCKS; index++) {
+    sum += ((char *) blocks[index])[0];
+    allocf(NULL, blocks[index], 0, NULL);
+  }
+  return sum;
+}
+
+
+TEST_FUNC(rhalloc) {
+  RhallocStats stats;
+  char * small, * big, * grown;
+  int index;
+  TEST_INTEQ(16, rhalloc_class_size(0));
+  TEST_INTEQ(RHALLOC_SMALL_MAX, rhalloc_class_size(RHALLOC_CLASSES - 1));
+  TEST_INTEQ(-1, rhalloc_class_size(RHALLOC_CLASSES));
+  small = rhalloc_allocf(NULL, NULL, 10, NULL);
+  TEST_NOTNULL(small);
+  TEST_INTEQ(0, (int) (((size_t) small) % 8));
+  strcpy(small, "eruta");
+  TEST_TRUE(rhalloc_stats(0, &stats));
+  TEST_LONGEQ(1, stats.live);
+  TEST_INTEQ(10, (int) rhalloc_heap());
+  /* Still fits the size class, so it stays put. */
+  TEST_PTREQ(small, rhalloc_allocf(NULL, small, 14, NULL));
+  grown = rhalloc_allocf(NULL, small, 100, NULL);
+  TEST_NOTNULL(grown);
+  TEST_STREQ("eruta", grown);
+  TEST_TRUE(rhalloc_stats(0, &stats));
+  TEST_LONGEQ(0, stats.live);
+  big = rhalloc_allocf(NULL, NULL, 10000, NULL);
+  TEST_NOTNULL(big);
+  TEST_TRUE(rhalloc_stats(RHALLOC_CLASS_SYSTEM, &stats));
+  TEST_LONGEQ(1, stats.live);
+  TEST_INTEQ(10100, (int) rhalloc_heap());
+  TEST_NULL(rhalloc_allocf(NULL, big, 0, NULL));
+  TEST_NULL(rhalloc_allocf(NULL, grown, 0, NULL));
+  TEST_INTEQ(0, (int) rhalloc_heap());
+  TEST_INTEQ(10100, (int) rhalloc_heap_max());
+  /* A freed block is reused first. */
+  small = rhalloc_allocf(NULL, NULL, 10, NULL);
+  TEST_NULL(rhalloc_allocf(NULL, small, 0, NULL));
+  TEST_PTREQ(small, rhalloc_allocf(NULL, NULL, 12, NULL));
+  TEST_NULL(rhalloc_allocf(NULL, small, 0, NULL));
+  /* In a frame, small blocks the free lists don't have come from a region. */
+  rhalloc_frame_begin();
+  for (index = 0; index < 100; index++) {
+    TEST_NOTNULL(rhalloc_allocf(NULL, NULL, 200, NULL));
+  }
+  rhalloc_frame_end();
+  TEST_TRUE(rhalloc_stats(RHALLOC_CLASS_FRAME, &stats));
+  TEST_LONGEQ(100, stats.live);
+  TEST_FALSE(rhalloc_stats(RHALLOC_STATS, &stats));
+  rhalloc_done();
+  TEST_INTEQ(0, (int) rhalloc_heap());
+  TEST_DONE();
+}
+
+/* A region is emptied once its blocks are freed, but one that fills up
+ * with survivors in it gives their blocks to the free lists. */
+TEST_FUNC(rhalloc_region) {
+  void * blocks[TEST_RHALLOC_REGION_BLOCKS];
+  void * first, * block;
+  int index;
+  rhalloc_frame_begin();
+  first = rhalloc_allocf(NULL, NULL, 200, NULL);
+  TEST_NULL(rhalloc_allocf(NULL, first, 0, NULL));
+  TEST_PTREQ(first, rhalloc_allocf(NULL, NULL, 200, NULL));
+  /* Fill the region past its end, with the first block still live. */
+  for (index = 0; index < TEST_RHALLOC_REGION_BLOCKS; index++) {
+    blocks[index] = rhalloc_allocf(NULL, NULL, 200, NULL);
+    TEST_NOTNULL(blocks[index]);
+  }
+  rhalloc_frame_end();
+  TEST_NULL(rhalloc_allocf(NULL, first, 0, NULL));
+  /* The block of the retired region is reused, in or out of a frame. */
+  block = rhalloc_allocf(NULL, NULL, 200, NULL);
+  TEST_PTREQ(first, block);
+  TEST_NULL(rhalloc_allocf(NULL, block, 0, NULL));
+  rhalloc_frame_begin();
+  TEST_PTREQ(first, rhalloc_allocf(NULL, NULL, 190, NULL));
+  rhalloc_frame_end();
+  TEST_NULL(rhalloc_allocf(NULL, first, 0, NULL));
+  for (index = 0; index < TEST_RHALLOC_REGION_BLOCKS; index++) {
+    TEST_NULL(rhalloc_allocf(NULL, blocks[index], 0, NULL));
+  }
+  TEST_INTEQ(0, (int) rhalloc_heap());
+  rhalloc_done();
+  TEST_DONE();
+}
+
+/* Compares rhalloc with malloc for frames of script like allocations. Only
+ * checks the results, the times are informational. */
+TEST_FUNC(rhalloc_bench) {
+  void   ** blocks = calloc(TEST_RHALLOC_BLOCKS, sizeof(void *));
+  clock_t   start;
+  double    system_time, pool_time;
+  long      system_sum = 0, pool_sum = 0;
+  int round;
+  TEST_NOTNULL(blocks);
+  start = clock();
+  for (round = 0; round < TEST_RHALLOC_ROUNDS; round++) {
+    system_sum += test_rhalloc_frame(test_rhalloc_system, blocks);
+  }
+  system_time = ((double) (clock() - start)) / CLOCKS_PER_SEC;
+  start = clock();
+  for (round = 0; round < TEST_RHALLOC_ROUNDS; round++) {
+    rhalloc_frame_begin();
+    pool_sum += test_rhalloc_frame(rhalloc_allocf, blocks);
+    rhalloc_frame_end();
+  }
+  pool_time = ((double) (clock() - start)) / CLOCKS_PER_SEC;
+  TEST_LONGEQ(system_sum, pool_sum);
+  TEST_INTEQ(0, (int) rhalloc_heap());
+  printf("%d frames of %d blocks: malloc %f s, rhalloc %f s\n",
+         TEST_RHALLOC_ROUNDS, TEST_RHALLOC_BLOCKS, system_time, pool_time);
+  rhalloc_done();
+  free(blocks);
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(rhalloc);
+  TEST_RUN(rhalloc_region);
+  TEST_RUN(rhalloc_bench);
+  TEST_REPORT();
+}
@@ -0,0 +1,89 @@
+/**
+* This is a test for rhprof in $package$
+*/
+#include "si_test.h"
+#include "rhprof.h"
+#include <string.h>
+
+TEST_FUNC(rhprof) {
+  RhprofEntry  entries[8];
+  const char * update[]  = { "<main> main.rb:1", "eruta_on_update main.rb:577",
+                             "update thing.rb:40" };
+  const char * draw[]    = { "<main> main.rb:1", "eruta_on_update main.rb:577",
+                             "draw <cfunc>" };
+  const char * recurse[] = { "<main> main.rb:1", "walk maze.rb:3",
+                             "walk maze.rb:3" };
+  char   buffer[512];
+  FILE * out;
+  size_t size;
+  TEST_INTEQ(0, rhprof_top(entries, 8));
+  TEST_INTEQ(0, rhprof_record(update, 3, 3));
+  TEST_INTEQ(0, rhprof_record(draw, 3, 1));
+  TEST_INTEQ(0, rhprof_record(update, 3, 2));
+  TEST_INTEQ(0, rhprof_record(recurse, 3, 4));
+  TEST_TRUE(rhprof_record(update, 0, 1) < 0);
+  TEST_TRUE(rhprof_record(update, 3, 0) < 0);
+  TEST_LONGEQ(10, rhprof_samples());
+  TEST_INTEQ(5, rhprof_top(entries, 8));
+  TEST_STREQ("update thing.rb:40", entries[0].label);
+  TEST_LONGEQ(5, entries[0].self);
+  TEST_LONGEQ(5, entries[0].total);
+  /* Recursion only counts once in the total. */
+  TEST_STREQ("walk maze.rb:3", entries[1].label);
+  TEST_LONGEQ(4, entries[1].self);
+  TEST_LONGEQ(4, entries[1].total);
+  TEST_STREQ("draw <cfunc>", entries[2].label);
+  TEST_STREQ("<main> main.rb:1", entries[3].label);
+  TEST_LONGEQ(0, entries[3].self);
+  TEST_LONGEQ(10, entries[3].total);
+  TEST_STREQ("eruta_on_update main.rb:577", entries[4].label);
+  TEST_LONGEQ(6, entries[4].total);
+  TEST_INTEQ(2, rhprof_top(entries, 2));
+  out = tmpfile();
+  TEST_NOTNULL(out);
+  TEST_INTEQ(3, rhprof_write_folded(out));
+  rewind(out);
+  size = fread(buffer, 1, sizeof(buffer) - 1, out);
+  buffer[size] = '\0';
+  fclose(out);
+  TEST_NOTNULL(strstr(buffer,
+    "<main> main.rb:1;eruta_on_update main.rb:577;update thing.rb:40 5\n"));
+  TEST_NOTNULL(strstr(buffer,
+    "<main> main.rb:1;walk maze.rb:3;walk maze.rb:3 4\n"));
+  rhprof_reset();
+  TEST_LONGEQ(0, rhprof_samples());
+  TEST_INTEQ(0, rhprof_top(entries, 8));
+  TEST_FALSE(rhprof_active());
+  TEST_TRUE((rhprof_interval_(0.002) == 0.002));
+  TEST_TRUE((rhprof_interval_(-1.0) == 0.002));
+  /* Without a ruby there is nothing to profile. */
+  TEST_FALSE(rhprof_start(NULL, 0.0));
+  TEST_FALSE(rhprof_stop(NULL));
+  TEST_DONE();
+}
+
+/* Many distinct stacks make the tables grow. */
+TEST_FUNC(rhprof_grow) {
+  RhprofEntry  entries[1];
+  char         label[RHPROF_LABEL_MAX];
+  const char * labels[2] = { "<main> main.rb:1", label };
+  int index;
+  for (index = 0; index < 1000; index++) {
+    sprintf(label, "method_%d thing.rb:%d", index, index);
+    TEST_INTEQ(0, rhprof_record(labels, 2, 1 + (index == 500)));
+  }
+  TEST_LONGEQ(1001, rhprof_samples());
+  TEST_INTEQ(1, rhprof_top(entries, 1));
+  TEST_STREQ("method_500 thing.rb:500", entries[0].label);
+  TEST_LONGEQ(2, entries[0].self);
+  rhprof_reset();
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(rhprof);
+  TEST_RUN(rhprof_grow);
+  TEST_REPORT();
+}
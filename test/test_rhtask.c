@@ -0,0 +1,112 @@
+/**
+* This is a test for rhtask in $package$
+*/
+#include "si_test.h"
+#include "rhtask.h"
+
+/* Turns each task id had, a task is done after 3 turns. */
+static int test_rhtask_turns[16];
+
+static int test_rhtask_resume(int id, void * data) {
+  (void) data;
+  test_rhtask_turns[id]++;
+  /* Running the tasks from a task does nothing. */
+  if (rhtask_run(test_rhtask_resume, NULL) != 0) return false;
+  /* Task 4 stops itself. */
+  if (id == 4) rhtask_remove(id);
+  return test_rhtask_turns[id] < 3;
+}
+
+/* Takes 3 ms per turn, and never finishes. */
+static int test_rhtask_slow(int id, void * data) {
+  double done = al_get_time() + 0.003;
+  (void) id; (void) data;
+  while (al_get_time() < done);
+  return true;
+}
+
+TEST_FUNC(rhtask) {
+  RhTaskStats      stats;
+  RhTaskFrameStats frame;
+  TEST_INTEQ(0, rhtask_count());
+  TEST_INTEQ(0, rhtask_run(test_rhtask_resume, NULL));
+  TEST_INTEQ(1, rhtask_add("sort"));
+  TEST_INTEQ(2, rhtask_add("plan"));
+  TEST_INTEQ(3, rhtask_add(NULL));
+  TEST_INTEQ(3, rhtask_count());
+  TEST_TRUE(rhtask_stats(2, &stats));
+  TEST_STREQ("task", stats.name);
+  TEST_FALSE(rhtask_stats(3, &stats));
+  /* With a large budget every task gets one turn per frame. */
+  TEST_TRUE((rhtask_budget_(10.0) == 10.0));
+  TEST_INTEQ(3, rhtask_run(test_rhtask_resume, NULL));
+  TEST_INTEQ(1, test_rhtask_turns[1]);
+  TEST_INTEQ(1, test_rhtask_turns[3]);
+  TEST_TRUE(rhtask_stats(0, &stats));
+  TEST_INTEQ(1, stats.id);
+  TEST_LONGEQ(1, stats.resumes);
+  TEST_LONGEQ(0, stats.overruns);
+  /* Without budget, one task a frame gets a turn, and the others wait. */
+  TEST_TRUE((rhtask_budget_(0.0) == 0.0));
+  TEST_INTEQ(1, rhtask_run(test_rhtask_resume, NULL));
+  TEST_TRUE(rhtask_frame_stats(&frame));
+  TEST_INTEQ(1, frame.resumed);
+  TEST_INTEQ(2, frame.waiting);
+  TEST_INTEQ(1, rhtask_run(test_rhtask_resume, NULL));
+  TEST_INTEQ(1, rhtask_run(test_rhtask_resume, NULL));
+  TEST_INTEQ(2, test_rhtask_turns[1]);
+  TEST_INTEQ(2, test_rhtask_turns[2]);
+  TEST_INTEQ(2, test_rhtask_turns[3]);
+  /* Task 1 has it's third turn and is done. */
+  TEST_INTEQ(1, rhtask_run(test_rhtask_resume, NULL));
+  TEST_INTEQ(2, rhtask_count());
+  TEST_INTEQ(4, rhtask_add("stop"));
+  TEST_INTEQ(1, rhtask_run(test_rhtask_resume, NULL));
+  TEST_INTEQ(3, test_rhtask_turns[2]);
+  TEST_INTEQ(2, rhtask_count());
+  TEST_INTEQ(1, rhtask_run(test_rhtask_resume, NULL));
+  TEST_INTEQ(3, test_rhtask_turns[3]);
+  TEST_INTEQ(1, rhtask_count());
+  TEST_INTEQ(1, rhtask_run(test_rhtask_resume, NULL));
+  TEST_INTEQ(1, test_rhtask_turns[4]);
+  TEST_TRUE(rhtask_frame_stats(&frame));
+  TEST_INTEQ(1, frame.finished);
+  TEST_INTEQ(0, rhtask_count());
+  TEST_TRUE(rhtask_remove(4) < 0);
+  TEST_TRUE((rhtask_time_left() == 0.0));
+  rhtask_done();
+  TEST_DONE();
+}
+
+/* A task that takes longer than the budget keeps the others waiting, and
+ * is counted as an overrun. */
+TEST_FUNC(rhtask_overrun) {
+  RhTaskStats      stats;
+  RhTaskFrameStats frame;
+  TEST_TRUE(rhtask_add("slow") > 0);
+  TEST_TRUE(rhtask_add("slower") > 0);
+  TEST_TRUE((rhtask_budget_(0.001) == 0.001));
+  TEST_INTEQ(1, rhtask_run(test_rhtask_slow, NULL));
+  TEST_TRUE(rhtask_frame_stats(&frame));
+  TEST_INTEQ(1, frame.resumed);
+  TEST_INTEQ(1, frame.waiting);
+  TEST_TRUE(rhtask_stats(0, &stats));
+  TEST_LONGEQ(1, stats.overruns);
+  TEST_TRUE((stats.time_max > 0.002));
+  /* The other one goes first the next frame. */
+  TEST_INTEQ(1, rhtask_run(test_rhtask_slow, NULL));
+  TEST_TRUE(rhtask_stats(1, &stats));
+  TEST_LONGEQ(1, stats.resumes);
+  TEST_LONGEQ(1, stats.overruns);
+  rhtask_budget_(RHTASK_BUDGET);
+  rhtask_done();
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(rhtask);
+  TEST_RUN(rhtask_overrun);
+  TEST_REPORT();
+}
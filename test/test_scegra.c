@@ -29,10 +29,75 @@ TEST_FUNC(scegra) {
   TEST_DONE();
 }
 
+TEST_FUNC(scegra_bulk) {
+  ScegraStyle  style;
+  ScegraChange changes[3] = {
+    { 10, SCEGRA_PROP_POSITION, { 5.0, 6.0, 0.0, 0.0 } },
+    { 10, SCEGRA_PROP_Z       , { 77.0, 0.0, 0.0, 0.0 } },
+    { 11, SCEGRA_PROP_SIZE    , { 1.0, 2.0, 0.0, 0.0 } },
+  };
+  char  packed[SCEGRA_CHANGE_PACKED_SIZE];
+  int   ids[3];
+  float x, y;
+  scegra_init();
+  scegrastyle_initempty(&style);
+  TEST_INTEQ(10, scegra_make_box(10, bevec(0, 0), bevec(8, 8), bevec(4, 4), style));
+  /* Node 11 isn't in use so that change must be skipped. */
+  TEST_INTEQ(2, scegra_apply_changes(changes, 3));
+  scegra_position(10, &x, &y);
+  TEST_FLOATEQ(5.0, x);
+  TEST_FLOATEQ(6.0, y);
+  TEST_INTEQ(77, scegra_z(10));
+  
+  changes[0].values[0] = 9.0;
+  memcpy(packed, changes, SCEGRA_CHANGE_PACKED_SIZE);
+  TEST_INTEQ(1, scegra_apply_packed(packed, SCEGRA_CHANGE_PACKED_SIZE));
+  TEST_INTEQ(0, scegra_apply_packed(packed, SCEGRA_CHANGE_PACKED_SIZE - 1));
+  scegra_position(10, &x, &y);
+  TEST_FLOATEQ(9.0, x);
+
+  TEST_INTEQ(3, scegra_make_from_template(10, 10, 3, 0.0, 10.0, ids));
+  TEST_INTEQ(11, ids[0]);
+  TEST_INTEQ(13, ids[2]);
+  TEST_INTEQ(77, scegra_z(13));
+  scegra_position(13, &x, &y);
+  TEST_FLOATEQ(9.0, x);
+  TEST_FLOATEQ(36.0, y);
+  TEST_INTEQ(-2, scegra_get_id(scegra_nodes_max()));
+  scegra_done();
+  TEST_DONE();
+}
+
+
+TEST_FUNC(scegra_pick) {
+  ScegraStyle  style;
+  scegra_init();
+  scegrastyle_initempty(&style);
+  TEST_INTEQ(1, scegra_make_box(1, bevec(0, 0), bevec(100, 100), bevec(4, 4), style));
+  TEST_INTEQ(2, scegra_make_box(2, bevec(50, 50), bevec(20, 20), bevec(4, 4), style));
+  TEST_INTEQ(2 , scegra_pick(60, 60));
+  TEST_INTEQ(1 , scegra_pick(10, 10));
+  TEST_INTEQ(-1, scegra_pick(300, 300));
+  /* Higher z is on top. */
+  scegra_z_(1, 10);
+  TEST_INTEQ(1 , scegra_pick(60, 60));
+  scegra_visible_(1, FALSE);
+  TEST_INTEQ(2 , scegra_pick(60, 60));
+  scegra_position_(2, 200, 200);
+  TEST_INTEQ(-1, scegra_pick(60, 60));
+  TEST_INTEQ(2 , scegra_pick(210, 210));
+  scegra_disable_node(2);
+  TEST_INTEQ(-1, scegra_pick(210, 210));
+  scegra_done();
+  TEST_DONE();
+}
+
 
 int main(void) {
   TEST_INIT();  
   TEST_RUN(scegra);
+  TEST_RUN(scegra_bulk);
+  TEST_RUN(scegra_pick);
   TEST_REPORT();
 }
 
@@ -0,0 +1,100 @@
+/**
+* This is a test for scriptcache in $package$
+*/
+#include "si_test.h"
+#include "scriptcache.h"
+#include "fifi.h"
+#include "mem.h"
+#include <string.h>
+#include <mruby.h>
+
+#define TEST_SCRIPTCACHE_FILE "test_scriptcache.tmp"
+#define TEST_SCRIPTCACHE_CODE "RITE0002 not really bytecode"
+#define TEST_SCRIPTCACHE_RB   "test_scriptcache_tmp.rb"
+
+/* Writes source to the script in the test directory. */
+static void test_scriptcache_save(const char * source) {
+  ALLEGRO_PATH * path = fifi_data_vpath(TEST_SCRIPTCACHE_RB);
+  FILE * file = fopen(PATH_CSTR(path), "wb");
+  if (file) {
+    fputs(source, file);
+    fclose(file);
+  }
+  al_destroy_path(path);
+}
+
+
+TEST_FUNC(scriptcache) {
+  const char    * source = "puts 'Hello'\n";
+  const char    * code   = TEST_SCRIPTCACHE_CODE;
+  unsigned char * read;
+  size_t          size   = 0;
+  uint64_t        key;
+  al_init();
+  key = scriptcache_key(source, strlen(source));
+  TEST_TRUE((key == scriptcache_key(source, strlen(source))));
+  TEST_TRUE((key != scriptcache_key("puts 'Hello!'\n", strlen(source) + 1)));
+  TEST_TRUE((key != scriptcache_key(source, strlen(source) - 1)));
+  TEST_NULL(scriptcache_read(TEST_SCRIPTCACHE_FILE, key, &size));
+  TEST_TRUE(scriptcache_write(TEST_SCRIPTCACHE_FILE, key,
+            (const unsigned char *) code, strlen(code)));
+  read = scriptcache_read(TEST_SCRIPTCACHE_FILE, key, &size);
+  TEST_NOTNULL(read);
+  TEST_INTEQ((int) strlen(code), (int) size);
+  TEST_MEMEQ((char *) code, size, (char *) read);
+  mem_free(read);
+  /* Stale when the source changed. */
+  TEST_NULL(scriptcache_read(TEST_SCRIPTCACHE_FILE, key + 1, &size));
+  remove(TEST_SCRIPTCACHE_FILE);
+  TEST_TRUE(scriptcache_enabled());
+  TEST_FALSE(scriptcache_enabled_(false));
+  TEST_TRUE(scriptcache_enabled_(true));
+  /* Nothing loaded yet, so nothing to reload. */
+  TEST_INTEQ(0, scriptcache_changed());
+  TEST_INTEQ(-1, scriptcache_reload(NULL));
+  TEST_NULL((char *) scriptcache_loaded_vpath(0, NULL));
+  TEST_FALSE(scriptcache_poll());
+  TEST_DONE();
+}
+
+
+/* A second save in the same second, with the same size, is still seen. */
+TEST_FUNC(scriptcache_changed) {
+  ALLEGRO_PATH * path;
+  Ruby         * ruby;
+  fifi_data_path_ = al_create_path(__FILE__);
+  al_set_path_filename(fifi_data_path_, NULL);
+  ruby = mrb_open();
+  TEST_NOTNULL(ruby);
+  test_scriptcache_save("$test_scriptcache = 1\n");
+  TEST_INTEQ(0, scriptcache_run(ruby, TEST_SCRIPTCACHE_RB));
+  TEST_INTEQ(0, scriptcache_changed());
+  test_scriptcache_save("$test_scriptcache = 2\n");
+  TEST_INTEQ(1, scriptcache_changed());
+  TEST_INTEQ(1, scriptcache_reload(ruby));
+  TEST_INTEQ(0, scriptcache_changed());
+  scriptcache_forget();
+  mrb_close(ruby);
+  scriptcache_done();
+  path = fifi_data_vpath(TEST_SCRIPTCACHE_RB);
+  remove(PATH_CSTR(path));
+  al_destroy_path(path);
+  path = scriptcache_path(TEST_SCRIPTCACHE_RB);
+  if (path) {
+    remove(PATH_CSTR(path));
+    al_set_path_filename(path, NULL);
+    remove(PATH_CSTR(path));
+    al_destroy_path(path);
+  }
+  al_destroy_path(fifi_data_path_);
+  fifi_data_path_ = NULL;
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(scriptcache);
+  TEST_RUN(scriptcache_changed);
+  TEST_REPORT();
+}
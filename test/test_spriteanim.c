@@ -0,0 +1,53 @@
+/**
+* This is a test for spriteanim in $package$
+*/
+#include "si_test.h"
+#include "spriteanim.h"
+
+
+TEST_FUNC(spriteanim) {
+  Sprite      * sprite;
+  SpriteState * state1, * state2;
+  sprite = sprite_new(1);
+  TEST_NOTNULL(sprite);
+  TEST_NOTNULL(sprite_set_new_action(sprite, 0, SPRITE_WALK, SPRITE_SOUTH));
+  TEST_NOTNULL(sprite_newframe(sprite, 0, 0, 0.1));
+  TEST_NOTNULL(sprite_newframe(sprite, 0, 1, 0.2));
+  TEST_INTEQ(2, sprite_flat_frames(sprite, 0));
+  TEST_INTEQ(0, sprite_flat_frames(sprite, 1));
+  
+  state1 = spritestate_new(sprite, NULL);
+  state2 = spritestate_new(sprite, NULL);
+  TEST_INTEQ(2, spriteanim_count());
+  TEST_NOTNULL(spritestate_now_(state1, 0, 0));
+  TEST_NOTNULL(spritestate_now_(state2, 0, 1));
+  spritestate_speedup_(state2, 2.0);
+  
+  TEST_INTEQ(0, spriteanim_update(0.05));
+  /* state2 is twice as fast, so it's frame of 0.2 is over now. */
+  TEST_INTEQ(2, spriteanim_update(0.06));
+  TEST_INTEQ(1, state1->frame_index);
+  TEST_INTEQ(0, state2->frame_index);
+  /* Updating by hand does nothing since the animation system does it. */
+  spritestate_update(state1, 1.0);
+  TEST_INTEQ(1, state1->frame_index);
+  
+  /* Removing a state keeps the others going. */
+  spritestate_free(state1);
+  TEST_INTEQ(1, spriteanim_count());
+  TEST_INTEQ(1, spriteanim_update(0.06));
+  TEST_INTEQ(1, state2->frame_index);
+  
+  spritestate_free(state2);
+  TEST_INTEQ(0, spriteanim_count());
+  spriteanim_done();
+  sprite_free(sprite);
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(spriteanim);
+  TEST_REPORT();
+}
@@ -2,10 +2,50 @@
 * This is a test for spritelist in $package$
 */
 #include "si_test.h"
+#include "sprite.h"
 #include "spritelist.h"
 
 
+/* Walker that counts the sprites it sees. */
+static void * count_walker(void * sprite, void * extra) {
+  int * count = extra;
+  if (sprite) (*count)++;
+  return NULL;
+}
+
 TEST_FUNC(spritelist) {
+  SpriteList * list;
+  Sprite     * sprite;
+  int count = 0;
+  list = spritelist_initall(spritelist_alloc(), 4);
+  TEST_NOTNULL(list);
+  TEST_INTEQ(0, spritelist_get_unused_sprite_id(list));
+  TEST_INTEQ(0, spritelist_new_sprite_id(list));
+  TEST_INTEQ(1, spritelist_new_sprite_id(list));
+  TEST_INTEQ(2, spritelist_new_sprite_id(list));
+  TEST_INTEQ(3, spritelist_count(list));
+  /* Deleted ids are reused first. */
+  TEST_INTEQ(0, spritelist_delete_sprite(list, 1));
+  TEST_NULL(spritelist_sprite(list, 1));
+  TEST_INTEQ(-2, spritelist_delete_sprite(list, 1));
+  TEST_INTEQ(2, spritelist_count(list));
+  TEST_INTEQ(1, spritelist_get_unused_sprite_id(list));
+  TEST_INTEQ(1, spritelist_new_sprite_id(list));
+  TEST_INTEQ(3, spritelist_new_sprite_id(list));
+  /* The list is full. */
+  TEST_INTEQ(-1, spritelist_new_sprite_id(list));
+  /* Only live sprites are walked. */
+  TEST_INTEQ(0, spritelist_delete_sprite(list, 0));
+  spritelist_walk(list, count_walker, &count);
+  TEST_INTEQ(3, count);
+  TEST_INTEQ(3, spritelist_count(list));
+  TEST_NOTNULL(spritelist_live(list, 2));
+  TEST_NULL(spritelist_live(list, 3));
+  /* Putting a sprite at an id takes it out of the free ids. */
+  sprite = sprite_new(0);
+  TEST_PTREQ(sprite, spritelist_sprite_(list, 0, sprite));
+  TEST_INTEQ(-3, spritelist_get_unused_sprite_id(list));
+  TEST_NULL(spritelist_free(list));
   TEST_DONE();
 }
 
@@ -17,4 +57,3 @@ int main(void) {
 }
 
 
-
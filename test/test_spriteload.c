@@ -0,0 +1,100 @@
+/**
+* This is a test for spriteload in $package$
+*/
+#include "si_test.h"
+#include "spriteload.h"
+#include "spritelayout.h"
+#include "fifi.h"
+
+/* Longest time to wait for the workers, in seconds. */
+#define TEST_SPRITELOAD_WAIT 5.0
+
+
+TEST_FUNC(spriteload) {
+  SpriteLayout    * layout;
+  SpriteLoadStats   stats;
+  Sprite          * sprite;
+  SpriteFrame     * frame;
+  double            start;
+  int               action;
+  Point where, size, offset;
+  double duration;
+  int pose, direction;
+
+  /* The layout describes the cells without loading them. */
+  layout = spritelayout_for(SPRITE_LOAD_ULPCSS_NORMAL);
+  TEST_NOTNULL(layout);
+  TEST_INTEQ(178, spritelayout_cells(layout));
+  TEST_INTEQ(1, spritelayout_cell(layout, 8, 1, &pose, &direction,
+                                  &where, &size, &offset, &duration));
+  TEST_INTEQ(SPRITE_WALK, pose);
+  TEST_INTEQ(SPRITE_NORTH, direction);
+  TEST_FLOATEQ(64.0, where.x);
+  TEST_FLOATEQ(512.0, where.y);
+  TEST_FLOATEQ(64.0, size.x);
+  /* The first walking cell is the standing pose. */
+  TEST_INTEQ(1, spritelayout_cell(layout, 8, 0, &pose, &direction,
+                                  &where, &size, &offset, &duration));
+  TEST_INTEQ(SPRITE_STAND, pose);
+  TEST_TRUE(spritelayout_cell(layout, 21, 0, &pose, &direction,
+                              &where, &size, &offset, &duration) < 0);
+  TEST_TRUE(spritelayout_cell(layout, 0, 7, &pose, &direction,
+                              &where, &size, &offset, &duration) < 0);
+
+  sprite = sprite_new(1);
+  TEST_NOTNULL(sprite);
+  TEST_INTEQ(0, sprite_loading(sprite));
+  TEST_INTEQ(-1, spriteload_start(NULL, 0, "image/ulpcss/body.png",
+                                  SPRITE_LOAD_ULPCSS_NORMAL));
+  TEST_INTEQ(-2, spriteload_start(sprite, 0, "image/ulpcss/body.png", 12345));
+  TEST_INTEQ(0, sprite_loading(sprite));
+  /* Load test_image.png from the directory of the tests as layer 0. */
+  al_init();
+  al_init_image_addon();
+  al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+  fifi_data_path_ = al_create_path(__FILE__);
+  al_set_path_filename(fifi_data_path_, NULL);
+  TEST_TRUE(spriteload_start(sprite, 0, "test_image.png",
+                             SPRITE_LOAD_ULPCSS_NORMAL) > 0);
+  TEST_INTEQ(1, sprite_loading(sprite));
+  /* Meanwhile it is drawn as a box the size of the cells. */
+  TEST_TRUE(sprite_loading_box(sprite, &offset, &size));
+  TEST_FLOATEQ(64.0, size.x);
+  TEST_FLOATEQ(64.0, size.y);
+  /* The workers slice it, the updates copy the cells to the atlas. */
+  start = al_get_time();
+  while ((spriteload_pending() > 0) &&
+         ((al_get_time() - start) < TEST_SPRITELOAD_WAIT)) {
+    spriteload_update(spriteload_budget());
+    al_rest(0.001);
+  }
+  TEST_INTEQ(0, spriteload_pending());
+  TEST_INTEQ(0, sprite_loading(sprite));
+  TEST_TRUE(spriteload_stats(&stats));
+  TEST_LONGEQ(1, stats.loaded);
+  TEST_LONGEQ(178, stats.cells);
+  /* The first cell is on the sheet, the layer of its frame has an image. */
+  TEST_INTEQ(1, spritelayout_cell(layout, 0, 0, &pose, &direction,
+                                  &where, &size, &offset, &duration));
+  action = sprite_action_index_for(sprite, pose, direction);
+  TEST_TRUE(action >= 0);
+  frame  = sprite_frame(sprite, action, 0);
+  TEST_NOTNULL(frame);
+  TEST_NOTNULL(spriteframe_cell(frame, 0));
+  TEST_NOTNULL(spritecell_image(spriteframe_cell(frame, 0)));
+  sprite_free(sprite);
+  spriteload_done();
+  sprite_atlas_done();
+  al_destroy_path(fifi_data_path_);
+  fifi_data_path_ = NULL;
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(spriteload);
+  TEST_REPORT();
+}
+
+
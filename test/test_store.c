@@ -0,0 +1,156 @@
+/**
+* This is a test for store in $package$
+*/
+#include "si_test.h"
+#include "store.h"
+#include "fifi.h"
+
+static int test_store_loads = 0;
+static int test_store_frees = 0;
+
+static void * test_store_loader(const char * vpath, void * extra) {
+  (void) extra;
+  test_store_loads++;
+  return (void *) vpath;
+}
+
+static int test_store_destroy(Resor * resor) {
+  (void) resor;
+  test_store_frees++;
+  return 0;
+}
+
+TEST_FUNC(store) {
+  StoreCacheStats stats;
+  Resor * one, * two;
+  TEST_TRUE(store_init());
+  one = store_load_other(1, "data/one", RESOR_OTHER, test_store_loader, 
+                         test_store_destroy, NULL);
+  TEST_NOTNULL(one);
+  TEST_INTEQ(1, test_store_loads);
+  /* Loading the same again shares the resource. */
+  two = store_load_other(2, "data/one", RESOR_OTHER, test_store_loader, 
+                         test_store_destroy, NULL);
+  TEST_PTREQ(one, two);
+  TEST_INTEQ(1, test_store_loads);
+  TEST_INTEQ(2, resor_refs(one));
+  /* Loading again into the same index changes nothing. */
+  TEST_PTREQ(one, store_load_other(2, "data/one", RESOR_OTHER, 
+                  test_store_loader, test_store_destroy, NULL));
+  TEST_INTEQ(2, resor_refs(one));
+  /* Something else is loaded. */
+  two = store_load_other(3, "data/two", RESOR_OTHER, test_store_loader, 
+                         test_store_destroy, NULL);
+  TEST_NOTNULL(two);
+  TEST_TRUE(one != two);
+  TEST_INTEQ(2, test_store_loads);
+  TEST_TRUE(store_cache_stats(&stats));
+  TEST_LONGEQ(2, stats.hits);
+  TEST_LONGEQ(2, stats.misses);
+  TEST_INTEQ(2, stats.entries);
+  /* Dropping one of the shared indexes keeps the resource alive. */
+  TEST_TRUE(store_drop(1));
+  TEST_INTEQ(0, test_store_frees);
+  TEST_PTREQ(one, store_get(2));
+  TEST_INTEQ(1, resor_refs(one));
+  TEST_TRUE(store_drop(2));
+  TEST_INTEQ(1, test_store_frees);
+  TEST_TRUE(store_cache_stats(&stats));
+  TEST_INTEQ(1, stats.entries);
+  /* Unsharing takes the resource out of the cache. */
+  TEST_PTREQ(two, store_unshare(3));
+  TEST_TRUE(store_cache_stats(&stats));
+  TEST_INTEQ(0, stats.entries);
+  TEST_NOTNULL(store_load_other(4, "data/two", RESOR_OTHER, test_store_loader,
+                                test_store_destroy, NULL));
+  TEST_INTEQ(3, test_store_loads);
+  TEST_FALSE(store_cache_stats(NULL));
+  TEST_TRUE(store_done());
+  TEST_INTEQ(3, test_store_frees);
+  TEST_DONE();
+}
+
+TEST_FUNC(store_budget) {
+  TEST_TRUE(store_init());
+  TEST_FALSE(store_index_ok(store_max()));
+  TEST_LONGEQ(0, store_budget(RESOR_BITMAP));
+  TEST_LONGEQ(1024, store_budget_(RESOR_BITMAP, 1024));
+  TEST_LONGEQ(1024, store_budget(RESOR_BITMAP));
+  TEST_LONGEQ(0, store_budget_(RESOR_BITMAP, -1));
+  TEST_LONGEQ(0, store_budget_(12345, 1024));
+  TEST_LONGEQ(0, store_used(RESOR_BITMAP));
+  TEST_FALSE(store_pin(1));
+  TEST_NOTNULL(store_load_other(1, "data/one", RESOR_OTHER, test_store_loader,
+                                test_store_destroy, NULL));
+  TEST_FALSE(store_pinned(1));
+  TEST_TRUE(store_pin(1));
+  TEST_TRUE(store_pinned(1));
+  TEST_INTEQ(1, resor_pins(store_get(1)));
+  TEST_TRUE(store_unpin(1));
+  TEST_FALSE(store_unpin(1));
+  TEST_INTEQ(0, resor_pins(store_get(1)));
+  TEST_TRUE(store_pin(1));
+  /* Dropping unpins. */
+  TEST_TRUE(store_drop(1));
+  TEST_FALSE(store_pinned(1));
+  TEST_TRUE(store_done());
+  TEST_DONE();
+}
+
+TEST_FUNC(store_evict) {
+  StoreCacheStats stats;
+  long size;
+  al_init();
+  al_init_image_addon();
+  al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+  /* Load test_image.png from the directory of the tests. */
+  fifi_data_path_ = al_create_path(__FILE__);
+  al_set_path_filename(fifi_data_path_, NULL);
+  TEST_TRUE(store_init());
+  TEST_NOTNULL(store_load_bitmap(1, "test_image.png"));
+  size = store_used(RESOR_BITMAP);
+  TEST_TRUE(size > 0);
+  TEST_LONGEQ(size, store_budget_(RESOR_BITMAP, size));
+  TEST_NOTNULL(store_load_bitmap_flags(2, "test_image.png",
+                                       ALLEGRO_NO_PREMULTIPLIED_ALPHA));
+  /* Both were used during this frame, so neither may be evicted yet. */
+  TEST_LONGEQ(2 * size, store_used(RESOR_BITMAP));
+  TEST_NOTNULL(store_get_bitmap(1));
+  store_frame();
+  /* Now the least recently used one is evicted. */
+  TEST_LONGEQ(size, store_used(RESOR_BITMAP));
+  TEST_TRUE(store_cache_stats(&stats));
+  TEST_LONGEQ(1, stats.evictions);
+  TEST_NOTNULL(store_get_bitmap(1));
+  /* Loading the evicted one again doesn't evict the one that was just used. */
+  TEST_NOTNULL(store_get_bitmap(2));
+  TEST_LONGEQ(2 * size, store_used(RESOR_BITMAP));
+  TEST_TRUE(store_cache_stats(&stats));
+  TEST_LONGEQ(1, stats.evictions);
+  TEST_LONGEQ(1, stats.reloads);
+  store_frame();
+  TEST_LONGEQ(size, store_used(RESOR_BITMAP));
+  TEST_TRUE(store_cache_stats(&stats));
+  TEST_LONGEQ(2, stats.evictions);
+  /* A free id is found without loading the evicted one again. */
+  TEST_INTEQ(3, store_get_unused_id(1));
+  TEST_TRUE(store_cache_stats(&stats));
+  TEST_LONGEQ(1, stats.reloads);
+  TEST_TRUE(store_done());
+  TEST_LONGEQ(0, store_used(RESOR_BITMAP));
+  store_budget_(RESOR_BITMAP, 0);
+  al_destroy_path(fifi_data_path_);
+  fifi_data_path_ = NULL;
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(store);
+  TEST_RUN(store_budget);
+  TEST_RUN(store_evict);
+  TEST_REPORT();
+}
+
+
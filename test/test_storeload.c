@@ -0,0 +1,62 @@
+/**
+* This is a test for storeload in $package$
+*/
+#include "si_test.h"
+#include "storeload.h"
+#include "fifi.h"
+
+/* Longest time to wait for the workers, in seconds. */
+#define TEST_STORELOAD_WAIT 5.0
+
+
+TEST_FUNC(storeload) {
+  StoreLoadStats   stats;
+  ALLEGRO_BITMAP * bitmap;
+  double           start;
+  int              id;
+  al_init();
+  al_init_image_addon();
+  al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+  /* Load test_image.png from the directory of the tests. */
+  fifi_data_path_ = al_create_path(__FILE__);
+  al_set_path_filename(fifi_data_path_, NULL);
+  TEST_TRUE(store_init());
+  TEST_INTEQ(-1, storeload_bitmap(1, NULL));
+  TEST_INTEQ(-2, storeload_bitmap(-1, "test_image.png"));
+  id = storeload_bitmap(1, "test_image.png");
+  TEST_TRUE(id > 0);
+  TEST_TRUE(storeload_index_pending(1));
+  TEST_NULL(store_get_bitmap(1));
+  /* The workers decode it, the updates put it in the store. */
+  start = al_get_time();
+  while ((storeload_pending() > 0) &&
+         ((al_get_time() - start) < TEST_STORELOAD_WAIT)) {
+    storeload_update(storeload_budget());
+    al_rest(0.001);
+  }
+  TEST_INTEQ(0, storeload_pending());
+  TEST_FALSE(storeload_index_pending(1));
+  TEST_FLOATEQ(1.0, storeload_progress());
+  bitmap = store_get_bitmap(1);
+  TEST_NOTNULL(bitmap);
+  TEST_INTEQ(40, al_get_bitmap_width(bitmap));
+  TEST_INTEQ(80, al_get_bitmap_height(bitmap));
+  TEST_TRUE(storeload_stats(&stats));
+  TEST_LONGEQ(1, stats.started);
+  TEST_LONGEQ(1, stats.loaded);
+  TEST_LONGEQ(0, stats.failed);
+  storeload_done();
+  TEST_TRUE(store_done());
+  al_destroy_path(fifi_data_path_);
+  fifi_data_path_ = NULL;
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(storeload);
+  TEST_REPORT();
+}
+
+
@@ -0,0 +1,56 @@
+/**
+* This is a test for textcache in $package$
+*/
+#include "si_test.h"
+#include "textcache.h"
+
+
+TEST_FUNC(textcache) {
+  TextCache      * cache;
+  TextCacheStats   stats;
+  ALLEGRO_FONT   * font;
+  int w = 0, bbx, bby, bbw, bbh;
+  al_init();
+  al_init_font_addon();
+  font = al_create_builtin_font();
+  TEST_NOTNULL(font);
+  cache = textcache_new(2);
+  TEST_NOTNULL(cache);
+  TEST_TRUE(textcache_get_width(cache, font, "Hello", 5, &w));
+  TEST_INTEQ(al_get_text_width(font, "Hello"), w);
+  TEST_TRUE(textcache_get_width(cache, font, "Hello", 5, &w));
+  TEST_INTEQ(al_get_text_width(font, "Hello"), w);
+  TEST_TRUE(textcache_get_dimensions(cache, font, "Hello", 5, &bbx, &bby, &bbw, &bbh));
+  TEST_TRUE(textcache_get_dimensions(cache, font, "Hello", 5, &bbx, &bby, &bbw, &bbh));
+  TEST_INTEQ(w, bbw);
+  TEST_TRUE(textcache_stats(cache, &stats));
+  TEST_LONGEQ(2, stats.hits);
+  TEST_LONGEQ(2, stats.misses);
+  /* The cache holds 2 texts, so the third one evicts Hello. */
+  TEST_TRUE(textcache_get_width(cache, font, "World", 5, &w));
+  TEST_TRUE(textcache_get_width(cache, font, "Wide", 4, &w));
+  TEST_TRUE(textcache_get_width(cache, font, "Hello", 5, &w));
+  TEST_TRUE(textcache_stats(cache, &stats));
+  TEST_LONGEQ(2, stats.hits);
+  TEST_LONGEQ(5, stats.misses);
+  TEST_LONGEQ(2, stats.evictions);
+  /* Prewarmed widths are calculated. */
+  TEST_TRUE(textcache_prewarm(cache, font));
+  TEST_TRUE(textcache_get_width(cache, font, "Prewarmed", 9, &w));
+  TEST_INTEQ(al_get_text_width(font, "Prewarmed"), w);
+  TEST_TRUE(textcache_stats(cache, &stats));
+  TEST_LONGEQ(1, stats.computed);
+  TEST_FALSE(textcache_get_width(cache, NULL, "Hello", 5, &w));
+  TEST_NULL(textcache_free(cache));
+  al_destroy_font(font);
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(textcache);
+  TEST_REPORT();
+}
+
+
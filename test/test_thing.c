@@ -6,6 +6,87 @@
 
 
 TEST_FUNC(thing) {
+  int ids[8];
+  int a, b, c;
+  TEST_INTEQ(0, thing_count());
+  TEST_TRUE(thing_new(THING_KIND_NPC, 0, 0, 0, -1, 1) < 0);
+  a = thing_new(THING_KIND_PLAYER, 10, 20, 1, 32, 32);
+  b = thing_new(THING_KIND_NPC, 100, 20, 1, 16, 16);
+  c = thing_new(THING_KIND_ITEM, 200, 200, 0, 8, 8);
+  TEST_INTEQ(0, a);
+  TEST_INTEQ(1, b);
+  TEST_INTEQ(2, c);
+  TEST_INTEQ(3, thing_count());
+  TEST_INTEQ(THING_KIND_NPC, thing_kind(b));
+  TEST_TRUE((thing_cx(a) == 26.0f));
+  TEST_TRUE((thing_cy(a) == 36.0f));
+  TEST_INTEQ(SPRITE_STAND, thing_pose(a));
+  /* Deleting keeps the other ids, and the id is reused. */
+  TEST_INTEQ(0, thing_delete(a));
+  TEST_TRUE(thing_delete(a) < 0);
+  TEST_FALSE(thing_exists(a));
+  TEST_TRUE(thing_exists(c));
+  TEST_TRUE((thing_x(c) == 200.0f));
+  TEST_INTEQ(THING_KIND_ITEM, thing_kind(c));
+  TEST_INTEQ(2, thing_count());
+  a = thing_new(THING_KIND_PLAYER, 10, 20, 1, 32, 32);
+  TEST_INTEQ(0, a);
+  TEST_TRUE(thing_kind(7) < 0);
+  TEST_TRUE((thing_x(7) == 0.0f));
+  /* Integration moves all things that aren't static or disabled. */
+  TEST_INTEQ(0, thing_v_(a, 10, 0));
+  TEST_INTEQ(0, thing_v_(b, 0, -10));
+  TEST_INTEQ(0, thing_v_(c, 5, 5));
+  TEST_INTEQ(THING_FLAG_STATIC, thing_set_flag(c, THING_FLAG_STATIC));
+  TEST_INTEQ(2, thing_integrate(0.5));
+  TEST_TRUE((thing_x(a) == 15.0f));
+  TEST_TRUE((thing_y(b) == 15.0f));
+  TEST_TRUE((thing_x(c) == 200.0f));
+  /* Only animated things follow their velocity, and only when walking or
+   * standing. */
+  thing_set_flag(a, THING_FLAG_ANIMATE);
+  thing_set_flag(b, THING_FLAG_ANIMATE);
+  thing_pose_(b, SPRITE_SLASH);
+  TEST_INTEQ(1, thing_animate());
+  TEST_INTEQ(SPRITE_WALK, thing_pose(a));
+  TEST_INTEQ(SPRITE_EAST, thing_direction(a));
+  TEST_INTEQ(SPRITE_SLASH, thing_pose(b));
+  TEST_INTEQ(SPRITE_STAND, thing_pose(c));
+  thing_v_(a, 0, 0);
+  TEST_INTEQ(1, thing_animate());
+  TEST_INTEQ(SPRITE_STAND, thing_pose(a));
+  TEST_INTEQ(SPRITE_EAST, thing_direction(a));
+  TEST_INTEQ(0, thing_animate());
+  /* Without sprites there is nothing to sync. */
+  TEST_INTEQ(0, thing_sync_sprites());
+  /* Rectangle searches skip disabled things. */
+  TEST_INTEQ(2, thing_find_in_rectangle(0, 0, 120, 40, ids, 8));
+  TEST_INTEQ(1, thing_find_in_rectangle(0, 0, 120, 40, ids, 1));
+  thing_set_flag(b, THING_FLAG_DISABLED);
+  TEST_INTEQ(1, thing_find_in_rectangle(0, 0, 120, 40, ids, 8));
+  TEST_INTEQ(a, ids[0]);
+  TEST_INTEQ(0, thing_unset_flag(b, THING_FLAG_ANIMATE | THING_FLAG_DISABLED));
+  TEST_INTEQ(0, thing_find_in_rectangle(500, 500, 10, 10, ids, 8));
+  thing_done();
+  TEST_INTEQ(0, thing_count());
+  TEST_FALSE(thing_exists(a));
+  TEST_DONE();
+}
+
+/* Many things make the store grow. */
+TEST_FUNC(thing_grow) {
+  int index;
+  for (index = 0; index < 1000; index++) {
+    TEST_INTEQ(index, thing_new(THING_KIND_FOE, index, 0, 0, 1, 1));
+  }
+  for (index = 0; index < 1000; index += 2) {
+    TEST_INTEQ(0, thing_delete(index));
+  }
+  TEST_INTEQ(500, thing_count());
+  for (index = 1; index < 1000; index += 2) {
+    TEST_TRUE((thing_x(index) == (float) index));
+  }
+  thing_done();
   TEST_DONE();
 }
 
@@ -13,8 +94,6 @@ TEST_FUNC(thing) {
 int main(void) {
   TEST_INIT();
   TEST_RUN(thing);
+  TEST_RUN(thing_grow);
   TEST_REPORT();
 }
-
-
-
@@ -0,0 +1,121 @@
+/**
+* This is a test for tr_bind in $package$
+*/
+#include "si_test.h"
+#include "rh.h"
+#include "tr_macro.h"
+#include <mruby/compile.h>
+#include <mruby/string.h>
+#include <string.h>
+#include <time.h>
+
+static mrb_int test_tr_bind_counted = 0;
+
+static int test_tr_bind_add(int a, int b) {
+  return a + b;
+}
+
+static float test_tr_bind_scale(float value) {
+  return value * 2.0f;
+}
+
+static int test_tr_bind_not(int value) {
+  return !value;
+}
+
+static int test_tr_bind_length(const char * text) {
+  return (int) strlen(text);
+}
+
+static void test_tr_bind_count(int amount, int times) {
+  test_tr_bind_counted += amount * times;
+}
+
+#include "test_tr_bind_bind.h"
+
+/* The same as the generated add, the way the bindings used to be written. */
+static mrb_value test_tr_bind_add_get_args(mrb_state * mrb, mrb_value self) {
+  mrb_int a, b;
+  (void) self;
+  mrb_get_args(mrb, "ii", &a, &b);
+  return mrb_fixnum_value(test_tr_bind_add(a, b));
+}
+
+/* Runs code and returns the inspected result, or the class of the
+ * exception it raised. */
+static const char * test_tr_bind_eval(mrb_state * mrb, const char * code) {
+  mrb_value result = mrb_load_string(mrb, code);
+  if (mrb->exc) {
+    result  = mrb_obj_value(mrb->exc);
+    mrb->exc = NULL;
+    result  = mrb_str_new_cstr(mrb, mrb_obj_classname(mrb, result));
+  } else {
+    result  = mrb_inspect(mrb, result);
+  }
+  return RSTRING_PTR(result);
+}
+
+TEST_FUNC(tr_bind) {
+  mrb_state    * mrb = mrb_open();
+  struct RClass * klass;
+  TEST_NOTNULL(mrb);
+  klass = mrb_define_class(mrb, "TrBind", mrb->object_class);
+  test_tr_bind_define(mrb, klass);
+  TEST_STREQ("5", test_tr_bind_eval(mrb, "TrBind.add(2, 3)"));
+  TEST_STREQ("5", test_tr_bind_eval(mrb, "TrBind.add(2.9, 3)"));
+  TEST_STREQ("5", test_tr_bind_eval(mrb, "TrBind.add(*[2, 3])"));
+  TEST_STREQ("3.0", test_tr_bind_eval(mrb, "TrBind.scale(1.5)"));
+  TEST_STREQ("4.0", test_tr_bind_eval(mrb, "TrBind.scale(2)"));
+  TEST_STREQ("true", test_tr_bind_eval(mrb, "TrBind.not(nil)"));
+  TEST_STREQ("false", test_tr_bind_eval(mrb, "TrBind.not(0)"));
+  TEST_STREQ("5", test_tr_bind_eval(mrb, "TrBind.length('eruta')"));
+  TEST_STREQ("nil", test_tr_bind_eval(mrb, "TrBind.count_(2, 3)"));
+  TEST_LONGEQ(6, test_tr_bind_counted);
+  TEST_STREQ("3", test_tr_bind_eval(mrb, "TrBind.count_batch([1, 1, 2, 2, 3, 3])"));
+  TEST_LONGEQ(20, test_tr_bind_counted);
+  TEST_STREQ("0", test_tr_bind_eval(mrb, "TrBind.count_batch([])"));
+  /* Wrong arguments raise in stead of crashing or converting. */
+  TEST_STREQ("ArgumentError", test_tr_bind_eval(mrb, "TrBind.add(1)"));
+  TEST_STREQ("ArgumentError", test_tr_bind_eval(mrb, "TrBind.add(1, 2, 3)"));
+  TEST_STREQ("TypeError", test_tr_bind_eval(mrb, "TrBind.add('1', 2)"));
+  TEST_STREQ("TypeError", test_tr_bind_eval(mrb, "TrBind.scale(nil)"));
+  TEST_STREQ("TypeError", test_tr_bind_eval(mrb, "TrBind.length(5)"));
+  TEST_STREQ("RangeError", test_tr_bind_eval(mrb, "TrBind.add(1e100, 2)"));
+  TEST_STREQ("ArgumentError", test_tr_bind_eval(mrb, "TrBind.count_batch([1, 2, 3])"));
+  TEST_STREQ("ArgumentError", test_tr_bind_eval(mrb, "TrBind.count_batch(1)"));
+  TEST_LONGEQ(20, test_tr_bind_counted);
+  mrb_close(mrb);
+  TEST_DONE();
+}
+
+/* Compares the generated wrapper with mrb_get_args. The times are only
+ * reported, they depend too much on the machine to test them. */
+TEST_FUNC(tr_bind_bench) {
+  mrb_state    * mrb = mrb_open();
+  struct RClass * klass;
+  clock_t start, generated, get_args;
+  TEST_NOTNULL(mrb);
+  klass = mrb_define_class(mrb, "TrBind", mrb->object_class);
+  test_tr_bind_define(mrb, klass);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "add_get_args", test_tr_bind_add_get_args, 2);
+  start     = clock();
+  TEST_STREQ("1000000",
+    test_tr_bind_eval(mrb, "i = 0; while i < 1000000; i = TrBind.add(i, 1); end; i"));
+  generated = clock() - start;
+  start     = clock();
+  TEST_STREQ("1000000",
+    test_tr_bind_eval(mrb, "i = 0; while i < 1000000; i = TrBind.add_get_args(i, 1); end; i"));
+  get_args  = clock() - start;
+  fprintf(stderr, "tr_bind: generated %.3f s, mrb_get_args %.3f s\n",
+          (double) generated / CLOCKS_PER_SEC, (double) get_args / CLOCKS_PER_SEC);
+  mrb_close(mrb);
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(tr_bind);
+  TEST_RUN(tr_bind_bench);
+  TEST_REPORT();
+}
@@ -0,0 +1,85 @@
+/*
+ * Generated by bin/trgen from test_tr_bind.bind, don't edit.
+ */
+#ifndef test_tr_bind_bind_h_INCLUDED
+#define test_tr_bind_bind_h_INCLUDED
+
+#include "tr_bind.h"
+
+/* test_tr_bind_add(int, int) -> int */
+static mrb_value tr_bind_test_tr_bind_add(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  return mrb_fixnum_value(test_tr_bind_add(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1])));
+}
+
+/* test_tr_bind_scale(float) -> float */
+static mrb_value tr_bind_test_tr_bind_scale(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_float_value(mrb, test_tr_bind_scale(TR_BIND_FLOAT(mrb, argv[0])));
+}
+
+/* test_tr_bind_not(bool) -> bool */
+static mrb_value tr_bind_test_tr_bind_not(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return rh_bool_value(test_tr_bind_not(TR_BIND_BOOL(mrb, argv[0])));
+}
+
+/* test_tr_bind_length(string) -> int */
+static mrb_value tr_bind_test_tr_bind_length(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  return mrb_fixnum_value(test_tr_bind_length(TR_BIND_STRING(mrb, argv[0])));
+}
+
+/* test_tr_bind_count(int, int) -> nil */
+static mrb_value tr_bind_test_tr_bind_count(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 2) return tr_bind_arity_error(mrb, argc, 2);
+  test_tr_bind_count(TR_BIND_INT(mrb, argv[0]), TR_BIND_INT(mrb, argv[1]));
+  return mrb_nil_value();
+}
+
+/* test_tr_bind_count for each 2 values of a flat array -> calls */
+static mrb_value tr_bind_test_tr_bind_count_batch(mrb_state * mrb, mrb_value self) {
+  mrb_value * argv;
+  mrb_int     argc, size, index;
+  (void) self;
+  argv = tr_bind_args(mrb, &argc);
+  if (argc != 1) return tr_bind_arity_error(mrb, argc, 1);
+  size = tr_bind_batch_size(mrb, argv[0], 2);
+  for (index = 0; index < size; index += 2) {
+    mrb_value * item = RARRAY_PTR(argv[0]) + index;
+    test_tr_bind_count(TR_BIND_INT(mrb, item[0]), TR_BIND_INT(mrb, item[1]));
+  }
+  return mrb_fixnum_value(size / 2);
+}
+
+/* Defines the class methods of TrBind on klass. */
+static void test_tr_bind_define(mrb_state * mrb, struct RClass * klass) {
+  TR_CLASS_METHOD_ARGC(mrb, klass, "add"                   , tr_bind_test_tr_bind_add, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "scale"                 , tr_bind_test_tr_bind_scale, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "not"                   , tr_bind_test_tr_bind_not, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "length"                , tr_bind_test_tr_bind_length, 1);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "count_"                , tr_bind_test_tr_bind_count, 2);
+  TR_CLASS_METHOD_ARGC(mrb, klass, "count_batch"           , tr_bind_test_tr_bind_count_batch, 1);
+}
+
+#endif
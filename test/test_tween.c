@@ -0,0 +1,82 @@
+/**
+* This is a test for tween in $package$
+*/
+#include "si_test.h"
+#include "scegra.h"
+#include "tween.h"
+
+
+TEST_FUNC(tween_ease) {
+  int ease;
+  for (ease = 0; ease < TWEEN_EASE_MAX; ease++) {
+    TEST_DOUBLEEQ(0.0, tween_ease(ease, 0.0));
+    TEST_DOUBLEEQ(1.0, tween_ease(ease, 1.0));
+  }
+  TEST_DOUBLEEQ(0.5 , tween_ease(TWEEN_EASE_LINEAR, 0.5));
+  TEST_DOUBLEEQ(0.25, tween_ease(TWEEN_EASE_QUAD_IN, 0.5));
+  TEST_DOUBLEEQ(0.75, tween_ease(TWEEN_EASE_QUAD_OUT, 0.5));
+  TEST_DOUBLEEQ(0.5 , tween_ease(TWEEN_EASE_CUBIC_INOUT, 0.5));
+  TEST_DOUBLEEQ(1.0 , tween_ease(TWEEN_EASE_LINEAR, 2.0));
+  TEST_DOUBLEEQ(0.0 , tween_ease(TWEEN_EASE_LINEAR, -1.0));
+  TEST_DONE();
+}
+
+TEST_FUNC(tween) {
+  ScegraStyle style;
+  float to[SCEGRA_PROP_VALUES_MAX] = { 100.0, 200.0, 0.0, 0.0 };
+  float x, y;
+  scegra_init();
+  scegrastyle_initempty(&style);
+  TEST_INTEQ(12, scegra_make_box(12, bevec(0, 0), bevec(10, 10), bevec(4, 4), style));
+  TEST_INTEQ(12, tween_start(12, SCEGRA_PROP_POSITION, to, 1.0, 0.5,
+                             TWEEN_EASE_LINEAR, TWEEN_LOOP_NONE, 0, FALSE));
+  TEST_INTEQ(-1, tween_start(13, SCEGRA_PROP_POSITION, to, 1.0, 0.0,
+                             TWEEN_EASE_LINEAR, TWEEN_LOOP_NONE, 0, FALSE));
+  TEST_INTEQ(1, tween_count());
+  TEST_TRUE(tween_active_p(12, SCEGRA_PROP_POSITION));
+  /* Still delayed. */
+  scegra_update(0.25);
+  scegra_position(12, &x, &y);
+  TEST_FLOATEQ(0.0, x);
+  /* Delay runs out half way this step. */
+  scegra_update(0.5);
+  scegra_position(12, &x, &y);
+  TEST_FLOATEQ(25.0, x);
+  TEST_FLOATEQ(50.0, y);
+  scegra_update(1.0);
+  scegra_position(12, &x, &y);
+  TEST_FLOATEQ(100.0, x);
+  TEST_FLOATEQ(200.0, y);
+  TEST_INTEQ(0, tween_count());
+
+  /* Ping pong loops back to the start. */
+  to[0] = 0.0; to[1] = 0.0;
+  TEST_INTEQ(12, tween_start(12, SCEGRA_PROP_POSITION, to, 1.0, 0.0,
+                             TWEEN_EASE_LINEAR, TWEEN_LOOP_PINGPONG, -1, FALSE));
+  TEST_INTEQ(12, tween_start(12, SCEGRA_PROP_MARGIN, to, 1.0, 0.0,
+                             TWEEN_EASE_LINEAR, TWEEN_LOOP_NONE, 0, FALSE));
+  TEST_INTEQ(2, tween_count());
+  scegra_update(1.5);
+  TEST_INTEQ(1, tween_count());
+  scegra_position(12, &x, &y);
+  TEST_FLOATEQ(50.0, x);
+  scegra_update(0.5);
+  scegra_position(12, &x, &y);
+  TEST_FLOATEQ(100.0, x);
+  TEST_INTEQ(1, tween_count());
+  /* Disabling the node stops its tweens. */
+  scegra_disable_node(12);
+  TEST_INTEQ(0, tween_count());
+  scegra_done();
+  TEST_DONE();
+}
+
+
+int main(void) {
+  TEST_INIT();
+  TEST_RUN(tween_ease);
+  TEST_RUN(tween);
+  TEST_REPORT();
+}
+
+
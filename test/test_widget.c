@@ -10,11 +10,41 @@ TEST_FUNC(widget) {
 }
 
 
+TEST_FUNC(bbconsole) {
+  BBConsole * console;
+  Font      * font;
+  Style       style;
+  int         index, charw;
+  al_init();
+  al_init_font_addon();
+  font    = al_create_builtin_font();
+  TEST_NOTNULL(font);
+  charw   = al_get_text_width(font, "a ");
+  style   = style_make(al_map_rgb(255, 255, 255), al_map_rgb(0, 0, 0), font, NULL);
+  /* Room for 4 words of 1 character plus a space per row. */
+  console = bbconsole_new(1, rebox_make(0, 0, 10 + 4 * charw, 100), style);
+  TEST_NOTNULL(console);
+  TEST_INTEQ(1, bbconsole_puts(console, "a b c d"));
+  TEST_INTEQ(1, bbconsole_rows(console));
+  TEST_INTEQ(1, bbconsole_puts(console, "a b c d e f"));
+  TEST_INTEQ(3, bbconsole_rows(console));
+  /* Newlines start new lines. */
+  TEST_INTEQ(2, bbconsole_puts(console, "a\nb"));
+  TEST_INTEQ(5, bbconsole_rows(console));
+  /* The scrollback is bounded, old lines are dropped. */
+  for (index = 0; index < 1000; index++) {
+    bbconsole_printf(console, "line %d", index);
+  }
+  TEST_TRUE(bbconsole_rows(console) <= 200);
+  bbconsole_free((BBWidget *)console, NULL);
+  al_destroy_font(font);
+  TEST_DONE();
+}
+
+
 int main(void) {
   TEST_INIT();
   TEST_RUN(widget);
+  TEST_RUN(bbconsole);
   TEST_REPORT();
 }
-
-
-